@@ -162,6 +162,11 @@ static int lcec_ax5805_init(int comp_id, lcec_slave_t *slave) {
     return err;
   }
 
+  // export FSoE connection diagnostics
+  if ((err = lcec_fsoe_diag_init(slave)) != 0) {
+    return err;
+  }
+
   return 0;
 }
 
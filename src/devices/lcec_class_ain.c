@@ -21,8 +21,15 @@
 
 #include "lcec_class_ain.h"
 
+#include <stdlib.h>
+
 #include "../lcec.h"
 
+/// @brief Channels and curves of all devices, kept together for `lcec_ain_read_all()`.
+static lcec_pool_t ain_pool;
+
+static void ain_read_curve(lcec_class_ain_channel_t *data, double in);
+
 /// @brief Basic pins common to all analog in devices.
 static const lcec_pindesc_t slave_pins_basic[] = {
     {HAL_S32, HAL_OUT, offsetof(lcec_class_ain_channel_t, raw_val), "%s.%s.%s.%s-%d-raw"},
@@ -73,9 +80,9 @@ static const lcec_pindesc_t slave_pins_status[] = {
 lcec_class_ain_channels_t *lcec_ain_allocate_channels(int count) {
   lcec_class_ain_channels_t *channels;
 
-  channels = LCEC_HAL_ALLOCATE(lcec_class_ain_channels_t);
+  channels = LCEC_POOL_ALLOCATE(&ain_pool, lcec_class_ain_channels_t);
   channels->count = count;
-  channels->channels = LCEC_HAL_ALLOCATE_ARRAY(lcec_class_ain_channel_t *, count);
+  channels->channels = LCEC_POOL_ALLOCATE_ARRAY(&ain_pool, lcec_class_ain_channel_t *, count);
 
   return channels;
 }
@@ -144,7 +151,7 @@ lcec_class_ain_channel_t *lcec_ain_register_channel(lcec_slave_t *slave, int id,
   }
 
   // Allocate memory for per-channel data.
-  data = LCEC_HAL_ALLOCATE(lcec_class_ain_channel_t);
+  data = LCEC_POOL_ALLOCATE(&ain_pool, lcec_class_ain_channel_t);
 
   // Save important options for later use.  None of the _idx/_sidx will be needed outside of this function.
   data->options = opt;
@@ -232,6 +239,7 @@ void lcec_ain_read(lcec_slave_t *slave, lcec_class_ain_channel_t *data) {
   uint8_t *pd = slave->master->process_data;
   int value;  // Needs to be large enough to hold either a uint16_t or an sint16_t without loss.
   int max_value = data->options->max_value;
+  double in;
 
   // Update status bits, if enabled
   if (!data->options->valueonly) {
@@ -254,14 +262,20 @@ void lcec_ain_read(lcec_slave_t *slave, lcec_class_ain_channel_t *data) {
   *(data->raw_val) = value;
   if (data->options->is_temperature) {
     // Temperature uses different value calculations than regular analog sensors.
-    *(data->val) = *(data->scale) * (double)value;
+    in = *(data->scale) * (double)value;
   } else {
     // Normal analog sensors return a value between -1.0 and 1.0 (or 0
     // and 1.0, depending on the sensor type), where 1.0 is the
     // largest possible input value.
     //
     // Then, the result is multipled by `scale` (default: 1.0) and `bias` is added (default 0).
-    *(data->val) = *(data->bias) + *(data->scale) * (double)value * ((double)1 / (double)max_value);
+    in = *(data->bias) + *(data->scale) * (double)value * ((double)1 / (double)max_value);
+  }
+
+  if (data->curve != NULL) {
+    ain_read_curve(data, in);
+  } else {
+    *(data->val) = in;
   }
 }
 
@@ -276,3 +290,157 @@ void lcec_ain_read_all(lcec_slave_t *slave, lcec_class_ain_channels_t *channels)
     lcec_ain_read(slave, channel);
   }
 }
+
+/// @brief Parse breakpoints from a curve modParam.
+///
+/// `spec` is a comma-separated list of `input:output` pairs, for
+/// example "18.5:-50, 100:0, 175.8:200".
+///
+/// @param spec The modParam value.
+/// @param x Where to store the inputs, or NULL to only count the breakpoints.
+/// @param y Where to store the outputs, or NULL.
+/// @param max Room in `x` and `y`.
+/// @return The number of breakpoints, or -1 if `spec` is malformed or holds more than `max`.
+int lcec_ain_curve_parse(const char *spec, double *x, double *y, int max) {
+  const char *s = spec;
+  char *end;
+  double in, out;
+  int count = 0;
+
+  while (1) {
+    in = strtod(s, &end);
+    if (end == s) return -1;
+    for (s = end; *s == ' '; s++);
+    if (*s++ != ':') return -1;
+
+    out = strtod(s, &end);
+    if (end == s) return -1;
+    for (s = end; *s == ' '; s++);
+
+    if (count >= max) return -1;
+    if (x != NULL) {
+      x[count] = in;
+      y[count] = out;
+    }
+    count++;
+
+    if (*s == 0) return count;
+    if (*s++ != ',') return -1;
+  }
+}
+
+/// @brief Attach a piecewise-linear curve to a channel.
+///
+/// The breakpoints are collected from every modParam with
+/// `modparam_id`, in order, so a table that doesn't fit in one
+/// modParam value can be split over several.  The curve maps the
+/// channel's scaled reading (after `scale` and `bias`) to `val`, and
+/// adds an `open` pin; see `ain_read_curve()`.
+///
+/// @param slave The slave, from `_init`.
+/// @param data The channel, from `lcec_ain_register_channel()`.
+/// @param id The channel ID, as passed to `lcec_ain_register_channel()`.
+/// @param modparam_id The modParam ID holding the breakpoints.
+/// @return 0 on success or if there are no breakpoints, -1 on error.
+int lcec_ain_set_curve(lcec_slave_t *slave, lcec_class_ain_channel_t *data, int id, int modparam_id) {
+  lcec_master_t *master = slave->master;
+  lcec_slave_modparam_t *p;
+  lcec_class_ain_curve_t *curve;
+  const char *name_prefix;
+  int count = 0, n, i;
+
+  if (slave->modparams == NULL) {
+    return 0;
+  }
+
+  for (p = slave->modparams; p->id >= 0; p++) {
+    if (p->id != modparam_id) continue;
+
+    n = lcec_ain_curve_parse(p->value.str, NULL, NULL, LCEC_AIN_CURVE_MAX_POINTS - count);
+    if (n < 0) {
+      rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "invalid curve \"%s\" for slave %s.%s channel %d\n", p->value.str, master->name,
+          slave->name, id);
+      return -1;
+    }
+    count += n;
+  }
+  if (count == 0) {
+    return 0;
+  }
+  if (count < 2) {
+    rtapi_print_msg(
+        RTAPI_MSG_ERR, LCEC_MSG_PFX "curve for slave %s.%s channel %d needs at least 2 points\n", master->name, slave->name, id);
+    return -1;
+  }
+
+  curve = LCEC_POOL_ALLOCATE(&ain_pool, lcec_class_ain_curve_t);
+  curve->x = LCEC_POOL_ALLOCATE_ARRAY(&ain_pool, double, count);
+  curve->y = LCEC_POOL_ALLOCATE_ARRAY(&ain_pool, double, count);
+  curve->slope = LCEC_POOL_ALLOCATE_ARRAY(&ain_pool, double, count - 1);
+
+  for (p = slave->modparams; p->id >= 0; p++) {
+    if (p->id != modparam_id) continue;
+    curve->count += lcec_ain_curve_parse(p->value.str, &curve->x[curve->count], &curve->y[curve->count], count - curve->count);
+  }
+
+  for (i = 0; i < count - 1; i++) {
+    if (curve->x[i + 1] <= curve->x[i]) {
+      rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "curve inputs for slave %s.%s channel %d must be increasing\n", master->name,
+          slave->name, id);
+      return -1;
+    }
+    curve->slope[i] = (curve->y[i + 1] - curve->y[i]) / (curve->x[i + 1] - curve->x[i]);
+  }
+
+  // pressure pins don't use the name prefix, see `slave_pins_basic_pressure`
+  name_prefix = data->options->is_pressure ? "press" : data->options->name_prefix;
+  if (lcec_pin_newf(HAL_BIT, HAL_OUT, (void **)&data->open, "%s.%s.%s.%s-%d-open", LCEC_MODULE_NAME, master->name, slave->name,
+          name_prefix, id) != 0) {
+    return -1;
+  }
+
+  data->curve = curve;
+  return 0;
+}
+
+/// @brief Look up `in` on a curve.
+///
+/// Readings move slowly, so the search walks from the segment used
+/// last time instead of bisecting; in steady state that's a single
+/// comparison.  Inputs outside the curve extrapolate the end segments.
+double lcec_ain_curve_eval(lcec_class_ain_curve_t *curve, double in) {
+  int s = curve->segment;
+
+  while (s > 0 && in < curve->x[s]) s--;
+  while (s < curve->count - 2 && in > curve->x[s + 1]) s++;
+  curve->segment = s;
+
+  return curve->y[s] + (in - curve->x[s]) * curve->slope[s];
+}
+
+/// @brief Publish a reading through the channel's curve.
+///
+/// The sensor counts as open when the device flags an error, under-
+/// or overrange, or when the reading is outside the curve.  While
+/// it's open `val` keeps the last good value.  `val` is only
+/// recalculated when the input changes.
+static void ain_read_curve(lcec_class_ain_channel_t *data, double in) {
+  lcec_class_ain_curve_t *curve = data->curve;
+  int open = 0;
+
+  if (!data->options->valueonly) {
+    open = *(data->error) || *(data->underrange) || *(data->overrange);
+  }
+  if (in < curve->x[0] || in > curve->x[curve->count - 1]) {
+    open = 1;
+  }
+  *(data->open) = open;
+
+  if (open || (curve->published && in == curve->last_in)) {
+    return;
+  }
+
+  *(data->val) = lcec_ain_curve_eval(curve, in);
+  curve->last_in = in;
+  curve->published = 1;
+}
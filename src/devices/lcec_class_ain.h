@@ -38,6 +38,19 @@ typedef struct {
   uint16_t syncerror_idx, syncerror_sidx;    ///< PDO index/subindex for reading sync error status.
 } lcec_class_ain_options_t;
 
+#define LCEC_AIN_CURVE_MAX_POINTS 256  ///< Upper limit on breakpoints per channel.
+
+/// @brief A piecewise-linear curve applied to a channel's reading, see `lcec_ain_set_curve()`.
+typedef struct {
+  int count;       ///< Number of breakpoints, at least 2.
+  double *x;       ///< Breakpoint inputs, strictly increasing.
+  double *y;       ///< Breakpoint outputs.
+  double *slope;   ///< `(y[i+1] - y[i]) / (x[i+1] - x[i])`, one per segment.
+  int segment;     ///< Segment used for the last reading; the next search starts here.
+  double last_in;  ///< Input of the last published reading.
+  int published;   ///< `last_in` is valid.
+} lcec_class_ain_curve_t;
+
 /// @brief Data for a single analog channel.
 typedef struct {
   hal_bit_t *overrange;   ///< Device reading is over-range.
@@ -48,6 +61,7 @@ typedef struct {
   hal_float_t *scale;     ///< The scale used to convert `raw_val` into `val`.
   hal_float_t *bias;      ///< The offset used to convert `raw_val` into `val`.
   hal_float_t *val;       ///< The final result returned to LinuxCNC.
+  hal_bit_t *open;        ///< Sensor is open or outside its curve.  Only exported with a curve.
   unsigned int ovr_pdo_os;
   unsigned int ovr_pdo_bp;
   unsigned int udr_pdo_os;
@@ -59,6 +73,7 @@ typedef struct {
   unsigned int val_pdo_os;
   int is_unsigned;
   lcec_class_ain_options_t *options;  ///< The options used to create this device.
+  lcec_class_ain_curve_t *curve;      ///< Linearization curve, or NULL.
 } lcec_class_ain_channel_t;
 
 /// @brief Data for an analog input device.
@@ -72,3 +87,6 @@ lcec_class_ain_channel_t *lcec_ain_register_channel(struct lcec_slave *slave, in
 void lcec_ain_read(struct lcec_slave *slave, lcec_class_ain_channel_t *data);
 void lcec_ain_read_all(struct lcec_slave *slave, lcec_class_ain_channels_t *channels);
 lcec_class_ain_options_t *lcec_ain_options(void);
+int lcec_ain_curve_parse(const char *spec, double *x, double *y, int max);
+int lcec_ain_set_curve(struct lcec_slave *slave, lcec_class_ain_channel_t *data, int id, int modparam_id);
+double lcec_ain_curve_eval(lcec_class_ain_curve_t *curve, double in);
@@ -23,6 +23,11 @@
 
 #include "../lcec.h"
 
+/// @brief Channels of all devices, kept together for `lcec_aout_write_all()`.
+static lcec_pool_t aout_pool;
+
+#define RAMP_ONE 0x10000  ///< 1.0 in the ramp's 16.16 fixed point.
+
 /// @brief Basic pins common to all analog in devices.
 static const lcec_pindesc_t slave_pins_basic[] = {
     {HAL_FLOAT, HAL_IO, offsetof(lcec_class_aout_channel_t, scale), "%s.%s.%s.%s-%d-scale"},
@@ -36,6 +41,9 @@ static const lcec_pindesc_t slave_pins_basic[] = {
     {HAL_S32, HAL_OUT, offsetof(lcec_class_aout_channel_t, raw_val), "%s.%s.%s.%s-%d-raw"},
     {HAL_BIT, HAL_OUT, offsetof(lcec_class_aout_channel_t, pos), "%s.%s.%s.%s-%d-pos"},
     {HAL_BIT, HAL_OUT, offsetof(lcec_class_aout_channel_t, neg), "%s.%s.%s.%s-%d-neg"},
+    {HAL_FLOAT, HAL_IO, offsetof(lcec_class_aout_channel_t, ramp_rate), "%s.%s.%s.%s-%d-ramp-rate"},
+    {HAL_FLOAT, HAL_IO, offsetof(lcec_class_aout_channel_t, ramp_accel), "%s.%s.%s.%s-%d-ramp-accel"},
+    {HAL_FLOAT, HAL_IO, offsetof(lcec_class_aout_channel_t, ramp_tau), "%s.%s.%s.%s-%d-ramp-tau"},
     {HAL_TYPE_UNSPECIFIED, HAL_DIR_UNSPECIFIED, -1, NULL},
 };
 
@@ -50,9 +58,9 @@ static const lcec_pindesc_t slave_pins_basic[] = {
 lcec_class_aout_channels_t *lcec_aout_allocate_channels(int count) {
   lcec_class_aout_channels_t *channels;
 
-  channels = LCEC_HAL_ALLOCATE(lcec_class_aout_channels_t);
+  channels = LCEC_POOL_ALLOCATE(&aout_pool, lcec_class_aout_channels_t);
   channels->count = count;
-  channels->channels = LCEC_HAL_ALLOCATE_ARRAY(lcec_class_aout_channel_t *, count);
+  channels->channels = LCEC_POOL_ALLOCATE_ARRAY(&aout_pool, lcec_class_aout_channel_t *, count);
   return channels;
 }
 
@@ -89,6 +97,13 @@ lcec_class_aout_channel_t *lcec_aout_register_channel(lcec_slave_t *slave, int i
   if (opt && opt->value_idx) value_idx = opt->value_idx;
   if (opt && opt->value_sidx) value_sidx = opt->value_sidx;
 
+  // the ramp works in 16.16 fixed point in an int32_t
+  if (max_value < 1 || max_value > LCEC_AOUT_MAX_VALUE) {
+    rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "max_value %d for slave %s.%s channel %d is out of range\n", max_value, slave->master->name,
+        slave->name, id);
+    return NULL;
+  }
+
   // The default name depends on the port type.
   const char *name_prefix = "aout";
   if (opt && opt->name_prefix) name_prefix = opt->name_prefix;
@@ -101,7 +116,7 @@ lcec_class_aout_channel_t *lcec_aout_register_channel(lcec_slave_t *slave, int i
   }
 
   // Allocate memory for per-channel data.
-  data = LCEC_HAL_ALLOCATE(lcec_class_aout_channel_t);
+  data = LCEC_POOL_ALLOCATE(&aout_pool, lcec_class_aout_channel_t);
 
   // Save important options for later use.  None of the _idx/_sidx will be needed outside of this function.
   data->options = opt;
@@ -125,8 +140,7 @@ lcec_class_aout_channel_t *lcec_aout_register_channel(lcec_slave_t *slave, int i
   if (opt->default_offset != 0) *(data->offset) = opt->default_offset;
   *(data->max_dc) = 1.0;
   *(data->min_dc) = -1.0;
-  data->old_scale = *(data->scale) + 1.0;
-  data->scale_recip = 1.0 / *(data->scale);
+  data->scale_watch = lcec_scale_watch(slave, data->scale);
 
   return data;
 }
@@ -136,12 +150,15 @@ lcec_class_aout_channel_t *lcec_aout_register_channel(lcec_slave_t *slave, int i
 /// @param slave The `slave`, passed from the per-device `_read`.
 /// @param data  Which channel to read; a `lcec_class_aout_channel_t *`, as returned by lcec_aout_register_channel.
 ///
+/// @param period The cycle time, in ns, passed from the per-device `_write`.
+///
 /// Call this once per channel registered, from inside of your device's
 /// read function.  Use `lcec_aout_write_all` to read all pins.
-void lcec_aout_write(lcec_slave_t *slave, lcec_class_aout_channel_t *data) {
+void lcec_aout_write(lcec_slave_t *slave, lcec_class_aout_channel_t *data, long period) {
   uint8_t *pd = slave->master->process_data;
   int max_value = data->options->max_value;
   double tmpval, tmpdc, raw_val;
+  int target, out;
 
   // validate duty cycle limits, both limits must be between
   // 0.0 and 1.0 (inclusive) and max must be greater then min
@@ -158,19 +175,6 @@ void lcec_aout_write(lcec_slave_t *slave, lcec_class_aout_channel_t *data) {
     *(data->max_dc) = *(data->min_dc);
   }
 
-  // do scale calcs only when scale changes
-  if (*(data->scale) != data->old_scale) {
-    // validate the new scale value
-    if ((*(data->scale) < 1e-20) && (*(data->scale) > -1e-20)) {
-      // value too small, divide by zero is a bad thing
-      *(data->scale) = 1.0;
-    }
-    // get ready to detect future scale changes
-    data->old_scale = *(data->scale);
-    // we will need the reciprocal
-    data->scale_recip = 1.0 / *(data->scale);
-  }
-
   // get command
   tmpval = *(data->value);
   if (*(data->absmode) && (tmpval < 0)) {
@@ -178,7 +182,7 @@ void lcec_aout_write(lcec_slave_t *slave, lcec_class_aout_channel_t *data) {
   }
 
   // convert value command to duty cycle
-  tmpdc = tmpval * data->scale_recip + *(data->offset);
+  tmpdc = tmpval * data->scale_watch->recip + *(data->offset);
   if (tmpdc < *(data->min_dc)) {
     tmpdc = *(data->min_dc);
   }
@@ -192,6 +196,11 @@ void lcec_aout_write(lcec_slave_t *slave, lcec_class_aout_channel_t *data) {
     *(data->pos) = 0;
     *(data->neg) = 0;
     *(data->curr_dc) = 0;
+
+    // disabling drops the output at once, enabling ramps up from 0
+    data->ramp.filt = 0;
+    data->ramp.pos = 0;
+    data->ramp.vel = 0;
   } else {
     raw_val = (double)max_value * tmpdc;
     if (raw_val > (double)max_value) {
@@ -200,9 +209,30 @@ void lcec_aout_write(lcec_slave_t *slave, lcec_class_aout_channel_t *data) {
     if (raw_val < (double)-max_value) {
       raw_val = (double)-max_value;
     }
-    *(data->pos) = (*(data->value) > 0);
-    *(data->neg) = (*(data->value) < 0);
     *(data->curr_dc) = tmpdc;
+
+    // In absmode the ramp follows the signed output, so a reversal
+    // goes through 0 and pos/neg only flip when the output does.
+    // Without a ramp, pos/neg follow `value` as they always have.
+    target = (int)raw_val;
+    if (*(data->absmode) && *(data->value) < 0) {
+      target = -target;
+    }
+    out = lcec_aout_ramp(&data->ramp, max_value, *(data->ramp_rate), *(data->ramp_accel), *(data->ramp_tau), target, period);
+    if (*(data->ramp_rate) != 0 || *(data->ramp_accel) != 0 || *(data->ramp_tau) != 0) {
+      *(data->pos) = (out > 0);
+      *(data->neg) = (out < 0);
+    } else {
+      *(data->pos) = (*(data->value) > 0);
+      *(data->neg) = (*(data->value) < 0);
+    }
+    if (*(data->absmode) && out < 0) {
+      out = -out;
+    }
+    if (out != (int)raw_val) {
+      *(data->curr_dc) = out / (double)max_value;
+    }
+    raw_val = out;
   }
 
   // update value
@@ -214,10 +244,127 @@ void lcec_aout_write(lcec_slave_t *slave, lcec_class_aout_channel_t *data) {
 ///
 /// @param slave The `slave`, passed from the per-device `_read`.
 /// @param channels An `lcec_class_aout_channel_t *`, as returned by lcec_aout_register_channel.
-void lcec_aout_write_all(lcec_slave_t *slave, lcec_class_aout_channels_t *channels) {
+/// @param period The cycle time, in ns, passed from the per-device `_write`.
+void lcec_aout_write_all(lcec_slave_t *slave, lcec_class_aout_channels_t *channels, long period) {
   for (int i = 0; i < channels->count; i++) {
     lcec_class_aout_channel_t *channel = channels->channels[i];
 
-    lcec_aout_write(slave, channel);
+    lcec_aout_write(slave, channel, period);
+  }
+}
+
+/// @brief Convert the ramp pins into per-cycle fixed-point limits.
+static void aout_ramp_limits(lcec_class_aout_ramp_t *ramp, int max_value, double rate, double accel, double tau, long period) {
+  double dt = (double)period * 1e-9;
+  double full = (double)max_value * RAMP_ONE;  // duty cycle 1.0
+  double step;
+
+  ramp->rate = rate;
+  ramp->accel = accel;
+  ramp->tau = tau;
+  ramp->period = period;
+
+  // Limits are capped at full scale per cycle, which is no limit at
+  // all in practice, and keep the arithmetic below in range.
+  ramp->rate_step = 0;
+  if (rate > 0) {
+    step = rate * dt * full;
+    ramp->rate_step = step > full ? (int32_t)full : step < 1 ? 1 : (int32_t)step;
   }
+
+  ramp->accel_step = 0;
+  if (accel > 0) {
+    step = accel * dt * dt * full;
+    ramp->accel_step = step > full ? (int32_t)full : step < 1 ? 1 : (int32_t)step;
+  }
+
+  // backward Euler, so the gain stays below 1.0 for any tau
+  ramp->alpha = RAMP_ONE;
+  if (tau > 0) {
+    step = RAMP_ONE * dt / (tau + dt);
+    ramp->alpha = step < 1 ? 1 : (int32_t)step;
+  }
+}
+
+// Distance covered while braking from `u` to a stop at `a` per cycle.
+// In double, because u * u overflows int64_t near full scale.
+static double aout_ramp_brake_dist(int64_t u, int64_t a) { return (double)u * (double)(u + a) / (2.0 * (double)a); }
+
+/// @brief Advance an output ramp by one cycle.
+///
+/// The target first goes through a first-order lag with time constant
+/// `tau`, then through a rate limit and an acceleration limit.  With
+/// an acceleration limit the output follows an S-curve and brakes so
+/// that it doesn't overshoot.  Settings of 0 disable the stage; with
+/// all three at 0 the output is `target`.  The state is fixed point,
+/// and the floating point settings are only converted when they
+/// change.
+///
+/// @param ramp The ramp state, zeroed for an output at 0.
+/// @param max_value Full scale, in output counts.
+/// @param rate Rate limit, in full scale per second.
+/// @param accel Acceleration limit, in full scale per second^2.
+/// @param tau Time constant, in seconds.
+/// @param target The requested output, in counts.
+/// @param period The cycle time, in ns.
+/// @return The output for this cycle, in counts.
+int lcec_aout_ramp(lcec_class_aout_ramp_t *ramp, int max_value, double rate, double accel, double tau, int target, long period) {
+  int64_t limit = (int64_t)max_value * RAMP_ONE;
+  int64_t err, dist, vel, vmax, pos, u, a;
+  int dir;
+
+  if (rate != ramp->rate || accel != ramp->accel || tau != ramp->tau || period != ramp->period) {
+    aout_ramp_limits(ramp, max_value, rate, accel, tau, period);
+  }
+
+  // first-order stage
+  if (ramp->alpha < RAMP_ONE) {
+    ramp->filt += ((int64_t)target * RAMP_ONE - ramp->filt) * ramp->alpha / RAMP_ONE;
+  } else {
+    ramp->filt = target * RAMP_ONE;
+  }
+
+  // rate and acceleration stage
+  err = (int64_t)ramp->filt - ramp->pos;
+  vel = err;
+  if (ramp->accel_step != 0) {
+    // Work in the direction of the target.  Speed up, hold, or slow
+    // down, whichever is fastest and still lets the output brake to
+    // a stop at the target.
+    a = ramp->accel_step;
+    dir = err < 0 ? -1 : 1;
+    dist = err * dir;
+    u = ramp->vel * dir;
+    vmax = ramp->rate_step != 0 ? ramp->rate_step : limit;
+
+    if (dist <= a && u <= a && u >= -a) {
+      // close enough to stop this cycle
+      u = dist;
+    } else if (u < 0) {
+      // still moving away
+      u += a;
+    } else if (u + a <= vmax && aout_ramp_brake_dist(u + a, a) <= dist) {
+      u += a;
+    } else if (u <= vmax && aout_ramp_brake_dist(u, a) <= dist) {
+      // hold
+    } else {
+      u -= a;
+    }
+    vel = u * dir;
+  }
+  if (ramp->rate_step != 0) {
+    vmax = ramp->rate_step;
+    if (vel > vmax) vel = vmax;
+    if (vel < -vmax) vel = -vmax;
+  }
+  pos = ramp->pos + vel;
+  if (pos > limit) pos = limit;
+  if (pos < -limit) pos = -limit;
+  vel = pos - ramp->pos;
+  if (vel > limit) vel = limit;
+  if (vel < -limit) vel = -limit;
+  ramp->vel = (int32_t)vel;
+  ramp->pos = (int32_t)pos;
+
+  return (ramp->pos + (ramp->pos < 0 ? -RAMP_ONE / 2 : RAMP_ONE / 2)) / RAMP_ONE;
 }
@@ -21,6 +21,8 @@
 
 #include "../lcec.h"
 
+#define LCEC_AOUT_MAX_VALUE 0x7fff  ///< Largest `max_value`, so that the ramp's 16.16 fixed point fits in 32 bits.
+
 typedef struct {
   const char *name_prefix;         ///< Prefix for device naming, defaults to "aio".
   int max_value;                   ///< The maximum value returned for "normal" output channels.
@@ -29,6 +31,20 @@ typedef struct {
   uint16_t value_idx, value_sidx;  ///< PDO index and subindex for reading the value.
 } lcec_class_aout_options_t;
 
+/// @brief Output ramp state, see `lcec_aout_ramp()`.
+///
+/// Positions are in output counts, as 16.16 fixed point.
+typedef struct {
+  double rate, accel, tau;  ///< Pin values the per-cycle limits below were computed from.
+  long period;              ///< Cycle time the per-cycle limits below were computed from.
+  int32_t rate_step;        ///< Largest change of `pos` per cycle, 0 for no limit.
+  int32_t accel_step;       ///< Largest change of `vel` per cycle, 0 for no limit.
+  int32_t alpha;            ///< First-order gain per cycle, 16.16; 1.0 disables the filter.
+  int32_t filt;             ///< Output of the first-order stage.
+  int32_t pos;              ///< Output of the rate/acceleration stage.
+  int32_t vel;              ///< Change of `pos` in the last cycle, at most full scale.
+} lcec_class_aout_ramp_t;
+
 /// @brief Data for a single analog channel.
 typedef struct {
   hal_bit_t *pos;
@@ -38,12 +54,15 @@ typedef struct {
   hal_float_t *value;
   hal_float_t *scale;
   hal_float_t *offset;
-  double old_scale;
-  double scale_recip;
+  lcec_scale_t *scale_watch;  ///< Watched `scale`.
   hal_float_t *min_dc;
   hal_float_t *max_dc;
   hal_float_t *curr_dc;
   hal_s32_t *raw_val;  ///< The raw value read from the device.
+  hal_float_t *ramp_rate;   ///< Largest output change, in duty cycle per second.  0 disables.
+  hal_float_t *ramp_accel;  ///< Largest change of the ramp rate, in duty cycle per second^2.  0 disables.
+  hal_float_t *ramp_tau;    ///< First-order time constant, in seconds.  0 disables.
+  lcec_class_aout_ramp_t ramp;
   unsigned int val_pdo_os;
   lcec_class_aout_options_t *options;  ///< The options used to create this device.
 } lcec_class_aout_channel_t;
@@ -56,6 +75,7 @@ typedef struct {
 
 lcec_class_aout_channels_t *lcec_aout_allocate_channels(int count);
 lcec_class_aout_channel_t *lcec_aout_register_channel(struct lcec_slave *slave, int id, uint16_t idx, lcec_class_aout_options_t *opt);
-void lcec_aout_write(struct lcec_slave *slave, lcec_class_aout_channel_t *data);
-void lcec_aout_write_all(struct lcec_slave *slave, lcec_class_aout_channels_t *channels);
+void lcec_aout_write(struct lcec_slave *slave, lcec_class_aout_channel_t *data, long period);
+void lcec_aout_write_all(struct lcec_slave *slave, lcec_class_aout_channels_t *channels, long period);
 lcec_class_aout_options_t *lcec_aout_options(void);
+int lcec_aout_ramp(lcec_class_aout_ramp_t *ramp, int max_value, double rate, double accel, double tau, int target, long period);
@@ -27,21 +27,29 @@
 #include "../lcec.h"
 #include "lcec_class_cia402_opt.h"
 
+/// @brief Channel lists and `enabled` flags of all devices, kept together for the read and write functions.
+static lcec_pool_t cia402_pool;
+
 /// @brief Pins common to all CiA 402 devices
 static const lcec_pindesc_t pins_required[] = {
     // HAL_OUT is readable, HAL_IN is writable.
     {HAL_U32, HAL_IN, offsetof(lcec_class_cia402_channel_t, controlword), "%s.%s.%s.%s-cia-controlword"},
     {HAL_U32, HAL_OUT, offsetof(lcec_class_cia402_channel_t, statusword), "%s.%s.%s.%s-cia-statusword"},
-    {HAL_U32, HAL_OUT, offsetof(lcec_class_cia402_channel_t, supported_modes), "%s.%s.%s.%s-supported-modes"},
-    {HAL_BIT, HAL_OUT, offsetof(lcec_class_cia402_channel_t, supports_mode_pp), "%s.%s.%s.%s-supports-mode-pp"},
-    {HAL_BIT, HAL_OUT, offsetof(lcec_class_cia402_channel_t, supports_mode_vl), "%s.%s.%s.%s-supports-mode-vl"},
-    {HAL_BIT, HAL_OUT, offsetof(lcec_class_cia402_channel_t, supports_mode_pv), "%s.%s.%s.%s-supports-mode-pv"},
-    {HAL_BIT, HAL_OUT, offsetof(lcec_class_cia402_channel_t, supports_mode_tq), "%s.%s.%s.%s-supports-mode-tq"},
-    {HAL_BIT, HAL_OUT, offsetof(lcec_class_cia402_channel_t, supports_mode_hm), "%s.%s.%s.%s-supports-mode-hm"},
-    {HAL_BIT, HAL_OUT, offsetof(lcec_class_cia402_channel_t, supports_mode_ip), "%s.%s.%s.%s-supports-mode-ip"},
-    {HAL_BIT, HAL_OUT, offsetof(lcec_class_cia402_channel_t, supports_mode_csp), "%s.%s.%s.%s-supports-mode-csp"},
-    {HAL_BIT, HAL_OUT, offsetof(lcec_class_cia402_channel_t, supports_mode_csv), "%s.%s.%s.%s-supports-mode-csv"},
-    {HAL_BIT, HAL_OUT, offsetof(lcec_class_cia402_channel_t, supports_mode_cst), "%s.%s.%s.%s-supports-mode-cst"},
+    {HAL_TYPE_UNSPECIFIED, HAL_DIR_UNSPECIFIED, -1, NULL},
+};
+
+/// @brief Pins common to all CiA 402 devices that are only set up once
+static const lcec_pindesc_t pins_cold[] = {
+    {HAL_U32, HAL_OUT, offsetof(lcec_class_cia402_channel_cold_t, supported_modes), "%s.%s.%s.%s-supported-modes"},
+    {HAL_BIT, HAL_OUT, offsetof(lcec_class_cia402_channel_cold_t, supports_mode_pp), "%s.%s.%s.%s-supports-mode-pp"},
+    {HAL_BIT, HAL_OUT, offsetof(lcec_class_cia402_channel_cold_t, supports_mode_vl), "%s.%s.%s.%s-supports-mode-vl"},
+    {HAL_BIT, HAL_OUT, offsetof(lcec_class_cia402_channel_cold_t, supports_mode_pv), "%s.%s.%s.%s-supports-mode-pv"},
+    {HAL_BIT, HAL_OUT, offsetof(lcec_class_cia402_channel_cold_t, supports_mode_tq), "%s.%s.%s.%s-supports-mode-tq"},
+    {HAL_BIT, HAL_OUT, offsetof(lcec_class_cia402_channel_cold_t, supports_mode_hm), "%s.%s.%s.%s-supports-mode-hm"},
+    {HAL_BIT, HAL_OUT, offsetof(lcec_class_cia402_channel_cold_t, supports_mode_ip), "%s.%s.%s.%s-supports-mode-ip"},
+    {HAL_BIT, HAL_OUT, offsetof(lcec_class_cia402_channel_cold_t, supports_mode_csp), "%s.%s.%s.%s-supports-mode-csp"},
+    {HAL_BIT, HAL_OUT, offsetof(lcec_class_cia402_channel_cold_t, supports_mode_csv), "%s.%s.%s.%s-supports-mode-csv"},
+    {HAL_BIT, HAL_OUT, offsetof(lcec_class_cia402_channel_cold_t, supports_mode_cst), "%s.%s.%s.%s-supports-mode-cst"},
     {HAL_TYPE_UNSPECIFIED, HAL_DIR_UNSPECIFIED, -1, NULL},
 };
 
@@ -59,17 +67,24 @@ static const lcec_pindesc_t pins_required[] = {
       {HAL_TYPE_UNSPECIFIED, HAL_DIR_UNSPECIFIED, -1, NULL},                                                                      \
   }
 
+/// @brief Create a new, optional pin for writing an SDO, using standardized names.
+#define OPTIONAL_SDO_PIN_WRITE(var_name)                                                                                                \
+  static const lcec_pindesc_t pins_##var_name[] = {                                                                                     \
+      {PDO_PIN_TYPE_##var_name, HAL_IN, offsetof(lcec_class_cia402_channel_cold_t, var_name), "%s.%s.%s.%s-" PDO_PIN_NAME_##var_name},  \
+      {HAL_TYPE_UNSPECIFIED, HAL_DIR_UNSPECIFIED, -1, NULL},                                                                            \
+  }
+
 // These three create a whole slew of `pin_foo` variables that define
 // the pins for each PDO and SDO that we want pins for.
 FOR_ALL_READ_PDOS_DO(OPTIONAL_PIN_READ);
 FOR_ALL_WRITE_PDOS_DO(OPTIONAL_PIN_WRITE);
-FOR_ALL_WRITE_SDOS_DO(OPTIONAL_PIN_WRITE);
+FOR_ALL_WRITE_SDOS_DO(OPTIONAL_SDO_PIN_WRITE);
 
 /// @brief Create a `lcec_class_cia402_enabled_t` from a
 /// `lcec_class_cia402_channel_options_t`.
 static lcec_class_cia402_enabled_t *lcec_cia402_enabled(lcec_class_cia402_channel_options_t *opt) {
   lcec_class_cia402_enabled_t *enabled;
-  enabled = LCEC_HAL_ALLOCATE(lcec_class_cia402_enabled_t);
+  enabled = LCEC_POOL_ALLOCATE(&cia402_pool, lcec_class_cia402_enabled_t);
 
   if (opt->enable_opmode) {
     enabled->enable_opmode = 1;
@@ -134,9 +149,9 @@ static lcec_class_cia402_enabled_t *lcec_cia402_enabled(lcec_class_cia402_channe
 lcec_class_cia402_channels_t *lcec_cia402_allocate_channels(int count) {
   lcec_class_cia402_channels_t *channels;
 
-  channels = LCEC_HAL_ALLOCATE(lcec_class_cia402_channels_t);
+  channels = LCEC_POOL_ALLOCATE(&cia402_pool, lcec_class_cia402_channels_t);
   channels->count = count;
-  channels->channels = LCEC_HAL_ALLOCATE_ARRAY(lcec_class_cia402_channel_t *, count);
+  channels->channels = LCEC_POOL_ALLOCATE_ARRAY(&cia402_pool, lcec_class_cia402_channel_t *, count);
   return channels;
 }
 
@@ -337,9 +352,10 @@ lcec_class_cia402_channel_t *lcec_cia402_register_channel(
   }
 
   // Allocate memory for per-channel data.
-  data = LCEC_HAL_ALLOCATE(lcec_class_cia402_channel_t);
-  data->options = opt;
-  data->base_idx = base_idx;
+  data = LCEC_HOT_ALLOCATE(lcec_class_cia402_channel_t);
+  data->cold = LCEC_HAL_ALLOCATE(lcec_class_cia402_channel_cold_t);
+  data->cold->options = opt;
+  data->cold->base_idx = base_idx;
 
   // Set the `enabled` struct from `opt`.
   enabled = lcec_cia402_enabled(opt);
@@ -358,12 +374,11 @@ lcec_class_cia402_channel_t *lcec_cia402_register_channel(
   FOR_ALL_WRITE_PDOS_DO(INIT_OPTIONAL_PDO);
 
 #define INIT_SDO_REQUEST(pin_name) \
-  data->pin_name##_sdorequest =    \
-      ecrt_slave_config_create_sdo_request(slave->config, base_idx + PDO_IDX_OFFSET_##pin_name, PDO_SIDX_##pin_name, PDO_BITS_##pin_name)
+  lcec_create_sdo_request(          \
+      slave, base_idx + PDO_IDX_OFFSET_##pin_name, PDO_SIDX_##pin_name, PDO_BITS_##pin_name, &data->cold->pin_name##_sdorequest)
 
-  // Call `ecrt_slave_config_create_sdo_request()` for all writable
-  // SDOs, so we're able to write to them after we flip to real-time
-  // mode.
+  // Call `lcec_create_sdo_request()` for all writable SDOs, so we're
+  // able to write to them after we flip to real-time mode.
   FOR_ALL_WRITE_SDOS_DO(INIT_SDO_REQUEST);
 
   // Register pins
@@ -372,6 +387,11 @@ lcec_class_cia402_channel_t *lcec_cia402_register_channel(
     rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "lcec_pin_newf_list for slave %s.%s failed\n", slave->master->name, slave->name);
     return NULL;
   }
+  err = lcec_pin_newf_list(data->cold, pins_cold, LCEC_MODULE_NAME, slave->master->name, slave->name, name_prefix);
+  if (err != 0) {
+    rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "lcec_pin_newf_list for slave %s.%s failed\n", slave->master->name, slave->name);
+    return NULL;
+  }
 
   // Set up digital in/out
   if (enabled->enable_digital_input) {
@@ -411,38 +431,44 @@ lcec_class_cia402_channel_t *lcec_cia402_register_channel(
     }
   }
 
-#define REGISTER_OPTIONAL_PINS(pin_name)                                                                                              \
+#define REGISTER_OPTIONAL_PINS_IN(base, pin_name)                                                                                     \
   do {                                                                                                                                \
     if (enabled->enable_##pin_name) {                                                                                                 \
-      err = lcec_pin_newf_list(data, pins_##pin_name, LCEC_MODULE_NAME, slave->master->name, slave->name, name_prefix);               \
+      err = lcec_pin_newf_list(base, pins_##pin_name, LCEC_MODULE_NAME, slave->master->name, slave->name, name_prefix);               \
       if (err != 0) {                                                                                                                 \
         rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "lcec_pin_newf_list for slave %s.%s failed\n", slave->master->name, slave->name); \
         return NULL;                                                                                                                  \
       }                                                                                                                               \
     }                                                                                                                                 \
   } while (0)
+#define REGISTER_OPTIONAL_PINS(pin_name) REGISTER_OPTIONAL_PINS_IN(data, pin_name)
+#define REGISTER_OPTIONAL_SDO_PINS(pin_name)         \
+  do {                                               \
+    REGISTER_OPTIONAL_PINS_IN(data->cold, pin_name); \
+    data->write_sdos |= enabled->enable_##pin_name;  \
+  } while (0)
   //
 
   // Register pins for all read PDOs, write PDOs, and write SDOs.  The
-  // process is identical for all three.
+  // process is identical for all three, but SDO pins live in `cold`.
   FOR_ALL_READ_PDOS_DO(REGISTER_OPTIONAL_PINS);
   FOR_ALL_WRITE_PDOS_DO(REGISTER_OPTIONAL_PINS);
-  FOR_ALL_WRITE_SDOS_DO(REGISTER_OPTIONAL_PINS);
+  FOR_ALL_WRITE_SDOS_DO(REGISTER_OPTIONAL_SDO_PINS);
 
   // Set default values for pins here.
   uint32_t modes;
   lcec_read_sdo32(slave, base_idx + 0x502, 0, &modes);
 
-  *(data->supported_modes) = modes;
-  *(data->supports_mode_pp) = modes & 1 << 0;
-  *(data->supports_mode_vl) = modes & 1 << 1;
-  *(data->supports_mode_pv) = modes & 1 << 2;
-  *(data->supports_mode_tq) = modes & 1 << 3;
-  *(data->supports_mode_hm) = modes & 1 << 5;
-  *(data->supports_mode_ip) = modes & 1 << 6;
-  *(data->supports_mode_csp) = modes & 1 << 7;
-  *(data->supports_mode_csv) = modes & 1 << 8;
-  *(data->supports_mode_cst) = modes & 1 << 9;
+  *(data->cold->supported_modes) = modes;
+  *(data->cold->supports_mode_pp) = modes & 1 << 0;
+  *(data->cold->supports_mode_vl) = modes & 1 << 1;
+  *(data->cold->supports_mode_pv) = modes & 1 << 2;
+  *(data->cold->supports_mode_tq) = modes & 1 << 3;
+  *(data->cold->supports_mode_hm) = modes & 1 << 5;
+  *(data->cold->supports_mode_ip) = modes & 1 << 6;
+  *(data->cold->supports_mode_csp) = modes & 1 << 7;
+  *(data->cold->supports_mode_csv) = modes & 1 << 8;
+  *(data->cold->supports_mode_cst) = modes & 1 << 9;
 
   /// @brief Initializes a pin's defaults using the current value of the backing SDO.
   ///
@@ -458,15 +484,17 @@ lcec_class_cia402_channel_t *lcec_cia402_register_channel(
   ///
   /// The upshot?  Call SET_OPTIONAL_DEFAULTS(FOO), and the right
   /// thing happens.
-#define SET_OPTIONAL_DEFAULTS(pin_name)                                                                          \
+#define SET_OPTIONAL_DEFAULTS_IN(base, pin_name)                                                                 \
   if (enabled->enable_##pin_name) SUBSTJOIN5(lcec_read_sdo, PDO_BITS_##pin_name, _pin_, PDO_SIGN_##pin_name, 32) \
-  (slave, base_idx + PDO_IDX_OFFSET_##pin_name, PDO_SIDX_##pin_name, data->pin_name)
+  (slave, base_idx + PDO_IDX_OFFSET_##pin_name, PDO_SIDX_##pin_name, base->pin_name)
+#define SET_OPTIONAL_DEFAULTS(pin_name)     SET_OPTIONAL_DEFAULTS_IN(data, pin_name)
+#define SET_OPTIONAL_SDO_DEFAULTS(pin_name) SET_OPTIONAL_DEFAULTS_IN(data->cold, pin_name)
 
   // Read the current value of all of our writable PDOs and SDOs, so
   // (a) we have a reasonable default and (b) we don't immediately
   // overwrite the presumably-valid settings on the device.
   FOR_ALL_WRITE_PDOS_DO(SET_OPTIONAL_DEFAULTS);
-  FOR_ALL_WRITE_SDOS_DO(SET_OPTIONAL_DEFAULTS);
+  FOR_ALL_WRITE_SDOS_DO(SET_OPTIONAL_SDO_DEFAULTS);
 
   return data;
 }
@@ -513,7 +541,7 @@ void lcec_cia402_read_all(lcec_slave_t *slave, lcec_class_cia402_channels_t *cha
 /// writes to an SDO.  Unfortunately, Etherlab's EtherCAT library
 /// doesn't make this entirely trivial.  We have to have allocated an
 /// SDO request before real-time mode started (which we did, it's
-/// stored in `name##_sdorequest`).  Then we need to do 3 things:
+/// stored in `cold->name##_sdorequest`).  Then we need to do 3 things:
 ///
 /// 1. Make sure that another write isn't in progress for this SDO.
 ///    To do this, we need to check `ecrt_sdo_request_state()` and make
@@ -526,12 +554,12 @@ void lcec_cia402_read_all(lcec_slave_t *slave, lcec_class_cia402_channels_t *cha
 #define WRITE_OPT_SDO(name)                                                                   \
   do {                                                                                        \
     if (data->enabled->enable_##name) {                                                       \
-      if (*(data->name) != data->name##_old) {                                                \
-        if (ecrt_sdo_request_state(data->name##_sdorequest) != EC_REQUEST_BUSY) {             \
-          data->name##_old = *(data->name);                                                   \
-          uint8_t *sdo_tmp = ecrt_sdo_request_data(data->name##_sdorequest);                  \
-          SUBSTJOIN3(EC_WRITE_, PDO_SIGN_##name, PDO_BITS_##name)(sdo_tmp, data->name##_old); \
-          ecrt_sdo_request_write(data->name##_sdorequest);                                    \
+      if (*(cold->name) != cold->name##_old) {                                                \
+        if (ecrt_sdo_request_state(cold->name##_sdorequest) != EC_REQUEST_BUSY) {             \
+          cold->name##_old = *(cold->name);                                                   \
+          uint8_t *sdo_tmp = ecrt_sdo_request_data(cold->name##_sdorequest);                  \
+          SUBSTJOIN3(EC_WRITE_, PDO_SIGN_##name, PDO_BITS_##name)(sdo_tmp, cold->name##_old); \
+          ecrt_sdo_request_write(cold->name##_sdorequest);                                    \
         }                                                                                     \
       }                                                                                       \
     }                                                                                         \
@@ -546,7 +574,11 @@ void lcec_cia402_write(lcec_slave_t *slave, lcec_class_cia402_channel_t *data) {
   FOR_ALL_WRITE_PDOS_DO(WRITE_OPT);
 
   // Write SDOs (*not* mapped, written on demand, slower)
-  FOR_ALL_WRITE_SDOS_DO(WRITE_OPT_SDO);
+  if (data->write_sdos) {
+    lcec_class_cia402_channel_cold_t *cold = data->cold;
+
+    FOR_ALL_WRITE_SDOS_DO(WRITE_OPT_SDO);
+  }
 
   if (data->enabled->enable_digital_output) {
     lcec_dout_write_all(slave, data->dout);
@@ -203,26 +203,18 @@ typedef struct {
   int enable_vl_minimum;
 } lcec_class_cia402_enabled_t;
 
+/// @brief The parts of a channel that aren't used every cycle.
+///
+/// The supported modes are read from the drive when the channel is
+/// registered, and never change after that.  SDO pins are only
+/// looked at by `lcec_cia402_write()` when the channel has any, see
+/// `write_sdos`, and usually hold still.
 typedef struct {
-#define PDO_PIN(name, pin_type) \
-  pin_type *name;               \
-  unsigned int name##_os;       \
-  unsigned int name##_bp;
-
 #define SDO_PIN(name, pin_type) \
   pin_type *name;               \
   pin_type name##_old;          \
   ec_sdo_request_t *name##_sdorequest;
 
-  // Out
-  PDO_PIN(controlword, hal_u32_t);
-  PDO_PIN(opmode, hal_s32_t);
-  PDO_PIN(profile_velocity, hal_u32_t);
-  PDO_PIN(target_position, hal_s32_t);
-  PDO_PIN(target_torque, hal_s32_t);
-  PDO_PIN(target_velocity, hal_s32_t);
-  PDO_PIN(target_vl, hal_s32_t);
-
   SDO_PIN(following_error_timeout, hal_u32_t);
   SDO_PIN(following_error_window, hal_u32_t);
   SDO_PIN(home_accel, hal_u32_t);
@@ -256,13 +248,32 @@ typedef struct {
   SDO_PIN(vl_maximum, hal_u32_t);
   SDO_PIN(vl_minimum, hal_u32_t);
 
-  // In.
-  PDO_PIN(statusword, hal_u32_t);
-  PDO_PIN(opmode_display, hal_s32_t);
   hal_s32_t *supported_modes;
   hal_bit_t *supports_mode_pp, *supports_mode_vl, *supports_mode_pv, *supports_mode_tq, *supports_mode_hm, *supports_mode_ip,
       *supports_mode_csp, *supports_mode_csv, *supports_mode_cst;
 
+  unsigned int base_idx;                         ///< The PDO/SDO offset for this channel
+  lcec_class_cia402_channel_options_t *options;  ///< The options used to create this device.
+} lcec_class_cia402_channel_cold_t;
+
+/// @brief Per-cycle state of a channel, see `LCEC_HOT` in lcec.h.
+typedef struct LCEC_HOT {
+#define PDO_PIN(name, pin_type) \
+  pin_type *name;               \
+  unsigned int name##_os;
+
+  // Out
+  PDO_PIN(controlword, hal_u32_t);
+  PDO_PIN(opmode, hal_s32_t);
+  PDO_PIN(profile_velocity, hal_u32_t);
+  PDO_PIN(target_position, hal_s32_t);
+  PDO_PIN(target_torque, hal_s32_t);
+  PDO_PIN(target_velocity, hal_s32_t);
+  PDO_PIN(target_vl, hal_s32_t);
+
+  // In.
+  PDO_PIN(statusword, hal_u32_t);
+  PDO_PIN(opmode_display, hal_s32_t);
   PDO_PIN(actual_current, hal_s32_t);
   PDO_PIN(actual_following_error, hal_u32_t);
   PDO_PIN(actual_position, hal_s32_t);
@@ -279,15 +290,16 @@ typedef struct {
   PDO_PIN(velocity_demand, hal_s32_t);
   PDO_PIN(vl_demand, hal_s32_t);
 
-  unsigned int base_idx;  ///< The PDO/SDO offset for this channel
-
   lcec_class_din_channels_t *din;
   lcec_class_dout_channels_t *dout;
 
-  lcec_class_cia402_channel_options_t *options;  ///< The options used to create this device.
   lcec_class_cia402_enabled_t *enabled;
+  int write_sdos;                          ///< Some SDO pins are enabled, so `lcec_cia402_write()` checks `cold`.
+  lcec_class_cia402_channel_cold_t *cold;  ///< Everything else.
 } lcec_class_cia402_channel_t;
 
+LCEC_HOT_ASSERT_LINES(lcec_class_cia402_channel_t, 7);
+
 typedef struct {
   int count;                               ///< The number of channels described by this structure.
   lcec_class_cia402_channel_t **channels;  ///< a dynamic array of `lcec_class_cia402_channel_t` channels.  There should be 1 per axis.
@@ -25,6 +25,9 @@
 
 #include "../lcec.h"
 
+/// @brief Channels of all devices, kept together for `lcec_din_read_all()`.
+static lcec_pool_t din_pool;
+
 static const lcec_pindesc_t slave_pins[] = {
     {HAL_BIT, HAL_OUT, offsetof(lcec_class_din_channel_t, in), "%s.%s.%s.%s"},
     {HAL_BIT, HAL_OUT, offsetof(lcec_class_din_channel_t, in_not), "%s.%s.%s.%s-not"},
@@ -38,9 +41,9 @@ static const lcec_pindesc_t slave_pins[] = {
 lcec_class_din_channels_t *lcec_din_allocate_channels(int count) {
   lcec_class_din_channels_t *channels;
 
-  channels = LCEC_HAL_ALLOCATE(lcec_class_din_channels_t);
+  channels = LCEC_POOL_ALLOCATE(&din_pool, lcec_class_din_channels_t);
   channels->count = count;
-  channels->channels = LCEC_HAL_ALLOCATE_ARRAY(lcec_class_din_channel_t *, count);
+  channels->channels = LCEC_POOL_ALLOCATE_ARRAY(&din_pool, lcec_class_din_channel_t *, count);
 
   return channels;
 }
@@ -75,8 +78,7 @@ lcec_class_din_channel_t *lcec_din_register_channel_named(lcec_slave_t *slave, u
   lcec_class_din_channel_t *data;
   int err;
 
-  data = LCEC_HAL_ALLOCATE(lcec_class_din_channel_t);
-  memset(data, 0, sizeof(lcec_class_din_channel_t));
+  data = LCEC_POOL_ALLOCATE(&din_pool, lcec_class_din_channel_t);
   data->name = name;
   data->pdo_bp_packed = 0xffff;  // Flag value, this isn't a packed channel.
 
@@ -108,8 +110,7 @@ lcec_class_din_channel_t *lcec_din_register_channel_packed(lcec_slave_t *slave,
   lcec_class_din_channel_t *data;
   int err;
 
-  data = LCEC_HAL_ALLOCATE(lcec_class_din_channel_t);
-  memset(data, 0, sizeof(lcec_class_din_channel_t));
+  data = LCEC_POOL_ALLOCATE(&din_pool, lcec_class_din_channel_t);
   data->name = name;
 
   // Register the whole PDO, hopefully this does the sane thing if we register the same PDO repeatedly.
@@ -25,6 +25,9 @@
 
 #include "../lcec.h"
 
+/// @brief Channels of all devices, kept together for `lcec_dout_write_all()`.
+static lcec_pool_t dout_pool;
+
 static const lcec_pindesc_t slave_pins[] = {
     {HAL_BIT, HAL_IN, offsetof(lcec_class_dout_channel_t, out), "%s.%s.%s.%s"},
     {HAL_TYPE_UNSPECIFIED, HAL_DIR_UNSPECIFIED, -1, NULL},
@@ -45,12 +48,12 @@ static const lcec_paramdesc_t slave_params[] = {
 lcec_class_dout_channels_t *lcec_dout_allocate_channels(int count) {
   lcec_class_dout_channels_t *channels;
 
-  channels = LCEC_HAL_ALLOCATE(lcec_class_dout_channels_t);
+  channels = LCEC_POOL_ALLOCATE(&dout_pool, lcec_class_dout_channels_t);
   if (channels == NULL) {
     return NULL;
   }
   channels->count = count;
-  channels->channels = LCEC_HAL_ALLOCATE_ARRAY(lcec_class_dout_channel_t *, count);
+  channels->channels = LCEC_POOL_ALLOCATE_ARRAY(&dout_pool, lcec_class_dout_channel_t *, count);
 
   return channels;
 }
@@ -84,7 +87,7 @@ lcec_class_dout_channel_t *lcec_dout_register_channel_named(lcec_slave_t *slave,
   lcec_class_dout_channel_t *data;
   int err;
 
-  data = LCEC_HAL_ALLOCATE(lcec_class_dout_channel_t);
+  data = LCEC_POOL_ALLOCATE(&dout_pool, lcec_class_dout_channel_t);
   data->name = name;
   data->pdo_bp_packed = 0xffff;
 
@@ -121,7 +124,7 @@ lcec_class_dout_channel_t *lcec_dout_register_channel_packed(lcec_slave_t *slave
   lcec_class_dout_channel_t *data;
   int err;
 
-  data = LCEC_HAL_ALLOCATE(lcec_class_dout_channel_t);
+  data = LCEC_POOL_ALLOCATE(&dout_pool, lcec_class_dout_channel_t);
 
   // Register the whole PDO, hopefully this does the sane thing if we register the same PDO repeatedly.
   lcec_pdo_init(slave, idx, sidx, &data->pdo_os, &data->pdo_bp);
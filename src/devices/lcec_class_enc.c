@@ -46,6 +46,14 @@ static const lcec_paramdesc_t slave_params[] = {
     {HAL_TYPE_UNSPECIFIED},
 };
 
+static const lcec_pindesc_t stats_pins[] = {
+    {HAL_U32, HAL_OUT, offsetof(lcec_class_enc_stats_t, frames), "%s.%s.%s.%s-frames"},
+    {HAL_U32, HAL_OUT, offsetof(lcec_class_enc_stats_t, errors), "%s.%s.%s.%s-frame-errors"},
+    {HAL_FLOAT, HAL_OUT, offsetof(lcec_class_enc_stats_t, error_rate), "%s.%s.%s.%s-frame-error-rate"},
+    {HAL_BIT, HAL_IN, offsetof(lcec_class_enc_stats_t, reset), "%s.%s.%s.%s-frame-stats-reset"},
+    {HAL_TYPE_UNSPECIFIED, HAL_DIR_UNSPECIFIED, -1, NULL},
+};
+
 static int32_t raw_diff(int shift, uint32_t raw_a, uint32_t raw_b);
 static void set_ref(lcec_class_enc_data_t *hal_data, long long ref);
 static long long signed_mod_64(long long val, unsigned long div);
@@ -177,3 +185,69 @@ static long long signed_mod_64(long long val, unsigned long div) {
 
   return rem;
 }
+
+/// @brief Export frame error statistics pins.
+int class_enc_stats_init(lcec_slave_t *slave, lcec_class_enc_stats_t *stats, const char *pfx) {
+  lcec_master_t *master = slave->master;
+  int err;
+
+  if ((err = lcec_pin_newf_list(stats, stats_pins, LCEC_MODULE_NAME, master->name, slave->name, pfx)) != 0) {
+    return err;
+  }
+
+  stats->window_frames = 0;
+  stats->window_errors = 0;
+  stats->window_time = 0;
+  return 0;
+}
+
+/// @brief Count one received frame.
+///
+/// `error-rate` is the fraction of frames with errors over the last
+/// full window, so a single bad frame doesn't make it jump around.
+///
+/// @param stats The statistics to update.
+/// @param error Non-zero if the encoder flagged this frame with an error.
+/// @param period The servo period, in ns.
+void class_enc_stats_update(lcec_class_enc_stats_t *stats, int error, long period) {
+  if (*(stats->reset)) {
+    *(stats->frames) = 0;
+    *(stats->errors) = 0;
+    *(stats->error_rate) = 0.0;
+    stats->window_frames = 0;
+    stats->window_errors = 0;
+    stats->window_time = 0;
+  }
+
+  (*(stats->frames))++;
+  stats->window_frames++;
+  if (error) {
+    (*(stats->errors))++;
+    stats->window_errors++;
+  }
+
+  stats->window_time += period;
+  if (stats->window_time >= LCEC_CLASS_ENC_STATS_WINDOW_NS) {
+    *(stats->error_rate) = (double)stats->window_errors / stats->window_frames;
+    stats->window_frames = 0;
+    stats->window_errors = 0;
+    stats->window_time = 0;
+  }
+}
+
+/// @brief Convert a Gray-coded position to binary.
+///
+/// @param gray The raw value from the encoder.
+/// @param bits The number of data bits; anything above is ignored.
+uint32_t class_enc_gray_decode(uint32_t gray, int bits) {
+  if (bits > 0 && bits < 32) {
+    gray &= (1U << bits) - 1;
+  }
+
+  gray ^= gray >> 16;
+  gray ^= gray >> 8;
+  gray ^= gray >> 4;
+  gray ^= gray >> 2;
+  gray ^= gray >> 1;
+  return gray;
+}
@@ -56,8 +56,25 @@ typedef struct {
 
 } lcec_class_enc_data_t;
 
+/// @brief Frame error statistics for serial encoders (SSI, EnDat, ...).
+typedef struct {
+  hal_u32_t *frames;         ///< Frames received.
+  hal_u32_t *errors;         ///< Frames flagged with an error.
+  hal_float_t *error_rate;   ///< Fraction of frames with errors over the last window.
+  hal_bit_t *reset;          ///< Clear the counters.
+
+  uint32_t window_frames;
+  uint32_t window_errors;
+  long long window_time;
+} lcec_class_enc_stats_t;
+
+#define LCEC_CLASS_ENC_STATS_WINDOW_NS 1000000000LL  ///< Length of the `error-rate` window.
+
 int class_enc_init(struct lcec_slave *slave, lcec_class_enc_data_t *hal_data, int raw_bits, const char *pfx);
 void class_enc_update(
     lcec_class_enc_data_t *hal_data, uint64_t pprev, double scale, uint32_t raw, uint32_t ext_latch_raw, int ext_latch_ena);
+int class_enc_stats_init(struct lcec_slave *slave, lcec_class_enc_stats_t *stats, const char *pfx);
+void class_enc_stats_update(lcec_class_enc_stats_t *stats, int error, long period);
+uint32_t class_enc_gray_decode(uint32_t gray, int bits);
 
 #endif
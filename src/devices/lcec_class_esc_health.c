@@ -0,0 +1,221 @@
+//
+//    Copyright (C) 2024 LinuxCNC-Ethercat contributors
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program; if not, write to the Free Software
+//    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+//
+
+/// @file
+/// @brief Background link and error counter readout from a slave's ESC registers
+///
+/// Each readout is two register reads, the DL status and then all of
+/// the error counters in one block, and each read waits for the
+/// previous one to finish.  Register requests travel in the same frame
+/// as the process data, so a readout costs two small datagrams spread
+/// over two or more cycles, once per poll period.  Slaves start at
+/// different offsets into the poll period, so readouts of neighboring
+/// slaves don't pile up in the same cycles.
+
+#include "lcec_class_esc_health.h"
+
+#define LCEC_ESC_HEALTH_SLOTS 32  ///< Number of start offsets within a poll period.
+
+enum {
+  ESC_HEALTH_IDLE,
+  ESC_HEALTH_READ_DL_STATUS,
+  ESC_HEALTH_READ_COUNTERS,
+  ESC_HEALTH_CLEAR,
+};
+
+/// @brief The writes done on `health-reset`, in order.
+///
+/// Each group of counters is cleared by writing any register in it, so
+/// the first byte of each group is enough.  The ECAT and PDI error
+/// counters only clear themselves, and are written together.
+const lcec_esc_health_clear_t lcec_esc_health_clear[LCEC_ESC_HEALTH_CLEAR_COUNT] = {
+    {LCEC_ESC_REG_RX_ERRORS, 1},
+    {LCEC_ESC_REG_ECAT_ERRORS, 2},
+    {LCEC_ESC_REG_LOST_LINKS, 1},
+};
+
+/// @brief Start the write for `lcec_esc_health_clear[step]`.
+static void lcec_esc_health_clear_start(lcec_class_esc_health_t *health, uint8_t *data, int step) {
+  const lcec_esc_health_clear_t *clear = &lcec_esc_health_clear[step];
+
+  memset(data, 0, clear->len);
+  ecrt_reg_request_write(health->req, clear->address, clear->len);
+  health->clear_step = step;
+  health->state = ESC_HEALTH_CLEAR;
+}
+
+static const lcec_pindesc_t port_pins[] = {
+    {HAL_BIT, HAL_OUT, offsetof(lcec_class_esc_health_port_t, link), "%s.%s.%s.health-port-%d-link"},
+    {HAL_U32, HAL_OUT, offsetof(lcec_class_esc_health_port_t, invalid_frames), "%s.%s.%s.health-port-%d-invalid-frames"},
+    {HAL_U32, HAL_OUT, offsetof(lcec_class_esc_health_port_t, rx_errors), "%s.%s.%s.health-port-%d-rx-errors"},
+    {HAL_U32, HAL_OUT, offsetof(lcec_class_esc_health_port_t, forwarded_errors), "%s.%s.%s.health-port-%d-forwarded-errors"},
+    {HAL_U32, HAL_OUT, offsetof(lcec_class_esc_health_port_t, lost_links), "%s.%s.%s.health-port-%d-lost-links"},
+    {HAL_TYPE_UNSPECIFIED, HAL_DIR_UNSPECIFIED, -1, NULL},
+};
+
+static const lcec_pindesc_t slave_pins[] = {
+    {HAL_U32, HAL_OUT, offsetof(lcec_class_esc_health_t, ecat_errors), "%s.%s.%s.health-ecat-errors"},
+    {HAL_U32, HAL_OUT, offsetof(lcec_class_esc_health_t, pdi_errors), "%s.%s.%s.health-pdi-errors"},
+    {HAL_BIT, HAL_OUT, offsetof(lcec_class_esc_health_t, valid), "%s.%s.%s.health-valid"},
+    {HAL_BIT, HAL_IN, offsetof(lcec_class_esc_health_t, reset), "%s.%s.%s.health-reset"},
+    {HAL_TYPE_UNSPECIFIED, HAL_DIR_UNSPECIFIED, -1, NULL},
+};
+
+/// @brief Set up the health readout for a slave, and export its pins.
+///
+/// Must be called from `_init`, since it creates a register request.
+/// Call `lcec_esc_health_run()` from the slave's read function.
+///
+/// @param slave The slave, from `_init`.
+/// @param poll_period Time between readouts, in ns.
+lcec_class_esc_health_t *lcec_esc_health_init(lcec_slave_t *slave, long long poll_period) {
+  lcec_master_t *master = slave->master;
+  lcec_class_esc_health_t *health;
+  int i;
+
+  health = LCEC_HAL_ALLOCATE(lcec_class_esc_health_t);
+  health->poll_period = poll_period;
+  health->wait = poll_period / LCEC_ESC_HEALTH_SLOTS * (slave->index % LCEC_ESC_HEALTH_SLOTS);
+
+  for (i = 0; i < LCEC_ESC_PORTS; i++) {
+    if (lcec_pin_newf_list(&health->port[i], port_pins, LCEC_MODULE_NAME, master->name, slave->name, i) != 0) {
+      return NULL;
+    }
+  }
+  if (lcec_pin_newf_list(health, slave_pins, LCEC_MODULE_NAME, master->name, slave->name) != 0) {
+    return NULL;
+  }
+
+  if (lcec_create_reg_request(slave, LCEC_ESC_REG_COUNTERS_LEN, &health->req) != 0) {
+    return NULL;
+  }
+
+  return health;
+}
+
+/// @brief Publish the result of a register read.
+///
+/// @param health The health data, from `lcec_esc_health_init()`.
+/// @param address `LCEC_ESC_REG_DL_STATUS` or `LCEC_ESC_REG_RX_ERRORS`.
+/// @param data The registers read.
+void lcec_esc_health_update(lcec_class_esc_health_t *health, uint16_t address, const uint8_t *data) {
+  uint16_t dl_status;
+  int i;
+
+  switch (address) {
+    case LCEC_ESC_REG_DL_STATUS:
+      dl_status = EC_READ_U16(data);
+      for (i = 0; i < LCEC_ESC_PORTS; i++) {
+        *(health->port[i].link) = (dl_status >> (4 + i)) & 1;
+      }
+      break;
+
+    case LCEC_ESC_REG_RX_ERRORS:
+      for (i = 0; i < LCEC_ESC_PORTS; i++) {
+        *(health->port[i].invalid_frames) = EC_READ_U8(&data[2 * i]);
+        *(health->port[i].rx_errors) = EC_READ_U8(&data[2 * i + 1]);
+        *(health->port[i].forwarded_errors) = EC_READ_U8(&data[LCEC_ESC_REG_FWD_ERRORS - LCEC_ESC_REG_RX_ERRORS + i]);
+        *(health->port[i].lost_links) = EC_READ_U8(&data[LCEC_ESC_REG_LOST_LINKS - LCEC_ESC_REG_RX_ERRORS + i]);
+      }
+      *(health->ecat_errors) = EC_READ_U8(&data[LCEC_ESC_REG_ECAT_ERRORS - LCEC_ESC_REG_RX_ERRORS]);
+      *(health->pdi_errors) = EC_READ_U8(&data[LCEC_ESC_REG_PDI_ERRORS - LCEC_ESC_REG_RX_ERRORS]);
+      *(health->valid) = 1;
+      break;
+  }
+}
+
+/// @brief Advance the health readout.
+///
+/// Call every cycle from the slave's read function.  Most cycles this
+/// only counts down the time to the next readout.  A rising edge on
+/// `health-reset` clears the ESC's counters at the next opportunity.
+void lcec_esc_health_run(lcec_slave_t *slave, lcec_class_esc_health_t *health, long period) {
+  uint8_t *data;
+
+  if (health->req == NULL) {
+    return;
+  }
+  data = ecrt_reg_request_data(health->req);
+
+  if (*(health->reset) && !health->reset_old) {
+    health->reset_pending = 1;
+  }
+  health->reset_old = *(health->reset);
+
+  // check for completion of the request in flight
+  if (health->state != ESC_HEALTH_IDLE) {
+    switch (ecrt_reg_request_state(health->req)) {
+      case EC_REQUEST_SUCCESS:
+        break;
+      case EC_REQUEST_ERROR:
+        *(health->valid) = 0;
+        health->state = ESC_HEALTH_IDLE;
+        return;
+      default:
+        return;
+    }
+  }
+
+  switch (health->state) {
+    case ESC_HEALTH_READ_DL_STATUS:
+      lcec_esc_health_update(health, LCEC_ESC_REG_DL_STATUS, data);
+      ecrt_reg_request_read(health->req, LCEC_ESC_REG_RX_ERRORS, LCEC_ESC_REG_COUNTERS_LEN);
+      health->state = ESC_HEALTH_READ_COUNTERS;
+      return;
+
+    case ESC_HEALTH_READ_COUNTERS:
+      lcec_esc_health_update(health, LCEC_ESC_REG_RX_ERRORS, data);
+      health->state = ESC_HEALTH_IDLE;
+      return;
+
+    case ESC_HEALTH_CLEAR:
+      if (health->clear_step + 1 < LCEC_ESC_HEALTH_CLEAR_COUNT) {
+        lcec_esc_health_clear_start(health, data, health->clear_step + 1);
+        return;
+      }
+      // read back right away, so the pins show the reset
+      ecrt_reg_request_read(health->req, LCEC_ESC_REG_DL_STATUS, sizeof(uint16_t));
+      health->state = ESC_HEALTH_READ_DL_STATUS;
+      return;
+
+    default:
+      break;
+  }
+
+  // idle: wait for the next readout, unless there's a reset to do
+  if (!slave->state.online) {
+    *(health->valid) = 0;
+    return;
+  }
+  if (health->reset_pending) {
+    health->reset_pending = 0;
+    lcec_esc_health_clear_start(health, data, 0);
+    return;
+  }
+  health->wait -= period;
+  if (health->wait > 0) {
+    return;
+  }
+
+  health->wait += health->poll_period;
+  if (health->wait <= 0) {
+    health->wait = health->poll_period;
+  }
+  ecrt_reg_request_read(health->req, LCEC_ESC_REG_DL_STATUS, sizeof(uint16_t));
+  health->state = ESC_HEALTH_READ_DL_STATUS;
+}
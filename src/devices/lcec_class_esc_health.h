@@ -0,0 +1,80 @@
+//
+//    Copyright (C) 2024 LinuxCNC-Ethercat contributors
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program; if not, write to the Free Software
+//    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+//
+
+/// @file
+/// @brief Background link and error counter readout from a slave's ESC registers
+///
+/// Works on any slave, including couplers and junctions without
+/// process data, since it only uses register requests.
+
+#ifndef _LCEC_CLASS_ESC_HEALTH_H_
+#define _LCEC_CLASS_ESC_HEALTH_H_
+
+#include "../lcec.h"
+
+#define LCEC_ESC_PORTS 4  ///< Ports per ESC.
+
+#define LCEC_ESC_REG_DL_STATUS    0x0110  ///< DL status, 2 bytes.  Link and loop state of each port.
+#define LCEC_ESC_REG_RX_ERRORS    0x0300  ///< Invalid frame and RX error counters, 2 bytes per port.  Writing clears 0x0300-0x030b.
+#define LCEC_ESC_REG_FWD_ERRORS   0x0308  ///< Forwarded RX error counters, 1 byte per port.
+#define LCEC_ESC_REG_ECAT_ERRORS  0x030c  ///< EtherCAT processing unit error counter.  Cleared by writing it.
+#define LCEC_ESC_REG_PDI_ERRORS   0x030d  ///< PDI error counter.  Cleared by writing it.
+#define LCEC_ESC_REG_LOST_LINKS   0x0310  ///< Lost link counters, 1 byte per port.  Writing clears all four.
+#define LCEC_ESC_REG_COUNTERS_LEN 20      ///< 0x0300-0x0313, read in one request.
+
+#define LCEC_ESC_HEALTH_CLEAR_COUNT 3  ///< Entries in `lcec_esc_health_clear`.
+
+/// @brief A register write that clears some of the counters.
+typedef struct {
+  uint16_t address;  ///< First register written.
+  size_t len;        ///< Bytes written, all zero.
+} lcec_esc_health_clear_t;
+
+extern const lcec_esc_health_clear_t lcec_esc_health_clear[LCEC_ESC_HEALTH_CLEAR_COUNT];
+
+/// @brief Health data for a single ESC port.
+typedef struct {
+  hal_bit_t *link;              ///< Physical link detected.
+  hal_u32_t *invalid_frames;    ///< Frames with an invalid checksum or length.
+  hal_u32_t *rx_errors;         ///< PHY receive errors.
+  hal_u32_t *forwarded_errors;  ///< Frames that were already marked bad by an earlier slave.
+  hal_u32_t *lost_links;        ///< Times the link went down.
+} lcec_class_esc_health_port_t;
+
+/// @brief Health data for a slave, see `lcec_esc_health_init()`.
+typedef struct {
+  lcec_class_esc_health_port_t port[LCEC_ESC_PORTS];
+  hal_u32_t *ecat_errors;  ///< EtherCAT processing unit errors.
+  hal_u32_t *pdi_errors;   ///< PDI errors.
+  hal_bit_t *valid;        ///< The last readout succeeded.
+  hal_bit_t *reset;        ///< Clear the ESC's counters on a rising edge.
+
+  ec_reg_request_t *req;
+  int state;               ///< Request in flight, see lcec_class_esc_health.c.
+  int reset_old;           ///< `reset` in the previous cycle.
+  int reset_pending;       ///< A reset is waiting for the request to be free.
+  int clear_step;          ///< Entry in `lcec_esc_health_clear` being written.
+  long long poll_period;   ///< Time between readouts, in ns.
+  long long wait;          ///< Time until the next readout, in ns.
+} lcec_class_esc_health_t;
+
+lcec_class_esc_health_t *lcec_esc_health_init(lcec_slave_t *slave, long long poll_period);
+void lcec_esc_health_update(lcec_class_esc_health_t *health, uint16_t address, const uint8_t *data);
+void lcec_esc_health_run(lcec_slave_t *slave, lcec_class_esc_health_t *health, long period);
+
+#endif
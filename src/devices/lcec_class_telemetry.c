@@ -0,0 +1,207 @@
+//
+//    Copyright (C) 2024 LinuxCNC-Ethercat contributors
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program; if not, write to the Free Software
+//    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+//
+
+/// @file
+/// @brief Library for slow-moving measurements (currents, voltages, ...)
+
+#include "lcec_class_telemetry.h"
+
+#include <stdarg.h>
+#include <string.h>
+
+#include "../lcec.h"
+
+/// @brief Values of all devices, kept together for `lcec_telemetry_read()`.
+static lcec_pool_t telemetry_pool;
+
+static double read_raw(lcec_class_telemetry_value_t *value, const uint8_t *data);
+
+/// @brief Convert a `telemetry` modParam to one of the `LCEC_TELEMETRY_*` modes.
+///
+/// @return The mode, or -1 if `mode` isn't one of "off", "pdo", or "sdo".
+int lcec_telemetry_parse_mode(const char *mode) {
+  if (!strcmp(mode, "off")) return LCEC_TELEMETRY_OFF;
+  if (!strcmp(mode, "pdo")) return LCEC_TELEMETRY_PDO;
+  if (!strcmp(mode, "sdo")) return LCEC_TELEMETRY_SDO;
+  return -1;
+}
+
+/// @brief Allocate room for `max` values, and export the `telemetry-reset` pin.
+///
+/// @param slave The slave, from `_init`.
+/// @param max The number of values that will be registered.
+/// @param mode How to read the values, `LCEC_TELEMETRY_PDO` or `LCEC_TELEMETRY_SDO`.
+/// @param poll_period Time between SDO reads of the same value, in ns.
+lcec_class_telemetry_t *lcec_telemetry_allocate(lcec_slave_t *slave, int max, int mode, long long poll_period) {
+  lcec_class_telemetry_t *telemetry;
+
+  telemetry = LCEC_POOL_ALLOCATE(&telemetry_pool, lcec_class_telemetry_t);
+  telemetry->mode = mode;
+  telemetry->poll_period = poll_period;
+  telemetry->max = max;
+  telemetry->values = LCEC_POOL_ALLOCATE_ARRAY(&telemetry_pool, lcec_class_telemetry_value_t, max);
+
+  if (lcec_pin_newf(HAL_BIT, HAL_IN, (void **)&telemetry->reset, "%s.%s.%s.telemetry-reset", LCEC_MODULE_NAME, slave->master->name,
+          slave->name) != 0) {
+    return NULL;
+  }
+
+  return telemetry;
+}
+
+/// @brief Register a value, and export its pins.
+///
+/// Creates `<name>`, `<name>-peak`, and `<name>-avg`.  In PDO mode the
+/// object has to be in the slave's PDO mapping.
+///
+/// @param slave The slave, from `_init`.
+/// @param telemetry The values, from `lcec_telemetry_allocate()`.
+/// @param idx The object index.
+/// @param sidx The object subindex.
+/// @param bits The object size, 8, 16, or 32.
+/// @param is_signed Non-zero if the object is signed.
+/// @param scale Multiplied with the raw value to produce the pin value.
+/// @param fmt A printf-style format for the pin name, after `<master>.<slave>.`.
+lcec_class_telemetry_value_t *lcec_telemetry_register_value(lcec_slave_t *slave, lcec_class_telemetry_t *telemetry, uint16_t idx,
+    uint8_t sidx, int bits, int is_signed, double scale, const char *fmt, ...) {
+  lcec_master_t *master = slave->master;
+  lcec_class_telemetry_value_t *value;
+  char name[64];
+  va_list ap;
+
+  if (telemetry->count >= telemetry->max) {
+    rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "too many telemetry values for slave %s.%s\n", master->name, slave->name);
+    return NULL;
+  }
+  value = &telemetry->values[telemetry->count];
+
+  va_start(ap, fmt);
+  rtapi_vsnprintf(name, sizeof(name), fmt, ap);
+  va_end(ap);
+
+  value->idx = idx;
+  value->sidx = sidx;
+  value->bits = bits;
+  value->is_signed = is_signed;
+  value->scale = scale;
+
+  if (lcec_pin_newf(HAL_FLOAT, HAL_OUT, (void **)&value->value, "%s.%s.%s.%s", LCEC_MODULE_NAME, master->name, slave->name, name) != 0) {
+    return NULL;
+  }
+  if (lcec_pin_newf(
+          HAL_FLOAT, HAL_OUT, (void **)&value->peak, "%s.%s.%s.%s-peak", LCEC_MODULE_NAME, master->name, slave->name, name) != 0) {
+    return NULL;
+  }
+  if (lcec_pin_newf(HAL_FLOAT, HAL_OUT, (void **)&value->avg, "%s.%s.%s.%s-avg", LCEC_MODULE_NAME, master->name, slave->name, name) != 0) {
+    return NULL;
+  }
+
+  if (telemetry->mode == LCEC_TELEMETRY_PDO) {
+    lcec_pdo_init(slave, idx, sidx, &value->pdo_os, NULL);
+  } else if (lcec_create_sdo_request(slave, idx, sidx, bits >> 3, &value->poll.req) != 0) {
+    return NULL;
+  }
+
+  telemetry->count++;
+  return value;
+}
+
+/// @brief Record a new reading.
+///
+/// The average is exponential with a time constant of
+/// `LCEC_TELEMETRY_AVG_TAU_NS`, weighted by the time since the
+/// previous reading, so PDO and SDO readings average the same way.
+/// Add the elapsed time to `value->age` before calling this.
+void lcec_telemetry_sample(lcec_class_telemetry_value_t *value, double v) {
+  double alpha;
+
+  *(value->value) = v;
+  if (!value->valid) {
+    *(value->peak) = v;
+    *(value->avg) = v;
+    value->valid = 1;
+  } else {
+    if (v > *(value->peak)) {
+      *(value->peak) = v;
+    }
+    alpha = (double)value->age / LCEC_TELEMETRY_AVG_TAU_NS;
+    if (alpha > 1.0) {
+      alpha = 1.0;
+    }
+    *(value->avg) += (v - *(value->avg)) * alpha;
+  }
+  value->age = 0;
+}
+
+/// @brief Update all values.
+///
+/// Call from the device's read function.  PDO values are read once
+/// the slave is operational.  SDO reads are polled with
+/// `lcec_sdo_poll()`, so this never waits on the mailbox.
+void lcec_telemetry_read(lcec_slave_t *slave, lcec_class_telemetry_t *telemetry, long period) {
+  uint8_t *pd = slave->master->process_data;
+  lcec_class_telemetry_value_t *value;
+  int i, started;
+
+  if (*(telemetry->reset)) {
+    for (i = 0; i < telemetry->count; i++) {
+      telemetry->values[i].valid = 0;
+    }
+  }
+
+  for (i = 0, started = 0; i < telemetry->count; i++) {
+    value = &telemetry->values[i];
+    value->age += period;
+
+    if (telemetry->mode == LCEC_TELEMETRY_PDO) {
+      if (slave->state.operational) {
+        lcec_telemetry_sample(value, read_raw(value, &pd[value->pdo_os]) * value->scale);
+      }
+      continue;
+    }
+
+    switch (lcec_sdo_poll(slave, &value->poll, telemetry->poll_period, period, &started)) {
+      case LCEC_SDO_POLL_DONE:
+        lcec_telemetry_sample(value, read_raw(value, ecrt_sdo_request_data(value->poll.req)) * value->scale);
+        break;
+      case LCEC_SDO_POLL_ERROR:
+        lcec_log_slave(slave, LCEC_LOG_TELEMETRY_ERROR, value->idx, value->sidx, 0, 0);
+        break;
+      case LCEC_SDO_POLL_DUE:
+        lcec_sdo_poll_start(&value->poll, 0, &started);
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+static double read_raw(lcec_class_telemetry_value_t *value, const uint8_t *data) {
+  switch (value->bits) {
+    case 8:
+      return value->is_signed ? EC_READ_S8(data) : EC_READ_U8(data);
+    case 16:
+      return value->is_signed ? EC_READ_S16(data) : EC_READ_U16(data);
+    default:
+      // not with ?:, which would make a signed value unsigned
+      if (value->is_signed) {
+        return EC_READ_S32(data);
+      }
+      return EC_READ_U32(data);
+  }
+}
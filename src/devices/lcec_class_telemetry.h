@@ -0,0 +1,72 @@
+//
+//    Copyright (C) 2024 LinuxCNC-Ethercat contributors
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program; if not, write to the Free Software
+//    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+//
+
+/// @file
+/// @brief Library for slow-moving measurements (currents, voltages, ...)
+///
+/// Each value is read either from a cyclic PDO that the device maps,
+/// or by polling its SDO through the master's request queue, and
+/// published with its peak and a running average.
+
+#ifndef _LCEC_CLASS_TELEMETRY_H_
+#define _LCEC_CLASS_TELEMETRY_H_
+
+#include "../lcec.h"
+
+#define LCEC_TELEMETRY_OFF 0  ///< No readout.
+#define LCEC_TELEMETRY_PDO 1  ///< Read cyclic PDOs.
+#define LCEC_TELEMETRY_SDO 2  ///< Poll SDOs.
+
+#define LCEC_TELEMETRY_POLL_NS    100000000LL   ///< Default time between SDO reads of the same value.
+#define LCEC_TELEMETRY_AVG_TAU_NS 1000000000LL  ///< Time constant of the `-avg` pins.
+
+/// @brief A single measured value.
+typedef struct {
+  hal_float_t *value;  ///< The last reading, scaled.
+  hal_float_t *peak;   ///< The highest reading since the last reset.
+  hal_float_t *avg;    ///< Exponential average of the readings.
+
+  uint16_t idx;          ///< Object index.
+  uint8_t sidx;          ///< Object subindex.
+  int bits;              ///< Object size, 8, 16, or 32.
+  int is_signed;         ///< Object is signed.
+  double scale;          ///< Multiplied with the raw value.
+  unsigned int pdo_os;   ///< Process data offset, in PDO mode.
+  lcec_sdo_poll_t poll;  ///< SDO read polling state.
+  long long age;         ///< Time since the last reading, in ns.
+  int valid;             ///< At least one reading since the last reset.
+} lcec_class_telemetry_value_t;
+
+/// @brief All measured values of a device.
+typedef struct {
+  int mode;                               ///< One of the `LCEC_TELEMETRY_*` modes.
+  long long poll_period;                  ///< Time between SDO reads of the same value, in ns.
+  int count;                              ///< Values registered so far.
+  int max;                                ///< Values allocated.
+  lcec_class_telemetry_value_t *values;   ///< The values.
+  hal_bit_t *reset;                       ///< Clear peaks and averages.
+} lcec_class_telemetry_t;
+
+int lcec_telemetry_parse_mode(const char *mode);
+lcec_class_telemetry_t *lcec_telemetry_allocate(lcec_slave_t *slave, int max, int mode, long long poll_period);
+lcec_class_telemetry_value_t *lcec_telemetry_register_value(lcec_slave_t *slave, lcec_class_telemetry_t *telemetry, uint16_t idx,
+    uint8_t sidx, int bits, int is_signed, double scale, const char *fmt, ...) __attribute__((format(printf, 8, 9)));
+void lcec_telemetry_sample(lcec_class_telemetry_value_t *value, double v);
+void lcec_telemetry_read(lcec_slave_t *slave, lcec_class_telemetry_t *telemetry, long period);
+
+#endif
@@ -296,7 +296,7 @@ static void lcec_dems300_read(lcec_slave_t *slave, long period) {
   // set fault if op mode is wrong
   if (opmode_in != 2) {
     hal_data->internal_fault = 1;
-    rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "MS300 slave %s.%s not sending velo mode\n", master->name, slave->name);
+    lcec_log_slave(slave, LCEC_LOG_DEMS300_OPMODE, opmode_in, 0, 0, 0);
   }
 
   // update fault output
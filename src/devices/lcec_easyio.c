@@ -103,7 +103,7 @@ static void lcec_easyio_write(lcec_slave_t *slave, long period) {
     return;
   }
   lcec_dout_write_all(slave, hal_data->digital_out);
-  lcec_aout_write_all(slave, hal_data->analog_out);
+  lcec_aout_write_all(slave, hal_data->analog_out, period);
 }
 
 static void lcec_easyio_read(lcec_slave_t *slave, long period) {
@@ -125,6 +125,11 @@ static int lcec_el1904_init(int comp_id, lcec_slave_t *slave) {
     }
   }
 
+  // export FSoE connection diagnostics
+  if ((err = lcec_fsoe_diag_init(slave)) != 0) {
+    return err;
+  }
+
   return 0;
 }
 
@@ -72,11 +72,11 @@ typedef struct {
   hal_u32_t *state;
   hal_u32_t *cycle_counter;
 
-  hal_bit_t *std_in_pins[LCEC_EL1918_LOGIC_DIO_MAX_COUNT];
+  hal_bit_t **std_in_pins;
   int std_in_count;
   unsigned int std_in_os;
 
-  hal_bit_t *std_out_pins[LCEC_EL1918_LOGIC_DIO_MAX_COUNT];
+  hal_bit_t **std_out_pins;
   int std_out_count;
   unsigned int std_out_os;
 
@@ -107,11 +107,25 @@ static const lcec_pindesc_t fsoe_crc_pins[] = {
     {HAL_TYPE_UNSPECIFIED, HAL_DIR_UNSPECIFIED, -1, NULL},
 };
 
-static int export_std_pins(lcec_slave_t *slave, int pid, hal_bit_t **pin, hal_pin_dir_t dir) {
+static int export_std_pins(lcec_slave_t *slave, int pid, hal_bit_t ***pins, hal_pin_dir_t dir) {
   lcec_master_t *master = slave->master;
   lcec_slave_modparam_t *p;
+  hal_bit_t **pin;
   int count, err;
 
+  // count pins
+  for (p = slave->modparams, count = 0; p != NULL && p->id >= 0; p++) {
+    if (p->id == pid) {
+      count++;
+    }
+  }
+  if (count == 0) {
+    return 0;
+  }
+
+  pin = LCEC_HAL_ALLOCATE_ARRAY(hal_bit_t *, count);
+  *pins = pin;
+
   for (p = slave->modparams, count = 0; p != NULL && p->id >= 0; p++) {
     // skip not matching params
     if (p->id != pid) {
@@ -157,6 +171,13 @@ static int lcec_el1918_logic_preinit(lcec_slave_t *slave) {
           return -EINVAL;
         }
 
+        // a disabled side never maps its FSoE PDOs, so there would be nothing to copy to or from
+        if (fsoe_slave->disabled != slave->disabled) {
+          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "%s.%s: slave index %d and this logic terminal must both be enabled or disabled\n",
+              master->name, slave->name, index);
+          return -EINVAL;
+        }
+
         break;
 
       case LCEC_EL1918_LOGIC_PARAM_STDIN_NAME:
@@ -218,7 +239,7 @@ int lcec_el1918_logic_init(int comp_id, lcec_slave_t *slave) {
   }
 
   // map and export stdios
-  hal_data->std_in_count = export_std_pins(slave, LCEC_EL1918_LOGIC_PARAM_STDIN_NAME, hal_data->std_in_pins, HAL_IN);
+  hal_data->std_in_count = export_std_pins(slave, LCEC_EL1918_LOGIC_PARAM_STDIN_NAME, &hal_data->std_in_pins, HAL_IN);
   if (hal_data->std_in_count < 0) {
     return hal_data->std_in_count;
   }
@@ -226,7 +247,7 @@ int lcec_el1918_logic_init(int comp_id, lcec_slave_t *slave) {
     lcec_pdo_init(slave, 0xf788, 0x00, &hal_data->std_in_os, NULL);
   }
 
-  hal_data->std_out_count = export_std_pins(slave, LCEC_EL1918_LOGIC_PARAM_STDOUT_NAME, hal_data->std_out_pins, HAL_OUT);
+  hal_data->std_out_count = export_std_pins(slave, LCEC_EL1918_LOGIC_PARAM_STDOUT_NAME, &hal_data->std_out_pins, HAL_OUT);
   if (hal_data->std_out_count < 0) {
     return hal_data->std_out_count;
   }
@@ -282,7 +303,6 @@ void lcec_el1918_logic_read(lcec_slave_t *slave, long period) {
   uint8_t *pd = master->process_data;
   lcec_el1918_logic_fsoe_t *fsoe_data;
   int i, crc_idx;
-  uint8_t std_out;
   lcec_el1918_logic_fsoe_crc_t *crc;
   lcec_slave_t *fsoe_slave;
   const LCEC_CONF_FSOE_T *fsoeConf;
@@ -290,12 +310,7 @@ void lcec_el1918_logic_read(lcec_slave_t *slave, long period) {
   *(hal_data->state) = EC_READ_U8(&pd[hal_data->state_os]);
   *(hal_data->cycle_counter) = EC_READ_U8(&pd[hal_data->cycle_counter_os]);
 
-  if (hal_data->std_out_count > 0) {
-    std_out = EC_READ_U8(&pd[hal_data->std_out_os]);
-    for (i = 0; i < hal_data->std_out_count; i++) {
-      *(hal_data->std_out_pins[i]) = !!(std_out & (1 << i));
-    }
-  }
+  lcec_read_bits(pd, hal_data->std_out_os, 0, hal_data->std_out_pins, hal_data->std_out_count);
 
   for (i = 0, fsoe_data = hal_data->fsoe; i < hal_data->fsoe_count; i++, fsoe_data++) {
     fsoe_slave = fsoe_data->fsoe_slave;
@@ -315,14 +330,6 @@ void lcec_el1918_logic_write(lcec_slave_t *slave, long period) {
   lcec_master_t *master = slave->master;
   lcec_el1918_logic_data_t *hal_data = (lcec_el1918_logic_data_t *)slave->hal_data;
   uint8_t *pd = master->process_data;
-  uint8_t std_in;
-  int i;
 
-  if (hal_data->std_in_count > 0) {
-    std_in = 0;
-    for (i = 0; i < hal_data->std_in_count; i++) {
-      if (*(hal_data->std_in_pins[i])) std_in |= (1 << i);
-    }
-    EC_WRITE_U8(&pd[hal_data->std_in_os], std_in);
-  }
+  lcec_write_bits(pd, hal_data->std_in_os, 0, hal_data->std_in_pins, hal_data->std_in_count);
 }
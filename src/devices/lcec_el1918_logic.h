@@ -28,5 +28,5 @@
 #define LCEC_EL1918_LOGIC_PARAM_STDIN_NAME  2
 #define LCEC_EL1918_LOGIC_PARAM_STDOUT_NAME 3
 
-#define LCEC_EL1918_LOGIC_DIO_MAX_COUNT 8
+#define LCEC_EL1918_LOGIC_DIO_MAX_COUNT 8  ///< Std io is a single byte, 0xf688:00 and 0xf788:00.
 #endif
@@ -38,7 +38,8 @@ static lcec_typelist_t types[] = {
 };
 ADD_TYPES(types);
 
-typedef struct {
+// Per-cycle state, see LCEC_HOT in lcec.h.
+typedef struct LCEC_HOT {
   hal_s32_t *count;         // pin: captured feedback in counts
   hal_float_t *pos_fb;      // pin: position feedback (position units)
   hal_bit_t *ramp_active;   // pin: ramp currently active
@@ -59,28 +60,33 @@ typedef struct {
 
   int last_operational;
   int16_t last_hw_count;  // last hw counter value
-  double old_scale;       // stored scale value
-  double scale_recip;     // reciprocal value used for scaling
+  lcec_scale_t *scale;        // watched pos_scale
+  unsigned int scale_epoch;  // slave->scale_epoch when the limits were calculated
 
   unsigned int state_pdo_os;
   unsigned int count_pdo_os;
   unsigned int ctrl_pdo_os;
   unsigned int freq_pdo_os;
 
-  uint32_t sdo_base_freq;
-  uint16_t sdo_max_freq;
-  uint16_t sdo_ramp_rise;
-  uint16_t sdo_ramp_fall;
-  uint8_t sdo_ramp_factor;
-
   double freqscale;
-  double freqscale_recip;
   double max_freq;
   double max_ac_rise;
   double max_ac_fall;
 
 } lcec_el2521_data_t;
 
+LCEC_HOT_ASSERT_LINES(lcec_el2521_data_t, 3);
+
+// Only needed by _init.
+typedef struct {
+  uint32_t base_freq;
+  uint16_t max_freq;
+  uint16_t ramp_rise;
+  uint16_t ramp_fall;
+  uint8_t ramp_factor;
+  double freqscale_recip;
+} lcec_el2521_sdo_t;
+
 static const lcec_pindesc_t slave_pins[] = {
     {HAL_S32, HAL_OUT, offsetof(lcec_el2521_data_t, count), "%s.%s.%s.stp-counts"},
     {HAL_FLOAT, HAL_OUT, offsetof(lcec_el2521_data_t, pos_fb), "%s.%s.%s.stp-pos-fb"},
@@ -130,13 +136,14 @@ static ec_sync_info_t lcec_el2521_syncs[] = {
     {0xff},
 };
 
-static void lcec_el2521_check_scale(lcec_el2521_data_t *hal_data);
+static void lcec_el2521_calc_limits(lcec_el2521_data_t *hal_data);
 static void lcec_el2521_read(lcec_slave_t *slave, long period);
 static void lcec_el2521_write(lcec_slave_t *slave, long period);
 
 static int lcec_el2521_init(int comp_id, lcec_slave_t *slave) {
   lcec_master_t *master = slave->master;
   lcec_el2521_data_t *hal_data;
+  lcec_el2521_sdo_t sdo;
   int err;
   double ramp_factor;
   uint8_t sdo_buf[4];
@@ -146,30 +153,30 @@ static int lcec_el2521_init(int comp_id, lcec_slave_t *slave) {
   slave->proc_write = lcec_el2521_write;
 
   // alloc hal memory
-  hal_data = LCEC_HAL_ALLOCATE(lcec_el2521_data_t);
+  hal_data = LCEC_HOT_ALLOCATE(lcec_el2521_data_t);
   slave->hal_data = hal_data;
 
   // read sdos
   if (lcec_read_sdo(slave, 0x8001, 0x02, sdo_buf, 4)) {
     return -EIO;
   }
-  hal_data->sdo_base_freq = EC_READ_U32(sdo_buf);
+  sdo.base_freq = EC_READ_U32(sdo_buf);
   if (lcec_read_sdo(slave, 0x8001, 0x04, sdo_buf, 2)) {
     return -EIO;
   }
-  hal_data->sdo_ramp_rise = EC_READ_U16(sdo_buf);
+  sdo.ramp_rise = EC_READ_U16(sdo_buf);
   if (lcec_read_sdo(slave, 0x8001, 0x05, sdo_buf, 2)) {
     return -EIO;
   }
-  hal_data->sdo_ramp_fall = EC_READ_U16(sdo_buf);
+  sdo.ramp_fall = EC_READ_U16(sdo_buf);
   if (lcec_read_sdo(slave, 0x8000, 0x07, sdo_buf, 1)) {
     return -EIO;
   }
-  hal_data->sdo_ramp_factor = EC_READ_U8(sdo_buf);
+  sdo.ramp_factor = EC_READ_U8(sdo_buf);
   if (lcec_read_sdo(slave, 0x8800, 0x02, sdo_buf, 2)) {
     return -EIO;
   }
-  hal_data->sdo_max_freq = EC_READ_U16(sdo_buf);
+  sdo.max_freq = EC_READ_U16(sdo_buf);
 
   // initializer sync info
   slave->sync_info = lcec_el2521_syncs;
@@ -198,46 +205,43 @@ static int lcec_el2521_init(int comp_id, lcec_slave_t *slave) {
   hal_data->last_hw_count = 0;
 
   // calculate frequency factor
-  if (hal_data->sdo_base_freq != 0) {
-    hal_data->freqscale = (double)0x7fff / (double)hal_data->sdo_base_freq;
-    hal_data->freqscale_recip = 1 / hal_data->freqscale;
+  if (sdo.base_freq != 0) {
+    hal_data->freqscale = (double)0x7fff / (double)sdo.base_freq;
+    sdo.freqscale_recip = 1 / hal_data->freqscale;
   } else {
     hal_data->freqscale = 0;
-    hal_data->freqscale_recip = 0;
+    sdo.freqscale_recip = 0;
   }
 
   // calculate max frequency
-  if (hal_data->sdo_max_freq != 0) {
-    hal_data->max_freq = (double)hal_data->sdo_max_freq * hal_data->freqscale_recip;
+  if (sdo.max_freq != 0) {
+    hal_data->max_freq = (double)sdo.max_freq * sdo.freqscale_recip;
   } else {
-    hal_data->max_freq = (double)(hal_data->sdo_base_freq);
+    hal_data->max_freq = (double)(sdo.base_freq);
   }
 
   // calculate maximum acceleartions in Hz/s
-  if ((hal_data->sdo_ramp_factor & 0x01) != 0) {
+  if ((sdo.ramp_factor & 0x01) != 0) {
     ramp_factor = 1000;
   } else {
     ramp_factor = 10;
   }
-  hal_data->max_ac_rise = ramp_factor * (double)(hal_data->sdo_ramp_rise);
-  hal_data->max_ac_fall = ramp_factor * (double)(hal_data->sdo_ramp_fall);
+  hal_data->max_ac_rise = ramp_factor * (double)(sdo.ramp_rise);
+  hal_data->max_ac_fall = ramp_factor * (double)(sdo.ramp_fall);
+
+  // watch scale and calculate scaled limits
+  hal_data->scale = lcec_scale_watch(slave, &hal_data->pos_scale);
+  hal_data->scale_epoch = slave->scale_epoch;
+  lcec_el2521_calc_limits(hal_data);
 
   return 0;
 }
 
-static void lcec_el2521_check_scale(lcec_el2521_data_t *hal_data) {
-  // check for change in scale value
-  if (hal_data->pos_scale != hal_data->old_scale) {
-    // validate the new scale value
-    if ((hal_data->pos_scale < 1e-20) && (hal_data->pos_scale > -1e-20)) {
-      // value too small, divide by zero is a bad thing
-      hal_data->pos_scale = 1.0;
-    }
-    // get ready to detect future scale changes
-    hal_data->old_scale = hal_data->pos_scale;
-    // we will need the reciprocal
-    hal_data->scale_recip = 1.0 / hal_data->pos_scale;
-  }
+static void lcec_el2521_calc_limits(lcec_el2521_data_t *hal_data) {
+  // calculate scaled limits
+  hal_data->maxvel = hal_data->max_freq * hal_data->scale->recip;
+  hal_data->maxaccel_rise = hal_data->max_ac_rise * hal_data->scale->recip;
+  hal_data->maxaccel_fall = hal_data->max_ac_fall * hal_data->scale->recip;
 }
 
 static void lcec_el2521_read(lcec_slave_t *slave, long period) {
@@ -254,13 +258,11 @@ static void lcec_el2521_read(lcec_slave_t *slave, long period) {
     return;
   }
 
-  // check for change in scale value
-  lcec_el2521_check_scale(hal_data);
-
-  // calculate scaled limits
-  hal_data->maxvel = hal_data->max_freq * hal_data->scale_recip;
-  hal_data->maxaccel_rise = hal_data->max_ac_rise * hal_data->scale_recip;
-  hal_data->maxaccel_fall = hal_data->max_ac_fall * hal_data->scale_recip;
+  // recalculate limits if the scale changed
+  if (hal_data->scale_epoch != slave->scale_epoch) {
+    hal_data->scale_epoch = slave->scale_epoch;
+    lcec_el2521_calc_limits(hal_data);
+  }
 
   // read state word
   state = EC_READ_U16(&pd[hal_data->state_pdo_os]);
@@ -284,7 +286,7 @@ static void lcec_el2521_read(lcec_slave_t *slave, long period) {
   *(hal_data->count) += hw_count_diff;
 
   // scale position
-  *(hal_data->pos_fb) = (double)(*(hal_data->count)) * hal_data->scale_recip;
+  *(hal_data->pos_fb) = (double)(*(hal_data->count)) * hal_data->scale->recip;
 
   hal_data->last_operational = 1;
 }
@@ -296,9 +298,6 @@ static void lcec_el2521_write(lcec_slave_t *slave, long period) {
   uint16_t ctrl;
   int32_t freq_raw;
 
-  // check for change in scale value
-  lcec_el2521_check_scale(hal_data);
-
   // write control word
   ctrl = 0;
   if (*(hal_data->ramp_disable)) {
@@ -35,21 +35,40 @@
 #define LCEC_EL3XXX_MODPARAM_SENSOR     0
 #define LCEC_EL3XXX_MODPARAM_RESOLUTION 8
 #define LCEC_EL3XXX_MODPARAM_WIRES      16
+#define LCEC_EL3XXX_MODPARAM_CURVE      24
 
 #define LCEC_EL3XXX_MAXCHANS 8  // for sizing arrays
 
 static int lcec_el3xxx_init(int comp_id, lcec_slave_t *slave);
 
+/// @brief Curve modparam, available on every device.  May be repeated to add more points.
+#define MP_CURVE_CH(ch)                                                              \
+  {                                                                                  \
+    "ch" #ch "Curve", LCEC_EL3XXX_MODPARAM_CURVE + ch, MODPARAM_TYPE_STRING, NULL,   \
+        "Linearization points, \"in:out, in:out, ...\".  Repeat for longer curves." \
+  }
+
 /// @brief Modparams settings available via XML.
 #define MP_TEMP_CH(ch)                                                                                \
   {"ch" #ch "Sensor", LCEC_EL3XXX_MODPARAM_SENSOR + ch, MODPARAM_TYPE_STRING, "Pt100",                \
       "Sensor type, Pt100|Ni100|Pt1000|Pt500|Pt200|Ni1000|Ni1000-TK5000|Ohm/16|Ohm/64"},              \
       {"ch" #ch "Resolution", LCEC_EL3XXX_MODPARAM_RESOLUTION + ch, MODPARAM_TYPE_STRING, "Standard", \
           "Sensor resolution, Standard or High.  High reduces the range in some cases."},             \
-  {                                                                                                   \
-    "ch" #ch "Wires", LCEC_EL3XXX_MODPARAM_WIRES + ch, MODPARAM_TYPE_STRING, "2",                     \
-        "Number of wires used for sensor connection.  2, 3, or 4"                                     \
-  }
+      {"ch" #ch "Wires", LCEC_EL3XXX_MODPARAM_WIRES + ch, MODPARAM_TYPE_STRING, "2",                  \
+          "Number of wires used for sensor connection.  2, 3, or 4"},                                 \
+      MP_CURVE_CH(ch)
+
+static const lcec_modparam_desc_t modparams_ain[] = {
+    MP_CURVE_CH(0),
+    MP_CURVE_CH(1),
+    MP_CURVE_CH(2),
+    MP_CURVE_CH(3),
+    MP_CURVE_CH(4),
+    MP_CURVE_CH(5),
+    MP_CURVE_CH(6),
+    MP_CURVE_CH(7),
+    {NULL},
+};
 
 static const lcec_modparam_desc_t modparams_temperature1[] = {
     MP_TEMP_CH(0),
@@ -149,9 +168,9 @@ static const lcec_lookuptable_int_t temp_wires[] = {
 #define PDOS(flag)    (((flag)&F_SYNC) ? (5 * INPORTS(flag)) : (4 * INPORTS(flag)))
 
 /// Macro to avoid repeating all of the unchanging fields in
-/// `lcec_typelist_t`.
+/// `lcec_typelist_t`.  These only take curve `<modParam>`s.
 #define BECKHOFF_AIN_DEVICE(name, pid, flags) \
-  { name, LCEC_BECKHOFF_VID, pid, 0, NULL, lcec_el3xxx_init, NULL, flags }
+  { name, LCEC_BECKHOFF_VID, pid, 0, NULL, lcec_el3xxx_init, modparams_ain, flags }
 
 /// Macro for defining devices that take `<modParam>`s in the XML config.
 #define BECKHOFF_AIN_DEVICE_PARAMS(name, pid, flags, modparams) \
@@ -285,6 +304,20 @@ static int lcec_el3xxx_init(int comp_id, lcec_slave_t *slave) {
           return -1;  // set_resolution logs an error message so we don't have to.
       }
     }
+
+    // <modParam name="chXCurve" value="???"/>, possibly repeated
+    if (lcec_ain_set_curve(slave, chan, i, LCEC_EL3XXX_MODPARAM_CURVE + i) != 0) {
+      return -1;  // lcec_ain_set_curve logs an error message so we don't have to.
+    }
+  }
+
+  // modparams_ain covers 8 channels, catch curves for channels this device doesn't have.
+  for (lcec_slave_modparam_t *p = slave->modparams; p != NULL && p->id >= 0; p++) {
+    if (p->id >= LCEC_EL3XXX_MODPARAM_CURVE + hal_data->count && p->id < LCEC_EL3XXX_MODPARAM_CURVE + LCEC_EL3XXX_MAXCHANS) {
+      rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "slave %s.%s has no channel %d for a curve\n", slave->master->name, slave->name,
+          p->id - LCEC_EL3XXX_MODPARAM_CURVE);
+      return -1;
+    }
   }
   rtapi_print_msg(RTAPI_MSG_DBG, LCEC_MSG_PFX "done\n");
 
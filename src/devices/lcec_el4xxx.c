@@ -104,5 +104,5 @@ static void lcec_el4xxx_write(lcec_slave_t *slave, long period) {
     return;
   }
 
-  lcec_aout_write_all(slave, hal_data);
+  lcec_aout_write_all(slave, hal_data, period);
 }
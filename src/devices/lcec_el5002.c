@@ -21,33 +21,38 @@
 
 #include "lcec_el5002.h"
 
+#include <stdio.h>
+
 #include "../lcec.h"
+#include "lcec_class_enc.h"
 
 static int lcec_el5002_init(int comp_id, lcec_slave_t *slave);
 
 static lcec_modparam_desc_t lcec_el5002_modparams[] = {
-    {"ch0DisFrameErr", LCEC_EL5002_PARAM_CH_0 || LCEC_EL5002_PARAM_DIS_FRAME_ERR, MODPARAM_TYPE_BIT},
-    {"ch0EnPwrFailChk", LCEC_EL5002_PARAM_CH_0 || LCEC_EL5002_PARAM_EN_PWR_FAIL_CHK, MODPARAM_TYPE_BIT},
-    {"ch0EnInhibitTime", LCEC_EL5002_PARAM_CH_0 || LCEC_EL5002_PARAM_EN_INHIBIT_TIME, MODPARAM_TYPE_BIT},
-    {"ch0Coding", LCEC_EL5002_PARAM_CH_0 || LCEC_EL5002_PARAM_CODING, MODPARAM_TYPE_U32},
-    {"ch0Baudrate", LCEC_EL5002_PARAM_CH_0 || LCEC_EL5002_PARAM_BAUDRATE, MODPARAM_TYPE_U32},
-    {"ch0ClkJitComp", LCEC_EL5002_PARAM_CH_0 || LCEC_EL5002_PARAM_CLK_JIT_COMP, MODPARAM_TYPE_U32},
-    {"ch0FrameType", LCEC_EL5002_PARAM_CH_0 || LCEC_EL5002_PARAM_FRAME_TYPE, MODPARAM_TYPE_U32},
-    {"ch0FrameSize", LCEC_EL5002_PARAM_CH_0 || LCEC_EL5002_PARAM_FRAME_SIZE, MODPARAM_TYPE_U32},
-    {"ch0DataLen", LCEC_EL5002_PARAM_CH_0 || LCEC_EL5002_PARAM_DATA_LEN, MODPARAM_TYPE_U32},
-    {"ch0MinInhibitTime", LCEC_EL5002_PARAM_CH_0 || LCEC_EL5002_PARAM_MIN_INHIBIT_TIME, MODPARAM_TYPE_U32},
-    {"ch0NoClkBursts", LCEC_EL5002_PARAM_CH_0 || LCEC_EL5002_PARAM_NO_CLK_BURSTS, MODPARAM_TYPE_U32},
-    {"ch1DisFrameErr", LCEC_EL5002_PARAM_CH_1 || LCEC_EL5002_PARAM_DIS_FRAME_ERR, MODPARAM_TYPE_BIT},
-    {"ch1EnPwrFailChk", LCEC_EL5002_PARAM_CH_1 || LCEC_EL5002_PARAM_EN_PWR_FAIL_CHK, MODPARAM_TYPE_BIT},
-    {"ch1EnInhibitTime", LCEC_EL5002_PARAM_CH_1 || LCEC_EL5002_PARAM_EN_INHIBIT_TIME, MODPARAM_TYPE_BIT},
-    {"ch1Coding", LCEC_EL5002_PARAM_CH_1 || LCEC_EL5002_PARAM_CODING, MODPARAM_TYPE_U32},
-    {"ch1Baudrate", LCEC_EL5002_PARAM_CH_1 || LCEC_EL5002_PARAM_BAUDRATE, MODPARAM_TYPE_U32},
-    {"ch1ClkJitComp", LCEC_EL5002_PARAM_CH_1 || LCEC_EL5002_PARAM_CLK_JIT_COMP, MODPARAM_TYPE_U32},
-    {"ch1FrameType", LCEC_EL5002_PARAM_CH_1 || LCEC_EL5002_PARAM_FRAME_TYPE, MODPARAM_TYPE_U32},
-    {"ch1FrameSize", LCEC_EL5002_PARAM_CH_1 || LCEC_EL5002_PARAM_FRAME_SIZE, MODPARAM_TYPE_U32},
-    {"ch1DataLen", LCEC_EL5002_PARAM_CH_1 || LCEC_EL5002_PARAM_DATA_LEN, MODPARAM_TYPE_U32},
-    {"ch1MinInhibitTime", LCEC_EL5002_PARAM_CH_1 || LCEC_EL5002_PARAM_MIN_INHIBIT_TIME, MODPARAM_TYPE_U32},
-    {"ch1NoClkBursts", LCEC_EL5002_PARAM_CH_1 || LCEC_EL5002_PARAM_NO_CLK_BURSTS, MODPARAM_TYPE_U32},
+    {"ch0DisFrameErr", LCEC_EL5002_PARAM_CH_0 | LCEC_EL5002_PARAM_DIS_FRAME_ERR, MODPARAM_TYPE_BIT},
+    {"ch0EnPwrFailChk", LCEC_EL5002_PARAM_CH_0 | LCEC_EL5002_PARAM_EN_PWR_FAIL_CHK, MODPARAM_TYPE_BIT},
+    {"ch0EnInhibitTime", LCEC_EL5002_PARAM_CH_0 | LCEC_EL5002_PARAM_EN_INHIBIT_TIME, MODPARAM_TYPE_BIT},
+    {"ch0Coding", LCEC_EL5002_PARAM_CH_0 | LCEC_EL5002_PARAM_CODING, MODPARAM_TYPE_U32},
+    {"ch0Baudrate", LCEC_EL5002_PARAM_CH_0 | LCEC_EL5002_PARAM_BAUDRATE, MODPARAM_TYPE_U32},
+    {"ch0ClkJitComp", LCEC_EL5002_PARAM_CH_0 | LCEC_EL5002_PARAM_CLK_JIT_COMP, MODPARAM_TYPE_U32},
+    {"ch0FrameType", LCEC_EL5002_PARAM_CH_0 | LCEC_EL5002_PARAM_FRAME_TYPE, MODPARAM_TYPE_U32},
+    {"ch0FrameSize", LCEC_EL5002_PARAM_CH_0 | LCEC_EL5002_PARAM_FRAME_SIZE, MODPARAM_TYPE_U32},
+    {"ch0DataLen", LCEC_EL5002_PARAM_CH_0 | LCEC_EL5002_PARAM_DATA_LEN, MODPARAM_TYPE_U32},
+    {"ch0MinInhibitTime", LCEC_EL5002_PARAM_CH_0 | LCEC_EL5002_PARAM_MIN_INHIBIT_TIME, MODPARAM_TYPE_U32},
+    {"ch0NoClkBursts", LCEC_EL5002_PARAM_CH_0 | LCEC_EL5002_PARAM_NO_CLK_BURSTS, MODPARAM_TYPE_U32},
+    {"ch0GrayDecode", LCEC_EL5002_PARAM_CH_0 | LCEC_EL5002_PARAM_GRAY_DECODE, MODPARAM_TYPE_BIT},
+    {"ch1DisFrameErr", LCEC_EL5002_PARAM_CH_1 | LCEC_EL5002_PARAM_DIS_FRAME_ERR, MODPARAM_TYPE_BIT},
+    {"ch1EnPwrFailChk", LCEC_EL5002_PARAM_CH_1 | LCEC_EL5002_PARAM_EN_PWR_FAIL_CHK, MODPARAM_TYPE_BIT},
+    {"ch1EnInhibitTime", LCEC_EL5002_PARAM_CH_1 | LCEC_EL5002_PARAM_EN_INHIBIT_TIME, MODPARAM_TYPE_BIT},
+    {"ch1Coding", LCEC_EL5002_PARAM_CH_1 | LCEC_EL5002_PARAM_CODING, MODPARAM_TYPE_U32},
+    {"ch1Baudrate", LCEC_EL5002_PARAM_CH_1 | LCEC_EL5002_PARAM_BAUDRATE, MODPARAM_TYPE_U32},
+    {"ch1ClkJitComp", LCEC_EL5002_PARAM_CH_1 | LCEC_EL5002_PARAM_CLK_JIT_COMP, MODPARAM_TYPE_U32},
+    {"ch1FrameType", LCEC_EL5002_PARAM_CH_1 | LCEC_EL5002_PARAM_FRAME_TYPE, MODPARAM_TYPE_U32},
+    {"ch1FrameSize", LCEC_EL5002_PARAM_CH_1 | LCEC_EL5002_PARAM_FRAME_SIZE, MODPARAM_TYPE_U32},
+    {"ch1DataLen", LCEC_EL5002_PARAM_CH_1 | LCEC_EL5002_PARAM_DATA_LEN, MODPARAM_TYPE_U32},
+    {"ch1MinInhibitTime", LCEC_EL5002_PARAM_CH_1 | LCEC_EL5002_PARAM_MIN_INHIBIT_TIME, MODPARAM_TYPE_U32},
+    {"ch1NoClkBursts", LCEC_EL5002_PARAM_CH_1 | LCEC_EL5002_PARAM_NO_CLK_BURSTS, MODPARAM_TYPE_U32},
+    {"ch1GrayDecode", LCEC_EL5002_PARAM_CH_1 | LCEC_EL5002_PARAM_GRAY_DECODE, MODPARAM_TYPE_BIT},
     {NULL},
 };
 
@@ -72,6 +77,9 @@ typedef struct {
   hal_float_t *pos;
   hal_float_t *pos_scale;
 
+  lcec_class_enc_data_t enc;
+  lcec_class_enc_stats_t stats;
+
   unsigned int err_data_os;
   unsigned int err_data_bp;
   unsigned int err_frame_os;
@@ -90,6 +98,8 @@ typedef struct {
   int32_t last_count;
   double old_scale;
   double scale;
+  int data_len;
+  int gray_decode;
 } lcec_el5002_chan_t;
 
 typedef struct {
@@ -159,6 +169,9 @@ static int lcec_el5002_init(int comp_id, lcec_slave_t *slave) {
   int i;
   lcec_el5002_chan_t *chan;
   int err;
+  int gray_decode[LCEC_EL5002_CHANS] = {0};
+  uint16_t data_len;
+  char *pfx;
 
   // set config patameters
   for (p = slave->modparams; p != NULL && p->id >= 0; p++) {
@@ -231,6 +244,9 @@ static int lcec_el5002_init(int comp_id, lcec_slave_t *slave) {
           return -1;
         }
         break;
+      case LCEC_EL5002_PARAM_GRAY_DECODE:
+        gray_decode[p->id & LCEC_EL5002_PARAM_CH_MASK] = p->value.bit;
+        break;
     }
   }
 
@@ -265,6 +281,24 @@ static int lcec_el5002_init(int comp_id, lcec_slave_t *slave) {
       return err;
     }
 
+    // the multiturn position wraps with the encoder's data length
+    if (lcec_read_sdo16(slave, 0x8000 + (i << 4), 0x12, &data_len) != 0 || data_len == 0 || data_len > 32) {
+      data_len = 32;
+    }
+    chan->data_len = data_len;
+    chan->gray_decode = gray_decode[i];
+
+    pfx = LCEC_HAL_ALLOCATE_STRING(16);
+    snprintf(pfx, 16, "enc-%d-mt", i);
+    if ((err = class_enc_init(slave, &chan->enc, chan->data_len, pfx)) != 0) {
+      return err;
+    }
+    pfx = LCEC_HAL_ALLOCATE_STRING(16);
+    snprintf(pfx, 16, "enc-%d", i);
+    if ((err = class_enc_stats_init(slave, &chan->stats, pfx)) != 0) {
+      return err;
+    }
+
     // initialize pins
     *(chan->pos_scale) = 1.0;
 
@@ -285,6 +319,7 @@ static void lcec_el5002_read(lcec_slave_t *slave, long period) {
   int i;
   lcec_el5002_chan_t *chan;
   int32_t raw_count, raw_delta;
+  int frame_err;
 
   // wait for slave to be operational
   if (!slave->state.operational) {
@@ -319,6 +354,16 @@ static void lcec_el5002_read(lcec_slave_t *slave, long period) {
 
     // read raw values
     raw_count = EC_READ_S32(&pd[chan->count_pdo_os]);
+    if (chan->gray_decode) {
+      raw_count = class_enc_gray_decode(raw_count, chan->data_len);
+    }
+
+    // keep the last good position on bad frames
+    frame_err = *(chan->err_data) || *(chan->err_frame) || *(chan->err_sync);
+    class_enc_stats_update(&chan->stats, frame_err, period);
+    if (!frame_err) {
+      class_enc_update(&chan->enc, 0, chan->scale, raw_count, 0, 0);
+    }
 
     // check for operational change of slave
     if (!hal_data->last_operational) {
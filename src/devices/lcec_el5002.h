@@ -43,5 +43,6 @@
 #define LCEC_EL5002_PARAM_DATA_LEN         0x0090
 #define LCEC_EL5002_PARAM_MIN_INHIBIT_TIME 0x00a0
 #define LCEC_EL5002_PARAM_NO_CLK_BURSTS    0x00b0
+#define LCEC_EL5002_PARAM_GRAY_DECODE      0x00c0
 
 #endif
@@ -21,12 +21,21 @@
 
 #include "lcec_el5032.h"
 
+#include <stdio.h>
+
 #include "../lcec.h"
+#include "lcec_class_enc.h"
 
 static int lcec_el5032_init(int comp_id, lcec_slave_t *slave);
 
+static lcec_modparam_desc_t lcec_el5032_modparams[] = {
+    {"ch0EncBits", LCEC_EL5032_PARAM_CH_0 | LCEC_EL5032_PARAM_ENC_BITS, MODPARAM_TYPE_U32},
+    {"ch1EncBits", LCEC_EL5032_PARAM_CH_1 | LCEC_EL5032_PARAM_ENC_BITS, MODPARAM_TYPE_U32},
+    {NULL},
+};
+
 static lcec_typelist_t types[] = {
-    {"EL5032", LCEC_BECKHOFF_VID, 0x13a83052, 0, NULL, lcec_el5032_init},
+    {"EL5032", LCEC_BECKHOFF_VID, 0x13a83052, 0, NULL, lcec_el5032_init, lcec_el5032_modparams},
     {NULL},
 };
 ADD_TYPES(types);
@@ -46,6 +55,9 @@ typedef struct {
   hal_float_t *pos;
   hal_float_t *pos_scale;
 
+  lcec_class_enc_data_t enc;
+  lcec_class_enc_stats_t stats;
+
   unsigned int warn_os;
   unsigned int warn_bp;
   unsigned int error_os;
@@ -129,10 +141,27 @@ static void lcec_el5032_read(lcec_slave_t *slave, long period);
 
 static int lcec_el5032_init(int comp_id, lcec_slave_t *slave) {
   lcec_master_t *master = slave->master;
+  lcec_slave_modparam_t *p;
   lcec_el5032_data_t *hal_data;
   int i;
   lcec_el5032_chan_t *chan;
   int err;
+  int enc_bits[LCEC_EL5032_CHANS] = {32, 32};
+  char *pfx;
+
+  // set config patameters
+  for (p = slave->modparams; p != NULL && p->id >= 0; p++) {
+    i = p->id & LCEC_EL5032_PARAM_CH_MASK;
+    switch (p->id & LCEC_EL5032_PARAM_FNK_MASK) {
+      case LCEC_EL5032_PARAM_ENC_BITS:
+        if (p->value.u32 < 1 || p->value.u32 > 32) {
+          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "slave %s.%s: ch%dEncBits must be between 1 and 32\n", master->name, slave->name, i);
+          return -1;
+        }
+        enc_bits[i] = p->value.u32;
+        break;
+    }
+  }
 
   // initialize callbacks
   slave->proc_read = lcec_el5032_read;
@@ -165,6 +194,17 @@ static int lcec_el5032_init(int comp_id, lcec_slave_t *slave) {
       return err;
     }
 
+    pfx = LCEC_HAL_ALLOCATE_STRING(16);
+    snprintf(pfx, 16, "enc-%d-mt", i);
+    if ((err = class_enc_init(slave, &chan->enc, enc_bits[i], pfx)) != 0) {
+      return err;
+    }
+    pfx = LCEC_HAL_ALLOCATE_STRING(16);
+    snprintf(pfx, 16, "enc-%d", i);
+    if ((err = class_enc_stats_init(slave, &chan->stats, pfx)) != 0) {
+      return err;
+    }
+
     // initialize pins
     *(chan->pos_scale) = 1.0;
 
@@ -222,6 +262,12 @@ static void lcec_el5032_read(lcec_slave_t *slave, long period) {
     // read raw values
     raw_count = EC_READ_S64(&pd[chan->count_pdo_os]);
 
+    // keep the last good position on bad frames
+    class_enc_stats_update(&chan->stats, *(chan->error), period);
+    if (!*(chan->error)) {
+      class_enc_update(&chan->enc, 0, chan->scale, (uint32_t)raw_count, 0, 0);
+    }
+
     // check for operational change of slave
     if (!hal_data->last_operational) {
       chan->last_count = raw_count;
@@ -26,4 +26,12 @@
 
 #define LCEC_EL5032_CHANS 2
 
+#define LCEC_EL5032_PARAM_CH_MASK  0x000f
+#define LCEC_EL5032_PARAM_FNK_MASK 0xfff0
+
+#define LCEC_EL5032_PARAM_CH_0 0x0000
+#define LCEC_EL5032_PARAM_CH_1 0x0001
+
+#define LCEC_EL5032_PARAM_ENC_BITS 0x0010
+
 #endif
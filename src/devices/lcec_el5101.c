@@ -43,7 +43,8 @@ ADD_TYPES(types);
 #define LCEC_EL5101_CTRL_EN_LATCH_EXTP (1 << 1)
 #define LCEC_EL5101_CTRL_EN_LATC       (1 << 0)
 
-typedef struct {
+// Per-cycle state, see LCEC_HOT in lcec.h.
+typedef struct LCEC_HOT {
   hal_bit_t *ena_latch_c;
   hal_bit_t *ena_latch_ext_pos;
   hal_bit_t *ena_latch_ext_neg;
@@ -78,12 +79,13 @@ typedef struct {
 
   int do_init;
   int16_t last_count;
-  double old_scale;
-  double scale;
+  lcec_scale_t *scale;
 
   int last_operational;
 } lcec_el5101_data_t;
 
+LCEC_HOT_ASSERT_LINES(lcec_el5101_data_t, 4);
+
 static const lcec_pindesc_t slave_pins[] = {
     {HAL_BIT, HAL_IO, offsetof(lcec_el5101_data_t, ena_latch_c), "%s.%s.%s.enc-index-c-enable"},
     {HAL_BIT, HAL_IO, offsetof(lcec_el5101_data_t, ena_latch_ext_pos), "%s.%s.%s.enc-index-ext-pos-enable"},
@@ -157,7 +159,7 @@ static int lcec_el5101_init(int comp_id, lcec_slave_t *slave) {
   slave->proc_write = lcec_el5101_write;
 
   // alloc hal memory
-  hal_data = LCEC_HAL_ALLOCATE(lcec_el5101_data_t);
+  hal_data = LCEC_HOT_ALLOCATE(lcec_el5101_data_t);
   slave->hal_data = hal_data;
 
   // initializer sync info
@@ -187,8 +189,7 @@ static int lcec_el5101_init(int comp_id, lcec_slave_t *slave) {
   // initialize variables
   hal_data->do_init = 1;
   hal_data->last_count = 0;
-  hal_data->old_scale = *(hal_data->pos_scale) + 1.0;
-  hal_data->scale = 1.0;
+  hal_data->scale = lcec_scale_watch(slave, hal_data->pos_scale);
 
   // This should really be 1e-2 (0.001), but this driver has had the wrong value here for years.  It produces incorrect results, but
   // presumably people are expecting that at this point?
@@ -212,19 +213,6 @@ static void lcec_el5101_read(lcec_slave_t *slave, long period) {
     return;
   }
 
-  // check for change in scale value
-  if (*(hal_data->pos_scale) != hal_data->old_scale) {
-    // scale value has changed, test and update it
-    if ((*(hal_data->pos_scale) < 1e-20) && (*(hal_data->pos_scale) > -1e-20)) {
-      // value too small, divide by zero is a bad thing
-      *(hal_data->pos_scale) = 1.0;
-    }
-    // save new scale to detect future changes
-    hal_data->old_scale = *(hal_data->pos_scale);
-    // we actually want the reciprocal
-    hal_data->scale = 1.0 / *(hal_data->pos_scale);
-  }
-
   // get bit states
   raw_status = EC_READ_U8(&pd[hal_data->status_pdo_os]);
   *(hal_data->inext) = raw_status & LCEC_EL5101_STATUS_INPUT;
@@ -287,7 +275,7 @@ static void lcec_el5101_read(lcec_slave_t *slave, long period) {
   *(hal_data->count) += raw_delta;
 
   // scale count to make floating point position
-  *(hal_data->pos) = *(hal_data->count) * hal_data->scale;
+  *(hal_data->pos) = *(hal_data->count) * hal_data->scale->recip;
 
   // scale period
   *(hal_data->frequency) = ((double)(*(hal_data->raw_frequency))) * (*hal_data->frequency_scale);
@@ -42,12 +42,14 @@ static lcec_typelist_t types[] = {
 ADD_TYPES(types);
 
 typedef struct {
-  hal_bit_t *pin;
+  int count;
+  hal_bit_t **pins;
 
   unsigned int os;
   unsigned int bp;
-
-} lcec_el6900_fsoe_io_t;
+  unsigned int last_os;
+  unsigned int last_bp;
+} lcec_el6900_std_io_t;
 
 typedef struct {
   hal_u32_t *fsoe_master_crc;
@@ -83,11 +85,8 @@ typedef struct {
   hal_bit_t *input_size_missmatch;
   hal_bit_t *output_size_missmatch;
 
-  int std_ins_count;
-  lcec_el6900_fsoe_io_t std_ins[LCEC_EL6900_DIO_MAX_COUNT];
-
-  int std_outs_count;
-  lcec_el6900_fsoe_io_t std_outs[LCEC_EL6900_DIO_MAX_COUNT];
+  lcec_el6900_std_io_t std_ins;
+  lcec_el6900_std_io_t std_outs;
 
   unsigned int control_os;
   unsigned int state_os;
@@ -125,32 +124,74 @@ static const lcec_pindesc_t fsoe_crc_pins[] = {
     {HAL_TYPE_UNSPECIFIED, HAL_DIR_UNSPECIFIED, -1, NULL},
 };
 
-static int init_std_pdos(lcec_slave_t *slave, int pid, lcec_el6900_fsoe_io_t *io, int index, hal_pin_dir_t dir) {
+static int init_std_pdos(lcec_slave_t *slave, int pid, lcec_el6900_std_io_t *io, int index, hal_pin_dir_t dir) {
   lcec_master_t *master = slave->master;
   lcec_slave_modparam_t *p;
   int count, err;
 
+  // count pins
   for (p = slave->modparams, count = 0; p != NULL && p->id >= 0; p++) {
+    if (p->id == pid) {
+      count++;
+    }
+  }
+  if (count == 0) {
+    return 0;
+  }
+
+  // the std io entries should be consecutive bits starting at subindex 1,
+  // but that's up to the TwinSAFE project.  Registering all of them
+  // wouldn't fit into LCEC_MAX_PDO_REG_COUNT, so register the first and
+  // the last, and let check_std_pdos() make sure there's nothing in between.
+  io->pins = LCEC_HAL_ALLOCATE_ARRAY(hal_bit_t *, count);
+  lcec_pdo_init(slave, index, 0x01, &io->os, &io->bp);
+  if (count > 1) {
+    lcec_pdo_init(slave, index, count, &io->last_os, &io->last_bp);
+  }
+
+  for (p = slave->modparams; p != NULL && p->id >= 0; p++) {
     // skip not matching params
     if (p->id != pid) {
       continue;
     }
 
-    // initialize POD entry
-    lcec_pdo_init(slave, index, 0x01 + count, &io->os, &io->bp);
-
     // export pin
-    if ((err = lcec_pin_newf(HAL_BIT, dir, (void **)&io->pin, "%s.%s.%s.%s", LCEC_MODULE_NAME, master->name, slave->name, p->value.str)) !=
-        0) {
+    if ((err = lcec_pin_newf(HAL_BIT, dir, (void **)&io->pins[io->count], "%s.%s.%s.%s", LCEC_MODULE_NAME, master->name, slave->name,
+             p->value.str)) != 0) {
       return err;
     }
+    io->count++;
+  }
+
+  return 0;
+}
 
-    // next item
-    io++;
-    count++;
+static int check_std_pdos(lcec_slave_t *slave, lcec_el6900_std_io_t *io, int index) {
+  unsigned int first, last;
+
+  if (io->count < 2) {
+    return 0;
   }
 
-  return count;
+  first = io->os * 8 + io->bp;
+  last = io->last_os * 8 + io->last_bp;
+  if (last - first != (unsigned int)(io->count - 1)) {
+    rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "%s.%s: 0x%04x:01 to 0x%04x:%02x are not mapped as consecutive bits\n", slave->master->name,
+        slave->name, index, index, io->count);
+    return -EINVAL;
+  }
+
+  return 0;
+}
+
+static int lcec_el6900_pdo_check(lcec_slave_t *slave) {
+  lcec_el6900_data_t *hal_data = (lcec_el6900_data_t *)slave->hal_data;
+  int err;
+
+  if ((err = check_std_pdos(slave, &hal_data->std_ins, 0xf201)) != 0) {
+    return err;
+  }
+  return check_std_pdos(slave, &hal_data->std_outs, 0xf101);
 }
 
 static int lcec_el6900_preinit(lcec_slave_t *slave) {
@@ -179,6 +220,13 @@ static int lcec_el6900_preinit(lcec_slave_t *slave) {
           return -EINVAL;
         }
 
+        // a disabled side never maps its FSoE PDOs, so there would be nothing to copy to or from
+        if (fsoe_slave->disabled != slave->disabled) {
+          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "%s.%s: slave index %d and this logic terminal must both be enabled or disabled\n",
+              master->name, slave->name, index);
+          return -EINVAL;
+        }
+
         break;
 
       case LCEC_EL6900_PARAM_STDIN_NAME:
@@ -217,6 +265,7 @@ static int lcec_el6900_init(int comp_id, lcec_slave_t *slave) {
   // initialize callbacks
   slave->proc_read = lcec_el6900_read;
   slave->proc_write = lcec_el6900_write;
+  slave->proc_pdo_check = lcec_el6900_pdo_check;
 
   // count fsoe slaves
   for (fsoe_idx = 0, p = slave->modparams; p != NULL && p->id >= 0; p++) {
@@ -243,13 +292,11 @@ static int lcec_el6900_init(int comp_id, lcec_slave_t *slave) {
   }
 
   // map and export stdios
-  hal_data->std_ins_count = init_std_pdos(slave, LCEC_EL6900_PARAM_STDIN_NAME, hal_data->std_ins, 0xf201, HAL_IN);
-  if (hal_data->std_ins_count < 0) {
-    return hal_data->std_ins_count;
+  if ((err = init_std_pdos(slave, LCEC_EL6900_PARAM_STDIN_NAME, &hal_data->std_ins, 0xf201, HAL_IN)) != 0) {
+    return err;
   }
-  hal_data->std_outs_count = init_std_pdos(slave, LCEC_EL6900_PARAM_STDOUT_NAME, hal_data->std_outs, 0xf101, HAL_OUT);
-  if (hal_data->std_outs_count < 0) {
-    return hal_data->std_outs_count;
+  if ((err = init_std_pdos(slave, LCEC_EL6900_PARAM_STDOUT_NAME, &hal_data->std_outs, 0xf101, HAL_OUT)) != 0) {
+    return err;
   }
 
   // map and export fsoe slave data
@@ -300,7 +347,6 @@ void lcec_el6900_read(lcec_slave_t *slave, long period) {
   uint8_t *pd = master->process_data;
   lcec_el6900_fsoe_t *fsoe_data;
   int i, crc_idx;
-  lcec_el6900_fsoe_io_t *io;
   lcec_el6900_fsoe_crc_t *crc;
   lcec_slave_t *fsoe_slave;
   const LCEC_CONF_FSOE_T *fsoeConf;
@@ -310,9 +356,7 @@ void lcec_el6900_read(lcec_slave_t *slave, long period) {
   *(hal_data->input_size_missmatch) = EC_READ_BIT(&pd[hal_data->input_size_missmatch_os], hal_data->input_size_missmatch_bp);
   *(hal_data->output_size_missmatch) = EC_READ_BIT(&pd[hal_data->output_size_missmatch_os], hal_data->output_size_missmatch_bp);
 
-  for (i = 0, io = hal_data->std_outs; i < hal_data->std_outs_count; i++, io++) {
-    *(io->pin) = EC_READ_BIT(&pd[io->os], io->bp);
-  }
+  lcec_read_bits(pd, hal_data->std_outs.os, hal_data->std_outs.bp, hal_data->std_outs.pins, hal_data->std_outs.count);
 
   for (i = 0, fsoe_data = hal_data->fsoe; i < hal_data->fsoe_count; i++, fsoe_data++) {
     fsoe_slave = fsoe_data->fsoe_slave;
@@ -332,12 +376,8 @@ void lcec_el6900_write(lcec_slave_t *slave, long period) {
   lcec_master_t *master = slave->master;
   lcec_el6900_data_t *hal_data = (lcec_el6900_data_t *)slave->hal_data;
   uint8_t *pd = master->process_data;
-  lcec_el6900_fsoe_io_t *io;
-  int i;
 
   EC_WRITE_U16(&pd[hal_data->control_os], *(hal_data->control));
 
-  for (i = 0, io = hal_data->std_ins; i < hal_data->std_ins_count; i++, io++) {
-    EC_WRITE_BIT(&pd[io->os], io->bp, *(io->pin));
-  }
+  lcec_write_bits(pd, hal_data->std_ins.os, hal_data->std_ins.bp, hal_data->std_ins.pins, hal_data->std_ins.count);
 }
@@ -28,5 +28,5 @@
 #define LCEC_EL6900_PARAM_STDIN_NAME  2
 #define LCEC_EL6900_PARAM_STDOUT_NAME 3
 
-#define LCEC_EL6900_DIO_MAX_COUNT 32
+#define LCEC_EL6900_DIO_MAX_COUNT 255  ///< Std io entries are subindexes 0x01-0xff of 0xf101 and 0xf201.
 #endif
@@ -369,15 +369,13 @@ static int handle_modparams(lcec_slave_t *slave) {
     switch (p->id) {
       case MODPARAM_MAX_CURRENT:
         current = p->value.flt * 1000.0;
-        if (lcec_write_sdo16(slave, 0x8010, 0x01, current) != 0) {
-          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "fail to configure slave %s.%s sdo maxCurrent\n", master->name, slave->name);
+        if (lcec_write_sdo16_modparam(slave, 0x8010, 0x01, current, p->name) != 0) {
           return -1;
         }
         break;
       case MODPARAM_REDUCED_CURRENT:  // Not allowed on my EL7041-1000 r21, but appears in the paramaterization doc.
         current = p->value.flt * 1000.0;
-        if (lcec_write_sdo16(slave, 0x8010, 0x02, current) != 0) {
-          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "fail to configure slave %s.%s sdo redCurrent\n", master->name, slave->name);
+        if (lcec_write_sdo16_modparam(slave, 0x8010, 0x02, current, p->name) != 0) {
           return -1;
         }
         break;
@@ -23,8 +23,7 @@
 
 #include "../lcec.h"
 
-static int lcec_el70x1_init(int comp_id, lcec_slave_t *slave);
-static int lcec_el7031_init(int comp_id, lcec_slave_t *slave);
+static int lcec_el70x1_init(int comp_id, lcec_slave_t *slave, ec_sync_info_t *syncs, ec_sync_info_t *positioning_syncs);
 static int lcec_el7041_0052_init(int comp_id, lcec_slave_t *slave);
 static void lcec_el70x1_read(lcec_slave_t *slave, long period);
 static void lcec_el70x1_write(lcec_slave_t *slave, long period);
@@ -35,6 +34,7 @@ static lcec_modparam_desc_t lcec_el70x1_modparams[] = {
     {"nomVoltage", LCEC_EL70x1_PARAM_NOM_VOLT, MODPARAM_TYPE_U32},
     {"coilRes", LCEC_EL70x1_PARAM_COIL_RES, MODPARAM_TYPE_U32},
     {"motorEMF", LCEC_EL70x1_PARAM_MOTOR_EMF, MODPARAM_TYPE_U32},
+    {"positioningInterface", LCEC_EL70x1_PARAM_POSITIONING, MODPARAM_TYPE_BIT},
     {NULL},
 };
 
@@ -72,6 +72,29 @@ typedef struct {
 
   hal_s32_t stm_pos_cmd_raw_last;
 
+  // positioning interface
+  int positioning;
+
+  hal_float_t *pos_target;
+  hal_s32_t *pos_target_raw;
+  hal_s32_t *pos_velocity;
+  hal_u32_t *pos_accel;
+  hal_u32_t *pos_decel;
+  hal_u32_t *pos_start_type;
+  hal_bit_t *pos_execute;
+  hal_bit_t *pos_emergency_stop;
+  hal_bit_t *pos_busy;
+  hal_bit_t *pos_in_target;
+  hal_bit_t *pos_warning;
+  hal_bit_t *pos_error;
+  hal_bit_t *pos_calibrated;
+  hal_bit_t *pos_accelerating;
+  hal_bit_t *pos_decelerating;
+  hal_float_t *pos_actual;
+  hal_s32_t *pos_actual_raw;
+  hal_s32_t *pos_actual_velocity;
+  hal_u32_t *pos_drive_time;
+
   unsigned int stm_ready_to_enable_pdo_os;
   unsigned int stm_ready_to_enable_pdo_bp;
   unsigned int stm_ready_pdo_os;
@@ -102,6 +125,33 @@ typedef struct {
   unsigned int stm_reduce_torque_pdo_bp;
   unsigned int stm_pos_raw_pdo_os;
 
+  unsigned int pos_execute_pdo_os;
+  unsigned int pos_execute_pdo_bp;
+  unsigned int pos_emergency_stop_pdo_os;
+  unsigned int pos_emergency_stop_pdo_bp;
+  unsigned int pos_target_pdo_os;
+  unsigned int pos_velocity_pdo_os;
+  unsigned int pos_start_type_pdo_os;
+  unsigned int pos_accel_pdo_os;
+  unsigned int pos_decel_pdo_os;
+  unsigned int pos_busy_pdo_os;
+  unsigned int pos_busy_pdo_bp;
+  unsigned int pos_in_target_pdo_os;
+  unsigned int pos_in_target_pdo_bp;
+  unsigned int pos_warning_pdo_os;
+  unsigned int pos_warning_pdo_bp;
+  unsigned int pos_error_pdo_os;
+  unsigned int pos_error_pdo_bp;
+  unsigned int pos_calibrated_pdo_os;
+  unsigned int pos_calibrated_pdo_bp;
+  unsigned int pos_accelerating_pdo_os;
+  unsigned int pos_accelerating_pdo_bp;
+  unsigned int pos_decelerating_pdo_os;
+  unsigned int pos_decelerating_pdo_bp;
+  unsigned int pos_actual_pdo_os;
+  unsigned int pos_actual_velocity_pdo_os;
+  unsigned int pos_drive_time_pdo_os;
+
 } lcec_el70x1_data_t;
 
 static ec_pdo_entry_info_t lcec_el70x1_enc_ctl[] = {
@@ -178,6 +228,54 @@ static ec_sync_info_t lcec_el70x1_syncs[] = {
     {0xff},
 };
 
+static ec_pdo_entry_info_t lcec_el70x1_pos_ctl[] = {
+    {0x7020, 0x01, 1},  /* Execute */
+    {0x7020, 0x02, 1},  /* Emergency stop */
+    {0x0000, 0x00, 6},  /* Gap */
+    {0x0000, 0x00, 8},  /* Gap */
+    {0x7020, 0x11, 32}, /* Target position */
+    {0x7020, 0x21, 16}, /* Velocity */
+    {0x7020, 0x22, 16}, /* Start type */
+    {0x7020, 0x23, 16}, /* Acceleration */
+    {0x7020, 0x24, 16}, /* Deceleration */
+};
+
+static ec_pdo_entry_info_t lcec_el70x1_pos_stat[] = {
+    {0x6020, 0x01, 1},  /* Busy */
+    {0x6020, 0x02, 1},  /* In-Target */
+    {0x6020, 0x03, 1},  /* Warning */
+    {0x6020, 0x04, 1},  /* Error */
+    {0x6020, 0x05, 1},  /* Calibrated */
+    {0x6020, 0x06, 1},  /* Accelerate */
+    {0x6020, 0x07, 1},  /* Decelerate */
+    {0x0000, 0x00, 1},  /* Gap */
+    {0x0000, 0x00, 8},  /* Gap */
+    {0x6020, 0x11, 32}, /* Actual position */
+    {0x6020, 0x21, 16}, /* Actual velocity */
+    {0x6020, 0x22, 32}, /* Actual drive time */
+};
+
+// The positioning interface replaces the STM position output.
+static ec_pdo_info_t lcec_el70x1_pos_pdos_out[] = {
+    {0x1601, 7, lcec_el70x1_enc_ctl}, /* ENC RxPDO-Map Control compact */
+    {0x1602, 5, lcec_el70x1_stm_ctl}, /* STM RxPDO-Map Control */
+    {0x1607, 9, lcec_el70x1_pos_ctl}, /* POS RxPDO-Map Control */
+};
+
+static ec_pdo_info_t lcec_el70x1_pos_pdos_in[] = {
+    {0x1a01, 13, lcec_el70x1_enc_stat}, /* ENC TxPDO-Map Status compact */
+    {0x1a03, 14, lcec_el70x1_stm_stat}, /* STM TxPDO-Map Status */
+    {0x1a07, 12, lcec_el70x1_pos_stat}, /* POS TxPDO-Map Status */
+};
+
+static ec_sync_info_t lcec_el70x1_pos_syncs[] = {
+    {0, EC_DIR_OUTPUT, 0, NULL},
+    {1, EC_DIR_INPUT, 0, NULL},
+    {2, EC_DIR_OUTPUT, 3, lcec_el70x1_pos_pdos_out},
+    {3, EC_DIR_INPUT, 3, lcec_el70x1_pos_pdos_in},
+    {0xff},
+};
+
 static ec_pdo_entry_info_t lcec_el7041_0052_stm_ctl[] = {
     {0x7010, 0x01, 1}, /* Enable */
     {0x7010, 0x02, 1}, /* Reset */
@@ -224,6 +322,24 @@ static ec_sync_info_t lcec_el7041_0052_syncs[] = {
     {0xff},
 };
 
+static ec_pdo_info_t lcec_el7041_0052_pos_pdos_out[] = {
+    {0x1602, 5, lcec_el7041_0052_stm_ctl}, /* STM RxPDO-Map Control */
+    {0x1607, 9, lcec_el70x1_pos_ctl},      /* POS RxPDO-Map Control */
+};
+
+static ec_pdo_info_t lcec_el7041_0052_pos_pdos_in[] = {
+    {0x1a03, 14, lcec_el7041_0052_stm_stat}, /* STM TxPDO-Map Status */
+    {0x1a07, 12, lcec_el70x1_pos_stat},      /* POS TxPDO-Map Status */
+};
+
+static ec_sync_info_t lcec_el7041_0052_pos_syncs[] = {
+    {0, EC_DIR_OUTPUT, 0, NULL},
+    {1, EC_DIR_INPUT, 0, NULL},
+    {2, EC_DIR_OUTPUT, 2, lcec_el7041_0052_pos_pdos_out},
+    {3, EC_DIR_INPUT, 2, lcec_el7041_0052_pos_pdos_in},
+    {0xff},
+};
+
 static const lcec_pindesc_t slave_pins[] = {
     // servo pins
     {HAL_BIT, HAL_OUT, offsetof(lcec_el70x1_data_t, stm_ready_to_enable), "%s.%s.%s.srv-ready-to-enable"},
@@ -240,9 +356,36 @@ static const lcec_pindesc_t slave_pins[] = {
     {HAL_BIT, HAL_IN, offsetof(lcec_el70x1_data_t, stm_enable), "%s.%s.%s.srv-enable"},
     {HAL_BIT, HAL_IN, offsetof(lcec_el70x1_data_t, stm_reset), "%s.%s.%s.srv-reset"},
     {HAL_BIT, HAL_IN, offsetof(lcec_el70x1_data_t, stm_reduce_torque), "%s.%s.%s.srv-reduce-torque"},
+
+    {HAL_TYPE_UNSPECIFIED, HAL_DIR_UNSPECIFIED, -1, NULL},
+};
+
+static const lcec_pindesc_t slave_pins_position[] = {
     {HAL_FLOAT, HAL_IN, offsetof(lcec_el70x1_data_t, stm_pos_cmd), "%s.%s.%s.srv-pos-cmd"},
     {HAL_S32, HAL_OUT, offsetof(lcec_el70x1_data_t, stm_pos_cmd_raw), "%s.%s.%s.srv-pos-cmd-raw"},
+    {HAL_TYPE_UNSPECIFIED, HAL_DIR_UNSPECIFIED, -1, NULL},
+};
 
+static const lcec_pindesc_t slave_pins_positioning[] = {
+    {HAL_FLOAT, HAL_IN, offsetof(lcec_el70x1_data_t, pos_target), "%s.%s.%s.pos-target"},
+    {HAL_S32, HAL_OUT, offsetof(lcec_el70x1_data_t, pos_target_raw), "%s.%s.%s.pos-target-raw"},
+    {HAL_S32, HAL_IN, offsetof(lcec_el70x1_data_t, pos_velocity), "%s.%s.%s.pos-velocity"},
+    {HAL_U32, HAL_IN, offsetof(lcec_el70x1_data_t, pos_accel), "%s.%s.%s.pos-accel"},
+    {HAL_U32, HAL_IN, offsetof(lcec_el70x1_data_t, pos_decel), "%s.%s.%s.pos-decel"},
+    {HAL_U32, HAL_IN, offsetof(lcec_el70x1_data_t, pos_start_type), "%s.%s.%s.pos-start-type"},
+    {HAL_BIT, HAL_IN, offsetof(lcec_el70x1_data_t, pos_execute), "%s.%s.%s.pos-execute"},
+    {HAL_BIT, HAL_IN, offsetof(lcec_el70x1_data_t, pos_emergency_stop), "%s.%s.%s.pos-emergency-stop"},
+    {HAL_BIT, HAL_OUT, offsetof(lcec_el70x1_data_t, pos_busy), "%s.%s.%s.pos-busy"},
+    {HAL_BIT, HAL_OUT, offsetof(lcec_el70x1_data_t, pos_in_target), "%s.%s.%s.pos-in-target"},
+    {HAL_BIT, HAL_OUT, offsetof(lcec_el70x1_data_t, pos_warning), "%s.%s.%s.pos-warning"},
+    {HAL_BIT, HAL_OUT, offsetof(lcec_el70x1_data_t, pos_error), "%s.%s.%s.pos-error"},
+    {HAL_BIT, HAL_OUT, offsetof(lcec_el70x1_data_t, pos_calibrated), "%s.%s.%s.pos-calibrated"},
+    {HAL_BIT, HAL_OUT, offsetof(lcec_el70x1_data_t, pos_accelerating), "%s.%s.%s.pos-accelerating"},
+    {HAL_BIT, HAL_OUT, offsetof(lcec_el70x1_data_t, pos_decelerating), "%s.%s.%s.pos-decelerating"},
+    {HAL_FLOAT, HAL_OUT, offsetof(lcec_el70x1_data_t, pos_actual), "%s.%s.%s.pos-actual"},
+    {HAL_S32, HAL_OUT, offsetof(lcec_el70x1_data_t, pos_actual_raw), "%s.%s.%s.pos-actual-raw"},
+    {HAL_S32, HAL_OUT, offsetof(lcec_el70x1_data_t, pos_actual_velocity), "%s.%s.%s.pos-actual-velocity"},
+    {HAL_U32, HAL_OUT, offsetof(lcec_el70x1_data_t, pos_drive_time), "%s.%s.%s.pos-drive-time"},
     {HAL_TYPE_UNSPECIFIED, HAL_DIR_UNSPECIFIED, -1, NULL},
 };
 
@@ -253,32 +396,37 @@ static const lcec_paramdesc_t slave_params[] = {
     {HAL_TYPE_UNSPECIFIED},
 };
 
-static int lcec_el7031_init(int comp_id, lcec_slave_t *slave) {
-  // initialize sync info
-  slave->sync_info = lcec_el70x1_syncs;
-
-  return lcec_el70x1_init(comp_id, slave);
+int lcec_el7031_init(int comp_id, lcec_slave_t *slave) {
+  return lcec_el70x1_init(comp_id, slave, lcec_el70x1_syncs, lcec_el70x1_pos_syncs);
 }
 
 static int lcec_el7041_0052_init(int comp_id, lcec_slave_t *slave) {
-  // initialize sync info
-  slave->sync_info = lcec_el7041_0052_syncs;
-
-  return lcec_el70x1_init(comp_id, slave);
+  return lcec_el70x1_init(comp_id, slave, lcec_el7041_0052_syncs, lcec_el7041_0052_pos_syncs);
 }
 
-static int lcec_el70x1_init(int comp_id, lcec_slave_t *slave) {
+static int lcec_el70x1_init(int comp_id, lcec_slave_t *slave, ec_sync_info_t *syncs, ec_sync_info_t *positioning_syncs) {
   lcec_master_t *master = slave->master;
   lcec_slave_modparam_t *p;
   lcec_el70x1_data_t *hal_data;
+  int positioning = 0;
   int err;
 
   // initialize callbacks
   slave->proc_read = lcec_el70x1_read;
   slave->proc_write = lcec_el70x1_write;
 
-  // set to position mode
-  if (lcec_write_sdo8(slave, 0x8012, 0x01, 3) != 0) {
+  for (p = slave->modparams; p != NULL && p->id >= 0; p++) {
+    if (p->id == LCEC_EL70x1_PARAM_POSITIONING) {
+      positioning = p->value.bit;
+    }
+  }
+
+  // initialize sync info
+  slave->sync_info = positioning ? positioning_syncs : syncs;
+
+  // set to position mode, or let the terminal pick the positioning
+  // interface from the PDO assignment
+  if (lcec_write_sdo8(slave, 0x8012, 0x01, positioning ? 0 : 3) != 0) {
     rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "fail to configure slave %s.%s sdo position mode\n", master->name, slave->name);
     return -1;
   }
@@ -322,6 +470,7 @@ static int lcec_el70x1_init(int comp_id, lcec_slave_t *slave) {
   // alloc hal memory
   hal_data = LCEC_HAL_ALLOCATE(lcec_el70x1_data_t);
   slave->hal_data = hal_data;
+  hal_data->positioning = positioning;
 
   // initialize POD entries
   lcec_pdo_init(slave, 0x6010, 0x01, &hal_data->stm_ready_to_enable_pdo_os, &hal_data->stm_ready_to_enable_pdo_bp);
@@ -340,12 +489,37 @@ static int lcec_el70x1_init(int comp_id, lcec_slave_t *slave) {
   lcec_pdo_init(slave, 0x7010, 0x02, &hal_data->stm_reset_pdo_os, &hal_data->stm_reset_pdo_bp);
   lcec_pdo_init(slave, 0x7010, 0x03, &hal_data->stm_reduce_torque_pdo_os, &hal_data->stm_reduce_torque_pdo_bp);
 
-  lcec_pdo_init(slave, 0x7010, 0x11, &hal_data->stm_pos_raw_pdo_os, NULL);
+  if (positioning) {
+    lcec_pdo_init(slave, 0x7020, 0x01, &hal_data->pos_execute_pdo_os, &hal_data->pos_execute_pdo_bp);
+    lcec_pdo_init(slave, 0x7020, 0x02, &hal_data->pos_emergency_stop_pdo_os, &hal_data->pos_emergency_stop_pdo_bp);
+    lcec_pdo_init(slave, 0x7020, 0x11, &hal_data->pos_target_pdo_os, NULL);
+    lcec_pdo_init(slave, 0x7020, 0x21, &hal_data->pos_velocity_pdo_os, NULL);
+    lcec_pdo_init(slave, 0x7020, 0x22, &hal_data->pos_start_type_pdo_os, NULL);
+    lcec_pdo_init(slave, 0x7020, 0x23, &hal_data->pos_accel_pdo_os, NULL);
+    lcec_pdo_init(slave, 0x7020, 0x24, &hal_data->pos_decel_pdo_os, NULL);
+
+    lcec_pdo_init(slave, 0x6020, 0x01, &hal_data->pos_busy_pdo_os, &hal_data->pos_busy_pdo_bp);
+    lcec_pdo_init(slave, 0x6020, 0x02, &hal_data->pos_in_target_pdo_os, &hal_data->pos_in_target_pdo_bp);
+    lcec_pdo_init(slave, 0x6020, 0x03, &hal_data->pos_warning_pdo_os, &hal_data->pos_warning_pdo_bp);
+    lcec_pdo_init(slave, 0x6020, 0x04, &hal_data->pos_error_pdo_os, &hal_data->pos_error_pdo_bp);
+    lcec_pdo_init(slave, 0x6020, 0x05, &hal_data->pos_calibrated_pdo_os, &hal_data->pos_calibrated_pdo_bp);
+    lcec_pdo_init(slave, 0x6020, 0x06, &hal_data->pos_accelerating_pdo_os, &hal_data->pos_accelerating_pdo_bp);
+    lcec_pdo_init(slave, 0x6020, 0x07, &hal_data->pos_decelerating_pdo_os, &hal_data->pos_decelerating_pdo_bp);
+    lcec_pdo_init(slave, 0x6020, 0x11, &hal_data->pos_actual_pdo_os, NULL);
+    lcec_pdo_init(slave, 0x6020, 0x21, &hal_data->pos_actual_velocity_pdo_os, NULL);
+    lcec_pdo_init(slave, 0x6020, 0x22, &hal_data->pos_drive_time_pdo_os, NULL);
+  } else {
+    lcec_pdo_init(slave, 0x7010, 0x11, &hal_data->stm_pos_raw_pdo_os, NULL);
+  }
 
   // export pins
   if ((err = lcec_pin_newf_list(hal_data, slave_pins, LCEC_MODULE_NAME, master->name, slave->name)) != 0) {
     return err;
   }
+  if ((err = lcec_pin_newf_list(hal_data, positioning ? slave_pins_positioning : slave_pins_position, LCEC_MODULE_NAME, master->name,
+           slave->name)) != 0) {
+    return err;
+  }
 
   // export pins
   if ((err = lcec_param_newf_list(hal_data, slave_params, LCEC_MODULE_NAME, master->name, slave->name)) != 0) {
@@ -358,6 +532,9 @@ static int lcec_el70x1_init(int comp_id, lcec_slave_t *slave) {
   hal_data->auto_reduce_tourque_delay = 0.0;
   hal_data->auto_reduce_tourque_timer = 0;
   hal_data->stm_pos_cmd_raw_last = 0;
+  if (positioning) {
+    *(hal_data->pos_start_type) = 1;  // absolute
+  }
 
   return 0;
 }
@@ -378,6 +555,45 @@ static void lcec_el70x1_read(lcec_slave_t *slave, long period) {
   *(hal_data->stm_din2) = EC_READ_BIT(&pd[hal_data->stm_din2_pdo_os], hal_data->stm_din2_pdo_bp);
   *(hal_data->stm_sync_err) = EC_READ_BIT(&pd[hal_data->stm_sync_err_pdo_os], hal_data->stm_sync_err_pdo_bp);
   *(hal_data->stm_tx_toggle) = EC_READ_BIT(&pd[hal_data->stm_tx_toggle_pdo_os], hal_data->stm_tx_toggle_pdo_bp);
+
+  if (hal_data->positioning) {
+    *(hal_data->pos_busy) = EC_READ_BIT(&pd[hal_data->pos_busy_pdo_os], hal_data->pos_busy_pdo_bp);
+    *(hal_data->pos_in_target) = EC_READ_BIT(&pd[hal_data->pos_in_target_pdo_os], hal_data->pos_in_target_pdo_bp);
+    *(hal_data->pos_warning) = EC_READ_BIT(&pd[hal_data->pos_warning_pdo_os], hal_data->pos_warning_pdo_bp);
+    *(hal_data->pos_error) = EC_READ_BIT(&pd[hal_data->pos_error_pdo_os], hal_data->pos_error_pdo_bp);
+    *(hal_data->pos_calibrated) = EC_READ_BIT(&pd[hal_data->pos_calibrated_pdo_os], hal_data->pos_calibrated_pdo_bp);
+    *(hal_data->pos_accelerating) = EC_READ_BIT(&pd[hal_data->pos_accelerating_pdo_os], hal_data->pos_accelerating_pdo_bp);
+    *(hal_data->pos_decelerating) = EC_READ_BIT(&pd[hal_data->pos_decelerating_pdo_os], hal_data->pos_decelerating_pdo_bp);
+    *(hal_data->pos_actual_raw) = EC_READ_S32(&pd[hal_data->pos_actual_pdo_os]);
+    *(hal_data->pos_actual_velocity) = EC_READ_S16(&pd[hal_data->pos_actual_velocity_pdo_os]);
+    *(hal_data->pos_drive_time) = EC_READ_U32(&pd[hal_data->pos_drive_time_pdo_os]);
+    if (hal_data->stm_pos_scale != 0.0) {
+      *(hal_data->pos_actual) = *(hal_data->pos_actual_raw) / hal_data->stm_pos_scale;
+    }
+  }
+}
+
+static inline int32_t clamp_s32(int64_t v, int32_t sub, int32_t sup) {
+  if (v < sub) return sub;
+  if (v > sup) return sup;
+  return v;
+}
+
+/// @brief Write the positioning interface outputs.
+///
+/// The terminal starts a move to `pos-target` on the rising edge of
+/// `pos-execute`, using the velocity, acceleration, and deceleration
+/// that are set at that time.
+static void lcec_el70x1_write_positioning(lcec_slave_t *slave, lcec_el70x1_data_t *hal_data, uint8_t *pd) {
+  *(hal_data->pos_target_raw) = (int32_t)(*(hal_data->pos_target) * hal_data->stm_pos_scale);
+
+  EC_WRITE_BIT(&pd[hal_data->pos_execute_pdo_os], hal_data->pos_execute_pdo_bp, *(hal_data->pos_execute));
+  EC_WRITE_BIT(&pd[hal_data->pos_emergency_stop_pdo_os], hal_data->pos_emergency_stop_pdo_bp, *(hal_data->pos_emergency_stop));
+  EC_WRITE_S32(&pd[hal_data->pos_target_pdo_os], *(hal_data->pos_target_raw));
+  EC_WRITE_S16(&pd[hal_data->pos_velocity_pdo_os], clamp_s32(*(hal_data->pos_velocity), -0x7fff, 0x7fff));
+  EC_WRITE_U16(&pd[hal_data->pos_start_type_pdo_os], *(hal_data->pos_start_type));
+  EC_WRITE_U16(&pd[hal_data->pos_accel_pdo_os], clamp_s32(*(hal_data->pos_accel), 0, 0xffff));
+  EC_WRITE_U16(&pd[hal_data->pos_decel_pdo_os], clamp_s32(*(hal_data->pos_decel), 0, 0xffff));
 }
 
 static void lcec_el70x1_write(lcec_slave_t *slave, long period) {
@@ -386,7 +602,11 @@ static void lcec_el70x1_write(lcec_slave_t *slave, long period) {
   uint8_t *pd = master->process_data;
   bool enabled, reduce_tourque;
 
-  *(hal_data->stm_pos_cmd_raw) = (int32_t)(*(hal_data->stm_pos_cmd) * hal_data->stm_pos_scale);
+  if (hal_data->positioning) {
+    lcec_el70x1_write_positioning(slave, hal_data, pd);
+  } else {
+    *(hal_data->stm_pos_cmd_raw) = (int32_t)(*(hal_data->stm_pos_cmd) * hal_data->stm_pos_scale);
+  }
 
   enabled = *(hal_data->stm_enable);
   if (!enabled) {
@@ -395,7 +615,12 @@ static void lcec_el70x1_write(lcec_slave_t *slave, long period) {
   EC_WRITE_BIT(&pd[hal_data->stm_ena_pdo_os], hal_data->stm_ena_pdo_bp, enabled);
 
   reduce_tourque = *(hal_data->stm_reduce_torque);
-  if (*(hal_data->stm_pos_cmd_raw) != hal_data->stm_pos_cmd_raw_last) {
+  if (hal_data->positioning) {
+    // the terminal is moving on its own
+    if (*(hal_data->pos_busy)) {
+      hal_data->auto_reduce_tourque_timer = 0;
+    }
+  } else if (*(hal_data->stm_pos_cmd_raw) != hal_data->stm_pos_cmd_raw_last) {
     hal_data->stm_pos_cmd_raw_last = *(hal_data->stm_pos_cmd_raw);
     hal_data->auto_reduce_tourque_timer = 0;
   }
@@ -410,5 +635,7 @@ static void lcec_el70x1_write(lcec_slave_t *slave, long period) {
 
   EC_WRITE_BIT(&pd[hal_data->stm_reset_pdo_os], hal_data->stm_reset_pdo_bp, *(hal_data->stm_reset));
 
-  EC_WRITE_S32(&pd[hal_data->stm_pos_raw_pdo_os], *(hal_data->stm_pos_cmd_raw));
+  if (!hal_data->positioning) {
+    EC_WRITE_S32(&pd[hal_data->stm_pos_raw_pdo_os], *(hal_data->stm_pos_cmd_raw));
+  }
 }
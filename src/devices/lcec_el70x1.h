@@ -25,10 +25,15 @@
 
 #include "../lcec.h"
 
-#define LCEC_EL70x1_PARAM_MAX_CURR  1
-#define LCEC_EL70x1_PARAM_RED_CURR  2
-#define LCEC_EL70x1_PARAM_NOM_VOLT  3
-#define LCEC_EL70x1_PARAM_COIL_RES  4
-#define LCEC_EL70x1_PARAM_MOTOR_EMF 5
+#define LCEC_EL70x1_PARAM_MAX_CURR    1
+#define LCEC_EL70x1_PARAM_RED_CURR    2
+#define LCEC_EL70x1_PARAM_NOM_VOLT    3
+#define LCEC_EL70x1_PARAM_COIL_RES    4
+#define LCEC_EL70x1_PARAM_MOTOR_EMF   5
+#define LCEC_EL70x1_PARAM_POSITIONING 6
+
+// Not static, so tests can set up an EL7031 before the types are
+// registered.
+int lcec_el7031_init(int comp_id, struct lcec_slave *slave);
 
 #endif
@@ -21,23 +21,82 @@
 
 #include "lcec_el7211.h"
 
+#include <stdlib.h>
+#include <strings.h>
+
 #include "../lcec.h"
 #include "hal.h"
 #include "lcec_class_enc.h"
 
 #define FAULT_RESET_PERIOD_NS 100000000
 
+// Torque offset, added to the velocity controller's output in CSV and CSP.
+#define TORQUE_FF_PDO_IDX  0x1605
+#define TORQUE_FF_IDX      0x7010
+#define TORQUE_FF_SIDX     0x0c
+#define TORQUE_FF_RAW_UNIT 1000.0  // The terminal wants 1000ths of rated current.
+
+// Modes of operation.  The driver only sends velocity commands.
+#define MODE_IDX  0x7010
+#define MODE_SIDX 0x03
+#define MODE_CSV  9
+
 /*static*/ int lcec_el7211_init(int comp_id, lcec_slave_t *slave);
 static int lcec_el7201_9014_init(int comp_id, lcec_slave_t *slave);
 
+static lcec_modparam_desc_t lcec_el7211_modparams[] = {
+    {"infoData1", LCEC_EL7211_PARAM_INFO_DATA_1, MODPARAM_TYPE_STRING},
+    {"infoData2", LCEC_EL7211_PARAM_INFO_DATA_2, MODPARAM_TYPE_STRING},
+    {"torqueFeedForward", LCEC_EL7211_PARAM_TORQUE_FF, MODPARAM_TYPE_BIT},
+    {NULL},
+};
+
+// The EL7201-9014 uses info data 1 for its digital inputs.
+static lcec_modparam_desc_t lcec_el7201_9014_modparams[] = {
+    {"infoData2", LCEC_EL7211_PARAM_INFO_DATA_2, MODPARAM_TYPE_STRING},
+    {"torqueFeedForward", LCEC_EL7211_PARAM_TORQUE_FF, MODPARAM_TYPE_BIT},
+    {NULL},
+};
+
 static lcec_typelist_t types[] = {
-    {"EL7201_9014", LCEC_BECKHOFF_VID, 0x1C213052, 0, NULL, lcec_el7201_9014_init},
-    {"EL7211", LCEC_BECKHOFF_VID, 0x1C2B3052, 0, NULL, lcec_el7211_init},
-    {"EL7221", LCEC_BECKHOFF_VID, 0x1C353052, 0, NULL, lcec_el7211_init},
+    {"EL7201_9014", LCEC_BECKHOFF_VID, 0x1C213052, 0, NULL, lcec_el7201_9014_init, lcec_el7201_9014_modparams},
+    {"EL7211", LCEC_BECKHOFF_VID, 0x1C2B3052, 0, NULL, lcec_el7211_init, lcec_el7211_modparams},
+    {"EL7221", LCEC_BECKHOFF_VID, 0x1C353052, 0, NULL, lcec_el7211_init, lcec_el7211_modparams},
     {NULL},
 };
 ADD_TYPES(types);
 
+/// @brief Info data values that can be selected with the `infoData1` and `infoData2` modparams.
+typedef struct {
+  const char *name;
+  int select;     ///< Value for 0x8010:39 or 0x8010:3a.
+  int is_signed;  ///< The raw value is signed.
+  double scale;   ///< Scale from the raw value to the `info-data-N` pin.
+} lcec_el7211_info_select_t;
+
+static const lcec_el7211_info_select_t info_selects[] = {
+    {"torqueCurrent", 0, 1, 0.001},  // Filtered over 1 ms, 1000ths of rated current.
+    {"dcLinkVoltage", 1, 0, 0.001},  // mV
+    {"pcbTemperature", 2, 1, 0.1},   // 0.1 C
+    {"errors", 3, 0, 1.0},
+    {"warnings", 4, 0, 1.0},
+    {"motorI2T", 5, 0, 1.0},      // %
+    {"amplifierI2T", 6, 0, 1.0},  // %
+    {"digitalInputs", 10, 0, 1.0},
+    {NULL},
+};
+
+/// @brief One mapped info data PDO.
+typedef struct {
+  hal_float_t *value;
+  hal_s32_t *raw;
+
+  int enabled;
+  int is_signed;
+  double scale;
+  unsigned int pdo_os;
+} lcec_el7211_info_t;
+
 typedef struct {
   hal_bit_t *enable;
   hal_bit_t *enabled;
@@ -69,6 +128,9 @@ typedef struct {
   hal_float_t *vel_cmd_out;
   hal_s32_t *vel_cmd_out_raw;
 
+  hal_float_t *torque_ff;
+  hal_s32_t *torque_ff_raw;
+
   hal_float_t scale;
 
   hal_u32_t vel_resolution;
@@ -80,13 +142,17 @@ typedef struct {
   hal_float_t at_speed_window;
 
   lcec_class_enc_data_t enc;
+  lcec_el7211_info_t info[2];
 
   unsigned int pos_fb_pdo_os;
   unsigned int status_pdo_os;
   unsigned int vel_fb_pdo_os;
   unsigned int ctrl_pdo_os;
   unsigned int vel_cmd_pdo_os;
-  unsigned int info1_pdo_os;
+  unsigned int torque_ff_pdo_os;
+
+  int info1_inputs;
+  int torque_ff_enabled;
 
   double vel_scale;
   double vel_rcpt;
@@ -130,6 +196,12 @@ static const lcec_pindesc_t slave_pins_el7201_9014[] = {
     {HAL_TYPE_UNSPECIFIED, HAL_DIR_UNSPECIFIED, -1, NULL},
 };
 
+static const lcec_pindesc_t slave_pins_torque_ff[] = {
+    {HAL_FLOAT, HAL_IN, offsetof(lcec_el7211_data_t, torque_ff), "%s.%s.%s.torque-ff"},
+    {HAL_S32, HAL_OUT, offsetof(lcec_el7211_data_t, torque_ff_raw), "%s.%s.%s.torque-ff-raw"},
+    {HAL_TYPE_UNSPECIFIED, HAL_DIR_UNSPECIFIED, -1, NULL},
+};
+
 static const lcec_paramdesc_t slave_params[] = {
     {HAL_FLOAT, HAL_RW, offsetof(lcec_el7211_data_t, scale), "%s.%s.%s.scale"},
     {HAL_U32, HAL_RO, offsetof(lcec_el7211_data_t, vel_resolution), "%s.%s.%s.vel-resolution"},
@@ -141,66 +213,9 @@ static const lcec_paramdesc_t slave_params[] = {
     {HAL_TYPE_UNSPECIFIED},
 };
 
-static ec_pdo_entry_info_t lcec_el7211_in_pos[] = {
-    {0x6000, 0x11, 32},  // actual position
-};
-
-static ec_pdo_entry_info_t lcec_el7211_in_status[] = {
-    {0x6010, 0x01, 16},  // status word
-};
-
-static ec_pdo_entry_info_t lcec_el7211_in_info1[] = {
-    {0x6010, 0x12, 16},  // info 1
-};
-
-static ec_pdo_entry_info_t lcec_el7211_in_vel[] = {
-    {0x6010, 0x07, 32},  // actual velocity
-};
-
-static ec_pdo_entry_info_t lcec_el7211_out_ctrl[] = {
-    {0x7010, 0x01, 16},  // control word
-};
-
-static ec_pdo_entry_info_t lcec_el7211_out_cmd[] = {
-    {0x7010, 0x06, 32},  // velocity command
-};
-
-static ec_pdo_info_t lcec_el7211_pdos_in[] = {
-    {0x1A00, 1, lcec_el7211_in_pos},
-    {0x1A01, 1, lcec_el7211_in_status},
-    {0x1A02, 1, lcec_el7211_in_vel},
-};
-
-static ec_pdo_info_t lcec_el7201_9014_pdos_in[] = {
-    {0x1A00, 1, lcec_el7211_in_pos},
-    {0x1A01, 1, lcec_el7211_in_status},
-    {0x1A02, 1, lcec_el7211_in_vel},
-    {0x1A04, 1, lcec_el7211_in_info1},
-};
-
-static ec_pdo_info_t lcec_el7211_pdos_out[] = {
-    {0x1600, 1, lcec_el7211_out_ctrl},
-    {0x1601, 1, lcec_el7211_out_cmd},
-};
-
-static ec_sync_info_t lcec_el7211_syncs[] = {
-    {0, EC_DIR_OUTPUT, 0, NULL},
-    {1, EC_DIR_INPUT, 0, NULL},
-    {2, EC_DIR_OUTPUT, 2, lcec_el7211_pdos_out},
-    {3, EC_DIR_INPUT, 3, lcec_el7211_pdos_in},
-    {0xff},
-};
-
-static ec_sync_info_t lcec_el7201_9014_syncs[] = {
-    {0, EC_DIR_OUTPUT, 0, NULL},
-    {1, EC_DIR_INPUT, 0, NULL},
-    {2, EC_DIR_OUTPUT, 2, lcec_el7211_pdos_out},
-    {3, EC_DIR_INPUT, 4, lcec_el7201_9014_pdos_in},
-    {0xff},
-};
-
 static lcec_el7211_data_t *lcec_el7211_alloc_hal(lcec_master_t *master, lcec_slave_t *slave);
 static int lcec_el7211_export_pins(lcec_master_t *master, lcec_slave_t *slave, lcec_el7211_data_t *hal_data);
+static int lcec_el7211_setup(lcec_slave_t *slave, lcec_el7211_data_t *hal_data);
 static void lcec_el7211_check_scales(lcec_el7211_data_t *hal_data);
 static void lcec_el7211_read(lcec_slave_t *slave, long period);
 static void lcec_el7201_9014_read(lcec_slave_t *slave, long period);
@@ -211,10 +226,11 @@ static lcec_el7211_data_t *lcec_el7211_alloc_hal(lcec_master_t *master, lcec_sla
 }
 
 static int lcec_el7211_export_pins(lcec_master_t *master, lcec_slave_t *slave, lcec_el7211_data_t *hal_data) {
-  int err;
+  int err, i;
   uint8_t sdo_buf[4];
   uint32_t sdo_vel_resolution;
   uint32_t sdo_pos_resolution;
+  lcec_el7211_info_t *info;
 
   // read sdos
   if (lcec_read_sdo(slave, 0x9010, 0x14, sdo_buf, 4)) {
@@ -230,6 +246,25 @@ static int lcec_el7211_export_pins(lcec_master_t *master, lcec_slave_t *slave, l
   if ((err = lcec_pin_newf_list(hal_data, slave_pins, LCEC_MODULE_NAME, master->name, slave->name)) != 0) {
     return err;
   }
+  if (hal_data->torque_ff_enabled) {
+    if ((err = lcec_pin_newf_list(hal_data, slave_pins_torque_ff, LCEC_MODULE_NAME, master->name, slave->name)) != 0) {
+      return err;
+    }
+  }
+  for (i = 0; i < 2; i++) {
+    info = &hal_data->info[i];
+    if (!info->enabled) {
+      continue;
+    }
+    if ((err = lcec_pin_newf(HAL_FLOAT, HAL_OUT, (void **)&info->value, "%s.%s.%s.info-data-%d", LCEC_MODULE_NAME, master->name,
+             slave->name, i + 1)) != 0) {
+      return err;
+    }
+    if ((err = lcec_pin_newf(HAL_S32, HAL_OUT, (void **)&info->raw, "%s.%s.%s.info-data-%d-raw", LCEC_MODULE_NAME, master->name,
+             slave->name, i + 1)) != 0) {
+      return err;
+    }
+  }
 
   // export parameters
   if ((err = lcec_param_newf_list(hal_data, slave_params, LCEC_MODULE_NAME, master->name, slave->name)) != 0) {
@@ -265,6 +300,140 @@ static int lcec_el7211_export_pins(lcec_master_t *master, lcec_slave_t *slave, l
   return 0;
 }
 
+/// @brief Select what info data channel `n` (1 or 2) reports.
+///
+/// `name` is either one of `info_selects`, or a raw selector value
+/// from the terminal's documentation, which is reported unscaled.
+static int lcec_el7211_select_info(lcec_slave_t *slave, lcec_el7211_info_t *info, int n, const char *name) {
+  const lcec_el7211_info_select_t *sel;
+  char *end;
+  long select;
+
+  for (sel = info_selects; sel->name != NULL; sel++) {
+    if (strcasecmp(sel->name, name) == 0) {
+      break;
+    }
+  }
+
+  if (sel->name != NULL) {
+    select = sel->select;
+    info->is_signed = sel->is_signed;
+    info->scale = sel->scale;
+  } else {
+    select = strtol(name, &end, 0);
+    if (*name == 0 || *end != 0 || select < 0 || select > 255) {
+      rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "unknown infoData%d value \"%s\" for slave %s.%s\n", n, name, slave->master->name,
+          slave->name);
+      return -1;
+    }
+    info->is_signed = 0;
+    info->scale = 1.0;
+  }
+
+  if (lcec_write_sdo8(slave, 0x8010, 0x38 + n, select) != 0) {
+    rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "fail to configure slave %s.%s sdo info%d select\n", slave->master->name, slave->name, n);
+    return -1;
+  }
+  info->enabled = 1;
+  return 0;
+}
+
+/// @brief Check that no `<sdoConfig>` moves the terminal out of velocity mode.
+///
+/// The torque offset is added to the velocity controller's output,
+/// which the terminal bypasses in other modes.
+static int lcec_el7211_check_mode(lcec_slave_t *slave) {
+  lcec_slave_sdoconf_t *sdo;
+
+  for (sdo = slave->sdo_config; sdo != NULL && sdo->index != 0xffff; sdo = (lcec_slave_sdoconf_t *)&sdo->data[sdo->length]) {
+    if (sdo->index == MODE_IDX && sdo->subindex == MODE_SIDX && sdo->length > 0 && sdo->data[0] != MODE_CSV) {
+      rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "slave %s.%s: torqueFeedForward needs velocity mode, but 0x%04x:%02x is set to %d\n",
+          slave->master->name, slave->name, MODE_IDX, MODE_SIDX, sdo->data[0]);
+      return -1;
+    }
+  }
+  return 0;
+}
+
+/// @brief Apply modparams and set up syncs and PDO entries.
+static int lcec_el7211_setup(lcec_slave_t *slave, lcec_el7211_data_t *hal_data) {
+  lcec_slave_modparam_t *p;
+  lcec_syncs_t *syncs;
+
+  // set config parameters
+  for (p = slave->modparams; p != NULL && p->id >= 0; p++) {
+    switch (p->id) {
+      case LCEC_EL7211_PARAM_INFO_DATA_1:
+        if (lcec_el7211_select_info(slave, &hal_data->info[0], 1, p->value.str) != 0) {
+          return -1;
+        }
+        break;
+      case LCEC_EL7211_PARAM_INFO_DATA_2:
+        if (lcec_el7211_select_info(slave, &hal_data->info[1], 2, p->value.str) != 0) {
+          return -1;
+        }
+        break;
+      case LCEC_EL7211_PARAM_TORQUE_FF:
+        hal_data->torque_ff_enabled = p->value.bit;
+        break;
+    }
+  }
+  if (hal_data->torque_ff_enabled && lcec_el7211_check_mode(slave) != 0) {
+    return -1;
+  }
+
+  // initialize sync info
+  syncs = LCEC_HAL_ALLOCATE(lcec_syncs_t);
+  lcec_syncs_init(slave, syncs);
+  lcec_syncs_add_sync(syncs, EC_DIR_OUTPUT, EC_WD_DEFAULT);
+  lcec_syncs_add_sync(syncs, EC_DIR_INPUT, EC_WD_DEFAULT);
+
+  lcec_syncs_add_sync(syncs, EC_DIR_OUTPUT, EC_WD_DEFAULT);
+  lcec_syncs_add_pdo_info(syncs, 0x1600);
+  lcec_syncs_add_pdo_entry(syncs, 0x7010, 0x01, 16);  // control word
+  lcec_syncs_add_pdo_info(syncs, 0x1601);
+  lcec_syncs_add_pdo_entry(syncs, 0x7010, 0x06, 32);  // velocity command
+  if (hal_data->torque_ff_enabled) {
+    lcec_syncs_add_pdo_info(syncs, TORQUE_FF_PDO_IDX);
+    lcec_syncs_add_pdo_entry(syncs, TORQUE_FF_IDX, TORQUE_FF_SIDX, 16);  // torque offset
+  }
+
+  lcec_syncs_add_sync(syncs, EC_DIR_INPUT, EC_WD_DEFAULT);
+  lcec_syncs_add_pdo_info(syncs, 0x1A00);
+  lcec_syncs_add_pdo_entry(syncs, 0x6000, 0x11, 32);  // actual position
+  lcec_syncs_add_pdo_info(syncs, 0x1A01);
+  lcec_syncs_add_pdo_entry(syncs, 0x6010, 0x01, 16);  // status word
+  lcec_syncs_add_pdo_info(syncs, 0x1A02);
+  lcec_syncs_add_pdo_entry(syncs, 0x6010, 0x07, 32);  // actual velocity
+  if (hal_data->info1_inputs || hal_data->info[0].enabled) {
+    lcec_syncs_add_pdo_info(syncs, 0x1A04);
+    lcec_syncs_add_pdo_entry(syncs, 0x6010, 0x12, 16);  // info data 1
+  }
+  if (hal_data->info[1].enabled) {
+    lcec_syncs_add_pdo_info(syncs, 0x1A05);
+    lcec_syncs_add_pdo_entry(syncs, 0x6010, 0x13, 16);  // info data 2
+  }
+  slave->sync_info = &syncs->syncs[0];
+
+  // initialize POD entries
+  lcec_pdo_init(slave, 0x6000, 0x11, &hal_data->pos_fb_pdo_os, NULL);
+  lcec_pdo_init(slave, 0x6010, 0x01, &hal_data->status_pdo_os, NULL);
+  lcec_pdo_init(slave, 0x6010, 0x07, &hal_data->vel_fb_pdo_os, NULL);
+  lcec_pdo_init(slave, 0x7010, 0x01, &hal_data->ctrl_pdo_os, NULL);
+  lcec_pdo_init(slave, 0x7010, 0x06, &hal_data->vel_cmd_pdo_os, NULL);
+  if (hal_data->torque_ff_enabled) {
+    lcec_pdo_init(slave, TORQUE_FF_IDX, TORQUE_FF_SIDX, &hal_data->torque_ff_pdo_os, NULL);
+  }
+  if (hal_data->info1_inputs || hal_data->info[0].enabled) {
+    lcec_pdo_init(slave, 0x6010, 0x12, &hal_data->info[0].pdo_os, NULL);
+  }
+  if (hal_data->info[1].enabled) {
+    lcec_pdo_init(slave, 0x6010, 0x13, &hal_data->info[1].pdo_os, NULL);
+  }
+
+  return 0;
+}
+
 // TODO: lcec_el7411_init calls this.  Fix?
 /*static*/ int lcec_el7211_init(int comp_id, lcec_slave_t *slave) {
   lcec_master_t *master = slave->master;
@@ -280,15 +449,10 @@ static int lcec_el7211_export_pins(lcec_master_t *master, lcec_slave_t *slave, l
   slave->proc_read = lcec_el7211_read;
   slave->proc_write = lcec_el7211_write;
 
-  // initialize sync info
-  slave->sync_info = lcec_el7211_syncs;
-
-  // initialize POD entries
-  lcec_pdo_init(slave, 0x6000, 0x11, &hal_data->pos_fb_pdo_os, NULL);
-  lcec_pdo_init(slave, 0x6010, 0x01, &hal_data->status_pdo_os, NULL);
-  lcec_pdo_init(slave, 0x6010, 0x07, &hal_data->vel_fb_pdo_os, NULL);
-  lcec_pdo_init(slave, 0x7010, 0x01, &hal_data->ctrl_pdo_os, NULL);
-  lcec_pdo_init(slave, 0x7010, 0x06, &hal_data->vel_cmd_pdo_os, NULL);
+  // initialize sync info and POD entries
+  if (lcec_el7211_setup(slave, hal_data) != 0) {
+    return -1;
+  }
 
   // export pins
   if ((err = lcec_el7211_export_pins(master, slave, hal_data)) != 0) {
@@ -313,21 +477,16 @@ static int lcec_el7201_9014_init(int comp_id, lcec_slave_t *slave) {
     rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "fail to configure slave %s.%s sdo info1 select\n", master->name, slave->name);
     return -1;
   }
+  hal_data->info1_inputs = 1;
 
   // initialize callbacks
   slave->proc_read = lcec_el7201_9014_read;
   slave->proc_write = lcec_el7211_write;
 
-  // initialize sync info
-  slave->sync_info = lcec_el7201_9014_syncs;
-
-  // initialize POD entries
-  lcec_pdo_init(slave, 0x6000, 0x11, &hal_data->pos_fb_pdo_os, NULL);
-  lcec_pdo_init(slave, 0x6010, 0x01, &hal_data->status_pdo_os, NULL);
-  lcec_pdo_init(slave, 0x6010, 0x07, &hal_data->vel_fb_pdo_os, NULL);
-  lcec_pdo_init(slave, 0x7010, 0x01, &hal_data->ctrl_pdo_os, NULL);
-  lcec_pdo_init(slave, 0x7010, 0x06, &hal_data->vel_cmd_pdo_os, NULL);
-  lcec_pdo_init(slave, 0x6010, 0x12, &hal_data->info1_pdo_os, NULL);
+  // initialize sync info and POD entries
+  if (lcec_el7211_setup(slave, hal_data) != 0) {
+    return -1;
+  }
 
   // export pins
   if ((err = lcec_el7211_export_pins(master, slave, hal_data)) != 0) {
@@ -372,6 +531,8 @@ static void lcec_el7211_read(lcec_slave_t *slave, long period) {
   int32_t vel_raw;
   double vel;
   uint32_t pos_cnt;
+  lcec_el7211_info_t *info;
+  int i;
 
   // wait for slave to be operational
   if (!slave->state.operational) {
@@ -427,6 +588,15 @@ static void lcec_el7211_read(lcec_slave_t *slave, long period) {
   // update position feedback
   pos_cnt = EC_READ_U32(&pd[hal_data->pos_fb_pdo_os]);
   class_enc_update(&hal_data->enc, hal_data->pos_resolution, hal_data->scale_rcpt, pos_cnt, 0, 0);
+
+  // read info data
+  for (i = 0; i < 2; i++) {
+    info = &hal_data->info[i];
+    if (info->enabled) {
+      *(info->raw) = info->is_signed ? EC_READ_S16(&pd[info->pdo_os]) : EC_READ_U16(&pd[info->pdo_os]);
+      *(info->value) = *(info->raw) * info->scale;
+    }
+  }
 }
 
 static void lcec_el7201_9014_read(lcec_slave_t *slave, long period) {
@@ -438,7 +608,7 @@ static void lcec_el7201_9014_read(lcec_slave_t *slave, long period) {
   lcec_el7211_read(slave, period);
 
   // read info1
-  info1 = EC_READ_U16(&pd[hal_data->info1_pdo_os]);
+  info1 = EC_READ_U16(&pd[hal_data->info[0].pdo_os]);
   *(hal_data->input_0) = (info1 >> 0) & 0x01;
   *(hal_data->input_0_not) = !*(hal_data->input_0);
   *(hal_data->input_1) = (info1 >> 1) & 0x01;
@@ -457,7 +627,7 @@ static void lcec_el7211_write(lcec_slave_t *slave, long period) {
   lcec_el7211_data_t *hal_data = (lcec_el7211_data_t *)slave->hal_data;
   uint8_t *pd = master->process_data;
   uint16_t control;
-  double velo_cmd, velo_raw, velo_maxdelta;
+  double velo_cmd, velo_raw, velo_maxdelta, torque_raw;
 
   // check for change in scale value
   lcec_el7211_check_scales(hal_data);
@@ -494,4 +664,14 @@ static void lcec_el7211_write(lcec_slave_t *slave, long period) {
   }
   *(hal_data->vel_cmd_out_raw) = (int32_t)velo_raw;
   EC_WRITE_S32(&pd[hal_data->vel_cmd_pdo_os], *(hal_data->vel_cmd_out_raw));
+
+  // set torque feed-forward
+  if (hal_data->torque_ff_enabled) {
+    torque_raw = 0.0;
+    if (*(hal_data->enable)) {
+      torque_raw = clamp(*(hal_data->torque_ff) * TORQUE_FF_RAW_UNIT, -0x7fff, 0x7fff);
+    }
+    *(hal_data->torque_ff_raw) = (int32_t)torque_raw;
+    EC_WRITE_S16(&pd[hal_data->torque_ff_pdo_os], *(hal_data->torque_ff_raw));
+  }
 }
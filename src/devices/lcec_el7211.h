@@ -24,5 +24,11 @@
 
 #include "../lcec.h"
 
+// Modparam IDs.  `lcec_el7411` passes its own modparams through
+// `lcec_el7211_init()`, so these start above the EL7411's.
+#define LCEC_EL7211_PARAM_INFO_DATA_1 100
+#define LCEC_EL7211_PARAM_INFO_DATA_2 101
+#define LCEC_EL7211_PARAM_TORQUE_FF   102
+
 int lcec_el7211_init(int comp_id, struct lcec_slave *slave);
 #endif
@@ -20,17 +20,45 @@
 /// @brief Driver for Beckhoff EP9410
 
 #include "../lcec.h"
+#include "lcec_class_telemetry.h"
+
+#define M_TELEMETRY      0
+#define M_TELEMETRY_POLL 1
 
 static int lcec_ep9214_init(int comp_id, lcec_slave_t *slave);
 
+static const lcec_modparam_desc_t lcec_ep9214_modparams[] = {
+    {"telemetry", M_TELEMETRY, MODPARAM_TYPE_STRING, "off", "Current and voltage readout: off, pdo, or sdo"},
+    {"telemetryPollMs", M_TELEMETRY_POLL, MODPARAM_TYPE_U32, "100", "Time between SDO reads of each value, in ms"},
+    {NULL},
+};
+
 /// @brief Devices supported by this driver.
 static lcec_typelist_t types[] = {
-    {"EP9214", LCEC_BECKHOFF_VID, 0x23fe4052, .proc_init = lcec_ep9214_init},
+    {"EP9214", LCEC_BECKHOFF_VID, 0x23fe4052, .proc_init = lcec_ep9214_init, .modparams = lcec_ep9214_modparams},
     {NULL},
 };
 ADD_TYPES(types)
 
 #define CHANNELS 4
+
+// Objects for the optional current and voltage readout.  Channel
+// currents are in mA at 0x60n0, supply voltages in mV at 0xf600.
+#define CURRENT_US_SIDX 0x11
+#define CURRENT_UP_SIDX 0x12
+#define VOLTAGE_IDX     0xf600
+#define VOLTAGE_US_SIDX 0x11
+#define VOLTAGE_UP_SIDX 0x12
+
+// PDOs.  The status and control PDOs are the box's default
+// assignment; the current and voltage PDOs are only assigned with
+// telemetry="pdo".
+#define CHAN_RX_PDO    0x1600  // +chan
+#define DEVICE_RX_PDO  0x1604
+#define CHAN_TX_PDO    0x1a00  // +chan
+#define DEVICE_TX_PDO  0x1a04
+#define CURRENT_TX_PDO 0x1a05  // +chan
+#define VOLTAGE_TX_PDO 0x1a09
   
 typedef struct {
   hal_bit_t *error_us, *error_up;
@@ -71,6 +99,8 @@ typedef struct {
   unsigned  int warning_us_os, warning_us_bp;
   unsigned  int warning_up_os, warning_up_bp;
   unsigned  int warning_temp_os, warning_temp_bp;
+
+  lcec_class_telemetry_t *telemetry;
 } lcec_ep9214_data_t;
 
 static const lcec_pindesc_t channel_pins[] = {
@@ -104,14 +134,71 @@ static const lcec_pindesc_t device_pins[] = {
 static void lcec_ep9214_read(lcec_slave_t *slave, long period);
 static void lcec_ep9214_write(lcec_slave_t *slave, long period);
 
+/// @brief Assign the default PDOs plus the current and voltage PDOs.
+///
+/// The PDOs are listed without entries, so the master keeps the
+/// box's own mapping for each of them.
+static void lcec_ep9214_telemetry_syncs(lcec_slave_t *slave) {
+  lcec_syncs_t *syncs = LCEC_HAL_ALLOCATE(lcec_syncs_t);
+  int chan;
+
+  lcec_syncs_init(slave, syncs);
+  lcec_syncs_add_sync(syncs, EC_DIR_OUTPUT, EC_WD_DEFAULT);
+  lcec_syncs_add_sync(syncs, EC_DIR_INPUT, EC_WD_DEFAULT);
+
+  lcec_syncs_add_sync(syncs, EC_DIR_OUTPUT, EC_WD_DEFAULT);
+  for (chan = 0; chan < CHANNELS; chan++) {
+    lcec_syncs_add_pdo_info(syncs, CHAN_RX_PDO + chan);
+  }
+  lcec_syncs_add_pdo_info(syncs, DEVICE_RX_PDO);
+
+  lcec_syncs_add_sync(syncs, EC_DIR_INPUT, EC_WD_DEFAULT);
+  for (chan = 0; chan < CHANNELS; chan++) {
+    lcec_syncs_add_pdo_info(syncs, CHAN_TX_PDO + chan);
+  }
+  lcec_syncs_add_pdo_info(syncs, DEVICE_TX_PDO);
+  for (chan = 0; chan < CHANNELS; chan++) {
+    lcec_syncs_add_pdo_info(syncs, CURRENT_TX_PDO + chan);
+  }
+  lcec_syncs_add_pdo_info(syncs, VOLTAGE_TX_PDO);
+
+  slave->sync_info = &syncs->syncs[0];
+}
+
 /// @brief Initialize an EP9214
 static int lcec_ep9214_init(int comp_id, lcec_slave_t *slave) {
   int err;
   lcec_ep9214_data_t *hal_data = LCEC_HAL_ALLOCATE(lcec_ep9214_data_t);
   int chan;
+  LCEC_CONF_MODPARAM_VAL_T *pval;
+  int telemetry = LCEC_TELEMETRY_OFF;
+  long long poll_period = LCEC_TELEMETRY_POLL_NS;
   
   slave->hal_data = hal_data;
 
+  pval = lcec_modparam_get(slave, M_TELEMETRY);
+  if (pval != NULL) {
+    telemetry = lcec_telemetry_parse_mode(pval->str);
+    if (telemetry < 0) {
+      rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "unknown telemetry mode \"%s\" for slave %s.%s\n", pval->str, slave->master->name,
+          slave->name);
+      return -1;
+    }
+  }
+  pval = lcec_modparam_get(slave, M_TELEMETRY_POLL);
+  if (pval != NULL) {
+    poll_period = pval->u32 * 1000000LL;
+  }
+  if (telemetry != LCEC_TELEMETRY_OFF) {
+    hal_data->telemetry = lcec_telemetry_allocate(slave, 2 * CHANNELS + 2, telemetry, poll_period);
+    if (hal_data->telemetry == NULL) {
+      return -1;
+    }
+  }
+  if (telemetry == LCEC_TELEMETRY_PDO) {
+    lcec_ep9214_telemetry_syncs(slave);
+  }
+
   for (chan=0; chan<4; chan++) {
     lcec_ep9214_channel_data_t *c = &(hal_data->chan[chan]);
     
@@ -148,6 +235,24 @@ static int lcec_ep9214_init(int comp_id, lcec_slave_t *slave) {
     c->current_limit_type_old = *(c->current_limit_type);
     c->current_limit_us_old = *(c->current_limit_us);
     c->current_limit_up_old = *(c->current_limit_up);
+
+    if (hal_data->telemetry != NULL) {
+      if (lcec_telemetry_register_value(
+              slave, hal_data->telemetry, 0x6000+16*chan, CURRENT_US_SIDX, 16, 0, 0.001, "chan-%d-current-us", chan+1) == NULL) {
+        return -1;
+      }
+      if (lcec_telemetry_register_value(
+              slave, hal_data->telemetry, 0x6000+16*chan, CURRENT_UP_SIDX, 16, 0, 0.001, "chan-%d-current-up", chan+1) == NULL) {
+        return -1;
+      }
+    }
+  }
+
+  if (hal_data->telemetry != NULL) {
+    if (lcec_telemetry_register_value(slave, hal_data->telemetry, VOLTAGE_IDX, VOLTAGE_US_SIDX, 16, 0, 0.001, "voltage-us") == NULL ||
+        lcec_telemetry_register_value(slave, hal_data->telemetry, VOLTAGE_IDX, VOLTAGE_UP_SIDX, 16, 0, 0.001, "voltage-up") == NULL) {
+      return -1;
+    }
   }
 
   lcec_pdo_init(slave, 0xf607, 1, &(hal_data->warning_temp_os), &(hal_data->warning_temp_bp));
@@ -174,6 +279,12 @@ static void lcec_ep9214_read(lcec_slave_t *slave, long period) {
   uint8_t *pd = slave->master->process_data;
   lcec_ep9214_data_t *hal_data = (lcec_ep9214_data_t *)slave->hal_data;
 
+  // SDO readout works before the slave is operational; PDO readout
+  // waits for it
+  if (hal_data->telemetry != NULL) {
+    lcec_telemetry_read(slave, hal_data->telemetry, period);
+  }
+
   // wait for slave to be operational
   if (!slave->state.operational) {
     return;
@@ -37,6 +37,9 @@ hal_u32_t lcec_generic_read_u32(uint8_t *pd, lcec_generic_pin_t *hal_data);
 void lcec_generic_write_s32(uint8_t *pd, lcec_generic_pin_t *hal_data, hal_s32_t sval);
 void lcec_generic_write_u32(uint8_t *pd, lcec_generic_pin_t *hal_data, hal_u32_t uval);
 
+static int lcec_generic_sdo_pin_init(lcec_slave_t *slave, lcec_generic_sdo_pin_t *sdo_pin);
+static void lcec_generic_sdo_pins_run(lcec_slave_t *slave, long period);
+
 /// @brief Initialize a generic device.
 ///
 /// Not static because it's called directly from `lcec_main`, unlike
@@ -115,9 +118,204 @@ int lcec_generic_init(int comp_id, lcec_slave_t *slave) {
     }
   }
 
+  // initialize sdo pins
+  for (i = 0; i < slave->generic_sdo_pin_count; i++) {
+    err = lcec_generic_sdo_pin_init(slave, &slave->generic_sdo_pins[i]);
+    if (err != 0) {
+      return err;
+    }
+  }
+
   return 0;
 }
 
+/// @brief Set up a `<sdoPin>`.
+static int lcec_generic_sdo_pin_init(lcec_slave_t *slave, lcec_generic_sdo_pin_t *sdo_pin) {
+  lcec_master_t *master = slave->master;
+  int err;
+
+  err = lcec_pin_newf(
+      sdo_pin->type, sdo_pin->dir, &sdo_pin->pin, "%s.%s.%s.%s", LCEC_MODULE_NAME, master->name, slave->name, sdo_pin->name);
+  if (err != 0) {
+    return err;
+  }
+
+  if (lcec_create_sdo_request(slave, sdo_pin->sdo_idx, sdo_pin->sdo_sidx, sdo_pin->bitLength >> 3, &sdo_pin->poll.req) != 0) {
+    return -EIO;
+  }
+
+  return 0;
+}
+
+/// @brief Service `<sdoPin>` requests.
+///
+/// Each pin is read or written once per poll period, see
+/// `lcec_sdo_poll()`.  Written pins only send a request when their
+/// value has changed.
+static void lcec_generic_sdo_pins_run(lcec_slave_t *slave, long period) {
+  lcec_generic_sdo_pin_t *sdo_pin;
+  uint8_t *data;
+  uint64_t raw;
+  int i, started;
+
+  for (i = 0, started = 0; i < slave->generic_sdo_pin_count; i++) {
+    sdo_pin = &slave->generic_sdo_pins[i];
+    switch (lcec_sdo_poll(slave, &sdo_pin->poll, sdo_pin->poll_period, period, &started)) {
+      case LCEC_SDO_POLL_DONE:
+        data = ecrt_sdo_request_data(sdo_pin->poll.req);
+        if (sdo_pin->dir == HAL_OUT) {
+          switch (sdo_pin->bitLength) {
+            case 8:
+              raw = EC_READ_U8(data);
+              break;
+            case 16:
+              raw = EC_READ_U16(data);
+              break;
+            case 32:
+              raw = EC_READ_U32(data);
+              break;
+            default:
+              raw = EC_READ_U64(data);
+          }
+          lcec_generic_sdo_decode(sdo_pin, raw);
+        } else {
+          sdo_pin->written = 1;
+        }
+        break;
+
+      case LCEC_SDO_POLL_ERROR:
+        lcec_log_slave(slave, LCEC_LOG_SDO_PIN_ERROR, sdo_pin->sdo_idx, sdo_pin->sdo_sidx, 0, 0);
+        break;
+
+      case LCEC_SDO_POLL_DUE:
+        if (sdo_pin->dir == HAL_OUT) {
+          lcec_sdo_poll_start(&sdo_pin->poll, 0, &started);
+          break;
+        }
+        raw = lcec_generic_sdo_encode(sdo_pin);
+        if (sdo_pin->written && raw == sdo_pin->last) {
+          sdo_pin->poll.wait = sdo_pin->poll_period;
+          break;
+        }
+        data = ecrt_sdo_request_data(sdo_pin->poll.req);
+        switch (sdo_pin->bitLength) {
+          case 8:
+            EC_WRITE_U8(data, raw);
+            break;
+          case 16:
+            EC_WRITE_U16(data, raw);
+            break;
+          case 32:
+            EC_WRITE_U32(data, raw);
+            break;
+          default:
+            EC_WRITE_U64(data, raw);
+        }
+        sdo_pin->last = raw;
+        sdo_pin->written = 0;
+        lcec_sdo_poll_start(&sdo_pin->poll, 1, &started);
+        break;
+
+      default:
+        break;
+    }
+  }
+}
+
+/// @brief Convert a raw SDO value to an `<sdoPin>`'s pin value.
+void lcec_generic_sdo_decode(lcec_generic_sdo_pin_t *sdo_pin, uint64_t raw) {
+  int shift = 64 - sdo_pin->bitLength;
+  int64_t sval = (int64_t)(raw << shift) >> shift;
+  hal_float_t fval;
+  uint32_t u32;
+  float f;
+  double d;
+
+  switch (sdo_pin->type) {
+    case HAL_BIT:
+      *((hal_bit_t *)sdo_pin->pin) = raw != 0;
+      break;
+
+    case HAL_S32:
+      *((hal_s32_t *)sdo_pin->pin) = sval;
+      break;
+
+    case HAL_U32:
+      *((hal_u32_t *)sdo_pin->pin) = raw;
+      break;
+
+    case HAL_FLOAT:
+      if (sdo_pin->subType == lcecPdoEntTypeFloatUnsigned) {
+        fval = raw;
+      } else if (sdo_pin->subType == lcecPdoEntTypeFloatIeee) {
+        u32 = raw;
+        memcpy(&f, &u32, sizeof(f));
+        fval = f;
+      } else if (sdo_pin->subType == lcecPdoEntTypeFloatDoubleIeee) {
+        memcpy(&d, &raw, sizeof(d));
+        fval = d;
+      } else {
+        fval = sval;
+      }
+      *((hal_float_t *)sdo_pin->pin) = fval * sdo_pin->floatScale + sdo_pin->floatOffset;
+      break;
+
+    default:
+      break;
+  }
+}
+
+/// @brief Convert an `<sdoPin>`'s pin value to a raw SDO value.
+///
+/// Integers are clamped to the range of the SDO.
+uint64_t lcec_generic_sdo_encode(lcec_generic_sdo_pin_t *sdo_pin) {
+  uint64_t umax = sdo_pin->bitLength < 64 ? (1ULL << sdo_pin->bitLength) - 1 : ~0ULL;
+  int64_t smax = umax >> 1;
+  double fval;
+  float f;
+  uint32_t u32;
+  uint64_t raw;
+
+  switch (sdo_pin->type) {
+    case HAL_BIT:
+      return *((hal_bit_t *)sdo_pin->pin) ? 1 : 0;
+
+    case HAL_S32:
+      fval = *((hal_s32_t *)sdo_pin->pin);
+      break;
+
+    case HAL_U32:
+      fval = *((hal_u32_t *)sdo_pin->pin);
+      break;
+
+    case HAL_FLOAT:
+      fval = (*((hal_float_t *)sdo_pin->pin) - sdo_pin->floatOffset) / sdo_pin->floatScale;
+      if (sdo_pin->subType == lcecPdoEntTypeFloatIeee) {
+        f = fval;
+        memcpy(&u32, &f, sizeof(u32));
+        return u32;
+      }
+      if (sdo_pin->subType == lcecPdoEntTypeFloatDoubleIeee) {
+        memcpy(&raw, &fval, sizeof(raw));
+        return raw;
+      }
+      break;
+
+    default:
+      return 0;
+  }
+
+  if (sdo_pin->type == HAL_U32 || sdo_pin->subType == lcecPdoEntTypeFloatUnsigned) {
+    if (fval < 0) return 0;
+    if (fval > umax) return umax;
+    return (uint64_t)fval;
+  }
+
+  if (fval > smax) return smax;
+  if (fval < -smax - 1) return (uint64_t)(-smax - 1) & umax;
+  return (uint64_t)(int64_t)fval & umax;
+}
+
 /// @brief Read from a generic device.
 void lcec_generic_read(lcec_slave_t *slave, long period) {
   lcec_master_t *master = slave->master;
@@ -169,6 +367,8 @@ void lcec_generic_read(lcec_slave_t *slave, long period) {
         continue;
     }
   }
+
+  lcec_generic_sdo_pins_run(slave, period);
 }
 
 /// @brief Write to a generic device.
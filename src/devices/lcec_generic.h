@@ -41,6 +41,26 @@ typedef struct {
   unsigned int pdo_bp;
 } lcec_generic_pin_t;
 
+/// @brief A HAL pin backed by an SDO, polled in the background.
+struct lcec_generic_sdo_pin {
+  char name[LCEC_CONF_STR_MAXLEN];
+  hal_type_t type;
+  LCEC_PDOENT_TYPE_T subType;
+  hal_float_t floatScale;
+  hal_float_t floatOffset;
+  uint8_t bitLength;
+  hal_pin_dir_t dir;
+  void *pin;
+  uint16_t sdo_idx;
+  uint8_t sdo_sidx;
+  long long poll_period;  ///< Time between requests (ns).
+  lcec_sdo_poll_t poll;   ///< Request polling state.
+  int written;            ///< `last` has been written successfully.
+  uint64_t last;          ///< Raw value of the last write.
+};
+
 int lcec_generic_init(int comp_id, struct lcec_slave *slave);
+uint64_t lcec_generic_sdo_encode(lcec_generic_sdo_pin_t *sdo_pin);
+void lcec_generic_sdo_decode(lcec_generic_sdo_pin_t *sdo_pin, uint64_t raw);
 
 #endif
@@ -20,15 +20,49 @@
 /// @brief Driver for "passive" devices with no PDOs.
 
 #include "lcec.h"
+#include "lcec_class_esc_health.h"
+
+#define M_HEALTH_POLL 0
+
+static int lcec_passive_init(int comp_id, lcec_slave_t *slave);
+
+static const lcec_modparam_desc_t lcec_passive_modparams[] = {
+    {"healthPollMs", M_HEALTH_POLL, MODPARAM_TYPE_U32, NULL, "Time between link and error counter readouts, in ms.  0 disables."},
+    {NULL},
+};
 
 static lcec_typelist_t types[] = {
     // bus coupler, no actual driver.
-    {"EK1100", LCEC_BECKHOFF_VID, 0x044C2C52, 0, NULL, NULL},
-    {"EK1101", LCEC_BECKHOFF_VID, 0x044D2C52, 0, NULL, NULL},
-    {"EK1110", LCEC_BECKHOFF_VID, 0x04562C52, 0, NULL, NULL},
-    {"EK1122", LCEC_BECKHOFF_VID, 0x04622C52, 0, NULL, NULL},
-    {"EP1122", LCEC_BECKHOFF_VID, 0x04624052, 0, NULL, NULL},
+    {"EK1100", LCEC_BECKHOFF_VID, 0x044C2C52, 0, NULL, lcec_passive_init, lcec_passive_modparams},
+    {"EK1101", LCEC_BECKHOFF_VID, 0x044D2C52, 0, NULL, lcec_passive_init, lcec_passive_modparams},
+    {"EK1110", LCEC_BECKHOFF_VID, 0x04562C52, 0, NULL, lcec_passive_init, lcec_passive_modparams},
+    {"EK1122", LCEC_BECKHOFF_VID, 0x04622C52, 0, NULL, lcec_passive_init, lcec_passive_modparams},
+    {"EP1122", LCEC_BECKHOFF_VID, 0x04624052, 0, NULL, lcec_passive_init, lcec_passive_modparams},
     {NULL},
 };
 
 ADD_TYPES(types);
+
+static void lcec_passive_read(lcec_slave_t *slave, long period);
+
+/// @brief Set up the optional health readout.  There's nothing else to initialize.
+static int lcec_passive_init(int comp_id, lcec_slave_t *slave) {
+  LCEC_CONF_MODPARAM_VAL_T *pval;
+
+  pval = lcec_modparam_get(slave, M_HEALTH_POLL);
+  if (pval == NULL || pval->u32 == 0) {
+    return 0;
+  }
+
+  slave->hal_data = lcec_esc_health_init(slave, (long long)pval->u32 * 1000000LL);
+  if (slave->hal_data == NULL) {
+    return -EIO;
+  }
+  slave->proc_read = lcec_passive_read;
+
+  return 0;
+}
+
+static void lcec_passive_read(lcec_slave_t *slave, long period) {
+  lcec_esc_health_run(slave, (lcec_class_esc_health_t *)slave->hal_data, period);
+}
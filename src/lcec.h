@@ -72,6 +72,21 @@ extern "C" {
 // State update period (ns)
 #define LCEC_STATE_UPDATE_PERIOD 1000000000LL
 
+// Cycles averaged by the `rx-wait-avg` pin
+#define LCEC_RX_WAIT_AVG_CYCLES 1000.0
+
+// Consecutive `receiveDeadline` misses before `read` stops waiting
+#define LCEC_RX_DEADLINE_MISS_LIMIT 10
+
+// Time between receives while waiting for `receiveDeadline` (ns)
+#define LCEC_RX_POLL_NS 20000
+
+// Largest `failover-lost-cycles` value; longer outages stop counting here
+#define LCEC_RX_LOST_RUN_LIMIT 1000000
+
+// Network devices per master, main and backup
+#define LCEC_MAX_LINKS 2
+
 // IDN builder
 #define LCEC_IDN_TYPE_P 0x8000
 #define LCEC_IDN_TYPE_S 0x0000
@@ -105,7 +120,7 @@ extern "C" {
 #define LCEC_HAL_ALLOCATE_STRING(len) ((char *)lcec_hal_malloc(len, __FILE__, __func__, __LINE__))
 
 /// Allocate memory for an array of `count` `expr`s.  This zeros out the allocated memory automatically, and exits if malloc fails.
-#define LCEC_HAL_ALLOCATE_ARRAY(expr, count) ((__typeof__(expr) *)lcec_hal_malloc(sizeof(expr) * count, __FILE__, __func__, __LINE__))
+#define LCEC_HAL_ALLOCATE_ARRAY(expr, count) ((__typeof__(expr) *)lcec_hal_malloc(sizeof(expr) * (count), __FILE__, __func__, __LINE__))
 
 /// Allocate memory for an `expr`.  This zeros out the allocated memory automatically, and exits if malloc fails.
 #define LCEC_ALLOCATE(expr) ((__typeof__(expr) *)lcec_malloc(sizeof(expr), __FILE__, __func__, __LINE__))
@@ -114,15 +129,91 @@ extern "C" {
 #define LCEC_ALLOCATE_STRING(len) ((char *)lcec_malloc(len, __FILE__, __func__, __LINE__))
 
 /// Allocate memory for an array of `count` `expr`s.  This zeros out the allocated memory automatically, and exits if malloc fails.
-#define LCEC_ALLOCATE_ARRAY(expr, count) ((__typeof__(expr) *)lcec_malloc(sizeof(expr) * count, __FILE__, __func__, __LINE__))
+#define LCEC_ALLOCATE_ARRAY(expr, count) ((__typeof__(expr) *)lcec_malloc(sizeof(expr) * (count), __FILE__, __func__, __LINE__))
+
+/// Allocate an `expr` from `pool`.  This zeros out the allocated memory automatically, and exits if malloc fails.
+#define LCEC_POOL_ALLOCATE(pool, expr) \
+  ((__typeof__(expr) *)lcec_pool_alloc(pool, sizeof(expr), __alignof__(expr), __FILE__, __func__, __LINE__))
+
+/// Allocate an array of `count` `expr`s from `pool`.  This zeros out the allocated memory automatically, and exits if malloc fails.
+#define LCEC_POOL_ALLOCATE_ARRAY(pool, expr, count) \
+  ((__typeof__(expr) *)lcec_pool_alloc(pool, sizeof(expr) * (count), __alignof__(expr), __FILE__, __func__, __LINE__))
+
+#define LCEC_POOL_ALIGN      64    ///< Alignment of hot structs, one cache line.
+#define LCEC_POOL_CHUNK_SIZE 2048  ///< HAL memory a pool takes at a time, unless the pool sets `chunk_size`.
+#define LCEC_HOT_CHUNK_SIZE  8192  ///< Chunk size of `lcec_hot_pool`.  Holds several of the largest hot structs.
+
+/// @brief A pool of HAL memory for data used every cycle.
+///
+/// Blocks are zeroed, aligned for their type, and follow each other in
+/// the order they were allocated, so channels registered one after
+/// another share cache lines and pages instead of being spread over
+/// HAL memory.  Only hot structs, see `LCEC_HOT`, start on a cache
+/// line.  Pools take `chunk_size` bytes of HAL memory at a time
+/// and never give anything back.  A zeroed `lcec_pool_t`, usually a
+/// static variable, is an empty pool with `LCEC_POOL_CHUNK_SIZE`
+/// chunks.
+typedef struct {
+  uint8_t *next;      ///< Next free byte in the current chunk.
+  size_t left;        ///< Bytes left in the current chunk.
+  size_t chunk_size;  ///< HAL memory taken at a time, or 0 for `LCEC_POOL_CHUNK_SIZE`.
+} lcec_pool_t;
+
+// Hot/cold split of driver data.
+//
+// Whatever a driver's read and write functions use every cycle, like
+// pin pointers, PDO offsets, and running state, goes into a "hot"
+// struct declared as `typedef struct LCEC_HOT {...}` and allocated
+// with `LCEC_HOT_ALLOCATE()`.  Whatever is only needed in `_init`,
+// like SDO readings, options, names, and pins that are only set once,
+// stays out of it: on the stack if `_init` is the only user, or in a
+// separate "cold" struct, allocated with `LCEC_HAL_ALLOCATE()` if it
+// holds pins and with `LCEC_ALLOCATE()` otherwise.  Hot structs start
+// on a cache line, and `LCEC_HOT_ASSERT_LINES()` keeps them from
+// quietly growing.  Never embed a hot struct in anything else, or
+// allocate one any other way, as the compiler relies on the
+// alignment.
+
+/// Declare a hot struct: `typedef struct LCEC_HOT {...} foo_t;`.
+#define LCEC_HOT __attribute__((aligned(LCEC_POOL_ALIGN)))
+
+/// Allocate a hot struct.  This zeros out the allocated memory automatically, and exits if malloc fails.
+#define LCEC_HOT_ALLOCATE(expr) LCEC_POOL_ALLOCATE(&lcec_hot_pool, expr)
+
+/// The number of cache lines that a `type` covers.
+#define LCEC_HOT_LINES(type) ((sizeof(type) + LCEC_POOL_ALIGN - 1) / LCEC_POOL_ALIGN)
+
+/// Fail the build if `type` covers more than `lines` cache lines.
+#define LCEC_HOT_ASSERT_LINES(type, lines) _Static_assert(LCEC_HOT_LINES(type) <= (lines), #type " covers more than " #lines " cache lines")
+
+/// @brief The pool for `LCEC_HOT_ALLOCATE()`, shared by all drivers.
+///
+/// Drivers are set up in bus order, so this keeps each slave's hot
+/// data next to its neighbors', in the order the cyclic functions
+/// visit them.
+extern lcec_pool_t lcec_hot_pool;
 
 typedef struct lcec_master lcec_master_t;
 typedef struct lcec_slave lcec_slave_t;
 
+#define LCEC_MEM_PIN_HAL_BYTES   88  ///< HAL memory used by `hal_pin_new()` for each pin, approximately.
+#define LCEC_MEM_PARAM_HAL_BYTES 72  ///< HAL memory used by `hal_param_new()` for each param, approximately.
+
+/// @brief Memory used by a master or a slave, see `lcec_mem_track()`.
+typedef struct {
+  size_t hal_bytes;     ///< Bytes from `lcec_hal_malloc()`.
+  size_t heap_bytes;    ///< Bytes from `lcec_malloc()`.
+  unsigned int pins;    ///< Pins exported.
+  unsigned int params;  ///< Params exported.
+  size_t pool_unused;   ///< Bytes of pool chunks not handed out, only counted in `lcec_mem_total()`.
+} lcec_mem_usage_t;
+typedef struct lcec_generic_sdo_pin lcec_generic_sdo_pin_t;
+
 typedef int (*lcec_slave_preinit_t)(lcec_slave_t *slave);
 typedef int (*lcec_slave_init_t)(int comp_id, lcec_slave_t *slave);
 typedef void (*lcec_slave_cleanup_t)(lcec_slave_t *slave);
 typedef void (*lcec_slave_rw_t)(lcec_slave_t *slave, long period);
+typedef int (*lcec_slave_pdo_check_t)(lcec_slave_t *slave);
 
 typedef enum {
   MODPARAM_TYPE_BIT,    ///< Modparam value is a single bit.
@@ -171,6 +262,126 @@ typedef struct {
   int data_channels;    ///< Number of data channels.
 } LCEC_CONF_FSOE_T;
 
+#define LCEC_LOG_RING_SIZE   256           ///< Records per master log ring.  Must be a power of 2.
+#define LCEC_LOG_MAX_ARGS    4             ///< Maximum number of integer arguments per log record.
+#define LCEC_LOG_RATE_PERIOD 1000000000LL  ///< Rate-limit window for log records (ns).
+#define LCEC_LOG_RATE_BURST  4             ///< Records per message ID and slave per window before further ones are suppressed.
+
+/// @brief Message IDs for the realtime log ring.
+///
+/// Each ID maps to a level and a format string in `lcec_log.c`.  The
+/// format string is only used by the reader, so realtime code never
+/// formats text.  Format strings may use up to `LCEC_LOG_MAX_ARGS`
+/// 32-bit integer conversions.
+typedef enum {
+  LCEC_LOG_APP_TIME_PERIOD,    ///< appTimePeriod doesn't match the thread period.
+  LCEC_LOG_MASTER_LINK,        ///< Master link state changed.
+  LCEC_LOG_MASTER_AL_STATES,   ///< Combined AL state of all slaves changed.
+  LCEC_LOG_SLAVE_ONLINE,       ///< Slave came online.
+  LCEC_LOG_SLAVE_OFFLINE,      ///< Slave went offline.
+  LCEC_LOG_SLAVE_AL_STATE,     ///< Slave AL state changed.
+  LCEC_LOG_DEMS300_OPMODE,     ///< DEMS300 isn't reporting velocity mode.
+  LCEC_LOG_DC_CALIB_RESULT,    ///< SYNC0 shift calibration finished.
+  LCEC_LOG_DC_CALIB_APPLIED,   ///< Calibrated SYNC0 shift written to the slave.
+  LCEC_LOG_DC_CALIB_TOO_LATE,  ///< Calibrated SYNC0 shift not written, the slave was already in OP.
+  LCEC_LOG_DC_CALIB_ERROR,     ///< SYNC0 shift calibration register access failed.
+  LCEC_LOG_SDO_PIN_ERROR,      ///< A generic SDO pin request failed.
+  LCEC_LOG_TELEMETRY_ERROR,    ///< A telemetry SDO read failed.
+  LCEC_LOG_LINK_STATE,         ///< Link state of one of the master's network devices changed.
+  LCEC_LOG_REDUNDANCY,         ///< Process data switched to or from the backup path.
+  LCEC_LOG_ID_COUNT,
+} lcec_log_id_t;
+
+/// @brief A single binary log record.
+typedef struct {
+  uint16_t id;                       ///< `lcec_log_id_t` of this record.
+  int16_t slave;                     ///< Slave index, or -1 for master-level records.
+  uint32_t suppressed;               ///< Number of records with this ID suppressed by rate limiting before this one.
+  long long timestamp;               ///< `rtapi_get_time()` when the record was created.
+  int32_t args[LCEC_LOG_MAX_ARGS];  ///< Format arguments.
+} lcec_log_record_t;
+
+/// @brief Single-producer, single-consumer log ring for one master.
+///
+/// The realtime thread only ever writes `head`, and the reader only
+/// ever writes `tail`, so no locking is needed.
+typedef struct {
+  char master_name[LCEC_CONF_STR_MAXLEN];         ///< Master name, for the reader.
+  uint32_t head;                                  ///< Next record to write.  Written by realtime code.
+  uint32_t tail;                                  ///< Next record to read.  Written by the reader.
+  uint32_t dropped;                               ///< Records dropped because the ring was full.
+  uint32_t dropped_reported;                      ///< Value of `dropped` last reported.  Written by the reader.
+  lcec_log_record_t records[LCEC_LOG_RING_SIZE];  ///< Record storage.
+} lcec_log_ring_t;
+
+/// @brief Re-init counter for one slave.
+///
+/// Realtime code counts each time the slave re-enters OP, so the
+/// reader can re-apply a reloaded config.  Unlike log records, counts
+/// are never rate limited or dropped.
+typedef struct {
+  int master;      ///< Master index, in configuration order.  Written by the reader before startup.
+  int slave;       ///< Slave index.  Written by the reader before startup.
+  uint32_t count;  ///< Times the slave entered OP.  Written by realtime code.
+  uint32_t seen;   ///< Value of `count` last handled.  Written by the reader.
+} lcec_slave_reinit_t;
+
+/// @brief Header of the log shared memory segment, followed by
+/// `ring_count` rings and `slave_count` re-init counters.
+typedef struct {
+  uint32_t magic;
+  int ring_count;
+  int slave_count;
+} lcec_log_header_t;
+
+/// @brief Per-ID and per-slave rate-limiting state, private to the realtime side.
+typedef struct {
+  long long window_start;  ///< Start of the current rate-limit window.
+  uint32_t count;          ///< Records emitted in the current window.
+  uint32_t suppressed;     ///< Records suppressed since the last emitted one.
+} lcec_log_limit_t;
+
+#define LCEC_TRACE_MAX_RECORDS 4096  ///< Startup trace capacity.
+
+/// @brief Startup stages recorded by `lcec_trace_add()`.
+typedef enum {
+  LCEC_TRACE_PARSE_CONFIG,    ///< Reading the config from `lcec_conf`, including all preinits.
+  LCEC_TRACE_PREINIT,         ///< A slave's `proc_preinit`.
+  LCEC_TRACE_REQUEST_MASTER,  ///< `ecrt_request_master()` and domain creation.
+  LCEC_TRACE_SLAVE_CONFIG,    ///< `ecrt_master_slave_config()`.
+  LCEC_TRACE_SDO_IDN,         ///< Queuing startup SDOs and IDNs.
+  LCEC_TRACE_PROC_INIT,       ///< A slave's `proc_init`.
+  LCEC_TRACE_PDO_CONFIG,      ///< `ecrt_slave_config_pdos()` and the slave's state pins.
+  LCEC_TRACE_DOMAIN_REG,      ///< PDO entry registration for a master.
+  LCEC_TRACE_ACTIVATE,        ///< `ecrt_master_activate()`.
+  LCEC_TRACE_WAIT_OP,         ///< From master activation until the slave is operational.
+  LCEC_TRACE_MASTER_OP,       ///< From master activation until all of its slaves are operational.
+  LCEC_TRACE_STAGE_COUNT,
+} lcec_trace_stage_t;
+
+/// @brief A single startup trace record.
+typedef struct {
+  uint16_t valid;      ///< Set last, once the record is complete.
+  uint16_t stage;      ///< `lcec_trace_stage_t` of this record.
+  int16_t master;      ///< Position of the master in the config, or -1.
+  int16_t slave;       ///< Slave index, or -1.
+  long long start;     ///< `rtapi_get_time()` at the start of the stage.
+  long long duration;  ///< Duration of the stage (ns).
+} lcec_trace_record_t;
+
+/// @brief Startup trace shared memory, created by `lcec_conf`.
+typedef struct {
+  uint32_t magic;
+  uint32_t count;                                       ///< Records claimed so far, may exceed `LCEC_TRACE_MAX_RECORDS`.
+  lcec_trace_record_t records[LCEC_TRACE_MAX_RECORDS];  ///< Record storage.
+} lcec_trace_t;
+
+/// @brief Per-link HAL pins for masters with a backup device.
+typedef struct {
+  hal_bit_t *link_up;            ///< The device has a link.
+  hal_u32_t *slaves_responding;  ///< Slaves responding on this device.
+} lcec_master_link_data_t;
+
 typedef struct lcec_master_data {
   hal_u32_t *slaves_responding;
   hal_bit_t *state_init;
@@ -179,6 +390,12 @@ typedef struct lcec_master_data {
   hal_bit_t *state_op;
   hal_bit_t *link_up;
   hal_bit_t *all_op;
+  hal_u32_t *rx_deadline_misses;                  ///< Cycles where the domain wasn't complete by `receiveDeadline`.
+  hal_s32_t *rx_wait_avg;                         ///< Average time spent waiting for the domain (ns).
+  hal_bit_t *redundancy_active;                   ///< Process data is using the backup path.
+  hal_u32_t *failovers;                           ///< Switches to the backup path.
+  hal_u32_t *failover_lost_cycles;                ///< Cycles without complete process data around the last switch.
+  lcec_master_link_data_t links[LCEC_MAX_LINKS];  ///< Per-device state, if there's a backup device.
 #ifdef RTAPI_TASK_PLL_SUPPORT
   hal_s32_t *pll_err;
   hal_s32_t *pll_out;
@@ -210,6 +427,10 @@ typedef struct lcec_master {
   int process_data_len;
   lcec_slave_t *first_slave;
   lcec_slave_t *last_slave;
+  lcec_slave_t **slaves_by_index;   ///< Slaves by ring position, NULL for unused positions.  See `lcec_index_slaves()`.
+  int slaves_by_index_len;          ///< Length of `slaves_by_index`.
+  lcec_slave_t **slaves_by_name;    ///< Slaves sorted by name.
+  int slave_count;                  ///< Length of `slaves_by_name`.
   lcec_master_data_t *hal_data;
   uint64_t app_time_base;
   uint32_t app_time_period;
@@ -218,6 +439,26 @@ typedef struct lcec_master {
   int sync_ref_cycles;
   long long state_update_timer;
   ec_master_state_t ms;
+  lcec_log_ring_t *log;                            ///< Deferred log ring, or NULL to print directly.
+  lcec_log_limit_t log_limits[LCEC_LOG_ID_COUNT];  ///< Log rate-limiting state for master-level records.
+  LCEC_CONF_DC_CALIBRATE_T dc_calib_mode;          ///< SYNC0 shift calibration mode.
+  int dc_calib_samples;                            ///< Frame arrival samples per slave.
+  int32_t dc_calib_margin;                         ///< Wanted time between frame arrival and SYNC0 (ns), or 0 for 10% of the cycle.
+  int32_t rx_deadline;                             ///< Time to wait for a complete domain in `read` (ns), or 0.
+  double rx_wait_avg;                              ///< Running average of the receive wait (ns).
+  int rx_miss_run;                                 ///< Consecutive cycles that missed `rx_deadline`.
+  int scales_checked;                              ///< `read` checked the watched scales since the last `write`.
+  long long trace_op_start;                        ///< Master activation time, while slaves are still on their way to OP.
+  int trace_op_pending;                            ///< Slaves that haven't reached OP yet since activation.
+  int link_count;                                  ///< Network devices, 2 with a backup device.
+  int rx_lost_run;                                 ///< Consecutive cycles without complete process data.
+  int failover_pending;                            ///< Redundancy switched, waiting for complete process data.
+  lcec_mem_usage_t mem;                            ///< Memory used by the master and its slaves.
+  uint32_t hal_mem_budget;                         ///< Warn when `mem` needs more HAL memory than this (bytes), or 0.
+  int hal_mem_budget_warned;                       ///< The budget warning has been printed.
+#ifdef EC_HAVE_REDUNDANCY
+  ec_master_link_state_t link_states[LCEC_MAX_LINKS];  ///< Last state of each device.
+#endif
 #ifdef RTAPI_TASK_PLL_SUPPORT
   uint64_t dc_ref;
   uint32_t app_time_last;
@@ -270,6 +511,53 @@ typedef struct {
   LCEC_CONF_MODPARAM_VAL_T value;  /// The value set in `<modparam name="..." value="..."/>`
 } lcec_slave_modparam_t;
 
+/// @brief SYNC0 shift calibration state, private to `lcec_dc_calib.c`.
+typedef struct lcec_dc_calib lcec_dc_calib_t;
+
+/// @brief A watched HAL scale pin, see `lcec_scale_watch()`.
+typedef struct lcec_scale {
+  struct lcec_scale *next;  ///< Next watched scale on this slave.
+  hal_float_t *scale;       ///< The scale pin or param.
+  double old;               ///< The value of `*scale` when `recip` was computed.
+  double recip;             ///< `1.0 / *scale`.
+} lcec_scale_t;
+
+#define LCEC_FSOE_DIAG_BUCKETS 8  ///< Exchange histogram buckets: 1, 2, 3-4, 5-8, 9-16, 17-32, 33-64, and more cycles.
+
+/// @brief FSoE connection diagnostics, see `lcec_fsoe_diag_init()`.
+typedef struct {
+  hal_u32_t *exchange_cycles;                  ///< Cycles between the last two master frames.
+  hal_u32_t *exchange_cycles_max;              ///< Longest exchange since reset, including one still in progress.
+  hal_u32_t *slave_cycles;                     ///< Cycles from the last master frame until the slave answered.
+  hal_u32_t *stalls;                           ///< Exchanges that used more than half of the watchdog time.
+  hal_u32_t *watchdog_ms;                      ///< FSoE watchdog time, as configured in the safety project.
+  hal_float_t *watchdog_margin_ms;             ///< Watchdog time left over by the longest exchange.
+  hal_bit_t *reset;                            ///< Clears max, stalls, and the histogram on a rising edge.
+  hal_u32_t *hist[LCEC_FSOE_DIAG_BUCKETS];     ///< Exchange length histogram.
+  uint32_t master_sig;                         ///< Command and first CRC of the last master frame.
+  uint32_t slave_sig;                          ///< Command and first CRC of the last slave frame.
+  uint32_t since_master;                       ///< Cycles since the master frame last changed.
+  int started;                                 ///< At least one master frame has been seen.
+  int waiting;                                 ///< The slave hasn't answered the last master frame yet.
+  int stalled;                                 ///< The current exchange has already been counted as a stall.
+  int reset_old;                               ///< Previous value of `reset`.
+} lcec_fsoe_diag_t;
+
+/// @brief Background polling state of one SDO request, see `lcec_sdo_poll()`.
+typedef struct {
+  ec_sdo_request_t *req;  ///< The request, or NULL if there is none.
+  int busy;               ///< A transfer is in flight.
+  long long wait;         ///< Time until the next transfer (ns).
+} lcec_sdo_poll_t;
+
+/// @brief What `lcec_sdo_poll()` wants the caller to do next.
+typedef enum {
+  LCEC_SDO_POLL_IDLE,   ///< Nothing, this cycle.
+  LCEC_SDO_POLL_DONE,   ///< The last transfer succeeded.  For reads, the value is in `ecrt_sdo_request_data()`.
+  LCEC_SDO_POLL_ERROR,  ///< The last transfer failed.
+  LCEC_SDO_POLL_DUE,    ///< Start the next transfer with `lcec_sdo_poll_start()`, or set `wait` to skip it.
+} lcec_sdo_poll_result_t;
+
 /// @brief EtherCAT slave.
 typedef struct lcec_slave {
   lcec_slave_t *prev;                        ///< Next slave
@@ -289,12 +577,15 @@ typedef struct lcec_slave {
   lcec_slave_cleanup_t proc_cleanup;         ///< Calback for cleaning up the device.
   lcec_slave_rw_t proc_read;                 ///< Callback for reading from the device.
   lcec_slave_rw_t proc_write;                ///< Callback for writing to the device.
+  lcec_slave_pdo_check_t proc_pdo_check;     ///< Callback for checking PDO offsets once they are registered, if any.
   lcec_slave_state_t *hal_state_data;        ///< HAL state data.
   void *hal_data;                            ///< HAL data, device driver specific.
   int generic_pdo_entry_count;               ///< The number of generic PDO entries.
   ec_pdo_entry_info_t *generic_pdo_entries;  ///< Generic PDO entries.
   ec_pdo_info_t *generic_pdos;               ///< Generic PDOs.
   ec_sync_info_t *generic_sync_managers;     ///< Generic sync managers.
+  int generic_sdo_pin_count;                 ///< The number of generic SDO pins.
+  lcec_generic_sdo_pin_t *generic_sdo_pins;  ///< Generic SDO pins.
   lcec_slave_sdoconf_t *sdo_config;          ///< SDO config.
   lcec_slave_idnconf_t *idn_config;          ///< IDN config.
   lcec_slave_modparam_t *modparams;          ///< modParams.
@@ -304,6 +595,15 @@ typedef struct lcec_slave {
   unsigned int *fsoe_master_offset;          ///< FSoE master offset.
   uint64_t flags;                            ///< Flags, as defined by the driver itself.
   lcec_pdo_entry_reg_t *regs;
+  lcec_scale_t *scales;                      ///< Watched scales, checked once per cycle.
+  unsigned int scale_epoch;                  ///< Incremented whenever a watched scale changes.
+  lcec_fsoe_diag_t *fsoe_diag;               ///< FSoE connection diagnostics, if enabled.
+  lcec_dc_calib_t *dc_calib;                 ///< SYNC0 shift calibration, if enabled.
+  long long trace_op_start;                  ///< Master activation time, until this slave reaches OP.
+  int disabled;                              ///< Set by `enabled="false"`: pins only, no bus access.
+  lcec_mem_usage_t mem;                      ///< Memory used by this slave's driver.
+  uint32_t *reinit_count;                    ///< Re-init counter in the log segment, or NULL.
+  lcec_log_limit_t log_limits[LCEC_LOG_ID_COUNT];  ///< Log rate-limiting state for this slave's records.
 } lcec_slave_t;
 
 /// @brief HAL pin description.
@@ -355,7 +655,27 @@ typedef struct {
   const double value;
 } lcec_lookuptable_double_t;
 
+/// @brief Hooks for running driver setup without HAL or an EtherCAT bus.
+///
+/// Used by `lcec_conf --check`, by config reloads, and for slaves
+/// with `enabled="false"`.  While
+/// `lcec_dry_run` is set, HAL memory, pins, and params go to these
+/// hooks instead of HAL, SDO and IDN reads return zeros, and SDO
+/// writes go to `sdo_write`, or are skipped if it is NULL.
+typedef struct {
+  void *(*hal_malloc)(size_t size);                                                             ///< Allocate zeroed "HAL" memory.
+  int (*pin_new)(const char *name, hal_type_t type, hal_pin_dir_t dir, void **data_ptr_addr);  ///< Create a pin.
+  int (*param_new)(const char *name, hal_type_t type, hal_param_dir_t dir, void *data_addr);   ///< Create a param.
+  void (*limit_exceeded)(lcec_slave_t *slave, const char *what);                               ///< A `LCEC_MAX_*` limit was hit.
+  int (*sdo_write)(lcec_slave_t *slave, uint16_t index, uint8_t subindex, const uint8_t *value, size_t size,
+      const char *mpname);  ///< An SDO write, with the modParam that caused it or NULL.  Optional.
+} lcec_dry_run_t;
+
+extern const lcec_dry_run_t *lcec_dry_run;
+
 lcec_slave_t *lcec_slave_by_index(lcec_master_t *master, int index) __attribute__((nonnull));
+lcec_slave_t *lcec_slave_by_name(lcec_master_t *master, const char *name) __attribute__((nonnull));
+void lcec_index_slaves(lcec_master_t *master) __attribute__((nonnull));
 
 int lcec_read_sdo(lcec_slave_t *slave, uint16_t index, uint8_t subindex, uint8_t *target, size_t size);
 int lcec_read_sdo8(lcec_slave_t *slave, uint16_t index, uint8_t subindex, uint8_t *result);
@@ -382,6 +702,15 @@ int lcec_param_newf(hal_type_t type, hal_param_dir_t dir, void *data_addr, const
 int lcec_param_newf_list(void *base, const lcec_paramdesc_t *list, ...);
 
 void copy_fsoe_data(lcec_slave_t *slave, unsigned int slave_offset, unsigned int master_offset) __attribute__((nonnull));
+int lcec_fsoe_diag_init(lcec_slave_t *slave) __attribute__((nonnull));
+lcec_sdo_poll_result_t lcec_sdo_poll(lcec_slave_t *slave, lcec_sdo_poll_t *poll, long long poll_period, long period, int *started)
+    __attribute__((nonnull));
+void lcec_sdo_poll_start(lcec_sdo_poll_t *poll, int write, int *started) __attribute__((nonnull));
+int lcec_create_sdo_request(lcec_slave_t *slave, uint16_t index, uint8_t subindex, size_t size, ec_sdo_request_t **req)
+    __attribute__((nonnull));
+int lcec_create_reg_request(lcec_slave_t *slave, size_t size, ec_reg_request_t **req) __attribute__((nonnull));
+void lcec_read_bits(const uint8_t *pd, unsigned int os, unsigned int bp, hal_bit_t *const *pins, int count);
+void lcec_write_bits(uint8_t *pd, unsigned int os, unsigned int bp, hal_bit_t *const *pins, int count);
 void lcec_syncs_init(lcec_slave_t *slave, lcec_syncs_t *syncs) __attribute__((nonnull));
 void lcec_syncs_enable_autoflow(lcec_slave_t *slave, lcec_syncs_t *syncs, int pdo_limit, int pdo_entry_limit, int pdo_increment);
 void lcec_syncs_add_sync(lcec_syncs_t *syncs, ec_direction_t dir, ec_watchdog_mode_t watchdog_mode);
@@ -405,9 +734,39 @@ lcec_modparam_desc_t *lcec_modparam_desc_merge_docs(lcec_modparam_desc_t const *
 lcec_pdo_entry_reg_t *lcec_allocate_pdo_entry_reg(int size);
 int lcec_pdo_init(lcec_slave_t *slave, uint16_t idx, uint16_t sidx, unsigned int *os, unsigned int *bp);
 int lcec_pdo_entry_reg_len(lcec_pdo_entry_reg_t *reg);
+
+lcec_scale_t *lcec_scale_watch(lcec_slave_t *slave, hal_float_t *scale);
+void lcec_scale_update(lcec_slave_t *slave);
 int lcec_append_pdo_entry_reg(lcec_pdo_entry_reg_t *dest, lcec_pdo_entry_reg_t *src);
 
 void *lcec_hal_malloc(size_t size, const char *file, const char *func, int line);
 void *lcec_malloc(size_t size, const char *file, const char *func, int line);
+void *lcec_pool_alloc(lcec_pool_t *pool, size_t size, size_t align, const char *file, const char *func, int line);
+void lcec_mem_track(lcec_master_t *master, lcec_slave_t *slave);
+void lcec_mem_charge(size_t hal_bytes, size_t heap_bytes, unsigned int pins, unsigned int params);
+size_t lcec_mem_hal_estimate(const lcec_mem_usage_t *mem) __attribute__((nonnull));
+const lcec_mem_usage_t *lcec_mem_total(void);
+void lcec_mem_report(lcec_master_t *first_master);
+
+int lcec_dc_calib_init(lcec_slave_t *slave) __attribute__((nonnull));
+void lcec_dc_calib_run(lcec_slave_t *slave) __attribute__((nonnull));
+int32_t lcec_dc_calib_lead(uint64_t sync0, uint64_t sys_time, uint32_t cycle);
+
+int lcec_parse_conf_tokens(char *conf, lcec_master_t **first_master, lcec_master_t **last_master);
+int lcec_preinit_slaves(lcec_master_t *first_master);
+
+void lcec_log_master(lcec_master_t *master, lcec_log_id_t id, int32_t a0, int32_t a1, int32_t a2, int32_t a3) __attribute__((nonnull));
+void lcec_log_slave(lcec_slave_t *slave, lcec_log_id_t id, int32_t a0, int32_t a1, int32_t a2, int32_t a3) __attribute__((nonnull));
+void lcec_log_slave_reinit(lcec_slave_t *slave, const ec_slave_config_state_t *last) __attribute__((nonnull));
+int lcec_log_attach(lcec_master_t *first_master);
+void lcec_log_detach(void);
+size_t lcec_log_shmem_size(int ring_count, int slave_count);
+int lcec_log_pop(lcec_log_ring_t *ring, lcec_log_record_t *rec) __attribute__((nonnull));
+int lcec_log_format(const lcec_log_record_t *rec, const char *master_name, const char *slave_name, char *buf, size_t len);
+
+int lcec_trace_attach(void);
+void lcec_trace_detach(void);
+long long lcec_trace_start(void);
+void lcec_trace_add(lcec_master_t *master, lcec_slave_t *slave, lcec_trace_stage_t stage, long long start);
 
 #endif
@@ -22,11 +22,14 @@
 #include "lcec_conf.h"
 
 #include <ctype.h>
+#include <errno.h>
 #include <expat.h>
+#include <poll.h>
 #include <signal.h>
 #include <stdio.h>
 #include <string.h>
 #include <sys/eventfd.h>
+#include <sys/wait.h>
 #include <unistd.h>
 
 #include "hal.h"
@@ -35,16 +38,38 @@
 #include "lcec_rtapi.h"
 #include "rtapi.h"
 
+#define LCEC_CONF_LOG_POLL_MS 100
+
 typedef struct {
   hal_u32_t *master_count;
   hal_u32_t *slave_count;
 } LCEC_CONF_HAL_T;
 
+typedef struct LCEC_CONF_LOG_NAME {
+  int master;
+  int slave;
+  char name[LCEC_CONF_STR_MAXLEN];
+  struct LCEC_CONF_LOG_NAME *next;
+} LCEC_CONF_LOG_NAME_T;
+
+typedef struct LCEC_CONF_RESTORE {
+  int master;
+  int slave;
+  struct LCEC_CONF_RESTORE *next;
+} LCEC_CONF_RESTORE_T;
+
 static int hal_comp_id;
 static LCEC_CONF_HAL_T *conf_hal_data;
 static int shmem_id;
+static int log_shmem_id;
+static lcec_log_header_t *log_header;
+static LCEC_CONF_LOG_NAME_T *log_names;
 
 static int exitEvent;
+static int reloadEvent;
+static char *startup_conf;
+static char *active_conf;
+static LCEC_CONF_RESTORE_T *restore_slaves;
 
 typedef struct {
   LCEC_CONF_XML_INST_T xml;
@@ -58,12 +83,15 @@ typedef struct {
   LCEC_CONF_IDNCONF_T *currIdnConf;
   LCEC_CONF_PDOENTRY_T *currPdoEntry;
   uint8_t currComplexBitOffset;
+  int currSlaveRepeat;
+  size_t currSlaveEnd;
 
   LCEC_CONF_OUTBUF_T outputBuf;
 } LCEC_CONF_XML_STATE_T;
 
 static void parseMasterAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char **attr);
 static void parseSlaveAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char **attr);
+static void parseSlaveEnd(LCEC_CONF_XML_INST_T *inst, int next);
 static void parseDcConfAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char **attr);
 static void parseWatchdogAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char **attr);
 static void parseSdoConfigAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char **attr);
@@ -75,11 +103,13 @@ static void parsePdoAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char **att
 static void parsePdoEntryAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char **attr);
 static void parseComplexEntryAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char **attr);
 static void parseModParamAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char **attr);
+static void parseSdoPinAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char **attr);
 
 static const LCEC_CONF_XML_HANLDER_T xml_states[] = {
     {"masters", lcecConfTypeNone, lcecConfTypeMasters, NULL, NULL},
     {"master", lcecConfTypeMasters, lcecConfTypeMaster, parseMasterAttrs, NULL},
-    {"slave", lcecConfTypeMaster, lcecConfTypeSlave, parseSlaveAttrs, NULL},
+    {"slaveTemplate", lcecConfTypeMasters, lcecConfTypeSlave, parseSlaveAttrs, parseSlaveEnd},
+    {"slave", lcecConfTypeMaster, lcecConfTypeSlave, parseSlaveAttrs, parseSlaveEnd},
     {"dcConf", lcecConfTypeSlave, lcecConfTypeDcConf, parseDcConfAttrs, NULL},
     {"watchdog", lcecConfTypeSlave, lcecConfTypeWatchdog, parseWatchdogAttrs, NULL},
     {"sdoConfig", lcecConfTypeSlave, lcecConfTypeSdoConfig, parseSdoConfigAttrs, NULL},
@@ -92,10 +122,21 @@ static const LCEC_CONF_XML_HANLDER_T xml_states[] = {
     {"pdoEntry", lcecConfTypePdo, lcecConfTypePdoEntry, parsePdoEntryAttrs, NULL},
     {"complexEntry", lcecConfTypePdoEntry, lcecConfTypeComplexEntry, parseComplexEntryAttrs, NULL},
     {"modParam", lcecConfTypeSlave, lcecConfTypeModParam, parseModParamAttrs, NULL},
+    {"sdoPin", lcecConfTypeSlave, lcecConfTypeSdoPin, parseSdoPinAttrs, NULL},
     {"NULL", -1, -1, NULL, NULL},
 };
 
 static int parseSyncCycle(LCEC_CONF_XML_STATE_T *state, const char *nptr);
+static void addLogName(int master, int slave, const char *name);
+static int initLogRings(void);
+static void drainLogRings(void);
+static void freeLogNames(void);
+static int parseConfigFile(LCEC_CONF_XML_STATE_T *state, const char *filename);
+static int checkConfigFile(const char *filename);
+static void reloadConfigFile(const char *filename);
+static void addRestoreSlave(int master, int slave);
+static void restoreSlaves(void);
+static int sendReload(void);
 
 static void exitHandler(int sig) {
   uint64_t u = 1;
@@ -104,17 +145,43 @@ static void exitHandler(int sig) {
   }
 }
 
+static void reloadHandler(int sig) {
+  uint64_t u = 1;
+  if (write(reloadEvent, &u, sizeof(uint64_t)) < 0) {
+    fprintf(stderr, "%s: ERROR: error writing reload event\n", modname);
+  }
+}
+
 int main(int argc, char **argv) {
   int ret = 1;
-  char *filename;
-  int done;
-  char buffer[BUFFSIZE];
-  FILE *file;
-  LCEC_CONF_NULL_T *end;
+  const char *filename;
+  const char *trace_file = NULL;
   char *shmem_ptr;
   LCEC_CONF_HEADER_T *header;
   uint64_t u;
   LCEC_CONF_XML_STATE_T state;
+  struct pollfd pfd[2];
+  int res;
+
+  // get config file name
+  if (argc == 3 && strcmp(argv[1], "--check") == 0) {
+    return checkConfigFile(argv[2]);
+  }
+  if (argc == 2 && strcmp(argv[1], "--reload") == 0) {
+    return sendReload();
+  }
+  if (argc == 4 && strcmp(argv[1], "--trace-file") == 0) {
+    trace_file = argv[2];
+    argv += 2;
+    argc -= 2;
+  }
+  if (argc != 2) {
+    fprintf(stderr, "%s: ERROR: invalid arguments\n", modname);
+    fprintf(stderr, "usage: %s [--check | --trace-file <file>] <config.xml>\n", modname);
+    fprintf(stderr, "       %s --reload\n", modname);
+    goto fail0;
+  }
+  filename = argv[1];
 
   // initialize component
   hal_comp_id = hal_init(modname);
@@ -148,97 +215,375 @@ int main(int argc, char **argv) {
     fprintf(stderr, "%s: ERROR: unable to create exit event\n", modname);
     goto fail1;
   }
+  reloadEvent = eventfd(0, 0);
+  if (reloadEvent == -1) {
+    fprintf(stderr, "%s: ERROR: unable to create reload event\n", modname);
+    goto fail2;
+  }
   signal(SIGINT, exitHandler);
   signal(SIGTERM, exitHandler);
+  signal(SIGHUP, reloadHandler);
 
-  // get config file name
-  if (argc != 2) {
-    fprintf(stderr, "%s: ERROR: invalid arguments\n", modname);
-    goto fail2;
+  // parse config file
+  memset(&state, 0, sizeof(state));
+  if (parseConfigFile(&state, filename)) {
+    goto fail3;
   }
-  filename = argv[1];
+
+  // setup shared mem for config
+  shmem_id = rtapi_shmem_new(LCEC_CONF_SHMEM_KEY, hal_comp_id, sizeof(LCEC_CONF_HEADER_T) + state.outputBuf.len);
+  if (shmem_id < 0) {
+    fprintf(stderr, "%s: ERROR: couldn't allocate user/RT shared memory\n", modname);
+    goto fail3;
+  }
+  if (lcec_rtapi_shmem_getptr(shmem_id, (void **)&shmem_ptr) < 0) {
+    fprintf(stderr, "%s: ERROR: couldn't map user/RT shared memory\n", modname);
+    goto fail4;
+  }
+
+  // setup header
+  header = (LCEC_CONF_HEADER_T *)shmem_ptr;
+  shmem_ptr += sizeof(LCEC_CONF_HEADER_T);
+  header->magic = LCEC_CONF_SHMEM_MAGIC;
+  header->length = state.outputBuf.len;
+  header->pid = getpid();
+
+  // copy data and free buffer
+  copyFreeOutputBuffer(&state.outputBuf, shmem_ptr);
+
+  // keep a copy of the startup config to diff reloads against
+  startup_conf = malloc(header->length);
+  if (startup_conf == NULL) {
+    fprintf(stderr, "%s: ERROR: Couldn't allocate memory for config\n", modname);
+    goto fail4;
+  }
+  memcpy(startup_conf, shmem_ptr, header->length);
+  active_conf = startup_conf;
+
+  // setup shared mem for realtime log rings
+  if (initLogRings()) {
+    goto fail4;
+  }
+
+  // setup shared mem for the startup trace, not fatal if it fails
+  initStartupTrace(hal_comp_id, trace_file);
+
+  // everything is fine
+  ret = 0;
+  hal_ready(hal_comp_id);
+
+  // wait for SIGTERM, draining the realtime log rings and handling
+  // SIGHUP reloads meanwhile
+  pfd[0].fd = exitEvent;
+  pfd[0].events = POLLIN;
+  pfd[1].fd = reloadEvent;
+  pfd[1].events = POLLIN;
+  for (;;) {
+    res = poll(pfd, 2, LCEC_CONF_LOG_POLL_MS);
+    if (res < 0 && errno != EINTR) {
+      fprintf(stderr, "%s: ERROR: error waiting for exit event\n", modname);
+      break;
+    }
+    drainLogRings();
+    restoreSlaves();
+    pollStartupTrace(*(conf_hal_data->master_count));
+    if (res > 0 && (pfd[0].revents & POLLIN)) {
+      break;
+    }
+    if (res > 0 && (pfd[1].revents & POLLIN)) {
+      if (read(reloadEvent, &u, sizeof(uint64_t)) < 0) {
+        fprintf(stderr, "%s: ERROR: error reading reload event\n", modname);
+      }
+      reloadConfigFile(filename);
+    }
+  }
+  drainLogRings();
+  if (res > 0 && read(exitEvent, &u, sizeof(uint64_t)) < 0) {
+    fprintf(stderr, "%s: ERROR: error reading exit event\n", modname);
+  }
+
+  freeStartupTrace(hal_comp_id);
+  if (log_header != NULL) {
+    rtapi_shmem_delete(log_shmem_id, hal_comp_id);
+  }
+fail4:
+  rtapi_shmem_delete(shmem_id, hal_comp_id);
+fail3:
+  copyFreeOutputBuffer(&state.outputBuf, NULL);
+  freeLogNames();
+  freeSlaveTemplates();
+  if (active_conf != startup_conf) {
+    free(active_conf);
+  }
+  free(startup_conf);
+  close(reloadEvent);
+fail2:
+  close(exitEvent);
+fail1:
+  hal_exit(hal_comp_id);
+fail0:
+  return ret;
+}
+
+static int parseConfigFile(LCEC_CONF_XML_STATE_T *state, const char *filename) {
+  int ret = -1;
+  int done;
+  char buffer[BUFFSIZE];
+  FILE *file;
+  LCEC_CONF_NULL_T *end;
 
   // open file
   file = fopen(filename, "r");
   if (file == NULL) {
     fprintf(stderr, "%s: ERROR: unable to open config file %s\n", modname, filename);
-    goto fail2;
+    goto fail0;
   }
 
   // create xml parser
-  memset(&state, 0, sizeof(state));
-  if (initXmlInst((LCEC_CONF_XML_INST_T *)&state, xml_states)) {
+  if (initXmlInst((LCEC_CONF_XML_INST_T *)state, xml_states)) {
     fprintf(stderr, "%s: ERROR: Couldn't allocate memory for parser\n", modname);
-    goto fail3;
+    goto fail1;
   }
 
-  initOutputBuffer(&state.outputBuf);
+  initOutputBuffer(&state->outputBuf);
   for (done = 0; !done;) {
     // read block
     int len = fread(buffer, 1, BUFFSIZE, file);
     if (ferror(file)) {
       fprintf(stderr, "%s: ERROR: Couldn't read from file %s\n", modname, filename);
-      goto fail4;
+      goto fail2;
     }
 
     // check for EOF
     done = feof(file);
 
     // parse current block
-    if (!XML_Parse(state.xml.parser, buffer, len, done)) {
-      fprintf(stderr, "%s: ERROR: Parse error at line %u: %s\n", modname, (unsigned int)XML_GetCurrentLineNumber(state.xml.parser),
-          XML_ErrorString(XML_GetErrorCode(state.xml.parser)));
-      goto fail4;
+    if (!XML_Parse(state->xml.parser, buffer, len, done)) {
+      fprintf(stderr, "%s: ERROR: Parse error at line %u: %s\n", modname, (unsigned int)XML_GetCurrentLineNumber(state->xml.parser),
+          XML_ErrorString(XML_GetErrorCode(state->xml.parser)));
+      goto fail2;
     }
   }
 
   // set end marker
-  end = ADD_OUTPUT_BUFFER(&state.outputBuf, LCEC_CONF_NULL_T);
+  end = ADD_OUTPUT_BUFFER(&state->outputBuf, LCEC_CONF_NULL_T);
   if (end == NULL) {
-    goto fail4;
+    goto fail2;
   }
   end->confType = lcecConfTypeNone;
 
-  // setup shared mem for config
-  shmem_id = rtapi_shmem_new(LCEC_CONF_SHMEM_KEY, hal_comp_id, sizeof(LCEC_CONF_HEADER_T) + state.outputBuf.len);
-  if (shmem_id < 0) {
-    fprintf(stderr, "%s: ERROR: couldn't allocate user/RT shared memory\n", modname);
-    goto fail4;
+  ret = 0;
+
+fail2:
+  XML_ParserFree(state->xml.parser);
+fail1:
+  fclose(file);
+fail0:
+  return ret;
+}
+
+static int checkConfigFile(const char *filename) {
+  LCEC_CONF_HAL_T check_hal_data;
+  hal_u32_t master_count = 0;
+  hal_u32_t slave_count = 0;
+  LCEC_CONF_XML_STATE_T state;
+  char *conf;
+  int ret = 1;
+
+  // count into local memory, there's no HAL component
+  check_hal_data.master_count = &master_count;
+  check_hal_data.slave_count = &slave_count;
+  conf_hal_data = &check_hal_data;
+
+  memset(&state, 0, sizeof(state));
+  if (parseConfigFile(&state, filename)) {
+    goto fail0;
   }
-  if (lcec_rtapi_shmem_getptr(shmem_id, (void **)&shmem_ptr) < 0) {
-    fprintf(stderr, "%s: ERROR: couldn't map user/RT shared memory\n", modname);
-    goto fail5;
+
+  conf = malloc(state.outputBuf.len);
+  if (conf == NULL) {
+    fprintf(stderr, "%s: ERROR: Couldn't allocate memory for config\n", modname);
+    goto fail0;
   }
+  copyFreeOutputBuffer(&state.outputBuf, conf);
 
-  // setup header
-  header = (LCEC_CONF_HEADER_T *)shmem_ptr;
-  shmem_ptr += sizeof(LCEC_CONF_HEADER_T);
-  header->magic = LCEC_CONF_SHMEM_MAGIC;
-  header->length = state.outputBuf.len;
+  ret = checkConfig(conf);
+  free(conf);
 
-  // copy data and free buffer
-  copyFreeOutputBuffer(&state.outputBuf, shmem_ptr);
+fail0:
+  copyFreeOutputBuffer(&state.outputBuf, NULL);
+  freeLogNames();
+  freeSlaveTemplates();
+  return ret;
+}
 
-  // everything is fine
-  ret = 0;
-  hal_ready(hal_comp_id);
+static void reloadConfigFile(const char *filename) {
+  LCEC_CONF_HAL_T *saved_hal_data = conf_hal_data;
+  LCEC_CONF_LOG_NAME_T *saved_log_names = log_names;
+  LCEC_CONF_HAL_T reload_hal_data;
+  hal_u32_t master_count = 0;
+  hal_u32_t slave_count = 0;
+  LCEC_CONF_XML_STATE_T state;
+  char *conf = NULL;
+  pid_t pid;
+  int status;
 
-  // wait for SIGTERM
-  if (read(exitEvent, &u, sizeof(uint64_t)) < 0) {
-    fprintf(stderr, "%s: ERROR: error reading exit event\n", modname);
+  printf("%s: reloading %s\n", modname, filename);
+
+  // leave the running config's pins and log names alone
+  reload_hal_data.master_count = &master_count;
+  reload_hal_data.slave_count = &slave_count;
+  conf_hal_data = &reload_hal_data;
+  log_names = NULL;
+  freeSlaveTemplates();
+
+  memset(&state, 0, sizeof(state));
+  if (parseConfigFile(&state, filename)) {
+    goto fail0;
   }
 
-fail5:
-  rtapi_shmem_delete(shmem_id, hal_comp_id);
-fail4:
+  conf = malloc(state.outputBuf.len);
+  if (conf == NULL) {
+    fprintf(stderr, "%s: ERROR: Couldn't allocate memory for config\n", modname);
+    goto fail0;
+  }
+  copyFreeOutputBuffer(&state.outputBuf, conf);
+
+  // diff and apply in a child, so the drivers' dry-run setup can't
+  // leave memory or state behind in this long-running process
+  fflush(stdout);
+  fflush(stderr);
+  pid = fork();
+  if (pid < 0) {
+    fprintf(stderr, "%s: ERROR: unable to fork for reload\n", modname);
+    goto fail0;
+  }
+  if (pid == 0) {
+    status = reloadConfig(active_conf, conf);
+    fflush(stdout);
+    fflush(stderr);
+    _exit(status);
+  }
+
+  while (waitpid(pid, &status, 0) < 0) {
+    if (errno != EINTR) {
+      fprintf(stderr, "%s: ERROR: error waiting for reload\n", modname);
+      goto fail0;
+    }
+  }
+  if (WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+    if (active_conf != startup_conf) {
+      free(active_conf);
+    }
+    active_conf = conf;
+    conf = NULL;
+  }
+
+fail0:
   copyFreeOutputBuffer(&state.outputBuf, NULL);
-  XML_ParserFree(state.xml.parser);
-fail3:
-  fclose(file);
+  free(conf);
+  freeLogNames();
+  freeSlaveTemplates();
+  log_names = saved_log_names;
+  conf_hal_data = saved_hal_data;
+}
+
+static void addRestoreSlave(int master, int slave) {
+  LCEC_CONF_RESTORE_T *p;
+
+  for (p = restore_slaves; p != NULL; p = p->next) {
+    if (p->master == master && p->slave == slave) {
+      return;
+    }
+  }
+
+  p = malloc(sizeof(LCEC_CONF_RESTORE_T));
+  if (p == NULL) {
+    fprintf(stderr, "%s: ERROR: Couldn't allocate memory for slave restore\n", modname);
+    return;
+  }
+  p->master = master;
+  p->slave = slave;
+  p->next = restore_slaves;
+  restore_slaves = p;
+}
+
+// The master writes the startup config's SDOs and IDNs whenever it
+// re-initializes a slave, so write the reloaded ones again once the
+// slave is back in OP.
+static void restoreSlaves(void) {
+  LCEC_CONF_RESTORE_T *p;
+  pid_t pid;
+  int status = 0;
+
+  if (restore_slaves == NULL) {
+    return;
+  }
+
+  fflush(stdout);
+  fflush(stderr);
+  pid = fork();
+  if (pid < 0) {
+    fprintf(stderr, "%s: ERROR: unable to fork for slave restore\n", modname);
+  } else if (pid == 0) {
+    for (p = restore_slaves; p != NULL; p = p->next) {
+      status |= reloadRestoreSlave(startup_conf, active_conf, p->master, p->slave);
+    }
+    fflush(stdout);
+    fflush(stderr);
+    _exit(status);
+  } else {
+    while (waitpid(pid, &status, 0) < 0) {
+      if (errno != EINTR) {
+        fprintf(stderr, "%s: ERROR: error waiting for slave restore\n", modname);
+        break;
+      }
+    }
+  }
+
+  while (restore_slaves != NULL) {
+    p = restore_slaves;
+    restore_slaves = p->next;
+    free(p);
+  }
+}
+
+static int sendReload(void) {
+  int comp_id, id;
+  int ret = 1;
+  LCEC_CONF_HEADER_T *header;
+
+  comp_id = hal_init("lcec_conf_reload");
+  if (comp_id < 1) {
+    fprintf(stderr, "%s: ERROR: hal_init failed\n", modname);
+    goto fail0;
+  }
+
+  id = rtapi_shmem_new(LCEC_CONF_SHMEM_KEY, comp_id, sizeof(LCEC_CONF_HEADER_T));
+  if (id < 0) {
+    fprintf(stderr, "%s: ERROR: couldn't allocate user/RT shared memory\n", modname);
+    goto fail1;
+  }
+  if (lcec_rtapi_shmem_getptr(id, (void **)&header) < 0) {
+    fprintf(stderr, "%s: ERROR: couldn't map user/RT shared memory\n", modname);
+    goto fail2;
+  }
+  if (header->magic != LCEC_CONF_SHMEM_MAGIC || header->pid <= 0) {
+    fprintf(stderr, "%s: ERROR: no running %s found\n", modname, modname);
+    goto fail2;
+  }
+
+  if (kill(header->pid, SIGHUP) < 0) {
+    fprintf(stderr, "%s: ERROR: unable to signal %s (pid %d): %s\n", modname, modname, header->pid, strerror(errno));
+    goto fail2;
+  }
+  printf("%s: reload requested, results are printed by the running %s\n", modname, modname);
+  ret = 0;
+
 fail2:
-  close(exitEvent);
+  rtapi_shmem_delete(id, comp_id);
 fail1:
-  hal_exit(hal_comp_id);
+  hal_exit(comp_id);
 fail0:
   return ret;
 }
@@ -282,6 +627,75 @@ static void parseMasterAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char **
       continue;
     }
 
+    // parse dcCalibrate
+    if (strcmp(name, "dcCalibrate") == 0) {
+      if (strcasecmp(val, "off") == 0) {
+        p->dcCalibrate = lcecDcCalibrateOff;
+        continue;
+      }
+      if (strcasecmp(val, "report") == 0) {
+        p->dcCalibrate = lcecDcCalibrateReport;
+        continue;
+      }
+      if (strcasecmp(val, "apply") == 0) {
+        p->dcCalibrate = lcecDcCalibrateApply;
+        continue;
+      }
+      fprintf(stderr, "%s: ERROR: Invalid master dcCalibrate %s\n", modname, val);
+      XML_StopParser(inst->parser, 0);
+      return;
+    }
+
+    // parse dcCalibrateSamples
+    if (strcmp(name, "dcCalibrateSamples") == 0) {
+      p->dcCalibrateSamples = atoi(val);
+      if (p->dcCalibrateSamples <= 0) {
+        fprintf(stderr, "%s: ERROR: Invalid master dcCalibrateSamples %s\n", modname, val);
+        XML_StopParser(inst->parser, 0);
+        return;
+      }
+      continue;
+    }
+
+    // parse dcCalibrateMargin
+    if (strcmp(name, "dcCalibrateMargin") == 0) {
+      p->dcCalibrateMargin = atoi(val);
+      if (p->dcCalibrateMargin <= 0) {
+        fprintf(stderr, "%s: ERROR: Invalid master dcCalibrateMargin %s\n", modname, val);
+        XML_StopParser(inst->parser, 0);
+        return;
+      }
+      continue;
+    }
+
+    // parse receiveDeadline
+    if (strcmp(name, "receiveDeadline") == 0) {
+      p->receiveDeadline = atoi(val);
+      if (p->receiveDeadline < 0) {
+        fprintf(stderr, "%s: ERROR: Invalid master receiveDeadline %s\n", modname, val);
+        XML_StopParser(inst->parser, 0);
+        return;
+      }
+      continue;
+    }
+
+    // parse halMemBudget
+    if (strcmp(name, "halMemBudget") == 0) {
+      unsigned long long budget;
+      char *end;
+
+      // strtoull() would quietly negate "-1"
+      errno = 0;
+      budget = strtoull(val, &end, 10);
+      if (end == val || *end != 0 || val[strspn(val, " \t\n")] == '-' || errno == ERANGE || budget > UINT32_MAX) {
+        fprintf(stderr, "%s: ERROR: Invalid master halMemBudget %s\n", modname, val);
+        XML_StopParser(inst->parser, 0);
+        return;
+      }
+      p->halMemBudget = budget;
+      continue;
+    }
+
     // handle error
     fprintf(stderr, "%s: ERROR: Invalid master attribute %s\n", modname, name);
     XML_StopParser(inst->parser, 0);
@@ -293,26 +707,36 @@ static void parseMasterAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char **
     snprintf(p->name, LCEC_CONF_STR_MAXLEN, "%d", p->index);
   }
 
+  addLogName(*(conf_hal_data->master_count), -1, p->name);
   (*(conf_hal_data->master_count))++;
   state->currMaster = p;
 }
 
 static void parseSlaveAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char **attr) {
-  const lcec_typelist_t *slaveType;
+  const lcec_typelist_t *slaveType = NULL;
+  LCEC_CONF_TEMPLATE_T *tmpl = NULL;
+  LCEC_CONF_SLAVE_T *q;
+  char base_name[LCEC_CONF_STR_MAXLEN];
+  int i, enabled;
 
   LCEC_CONF_XML_STATE_T *state = (LCEC_CONF_XML_STATE_T *)inst;
 
+  // <slaveTemplate> is only valid directly below <masters>
+  int is_template = (inst->state == lcecConfTypeMasters);
+
   LCEC_CONF_SLAVE_T *p = ADD_OUTPUT_BUFFER(&state->outputBuf, LCEC_CONF_SLAVE_T);
   if (p == NULL) {
     XML_StopParser(inst->parser, 0);
     return;
   }
 
-  p->confType = lcecConfTypeSlave;
+  p->confType = is_template ? lcecConfTypeSlaveTemplate : lcecConfTypeSlave;
+  p->templateOffset = -1;
+  state->currSlaveRepeat = 1;
 
   int valid = 0;
 
-  // pre parse slave type to avoid attribute ordering problems
+  // pre parse slave type and template to avoid attribute ordering problems
   const char **iter = attr;
   while (*iter) {
     const char *name = *(iter++);
@@ -335,6 +759,34 @@ static void parseSlaveAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char **a
       valid = 1;
       continue;
     }
+
+    // parse template
+    if (strcmp(name, "template") == 0 && !is_template) {
+      tmpl = findSlaveTemplate(val);
+      if (tmpl == NULL) {
+        fprintf(stderr, "%s: ERROR: Cannot find slave template %s\n", modname, val);
+        XML_StopParser(inst->parser, 0);
+        return;
+      }
+      continue;
+    }
+  }
+
+  // inherit type and configuration from template
+  if (tmpl != NULL) {
+    if (valid) {
+      fprintf(stderr, "%s: ERROR: Slave using template %s must not set a type\n", modname, tmpl->conf->name);
+      XML_StopParser(inst->parser, 0);
+      return;
+    }
+
+    *p = *tmpl->conf;
+    p->confType = lcecConfTypeSlave;
+    p->templateOffset = tmpl->offset;
+    p->templateLength = 0;
+    p->name[0] = 0;
+    slaveType = lcec_findslavetype(p->type_name);
+    valid = 1;
   }
 
   while (*attr) {
@@ -348,7 +800,7 @@ static void parseSlaveAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char **a
     }
 
     // parse index
-    if (strcmp(name, "idx") == 0) {
+    if (strcmp(name, "idx") == 0 && !is_template) {
       p->index = atoi(val);
       continue;
     }
@@ -371,6 +823,34 @@ static void parseSlaveAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char **a
       continue;
     }
 
+    // parse enabled flag
+    if (strcmp(name, "enabled") == 0) {
+      enabled = parseBool(val);
+      if (enabled < 0) {
+        fprintf(stderr, "%s: ERROR: Invalid slave enabled value %s, expected true or false\n", modname, val);
+        XML_StopParser(inst->parser, 0);
+        return;
+      }
+      p->disabled = !enabled;
+      continue;
+    }
+
+    // template was handled above
+    if (strcmp(name, "template") == 0 && !is_template) {
+      continue;
+    }
+
+    // parse repeat count
+    if (strcmp(name, "count") == 0 && !is_template) {
+      state->currSlaveRepeat = atoi(val);
+      if (state->currSlaveRepeat < 1) {
+        fprintf(stderr, "%s: ERROR: Invalid slave count %s\n", modname, val);
+        XML_StopParser(inst->parser, 0);
+        return;
+      }
+      continue;
+    }
+
     // generic only attributes
     if (!strcmp(p->type_name, "generic")) {
       // parse vid (hex value)
@@ -381,15 +861,10 @@ static void parseSlaveAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char **a
       }
     }
 
-    // handle error
-    fprintf(stderr, "%s: ERROR: Invalid slave attribute %s\n", modname, name);
-    XML_StopParser(inst->parser, 0);
-    return;
-  }
-
-  // set default name
-  if (p->name[0] == 0) {
-    snprintf(p->name, LCEC_CONF_STR_MAXLEN, "%d", p->index);
+    // handle error
+    fprintf(stderr, "%s: ERROR: Invalid slave attribute %s\n", modname, name);
+    XML_StopParser(inst->parser, 0);
+    return;
   }
 
   // type is required
@@ -399,9 +874,59 @@ static void parseSlaveAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char **a
     return;
   }
 
-  (*(conf_hal_data->slave_count))++;
   state->currSlaveType = slaveType;
   state->currSlave = p;
+
+  // register template, its body starts with the next token
+  if (is_template) {
+    if (addSlaveTemplate(p, state->outputBuf.len) == NULL) {
+      XML_StopParser(inst->parser, 0);
+    }
+    return;
+  }
+
+  // expand repeated slaves, named <name>-<n> if a name is given
+  strncpy(base_name, p->name, LCEC_CONF_STR_MAXLEN);
+  for (i = 0, q = p; i < state->currSlaveRepeat; i++) {
+    if (i > 0) {
+      q = ADD_OUTPUT_BUFFER(&state->outputBuf, LCEC_CONF_SLAVE_T);
+      if (q == NULL) {
+        XML_StopParser(inst->parser, 0);
+        return;
+      }
+      *q = *p;
+      q->index = p->index + i;
+    }
+
+    setRepeatedSlaveName(q, base_name, state->currSlaveRepeat, i);
+
+    addLogName(*(conf_hal_data->master_count) - 1, q->index, q->name);
+    (*(conf_hal_data->slave_count))++;
+  }
+  state->currSlaveEnd = state->outputBuf.len;
+}
+
+static void parseSlaveEnd(LCEC_CONF_XML_INST_T *inst, int next) {
+  LCEC_CONF_XML_STATE_T *state = (LCEC_CONF_XML_STATE_T *)inst;
+  LCEC_CONF_NULL_T *p;
+
+  // repeated slaves are emitted up front, so they can't take children
+  if (next == lcecConfTypeMaster) {
+    if (state->currSlaveRepeat > 1 && state->outputBuf.len != state->currSlaveEnd) {
+      fprintf(stderr, "%s: ERROR: Slave %s with count must not have child elements\n", modname, state->currSlave->name);
+      XML_StopParser(inst->parser, 0);
+    }
+    return;
+  }
+
+  // terminate template body
+  p = ADD_OUTPUT_BUFFER(&state->outputBuf, LCEC_CONF_NULL_T);
+  if (p == NULL) {
+    XML_StopParser(inst->parser, 0);
+    return;
+  }
+  p->confType = lcecConfTypeSlaveTemplateEnd;
+  state->currSlave->templateLength = state->outputBuf.len - findSlaveTemplate(state->currSlave->name)->offset;
 }
 
 static void parseDcConfAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char **attr) {
@@ -1302,6 +1827,229 @@ static void parseModParamAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char
   (state->currSlave->modParamCount)++;
 }
 
+static void parseSdoPinAttrs(LCEC_CONF_XML_INST_T *inst, int next, const char **attr) {
+  LCEC_CONF_XML_STATE_T *state = (LCEC_CONF_XML_STATE_T *)inst;
+
+  int tmp;
+  int floatReq;
+
+  if (strcmp(state->currSlave->type_name, "generic") != 0) {
+    fprintf(stderr, "%s: ERROR: sdoPin is only allowed for generic slaves\n", modname);
+    XML_StopParser(inst->parser, 0);
+    return;
+  }
+
+  LCEC_CONF_SDOPIN_T *p = ADD_OUTPUT_BUFFER(&state->outputBuf, LCEC_CONF_SDOPIN_T);
+  if (p == NULL) {
+    XML_StopParser(inst->parser, 0);
+    return;
+  }
+
+  floatReq = 0;
+  p->confType = lcecConfTypeSdoPin;
+  p->index = 0xffff;
+  p->subindex = 0xff;
+  p->halType = HAL_TYPE_UNSPECIFIED;
+  p->dir = HAL_OUT;
+  p->pollPeriod = 1000;
+  p->floatScale = 1.0;
+  while (*attr) {
+    const char *name = *(attr++);
+    const char *val = *(attr++);
+
+    // parse index
+    if (strcmp(name, "idx") == 0) {
+      tmp = strtol(val, NULL, 16);
+      if (tmp < 0 || tmp >= 0xffff) {
+        fprintf(stderr, "%s: ERROR: Invalid sdoPin idx %d\n", modname, tmp);
+        XML_StopParser(inst->parser, 0);
+        return;
+      }
+      p->index = tmp;
+      continue;
+    }
+
+    // parse subIdx
+    if (strcmp(name, "subIdx") == 0) {
+      tmp = strtol(val, NULL, 16);
+      if (tmp < 0 || tmp >= 0xff) {
+        fprintf(stderr, "%s: ERROR: Invalid sdoPin subIdx %d\n", modname, tmp);
+        XML_StopParser(inst->parser, 0);
+        return;
+      }
+      p->subindex = tmp;
+      continue;
+    }
+
+    // parse bitLen, SDOs are transferred in whole bytes
+    if (strcmp(name, "bitLen") == 0) {
+      tmp = atoi(val);
+      if (tmp != 8 && tmp != 16 && tmp != 32 && tmp != 64) {
+        fprintf(stderr, "%s: ERROR: Invalid sdoPin bitLen %d, must be 8, 16, 32, or 64\n", modname, tmp);
+        XML_StopParser(inst->parser, 0);
+        return;
+      }
+      p->bitLength = tmp;
+      continue;
+    }
+
+    // parse halType
+    if (strcmp(name, "halType") == 0) {
+      if (strcasecmp(val, "bit") == 0) {
+        p->subType = lcecPdoEntTypeSimple;
+        p->halType = HAL_BIT;
+        continue;
+      }
+      if (strcasecmp(val, "s32") == 0) {
+        p->subType = lcecPdoEntTypeSimple;
+        p->halType = HAL_S32;
+        continue;
+      }
+      if (strcasecmp(val, "u32") == 0) {
+        p->subType = lcecPdoEntTypeSimple;
+        p->halType = HAL_U32;
+        continue;
+      }
+      if (strcasecmp(val, "float") == 0) {
+        p->subType = lcecPdoEntTypeFloatSigned;
+        p->halType = HAL_FLOAT;
+        continue;
+      }
+      if (strcasecmp(val, "float-unsigned") == 0) {
+        p->subType = lcecPdoEntTypeFloatUnsigned;
+        p->halType = HAL_FLOAT;
+        continue;
+      }
+      if (strcasecmp(val, "float-ieee") == 0) {
+        p->subType = lcecPdoEntTypeFloatIeee;
+        p->halType = HAL_FLOAT;
+        continue;
+      }
+      if (strcasecmp(val, "float-double-ieee") == 0) {
+        p->subType = lcecPdoEntTypeFloatDoubleIeee;
+        p->halType = HAL_FLOAT;
+        continue;
+      }
+      fprintf(stderr, "%s: ERROR: Invalid sdoPin halType %s\n", modname, val);
+      XML_StopParser(inst->parser, 0);
+      return;
+    }
+
+    // parse dir
+    if (strcmp(name, "dir") == 0) {
+      if (strcasecmp(val, "read") == 0) {
+        p->dir = HAL_OUT;
+        continue;
+      }
+      if (strcasecmp(val, "write") == 0) {
+        p->dir = HAL_IN;
+        continue;
+      }
+      fprintf(stderr, "%s: ERROR: Invalid sdoPin dir %s, must be read or write\n", modname, val);
+      XML_StopParser(inst->parser, 0);
+      return;
+    }
+
+    // parse pollMs
+    if (strcmp(name, "pollMs") == 0) {
+      tmp = atoi(val);
+      if (tmp <= 0) {
+        fprintf(stderr, "%s: ERROR: Invalid sdoPin pollMs %s\n", modname, val);
+        XML_StopParser(inst->parser, 0);
+        return;
+      }
+      p->pollPeriod = tmp;
+      continue;
+    }
+
+    // parse scale
+    if (strcmp(name, "scale") == 0) {
+      floatReq = 1;
+      p->floatScale = atof(val);
+      continue;
+    }
+
+    // parse offset
+    if (strcmp(name, "offset") == 0) {
+      floatReq = 1;
+      p->floatOffset = atof(val);
+      continue;
+    }
+
+    // parse halPin
+    if (strcmp(name, "halPin") == 0) {
+      strncpy(p->halPin, val, LCEC_CONF_STR_MAXLEN);
+      p->halPin[LCEC_CONF_STR_MAXLEN - 1] = 0;
+      continue;
+    }
+
+    // handle error
+    fprintf(stderr, "%s: ERROR: Invalid sdoPin attribute %s\n", modname, name);
+    XML_StopParser(inst->parser, 0);
+    return;
+  }
+
+  // idx is required
+  if (p->index == 0xffff) {
+    fprintf(stderr, "%s: ERROR: sdoPin has no idx attribute\n", modname);
+    XML_StopParser(inst->parser, 0);
+    return;
+  }
+
+  // subIdx is required
+  if (p->subindex == 0xff) {
+    fprintf(stderr, "%s: ERROR: sdoPin has no subIdx attribute\n", modname);
+    XML_StopParser(inst->parser, 0);
+    return;
+  }
+
+  // bitLen is required
+  if (p->bitLength == 0) {
+    fprintf(stderr, "%s: ERROR: sdoPin has no bitLen attribute\n", modname);
+    XML_StopParser(inst->parser, 0);
+    return;
+  }
+
+  // halType is required
+  if (p->halType == HAL_TYPE_UNSPECIFIED) {
+    fprintf(stderr, "%s: ERROR: sdoPin has no halType attribute\n", modname);
+    XML_StopParser(inst->parser, 0);
+    return;
+  }
+
+  // halPin is required
+  if (p->halPin[0] == 0) {
+    fprintf(stderr, "%s: ERROR: sdoPin has no halPin attribute\n", modname);
+    XML_StopParser(inst->parser, 0);
+    return;
+  }
+
+  // IEEE floats have a fixed size
+  if ((p->subType == lcecPdoEntTypeFloatIeee && p->bitLength != 32) ||
+      (p->subType == lcecPdoEntTypeFloatDoubleIeee && p->bitLength != 64) ||
+      (p->bitLength == 64 && p->subType != lcecPdoEntTypeFloatDoubleIeee)) {
+    fprintf(stderr, "%s: ERROR: sdoPin %s bitLen %d doesn't match its halType\n", modname, p->halPin, p->bitLength);
+    XML_StopParser(inst->parser, 0);
+    return;
+  }
+
+  // check for float type if required
+  if (floatReq && p->halType != HAL_FLOAT) {
+    fprintf(stderr, "%s: ERROR: sdoPin has scale/offset attributes but pin type is not 'float'\n", modname);
+    XML_StopParser(inst->parser, 0);
+    return;
+  }
+
+  // written values are divided by scale
+  if (p->dir == HAL_IN && p->floatScale == 0.0) {
+    fprintf(stderr, "%s: ERROR: sdoPin %s with dir write must not have a scale of 0\n", modname, p->halPin);
+    XML_StopParser(inst->parser, 0);
+    return;
+  }
+
+  (state->currSlave->sdoPinCount)++;
+}
+
 static int parseSyncCycle(LCEC_CONF_XML_STATE_T *state, const char *nptr) {
   // chack for master period multiples
   if (*nptr == '*') {
@@ -1312,3 +2060,136 @@ static int parseSyncCycle(LCEC_CONF_XML_STATE_T *state, const char *nptr) {
   // custom value
   return atoi(nptr);
 }
+
+static void addLogName(int master, int slave, const char *name) {
+  LCEC_CONF_LOG_NAME_T *p = calloc(1, sizeof(LCEC_CONF_LOG_NAME_T));
+  if (p == NULL) {
+    // only used to make log messages readable
+    return;
+  }
+
+  p->master = master;
+  p->slave = slave;
+  snprintf(p->name, sizeof(p->name), "%s", name);
+  p->next = log_names;
+  log_names = p;
+}
+
+const char *findLogName(int master, int slave) {
+  LCEC_CONF_LOG_NAME_T *p;
+
+  for (p = log_names; p != NULL; p = p->next) {
+    if (p->master == master && p->slave == slave) {
+      return p->name;
+    }
+  }
+
+  return NULL;
+}
+
+static void freeLogNames(void) {
+  LCEC_CONF_LOG_NAME_T *p;
+
+  while (log_names != NULL) {
+    p = log_names;
+    log_names = p->next;
+    free(p);
+  }
+}
+
+static int initLogRings(void) {
+  void *ptr;
+  lcec_log_ring_t *rings;
+  lcec_slave_reinit_t *reinits;
+  LCEC_CONF_LOG_NAME_T *p;
+  const char *name;
+  int count = *(conf_hal_data->master_count);
+  int slave_count = 0;
+  int i;
+
+  log_header = NULL;
+  if (count == 0) {
+    return 0;
+  }
+
+  for (p = log_names; p != NULL; p = p->next) {
+    if (p->slave >= 0) {
+      slave_count++;
+    }
+  }
+
+  log_shmem_id = rtapi_shmem_new(LCEC_LOG_SHMEM_KEY, hal_comp_id, lcec_log_shmem_size(count, slave_count));
+  if (log_shmem_id < 0) {
+    fprintf(stderr, "%s: ERROR: couldn't allocate log shared memory\n", modname);
+    return -1;
+  }
+  if (lcec_rtapi_shmem_getptr(log_shmem_id, &ptr) < 0) {
+    fprintf(stderr, "%s: ERROR: couldn't map log shared memory\n", modname);
+    rtapi_shmem_delete(log_shmem_id, hal_comp_id);
+    return -1;
+  }
+
+  memset(ptr, 0, lcec_log_shmem_size(count, slave_count));
+  rings = (lcec_log_ring_t *)((char *)ptr + sizeof(lcec_log_header_t));
+  for (i = 0; i < count; i++) {
+    name = findLogName(i, -1);
+    snprintf(rings[i].master_name, sizeof(rings[i].master_name), "%s", name != NULL ? name : "?");
+  }
+
+  reinits = (lcec_slave_reinit_t *)&rings[count];
+  for (p = log_names, i = 0; p != NULL; p = p->next) {
+    if (p->slave >= 0) {
+      reinits[i].master = p->master;
+      reinits[i].slave = p->slave;
+      i++;
+    }
+  }
+
+  log_header = (lcec_log_header_t *)ptr;
+  log_header->ring_count = count;
+  log_header->slave_count = slave_count;
+  log_header->magic = LCEC_LOG_SHMEM_MAGIC;
+  return 0;
+}
+
+static void drainLogRings(void) {
+  lcec_log_ring_t *rings, *ring;
+  lcec_slave_reinit_t *reinits;
+  lcec_log_record_t rec;
+  char buf[256];
+  uint32_t dropped, count;
+  int i, level;
+
+  if (log_header == NULL) {
+    return;
+  }
+
+  rings = (lcec_log_ring_t *)((char *)log_header + sizeof(lcec_log_header_t));
+  for (i = 0; i < log_header->ring_count; i++) {
+    ring = &rings[i];
+
+    while (lcec_log_pop(ring, &rec)) {
+      level = lcec_log_format(&rec, ring->master_name, findLogName(i, rec.slave), buf, sizeof(buf));
+      rtapi_print_msg(level, "%s\n", buf);
+    }
+
+    dropped = __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+    if (dropped != ring->dropped_reported) {
+      rtapi_print_msg(RTAPI_MSG_WARN, LCEC_MSG_PFX "master %s: log ring full, %u messages dropped\n", ring->master_name,
+          dropped - ring->dropped_reported);
+      ring->dropped_reported = dropped;
+    }
+  }
+
+  // a slave re-entering OP was re-initialized with the startup values
+  reinits = (lcec_slave_reinit_t *)&rings[log_header->ring_count];
+  for (i = 0; i < log_header->slave_count; i++) {
+    count = __atomic_load_n(&reinits[i].count, __ATOMIC_ACQUIRE);
+    if (count != reinits[i].seen) {
+      if (active_conf != startup_conf) {
+        addRestoreSlave(reinits[i].master, reinits[i].slave);
+      }
+      reinits[i].seen = count;
+    }
+  }
+}
@@ -29,6 +29,12 @@
 #define LCEC_CONF_SHMEM_KEY   0xACB572C7
 #define LCEC_CONF_SHMEM_MAGIC 0x036ED5A3
 
+#define LCEC_LOG_SHMEM_KEY   0xACB572C8
+#define LCEC_LOG_SHMEM_MAGIC 0x036ED5A4
+
+#define LCEC_TRACE_SHMEM_KEY   0xACB572C9
+#define LCEC_TRACE_SHMEM_MAGIC 0x036ED5A5
+
 #define LCEC_CONF_STR_MAXLEN 48
 
 #define LCEC_CONF_SDO_COMPLETE_SUBIDX -1
@@ -51,7 +57,10 @@ typedef enum {
   lcecConfTypeIdnDataRaw,
   lcecConfTypeInitCmds,
   lcecConfTypeComplexEntry,
-  lcecConfTypeModParam
+  lcecConfTypeModParam,
+  lcecConfTypeSlaveTemplate,
+  lcecConfTypeSlaveTemplateEnd,
+  lcecConfTypeSdoPin
 } LCEC_CONF_TYPE_T;
 
 typedef enum {
@@ -66,14 +75,26 @@ typedef enum {
 typedef struct {
   uint32_t magic;
   size_t length;
+  int pid;  ///< Process ID of `lcec_conf`, used by `lcec_conf --reload`.
 } LCEC_CONF_HEADER_T;
 
+typedef enum {
+  lcecDcCalibrateOff = 0,
+  lcecDcCalibrateReport,
+  lcecDcCalibrateApply,
+} LCEC_CONF_DC_CALIBRATE_T;
+
 typedef struct {
   LCEC_CONF_TYPE_T confType;
   int index;
   uint32_t appTimePeriod;
   int refClockSyncCycles;
   char name[LCEC_CONF_STR_MAXLEN];
+  LCEC_CONF_DC_CALIBRATE_T dcCalibrate;  ///< SYNC0 shift calibration mode.
+  int dcCalibrateSamples;                ///< Frame arrival samples per slave, 0 for the default.
+  int32_t dcCalibrateMargin;             ///< Minimum time between frame arrival and SYNC0 (ns), 0 for the default.
+  int32_t receiveDeadline;               ///< Time to wait for a complete domain in `read` (ns), 0 to receive once.
+  uint32_t halMemBudget;                 ///< Warn when the master needs more HAL memory than this (bytes), 0 for no budget.
 } LCEC_CONF_MASTER_T;
 
 typedef struct {
@@ -90,6 +111,10 @@ typedef struct {
   size_t sdoConfigLength;
   size_t idnConfigLength;
   unsigned int modParamCount;
+  unsigned int sdoPinCount;
+  long templateOffset;    ///< Offset of the template body in the config data, or -1 if the slave has no template.
+  size_t templateLength;  ///< Length of the template body, including its end token.  Templates only.
+  int disabled;           ///< Set by `enabled="false"`.
   char name[LCEC_CONF_STR_MAXLEN];
 } LCEC_CONF_SLAVE_T;
 
@@ -144,6 +169,20 @@ typedef struct {
   char halPin[LCEC_CONF_STR_MAXLEN];
 } LCEC_CONF_COMPLEXENTRY_T;
 
+typedef struct {
+  LCEC_CONF_TYPE_T confType;
+  uint16_t index;
+  uint8_t subindex;
+  uint8_t bitLength;
+  LCEC_PDOENT_TYPE_T subType;
+  hal_type_t halType;
+  hal_pin_dir_t dir;     ///< `HAL_OUT` to read the SDO, `HAL_IN` to write it.
+  uint32_t pollPeriod;  ///< Time between requests (ms).
+  hal_float_t floatScale;
+  hal_float_t floatOffset;
+  char halPin[LCEC_CONF_STR_MAXLEN];
+} LCEC_CONF_SDOPIN_T;
+
 typedef struct {
   LCEC_CONF_TYPE_T confType;
 } LCEC_CONF_NULL_T;
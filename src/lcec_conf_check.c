@@ -0,0 +1,301 @@
+//
+//    Copyright (C) 2024 LinuxCNC-Ethercat contributors
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program; if not, write to the Free Software
+//    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+//
+
+/// @file
+/// @brief Dry-run validation for `lcec_conf --check`
+///
+/// This runs the same config parsing, `proc_preinit`, and `proc_init`
+/// steps as the realtime module, but with HAL and the EtherCAT master
+/// replaced by the `lcec_dry_run` hooks.  Pins and params are only
+/// recorded by name, so duplicates can be reported.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lcec.h"
+#include "lcec_conf.h"
+#include "lcec_conf_priv.h"
+
+#define CHECK_NAME_BUCKETS 4096
+
+extern int lcec_comp_id;
+
+typedef struct CHECK_NAME {
+  struct CHECK_NAME *next;
+  char name[];
+} CHECK_NAME_T;
+
+static CHECK_NAME_T *check_names[CHECK_NAME_BUCKETS];
+static int check_pin_count;
+static int check_param_count;
+static int check_errors;
+
+static void *checkHalMalloc(size_t size);
+static int checkPinNew(const char *name, hal_type_t type, hal_pin_dir_t dir, void **data_ptr_addr);
+static int checkParamNew(const char *name, hal_type_t type, hal_param_dir_t dir, void *data_addr);
+static void checkLimitExceeded(lcec_slave_t *slave, const char *what);
+
+static const lcec_dry_run_t check_hooks = {
+    checkHalMalloc,
+    checkPinNew,
+    checkParamNew,
+    checkLimitExceeded,
+    NULL,
+};
+
+static void *checkHalMalloc(size_t size) { return calloc(1, size); }
+
+static int checkAddName(const char *name) {
+  unsigned int hash = 5381;
+  const char *c;
+  CHECK_NAME_T *p;
+
+  for (c = name; *c; c++) {
+    hash = hash * 33 + (unsigned char)*c;
+  }
+  hash %= CHECK_NAME_BUCKETS;
+
+  for (p = check_names[hash]; p != NULL; p = p->next) {
+    if (strcmp(p->name, name) == 0) {
+      fprintf(stderr, "%s: ERROR: duplicate pin or param name %s\n", modname, name);
+      check_errors++;
+      return -1;
+    }
+  }
+
+  p = calloc(1, sizeof(CHECK_NAME_T) + strlen(name) + 1);
+  if (p == NULL) {
+    fprintf(stderr, "%s: ERROR: Couldn't allocate memory for name %s\n", modname, name);
+    return -1;
+  }
+  strcpy(p->name, name);
+  p->next = check_names[hash];
+  check_names[hash] = p;
+
+  return 0;
+}
+
+static int checkPinNew(const char *name, hal_type_t type, hal_pin_dir_t dir, void **data_ptr_addr) {
+  if (checkAddName(name)) {
+    return -1;
+  }
+
+  // hal_float_t is the largest of the pin types drivers use
+  *data_ptr_addr = calloc(1, sizeof(hal_float_t));
+  if (*data_ptr_addr == NULL) {
+    return -1;
+  }
+
+  check_pin_count++;
+  return 0;
+}
+
+static int checkParamNew(const char *name, hal_type_t type, hal_param_dir_t dir, void *data_addr) {
+  if (checkAddName(name)) {
+    return -1;
+  }
+
+  check_param_count++;
+  return 0;
+}
+
+static void checkLimitExceeded(lcec_slave_t *slave, const char *what) {
+  fprintf(stderr, "%s: ERROR: slave %s.%s exceeds %s\n", modname, slave->master->name, slave->name, what);
+  check_errors++;
+}
+
+static void checkFreeNames(void) {
+  CHECK_NAME_T *p;
+  int i;
+
+  for (i = 0; i < CHECK_NAME_BUCKETS; i++) {
+    while (check_names[i] != NULL) {
+      p = check_names[i];
+      check_names[i] = p->next;
+      free(p);
+    }
+  }
+}
+
+// Estimate the number of bits a slave adds to the process data
+// domain.  The master maps every sync manager that has at least one
+// registered entry in full, so all entries of such a sync manager are
+// counted.  Entries that aren't described by `sync_info` are only
+// known by the slave, and are reported as unknown.
+static unsigned int checkSlaveDomainBits(lcec_slave_t *slave, int *unknown) {
+  const ec_sync_info_t *sync;
+  const ec_pdo_info_t *pdo;
+  const ec_pdo_entry_reg_t *reg;
+  unsigned int bits = 0, sync_bits, i, j;
+  int used, found, r;
+
+  for (r = 0; r < slave->regs->current; r++) {
+    reg = &slave->regs->pdo_entry_regs[r];
+    found = 0;
+    for (sync = slave->sync_info; sync != NULL && sync->index != 0xff && !found; sync++) {
+      for (i = 0, pdo = sync->pdos; i < sync->n_pdos && !found; i++, pdo++) {
+        for (j = 0; j < pdo->n_entries && !found; j++) {
+          found = (pdo->entries[j].index == reg->index && pdo->entries[j].subindex == reg->subindex);
+        }
+      }
+    }
+    if (!found) {
+      (*unknown)++;
+    }
+  }
+
+  for (sync = slave->sync_info; sync != NULL && sync->index != 0xff; sync++) {
+    used = 0;
+    sync_bits = 0;
+    for (i = 0, pdo = sync->pdos; i < sync->n_pdos; i++, pdo++) {
+      for (j = 0; j < pdo->n_entries; j++) {
+        sync_bits += pdo->entries[j].bit_length;
+        for (r = 0; r < slave->regs->current && !used; r++) {
+          used = (slave->regs->pdo_entry_regs[r].index == pdo->entries[j].index &&
+                  slave->regs->pdo_entry_regs[r].subindex == pdo->entries[j].subindex);
+        }
+      }
+    }
+    if (used) {
+      bits += (sync_bits + 7) & ~7;
+    }
+  }
+
+  return bits;
+}
+
+/// @brief Run `proc_init` for a master's slaves and estimate its domain.
+///
+/// Disabled slaves export their pins like any other, but their PDOs
+/// aren't part of the domain.  The caller sets `lcec_dry_run`.
+///
+/// @param master The master to check.
+/// @param domain_bits Set to the estimated domain size in bits.
+/// @param unknown Set to the number of PDO entries of unknown size.
+/// @return The number of PDO entries in the domain.
+int checkMaster(lcec_master_t *master, unsigned int *domain_bits, int *unknown) {
+  lcec_slave_t *slave;
+  int pdo_entries = 0;
+
+  *domain_bits = 0;
+  *unknown = 0;
+
+  for (slave = master->first_slave; slave != NULL; slave = slave->next) {
+    lcec_mem_track(master, slave);
+    slave->regs = lcec_allocate_pdo_entry_reg(LCEC_MAX_PDO_REG_COUNT);
+    if (slave->proc_init != NULL && slave->proc_init(lcec_comp_id, slave) != 0) {
+      fprintf(stderr, "%s: ERROR: proc_init failed for slave %s.%s\n", modname, master->name, slave->name);
+      check_errors++;
+      continue;
+    }
+
+    // disabled slaves aren't part of the domain
+    if (slave->disabled) {
+      continue;
+    }
+    pdo_entries += lcec_pdo_entry_reg_len(slave->regs);
+    *domain_bits += checkSlaveDomainBits(slave, unknown);
+  }
+  lcec_mem_track(NULL, NULL);
+
+  return pdo_entries;
+}
+
+/// @brief Validate a config token stream without HAL or an EtherCAT bus.
+///
+/// @param conf The config tokens, terminated by a `lcecConfTypeNone` token.
+/// @return 0 if the configuration is valid, 1 otherwise.
+int checkConfig(char *conf) {
+  lcec_master_t *first_master = NULL, *last_master = NULL;
+  lcec_master_t *master;
+  lcec_slave_t *slave, *other, *largest;
+  int slave_count, master_count, pdo_entries, unknown;
+  unsigned int domain_bits;
+
+  lcec_dry_run = &check_hooks;
+  check_errors = 0;
+  check_pin_count = 0;
+  check_param_count = 0;
+
+  if ((slave_count = lcec_parse_conf_tokens(conf, &first_master, &last_master)) < 0) {
+    fprintf(stderr, "%s: ERROR: config parsing failed\n", modname);
+    check_errors++;
+    goto out;
+  }
+
+  // check for slaves that would collide on the bus or in HAL.  The
+  // lookups return the first slave in config order, so any other
+  // result is a later duplicate.
+  for (master = first_master; master != NULL; master = master->next) {
+    for (slave = master->first_slave; slave != NULL; slave = slave->next) {
+      other = lcec_slave_by_index(master, slave->index);
+      if (other != NULL && other != slave) {
+        fprintf(stderr, "%s: ERROR: slaves %s.%s and %s.%s share index %d\n", modname, master->name, other->name, master->name,
+            slave->name, slave->index);
+        check_errors++;
+      }
+      if (lcec_slave_by_name(master, slave->name) != slave) {
+        fprintf(stderr, "%s: ERROR: duplicate slave name %s.%s\n", modname, master->name, slave->name);
+        check_errors++;
+      }
+    }
+  }
+
+  if (lcec_preinit_slaves(first_master) < 0) {
+    fprintf(stderr, "%s: ERROR: slave preinit failed\n", modname);
+    check_errors++;
+    goto out;
+  }
+
+  for (master_count = 0, master = first_master; master != NULL; master = master->next, master_count++) {
+    pdo_entries = checkMaster(master, &domain_bits, &unknown);
+
+    printf("%s: master %s: %d PDO entries, domain size %u bytes", modname, master->name, pdo_entries, domain_bits / 8);
+    if (unknown > 0) {
+      printf(" plus %d entries of unknown size", unknown);
+    }
+    printf("\n");
+
+    largest = NULL;
+    for (slave = master->first_slave; slave != NULL; slave = slave->next) {
+      if (largest == NULL || lcec_mem_hal_estimate(&slave->mem) > lcec_mem_hal_estimate(&largest->mem)) {
+        largest = slave;
+      }
+    }
+    printf("%s: master %s: about %lu bytes of HAL memory", modname, master->name, (unsigned long)lcec_mem_hal_estimate(&master->mem));
+    if (largest != NULL) {
+      printf(", most for slave %s (%lu bytes)", largest->name, (unsigned long)lcec_mem_hal_estimate(&largest->mem));
+    }
+    printf("\n");
+  }
+
+  printf("%s: %d masters, %d slaves, %d pins, %d params\n", modname, master_count, slave_count, check_pin_count, check_param_count);
+
+out:
+  lcec_dry_run = NULL;
+  checkFreeNames();
+
+  if (check_errors > 0) {
+    printf("%s: configuration check failed with %d errors\n", modname, check_errors);
+    return 1;
+  }
+
+  printf("%s: configuration OK\n", modname);
+  return 0;
+}
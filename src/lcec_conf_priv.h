@@ -23,6 +23,8 @@
 
 #include <expat.h>
 
+#include "lcec.h"
+
 #define BUFFSIZE 8192
 
 struct LCEC_CONF_XML_HANLDER;
@@ -52,6 +54,12 @@ typedef struct {
   size_t len;
 } LCEC_CONF_OUTBUF_T;
 
+typedef struct LCEC_CONF_TEMPLATE {
+  LCEC_CONF_SLAVE_T *conf;
+  long offset;
+  struct LCEC_CONF_TEMPLATE *next;
+} LCEC_CONF_TEMPLATE_T;
+
 extern const char *modname;
 
 #define ADD_OUTPUT_BUFFER(buf, type) ((type *)addOutputBuffer(buf, sizeof(type)))
@@ -62,8 +70,27 @@ void copyFreeOutputBuffer(LCEC_CONF_OUTBUF_T *buf, char *dest);
 
 int parseIcmds(LCEC_CONF_SLAVE_T *slave, LCEC_CONF_OUTBUF_T *outputBuf, const char *filename);
 
+LCEC_CONF_TEMPLATE_T *addSlaveTemplate(LCEC_CONF_SLAVE_T *conf, long offset);
+LCEC_CONF_TEMPLATE_T *findSlaveTemplate(const char *name);
+void freeSlaveTemplates(void);
+void setRepeatedSlaveName(LCEC_CONF_SLAVE_T *slave, const char *base_name, int count, int i);
+
 int initXmlInst(LCEC_CONF_XML_INST_T *inst, const LCEC_CONF_XML_HANLDER_T *states);
 
 int parseHex(const char *s, int slen, uint8_t *buf);
+int parseBool(const char *s);
+
+const char *findLogName(int master, int slave);
+
+int initStartupTrace(int comp_id, const char *file);
+void pollStartupTrace(int master_count);
+void freeStartupTrace(int comp_id);
+
+int checkMaster(lcec_master_t *master, unsigned int *domain_bits, int *unknown);
+int checkConfig(char *conf);
+int reloadCompareStructure(char *active, char *conf);
+int reloadDiff(char *old, char *conf, lcec_master_t **first, int master_index, int slave_index);
+int reloadConfig(char *active, char *conf);
+int reloadRestoreSlave(char *startup, char *active, int master_index, int slave_index);
 
 #endif
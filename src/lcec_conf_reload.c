@@ -0,0 +1,709 @@
+//
+//    Copyright (C) 2024 LinuxCNC-Ethercat contributors
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program; if not, write to the Free Software
+//    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+//
+
+/// @file
+/// @brief Incremental config reload for `lcec_conf --reload`
+///
+/// A reload compares a freshly parsed config with the one the
+/// realtime module is running.  Only `<sdoConfig>`, `<idnConfig>`,
+/// and `<modParam>` values may differ; anything else needs a restart
+/// and rejects the whole reload.
+///
+/// Changed SDOs and IDNs are downloaded through the EtherCAT master's
+/// request queue, which doesn't block the realtime thread.  If a
+/// download fails, the ones already made are rolled back to their old
+/// values.  A changed
+/// modParam is only accepted if the driver turns it into an SDO write
+/// with `lcec_write_sdo*_modparam()`.  To find out, both versions of
+/// the slave are set up with `lcec_dry_run` and their SDO writes are
+/// compared.
+///
+/// The master only knows the startup values, and writes them again
+/// whenever it re-initializes a slave.  `lcec_conf` watches the log
+/// rings for slaves re-entering OP and calls `reloadRestoreSlave()` to
+/// write the reloaded values again.
+///
+/// `reloadConfig()` and `reloadRestoreSlave()` run in a child process,
+/// so nothing they allocate is freed.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lcec.h"
+#include "lcec_conf.h"
+#include "lcec_conf_priv.h"
+
+extern int lcec_comp_id;
+
+typedef struct RELOAD_WRITE {
+  struct RELOAD_WRITE *next;
+  lcec_slave_t *slave;
+  const char *mpname;
+  uint16_t index;
+  uint8_t subindex;
+  size_t length;
+  uint8_t data[];
+} RELOAD_WRITE_T;
+
+typedef struct RELOAD_OP {
+  struct RELOAD_OP *next;
+  lcec_slave_t *slave;
+  LCEC_CONF_TYPE_T type;  ///< `lcecConfTypeSdoConfig` or `lcecConfTypeIdnConfig`.
+  uint16_t index;
+  int16_t subindex;
+  uint8_t drive;
+  uint16_t idn;
+  size_t length;
+  uint8_t *data;
+  size_t old_length;
+  uint8_t *old_data;  ///< Value to roll back to, or NULL if it hasn't been read yet.
+  int applied;
+} RELOAD_OP_T;
+
+static RELOAD_WRITE_T *reload_writes;
+static RELOAD_OP_T *reload_ops;
+static RELOAD_OP_T *reload_ops_last;
+static int reload_pin_count;
+static int reload_param_count;
+static int reload_errors;
+
+static void *reloadHalMalloc(size_t size);
+static int reloadPinNew(const char *name, hal_type_t type, hal_pin_dir_t dir, void **data_ptr_addr);
+static int reloadParamNew(const char *name, hal_type_t type, hal_param_dir_t dir, void *data_addr);
+static void reloadLimitExceeded(lcec_slave_t *slave, const char *what);
+static int reloadSdoWrite(lcec_slave_t *slave, uint16_t index, uint8_t subindex, const uint8_t *value, size_t size, const char *mpname);
+
+static const lcec_dry_run_t reload_hooks = {
+    reloadHalMalloc,
+    reloadPinNew,
+    reloadParamNew,
+    reloadLimitExceeded,
+    reloadSdoWrite,
+};
+
+static void *reloadHalMalloc(size_t size) { return calloc(1, size); }
+
+static int reloadPinNew(const char *name, hal_type_t type, hal_pin_dir_t dir, void **data_ptr_addr) {
+  // hal_float_t is the largest of the pin types drivers use
+  *data_ptr_addr = calloc(1, sizeof(hal_float_t));
+  if (*data_ptr_addr == NULL) {
+    return -1;
+  }
+
+  reload_pin_count++;
+  return 0;
+}
+
+static int reloadParamNew(const char *name, hal_type_t type, hal_param_dir_t dir, void *data_addr) {
+  reload_param_count++;
+  return 0;
+}
+
+static void reloadLimitExceeded(lcec_slave_t *slave, const char *what) {}
+
+static int reloadSdoWrite(lcec_slave_t *slave, uint16_t index, uint8_t subindex, const uint8_t *value, size_t size, const char *mpname) {
+  RELOAD_WRITE_T *w;
+
+  w = calloc(1, sizeof(RELOAD_WRITE_T) + size);
+  if (w == NULL) {
+    fprintf(stderr, "%s: ERROR: Couldn't allocate memory for SDO write\n", modname);
+    return -1;
+  }
+  w->slave = slave;
+  w->mpname = mpname;
+  w->index = index;
+  w->subindex = subindex;
+  w->length = size;
+  memcpy(w->data, value, size);
+
+  w->next = reload_writes;
+  reload_writes = w;
+  return 0;
+}
+
+static size_t reloadTokenLength(const char *conf) {
+  switch (((LCEC_CONF_NULL_T *)conf)->confType) {
+    case lcecConfTypeMaster:
+      return sizeof(LCEC_CONF_MASTER_T);
+    case lcecConfTypeSlave:
+    case lcecConfTypeSlaveTemplate:
+      return sizeof(LCEC_CONF_SLAVE_T);
+    case lcecConfTypeDcConf:
+      return sizeof(LCEC_CONF_DC_T);
+    case lcecConfTypeWatchdog:
+      return sizeof(LCEC_CONF_WATCHDOG_T);
+    case lcecConfTypeSyncManager:
+      return sizeof(LCEC_CONF_SYNCMANAGER_T);
+    case lcecConfTypePdo:
+      return sizeof(LCEC_CONF_PDO_T);
+    case lcecConfTypePdoEntry:
+      return sizeof(LCEC_CONF_PDOENTRY_T);
+    case lcecConfTypeComplexEntry:
+      return sizeof(LCEC_CONF_COMPLEXENTRY_T);
+    case lcecConfTypeSdoConfig:
+      return sizeof(LCEC_CONF_SDOCONF_T) + ((LCEC_CONF_SDOCONF_T *)conf)->length;
+    case lcecConfTypeIdnConfig:
+      return sizeof(LCEC_CONF_IDNCONF_T) + ((LCEC_CONF_IDNCONF_T *)conf)->length;
+    case lcecConfTypeModParam:
+      return sizeof(LCEC_CONF_MODPARAM_T);
+    case lcecConfTypeSdoPin:
+      return sizeof(LCEC_CONF_SDOPIN_T);
+    default:
+      return sizeof(LCEC_CONF_NULL_T);
+  }
+}
+
+// Skip the tokens that a reload is allowed to change.
+static char *reloadSkipValues(char *conf) {
+  for (;;) {
+    switch (((LCEC_CONF_NULL_T *)conf)->confType) {
+      case lcecConfTypeSdoConfig:
+      case lcecConfTypeIdnConfig:
+      case lcecConfTypeModParam:
+        conf += reloadTokenLength(conf);
+        break;
+      default:
+        return conf;
+    }
+  }
+}
+
+// Check that two configs only differ in SDO, IDN, and modParam
+// values.  Template bodies are compared where they are defined, so
+// slaves that use them only need to match by their own token.
+int reloadCompareStructure(char *active, char *conf) {
+  LCEC_CONF_TYPE_T type;
+  LCEC_CONF_SLAVE_T a, b;
+  const char *master_name = "";
+  const char *slave_name = "";
+  size_t len;
+
+  for (;;) {
+    active = reloadSkipValues(active);
+    conf = reloadSkipValues(conf);
+
+    type = ((LCEC_CONF_NULL_T *)active)->confType;
+    if (((LCEC_CONF_NULL_T *)conf)->confType != type) {
+      goto changed;
+    }
+    if (type == lcecConfTypeNone) {
+      return 0;
+    }
+
+    len = reloadTokenLength(active);
+    if (type == lcecConfTypeSlave || type == lcecConfTypeSlaveTemplate) {
+      // lengths and offsets follow from the value tokens
+      memcpy(&a, active, sizeof(a));
+      memcpy(&b, conf, sizeof(b));
+      a.sdoConfigLength = b.sdoConfigLength = 0;
+      a.idnConfigLength = b.idnConfigLength = 0;
+      a.modParamCount = b.modParamCount = 0;
+      a.templateOffset = b.templateOffset = 0;
+      a.templateLength = b.templateLength = 0;
+      slave_name = ((LCEC_CONF_SLAVE_T *)active)->name;
+      if (memcmp(&a, &b, sizeof(a)) != 0) {
+        goto changed;
+      }
+    } else {
+      if (type == lcecConfTypeMaster) {
+        master_name = ((LCEC_CONF_MASTER_T *)active)->name;
+        slave_name = "";
+      }
+      if (len != reloadTokenLength(conf) || memcmp(active, conf, len) != 0) {
+        goto changed;
+      }
+    }
+
+    active += len;
+    conf += len;
+  }
+
+changed:
+  fprintf(stderr, "%s: ERROR: config structure changed near master %s slave %s, restart LinuxCNC to apply it\n", modname, master_name,
+      slave_name);
+  return -1;
+}
+
+static void reloadAddOp(lcec_slave_t *slave, LCEC_CONF_TYPE_T type, uint16_t index, int16_t subindex, uint8_t drive, uint16_t idn,
+    uint8_t *data, size_t length, uint8_t *old_data, size_t old_length) {
+  RELOAD_OP_T *op;
+
+  op = calloc(1, sizeof(RELOAD_OP_T));
+  if (op == NULL) {
+    fprintf(stderr, "%s: ERROR: Couldn't allocate memory for reload\n", modname);
+    reload_errors++;
+    return;
+  }
+  op->slave = slave;
+  op->type = type;
+  op->index = index;
+  op->subindex = subindex;
+  op->drive = drive;
+  op->idn = idn;
+  op->data = data;
+  op->length = length;
+  op->old_data = old_data;
+  op->old_length = old_length;
+
+  if (reload_ops_last != NULL) {
+    reload_ops_last->next = op;
+  } else {
+    reload_ops = op;
+  }
+  reload_ops_last = op;
+}
+
+static lcec_slave_sdoconf_t *reloadFindSdo(lcec_slave_sdoconf_t *list, uint16_t index, int16_t subindex) {
+  lcec_slave_sdoconf_t *sdo;
+
+  for (sdo = list; sdo != NULL && sdo->index != 0xffff; sdo = (lcec_slave_sdoconf_t *)&sdo->data[sdo->length]) {
+    if (sdo->index == index && sdo->subindex == subindex) {
+      return sdo;
+    }
+  }
+  return NULL;
+}
+
+static lcec_slave_idnconf_t *reloadFindIdn(lcec_slave_idnconf_t *list, uint8_t drive, uint16_t idn, ec_al_state_t state) {
+  lcec_slave_idnconf_t *p;
+
+  for (p = list; p != NULL && p->state != 0; p = (lcec_slave_idnconf_t *)&p->data[p->length]) {
+    if (p->drive == drive && p->idn == idn && p->state == state) {
+      return p;
+    }
+  }
+  return NULL;
+}
+
+static void reloadDiffSdos(lcec_slave_t *old, lcec_slave_t *slave) {
+  lcec_slave_sdoconf_t *sdo, *prev;
+
+  for (sdo = slave->sdo_config; sdo != NULL && sdo->index != 0xffff; sdo = (lcec_slave_sdoconf_t *)&sdo->data[sdo->length]) {
+    prev = reloadFindSdo(old->sdo_config, sdo->index, sdo->subindex);
+    if (prev == NULL || prev->length != sdo->length || memcmp(prev->data, sdo->data, sdo->length) != 0) {
+      reloadAddOp(slave, lcecConfTypeSdoConfig, sdo->index, sdo->subindex, 0, 0, sdo->data, sdo->length, prev != NULL ? prev->data : NULL,
+          prev != NULL ? prev->length : 0);
+    }
+  }
+
+  for (sdo = old->sdo_config; sdo != NULL && sdo->index != 0xffff; sdo = (lcec_slave_sdoconf_t *)&sdo->data[sdo->length]) {
+    if (reloadFindSdo(slave->sdo_config, sdo->index, sdo->subindex) == NULL) {
+      fprintf(stderr, "%s: ERROR: slave %s.%s: SDO 0x%04x:0x%02x was removed, restart LinuxCNC to apply it\n", modname,
+          slave->master->name, slave->name, sdo->index, sdo->subindex & 0xff);
+      reload_errors++;
+    }
+  }
+}
+
+static void reloadDiffIdns(lcec_slave_t *old, lcec_slave_t *slave) {
+  lcec_slave_idnconf_t *p, *prev;
+
+  for (p = slave->idn_config; p != NULL && p->state != 0; p = (lcec_slave_idnconf_t *)&p->data[p->length]) {
+    prev = reloadFindIdn(old->idn_config, p->drive, p->idn, p->state);
+    if (prev == NULL || prev->length != p->length || memcmp(prev->data, p->data, p->length) != 0) {
+      reloadAddOp(slave, lcecConfTypeIdnConfig, 0, 0, p->drive, p->idn, p->data, p->length, prev != NULL ? prev->data : NULL,
+          prev != NULL ? prev->length : 0);
+    }
+  }
+
+  for (p = old->idn_config; p != NULL && p->state != 0; p = (lcec_slave_idnconf_t *)&p->data[p->length]) {
+    if (reloadFindIdn(slave->idn_config, p->drive, p->idn, p->state) == NULL) {
+      fprintf(stderr, "%s: ERROR: slave %s.%s: IDN %c-%d-%d was removed, restart LinuxCNC to apply it\n", modname, slave->master->name,
+          slave->name, (p->idn & 0x8000) ? 'P' : 'S', (p->idn >> 12) & 0x0007, p->idn & 0x0fff);
+      reload_errors++;
+    }
+  }
+}
+
+static const lcec_slave_modparam_t *reloadFindModParam(const lcec_slave_modparam_t *list, int id) {
+  for (; list != NULL && list->id >= 0; list++) {
+    if (list->id == id) {
+      return list;
+    }
+  }
+  return NULL;
+}
+
+static RELOAD_WRITE_T *reloadFindWrite(lcec_slave_t *slave, uint16_t index, uint8_t subindex, const char *mpname) {
+  RELOAD_WRITE_T *w;
+
+  for (w = reload_writes; w != NULL; w = w->next) {
+    if (w->slave != slave) {
+      continue;
+    }
+    if (mpname != NULL ? (w->mpname != NULL && strcmp(w->mpname, mpname) == 0) : (w->index == index && w->subindex == subindex)) {
+      return w;
+    }
+  }
+  return NULL;
+}
+
+// Run a slave's `proc_init` with the reload hooks, returning the
+// number of pins, params, and PDO entries it registered.
+static int reloadInitSlave(lcec_slave_t *slave, int *pins, int *params, int *entries) {
+  reload_pin_count = 0;
+  reload_param_count = 0;
+
+  slave->regs = lcec_allocate_pdo_entry_reg(LCEC_MAX_PDO_REG_COUNT);
+  if (slave->proc_init != NULL && slave->proc_init(lcec_comp_id, slave) != 0) {
+    fprintf(stderr, "%s: ERROR: slave %s.%s: proc_init failed\n", modname, slave->master->name, slave->name);
+    reload_errors++;
+    return -1;
+  }
+
+  *pins = reload_pin_count;
+  *params = reload_param_count;
+  *entries = lcec_pdo_entry_reg_len(slave->regs);
+  return 0;
+}
+
+static void reloadDiffModParams(lcec_slave_t *old, lcec_slave_t *slave) {
+  const lcec_slave_modparam_t *p, *prev;
+  RELOAD_WRITE_T *w, *prev_w;
+  int old_pins, old_params, old_entries, pins, params, entries;
+  int changed = 0;
+
+  for (p = old->modparams; p != NULL && p->id >= 0; p++) {
+    if (reloadFindModParam(slave->modparams, p->id) == NULL) {
+      fprintf(stderr, "%s: ERROR: slave %s.%s: modParam %s was removed, restart LinuxCNC to apply it\n", modname, slave->master->name,
+          slave->name, p->name);
+      reload_errors++;
+    }
+  }
+  for (p = slave->modparams; p != NULL && p->id >= 0; p++) {
+    prev = reloadFindModParam(old->modparams, p->id);
+    if (prev == NULL || memcmp(&prev->value, &p->value, sizeof(p->value)) != 0) {
+      changed++;
+    }
+  }
+  if (changed == 0) {
+    return;
+  }
+
+  if (reloadInitSlave(old, &old_pins, &old_params, &old_entries) || reloadInitSlave(slave, &pins, &params, &entries)) {
+    return;
+  }
+  if (pins != old_pins || params != old_params || entries != old_entries) {
+    fprintf(stderr, "%s: ERROR: slave %s.%s: modParam changes alter pins or PDOs, restart LinuxCNC to apply them\n", modname,
+        slave->master->name, slave->name);
+    reload_errors++;
+    return;
+  }
+
+  // every changed modParam must map directly to an SDO
+  for (p = slave->modparams; p != NULL && p->id >= 0; p++) {
+    prev = reloadFindModParam(old->modparams, p->id);
+    if (prev != NULL && memcmp(&prev->value, &p->value, sizeof(p->value)) == 0) {
+      continue;
+    }
+    if (reloadFindWrite(slave, 0, 0, p->name) == NULL) {
+      fprintf(stderr, "%s: ERROR: slave %s.%s: modParam %s can't be changed at runtime, restart LinuxCNC to apply it\n", modname,
+          slave->master->name, slave->name, p->name);
+      reload_errors++;
+    }
+  }
+
+  for (w = reload_writes; w != NULL; w = w->next) {
+    if (w->slave != slave) {
+      continue;
+    }
+    prev_w = reloadFindWrite(old, w->index, w->subindex, NULL);
+    if (prev_w == NULL || prev_w->length != w->length || memcmp(prev_w->data, w->data, w->length) != 0) {
+      reloadAddOp(slave, lcecConfTypeSdoConfig, w->index, w->subindex, 0, 0, w->data, w->length, prev_w != NULL ? prev_w->data : NULL,
+          prev_w != NULL ? prev_w->length : 0);
+    }
+  }
+}
+
+// Download `data` for an op, printing any error.
+static int reloadWrite(RELOAD_OP_T *op, uint8_t *data, size_t length) {
+  lcec_slave_t *slave = op->slave;
+  lcec_master_t *master = slave->master;
+  uint32_t abort_code = 0;
+  uint16_t error_code = 0;
+  int err;
+
+  if (op->type == lcecConfTypeIdnConfig) {
+    err = ecrt_master_write_idn(master->master, slave->index, op->drive, op->idn, data, length, &error_code);
+    if (err) {
+      fprintf(stderr, "%s: ERROR: slave %s.%s: IDN %c-%d-%d write failed (error %d, error_code %04x)\n", modname, master->name,
+          slave->name, (op->idn & 0x8000) ? 'P' : 'S', (op->idn >> 12) & 0x0007, op->idn & 0x0fff, err, error_code);
+    }
+    return err;
+  }
+
+  if (op->subindex == LCEC_CONF_SDO_COMPLETE_SUBIDX) {
+    err = ecrt_master_sdo_download_complete(master->master, slave->index, op->index, data, length, &abort_code);
+  } else {
+    err = ecrt_master_sdo_download(master->master, slave->index, op->index, op->subindex, data, length, &abort_code);
+  }
+  if (err) {
+    fprintf(stderr, "%s: ERROR: slave %s.%s: SDO 0x%04x:0x%02x download failed (error %d, abort_code %08x)\n", modname, master->name,
+        slave->name, op->index, op->subindex & 0xff, err, abort_code);
+  }
+  return err;
+}
+
+// Read the value an op is about to overwrite, for values that weren't
+// in the old config.  Complete access SDOs can't be read back through
+// the request queue.
+static int reloadReadOld(RELOAD_OP_T *op) {
+  lcec_slave_t *slave = op->slave;
+  lcec_master_t *master = slave->master;
+  uint32_t abort_code = 0;
+  uint16_t error_code = 0;
+  size_t size = 0;
+  int err;
+
+  if (op->type == lcecConfTypeSdoConfig && op->subindex == LCEC_CONF_SDO_COMPLETE_SUBIDX) {
+    fprintf(stderr, "%s: ERROR: slave %s.%s: SDO 0x%04x has no old value to roll back to, restart LinuxCNC to apply it\n", modname,
+        master->name, slave->name, op->index);
+    return -1;
+  }
+
+  op->old_data = calloc(1, op->length);
+  if (op->old_data == NULL) {
+    fprintf(stderr, "%s: ERROR: Couldn't allocate memory for reload\n", modname);
+    return -1;
+  }
+
+  if (op->type == lcecConfTypeIdnConfig) {
+    err = ecrt_master_read_idn(master->master, slave->index, op->drive, op->idn, op->old_data, op->length, &size, &error_code);
+    if (err) {
+      fprintf(stderr, "%s: ERROR: slave %s.%s: IDN %c-%d-%d read failed (error %d, error_code %04x)\n", modname, master->name,
+          slave->name, (op->idn & 0x8000) ? 'P' : 'S', (op->idn >> 12) & 0x0007, op->idn & 0x0fff, err, error_code);
+    }
+  } else {
+    err = ecrt_master_sdo_upload(master->master, slave->index, op->index, op->subindex, op->old_data, op->length, &size, &abort_code);
+    if (err) {
+      fprintf(stderr, "%s: ERROR: slave %s.%s: SDO 0x%04x:0x%02x upload failed (error %d, abort_code %08x)\n", modname, master->name,
+          slave->name, op->index, op->subindex & 0xff, err, abort_code);
+    }
+  }
+  if (err) {
+    free(op->old_data);
+    op->old_data = NULL;
+    return -1;
+  }
+
+  op->old_length = size;
+  return 0;
+}
+
+static void reloadPrintOp(RELOAD_OP_T *op, const char *what) {
+  lcec_slave_t *slave = op->slave;
+
+  if (op->type == lcecConfTypeIdnConfig) {
+    printf("%s: slave %s.%s: IDN %c-%d-%d %s\n", modname, slave->master->name, slave->name, (op->idn & 0x8000) ? 'P' : 'S',
+        (op->idn >> 12) & 0x0007, op->idn & 0x0fff, what);
+  } else {
+    printf("%s: slave %s.%s: SDO 0x%04x:0x%02x %s\n", modname, slave->master->name, slave->name, op->index, op->subindex & 0xff, what);
+  }
+}
+
+// Write every op.  With `rollback` set, the first failure stops the
+// writes and the ones already made get their old values back.
+//
+// Returns 0 if everything was written, -1 if nothing is left changed,
+// and -2 if some writes are still in place.
+static int reloadApply(lcec_master_t *first_master, int rollback) {
+  lcec_master_t *master;
+  RELOAD_OP_T *op;
+  int errors = 0, rollback_errors = 0;
+
+  for (op = reload_ops; op != NULL; op = op->next) {
+    master = op->slave->master;
+
+    if (master->master == NULL) {
+      master->master = ecrt_open_master(master->index);
+      if (master->master == NULL) {
+        fprintf(stderr, "%s: ERROR: unable to open master %s\n", modname, master->name);
+        errors++;
+        break;
+      }
+    }
+
+    if (rollback && op->old_data == NULL && reloadReadOld(op) < 0) {
+      errors++;
+      break;
+    }
+    if (reloadWrite(op, op->data, op->length)) {
+      errors++;
+      if (rollback) {
+        break;
+      }
+      continue;
+    }
+    op->applied = 1;
+    reloadPrintOp(op, "updated");
+  }
+
+  if (errors > 0 && rollback) {
+    for (op = reload_ops; op != NULL; op = op->next) {
+      if (!op->applied) {
+        continue;
+      }
+      if (reloadWrite(op, op->old_data, op->old_length)) {
+        rollback_errors++;
+        continue;
+      }
+      op->applied = 0;
+      reloadPrintOp(op, "rolled back");
+    }
+  }
+
+  for (master = first_master; master != NULL; master = master->next) {
+    if (master->master != NULL) {
+      ecrt_release_master(master->master);
+      master->master = NULL;
+    }
+  }
+
+  if (errors == 0) {
+    return 0;
+  }
+  return (rollback && rollback_errors == 0) ? -1 : -2;
+}
+
+// Parse two configs and queue the ops that turn `old` into `conf`,
+// for all slaves or only for the one at `slave_index` on the
+// `master_index`th master.  Returns the number of ops, or -1 if the
+// differences can't be applied at runtime.
+int reloadDiff(char *old, char *conf, lcec_master_t **first, int master_index, int slave_index) {
+  lcec_master_t *old_first = NULL, *old_last = NULL, *last = NULL;
+  lcec_master_t *old_master, *master;
+  lcec_slave_t *old_slave, *slave;
+  RELOAD_OP_T *op;
+  int count = 0, i;
+
+  *first = NULL;
+  reload_writes = NULL;
+  reload_ops = NULL;
+  reload_ops_last = NULL;
+
+  lcec_dry_run = &reload_hooks;
+  reload_errors = 0;
+  if (lcec_parse_conf_tokens(old, &old_first, &old_last) < 0 || lcec_parse_conf_tokens(conf, first, &last) < 0) {
+    fprintf(stderr, "%s: ERROR: config parsing failed\n", modname);
+    lcec_dry_run = NULL;
+    return -1;
+  }
+  if (lcec_preinit_slaves(old_first) < 0 || lcec_preinit_slaves(*first) < 0) {
+    fprintf(stderr, "%s: ERROR: slave preinit failed\n", modname);
+    lcec_dry_run = NULL;
+    return -1;
+  }
+
+  // the structure matched, so masters and slaves pair up in order
+  for (old_master = old_first, master = *first, i = 0; master != NULL; old_master = old_master->next, master = master->next, i++) {
+    if (master_index >= 0 && i != master_index) {
+      continue;
+    }
+    for (old_slave = old_master->first_slave, slave = master->first_slave; slave != NULL;
+         old_slave = old_slave->next, slave = slave->next) {
+      // disabled slaves have nothing on the bus to update
+      if (slave->disabled || (slave_index >= 0 && slave->index != slave_index)) {
+        continue;
+      }
+      reloadDiffSdos(old_slave, slave);
+      reloadDiffIdns(old_slave, slave);
+      reloadDiffModParams(old_slave, slave);
+    }
+  }
+  lcec_dry_run = NULL;
+
+  if (reload_errors > 0) {
+    return -1;
+  }
+
+  for (op = reload_ops; op != NULL; op = op->next) {
+    count++;
+  }
+  return count;
+}
+
+/// @brief Apply the runtime-safe differences between two configs.
+///
+/// Nothing is applied unless every difference can be applied at
+/// runtime, and writes that were made before a failed one are rolled
+/// back.
+///
+/// @param active The config tokens that are currently active.
+/// @param conf The new config tokens.
+/// @return 0 if the new config is now active, 1 otherwise.
+int reloadConfig(char *active, char *conf) {
+  lcec_master_t *first;
+  int count, ret;
+
+  if (reloadCompareStructure(active, conf)) {
+    return 1;
+  }
+
+  count = reloadDiff(active, conf, &first, -1, -1);
+  if (count < 0) {
+    if (reload_errors > 0) {
+      printf("%s: reload rejected with %d errors, nothing was changed\n", modname, reload_errors);
+    }
+    return 1;
+  }
+  if (count == 0) {
+    printf("%s: reload found no changes\n", modname);
+    return 0;
+  }
+
+  ret = reloadApply(first, 1);
+  if (ret == -1) {
+    printf("%s: reload failed, nothing was changed\n", modname);
+    return 1;
+  }
+  if (ret < 0) {
+    fprintf(stderr, "%s: ERROR: reload failed and couldn't be rolled back, restart LinuxCNC to get a known config\n", modname);
+    return 1;
+  }
+
+  printf("%s: reload applied %d changes\n", modname, count);
+  return 0;
+}
+
+/// @brief Write reloaded values to a slave again after the master
+/// re-initialized it.
+///
+/// @param startup The config tokens the realtime module was started with.
+/// @param active The config tokens that are currently active.
+/// @param master_index Index of the slave's master, in config order.
+/// @param slave_index Bus position of the slave.
+/// @return 0 if the slave matches the active config again, 1 otherwise.
+int reloadRestoreSlave(char *startup, char *active, int master_index, int slave_index) {
+  lcec_master_t *first;
+  int count;
+
+  count = reloadDiff(startup, active, &first, master_index, slave_index);
+  if (count <= 0) {
+    return count < 0;
+  }
+
+  if (reloadApply(first, 0) < 0) {
+    fprintf(stderr, "%s: ERROR: couldn't restore reloaded values to re-initialized slave %d on master %d, restart LinuxCNC\n", modname,
+        slave_index, master_index);
+    return 1;
+  }
+
+  printf("%s: restored %d reloaded values to re-initialized slave %d on master %d\n", modname, count, slave_index, master_index);
+  return 0;
+}
@@ -0,0 +1,308 @@
+//
+//    Copyright (C) 2024 LinuxCNC-Ethercat contributors
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program; if not, write to the Free Software
+//    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+//
+
+/// @file
+/// @brief Startup timeline report for `lcec_conf`
+///
+/// `lcec_conf` creates the startup trace table before the realtime
+/// module is loaded and polls it along with the log rings.  Once
+/// every master has reached OP, a summary is printed and the full
+/// timeline is written to the file given with `--trace-file`, or to
+/// `LCEC_CONF_TRACE_FILE` in `$XDG_RUNTIME_DIR` (or `/tmp`).  If that takes
+/// longer than `LCEC_CONF_TRACE_TIMEOUT_S`, a partial report is
+/// written first, so a slave that never comes up shows as well.
+
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "lcec.h"
+#include "lcec_conf.h"
+#include "lcec_conf_priv.h"
+
+#define LCEC_CONF_TRACE_FILE      "lcec-startup.txt"  ///< Where the full timeline goes, without `--trace-file`.
+#define LCEC_CONF_TRACE_TIMEOUT_S 120                 ///< Report anyway after this long (s).
+#define LCEC_CONF_TRACE_SLOWEST   5                   ///< Slowest slave stages in the summary.
+
+static const char *stage_names[LCEC_TRACE_STAGE_COUNT] = {
+    [LCEC_TRACE_PARSE_CONFIG] = "parse-config",
+    [LCEC_TRACE_PREINIT] = "preinit",
+    [LCEC_TRACE_REQUEST_MASTER] = "request-master",
+    [LCEC_TRACE_SLAVE_CONFIG] = "slave-config",
+    [LCEC_TRACE_SDO_IDN] = "sdo-idn",
+    [LCEC_TRACE_PROC_INIT] = "proc-init",
+    [LCEC_TRACE_PDO_CONFIG] = "pdo-config",
+    [LCEC_TRACE_DOMAIN_REG] = "domain-reg",
+    [LCEC_TRACE_ACTIVATE] = "activate",
+    [LCEC_TRACE_WAIT_OP] = "wait-op",
+    [LCEC_TRACE_MASTER_OP] = "master-op",
+};
+
+static int trace_shmem_id;
+static lcec_trace_t *trace = NULL;
+static time_t first_seen;
+static int reported_partial;
+static int reported_done;
+static char trace_file[PATH_MAX];
+
+/// @brief Create the startup trace table for the realtime module.
+///
+/// @param file Where to write the full timeline, or NULL for the default.
+int initStartupTrace(int comp_id, const char *file) {
+  const char *dir;
+  void *ptr;
+
+  if (file != NULL) {
+    snprintf(trace_file, sizeof(trace_file), "%s", file);
+  } else {
+    dir = getenv("XDG_RUNTIME_DIR");
+    snprintf(trace_file, sizeof(trace_file), "%s/%s", dir != NULL && dir[0] != 0 ? dir : "/tmp", LCEC_CONF_TRACE_FILE);
+  }
+
+  trace_shmem_id = rtapi_shmem_new(LCEC_TRACE_SHMEM_KEY, comp_id, sizeof(lcec_trace_t));
+  if (trace_shmem_id < 0) {
+    fprintf(stderr, "%s: ERROR: couldn't allocate startup trace shared memory\n", modname);
+    return -1;
+  }
+  if (lcec_rtapi_shmem_getptr(trace_shmem_id, &ptr) < 0) {
+    fprintf(stderr, "%s: ERROR: couldn't map startup trace shared memory\n", modname);
+    rtapi_shmem_delete(trace_shmem_id, comp_id);
+    return -1;
+  }
+
+  memset(ptr, 0, sizeof(lcec_trace_t));
+  trace = (lcec_trace_t *)ptr;
+  trace->magic = LCEC_TRACE_SHMEM_MAGIC;
+  return 0;
+}
+
+/// @brief Release the startup trace table.
+void freeStartupTrace(int comp_id) {
+  if (trace != NULL) {
+    rtapi_shmem_delete(trace_shmem_id, comp_id);
+    trace = NULL;
+  }
+}
+
+static int countRecords(void) {
+  uint32_t count = __atomic_load_n(&trace->count, __ATOMIC_RELAXED);
+  return count < LCEC_TRACE_MAX_RECORDS ? count : LCEC_TRACE_MAX_RECORDS;
+}
+
+static int isValid(lcec_trace_record_t *rec) {
+  return __atomic_load_n(&rec->valid, __ATOMIC_ACQUIRE) != 0;
+}
+
+static double toMs(long long ns) {
+  return ns / 1000000.0;
+}
+
+static const char *masterName(int master) {
+  const char *name = findLogName(master, -1);
+  return name != NULL ? name : "?";
+}
+
+static const char *slaveName(int master, int slave) {
+  const char *name = findLogName(master, slave);
+  return name != NULL ? name : "?";
+}
+
+/// @brief Open the timeline file for writing.
+///
+/// The default file may be in a world-writable directory, so this
+/// neither follows a symlink there nor writes into somebody else's
+/// file.
+static FILE *openTimeline(void) {
+  struct stat st;
+  FILE *f;
+  int fd;
+
+  fd = open(trace_file, O_WRONLY | O_CREAT | O_NOFOLLOW | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    return NULL;
+  }
+  if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_uid != geteuid() || ftruncate(fd, 0) != 0) {
+    close(fd);
+    return NULL;
+  }
+  f = fdopen(fd, "w");
+  if (f == NULL) {
+    close(fd);
+  }
+  return f;
+}
+
+static void writeTimeline(int count, long long t0, int done) {
+  lcec_trace_record_t *rec;
+  FILE *f;
+  int i;
+
+  f = openTimeline();
+  if (f == NULL) {
+    fprintf(stderr, "%s: ERROR: unable to write startup trace to %s\n", modname, trace_file);
+    return;
+  }
+
+  fprintf(f, "# lcec startup trace%s\n", done ? "" : " (incomplete, not all slaves reached OP)");
+  fprintf(f, "# times in ms from the start of lcec_parse_config()\n");
+  fprintf(f, "#%11s %12s  %-14s %s\n", "start", "duration", "stage", "master.slave");
+  for (i = 0; i < count; i++) {
+    rec = &trace->records[i];
+    if (!isValid(rec) || rec->stage >= LCEC_TRACE_STAGE_COUNT) {
+      continue;
+    }
+    fprintf(f, "%12.3f %12.3f  %-14s ", toMs(rec->start - t0), toMs(rec->duration), stage_names[rec->stage]);
+    if (rec->master < 0) {
+      fprintf(f, "-\n");
+    } else if (rec->slave < 0) {
+      fprintf(f, "%s\n", masterName(rec->master));
+    } else {
+      fprintf(f, "%s.%s\n", masterName(rec->master), slaveName(rec->master, rec->slave));
+    }
+  }
+
+  if (trace->count > LCEC_TRACE_MAX_RECORDS) {
+    fprintf(f, "# %u records dropped\n", trace->count - LCEC_TRACE_MAX_RECORDS);
+  }
+  fclose(f);
+}
+
+static void printSummary(int count, int master_count, long long t0) {
+  lcec_trace_record_t *rec, *slowest[LCEC_CONF_TRACE_SLOWEST];
+  long long *totals;
+  long long parse = 0;
+  char buf[512];
+  size_t len;
+  int i, j, m;
+
+  totals = calloc(master_count * LCEC_TRACE_STAGE_COUNT, sizeof(long long));
+  if (totals == NULL) {
+    return;
+  }
+  memset(slowest, 0, sizeof(slowest));
+
+  for (i = 0; i < count; i++) {
+    rec = &trace->records[i];
+    if (!isValid(rec) || rec->stage >= LCEC_TRACE_STAGE_COUNT) {
+      continue;
+    }
+    if (rec->master < 0) {
+      parse += rec->duration;
+      continue;
+    }
+    if (rec->master >= master_count) {
+      continue;
+    }
+    totals[rec->master * LCEC_TRACE_STAGE_COUNT + rec->stage] += rec->duration;
+
+    // everything waits for OP together, so that's not interesting here
+    if (rec->slave < 0 || rec->stage == LCEC_TRACE_WAIT_OP) {
+      continue;
+    }
+    for (j = 0; j < LCEC_CONF_TRACE_SLOWEST; j++) {
+      if (slowest[j] == NULL || rec->duration > slowest[j]->duration) {
+        memmove(&slowest[j + 1], &slowest[j], (LCEC_CONF_TRACE_SLOWEST - j - 1) * sizeof(slowest[0]));
+        slowest[j] = rec;
+        break;
+      }
+    }
+  }
+
+  printf("%s: startup trace: parse-config %.1f ms\n", modname, toMs(parse));
+  for (m = 0; m < master_count; m++) {
+    len = 0;
+    for (i = LCEC_TRACE_PREINIT; i <= LCEC_TRACE_ACTIVATE; i++) {
+      len += snprintf(buf + len, sizeof(buf) - len, " %s %.1f,", stage_names[i], toMs(totals[m * LCEC_TRACE_STAGE_COUNT + i]));
+      // snprintf returns the untruncated length, so keep `len` inside buf
+      if (len >= sizeof(buf)) {
+        len = sizeof(buf) - 1;
+      }
+    }
+    if (totals[m * LCEC_TRACE_STAGE_COUNT + LCEC_TRACE_MASTER_OP] != 0) {
+      snprintf(buf + len, sizeof(buf) - len, " OP %.1f after activation", toMs(totals[m * LCEC_TRACE_STAGE_COUNT + LCEC_TRACE_MASTER_OP]));
+    } else {
+      snprintf(buf + len, sizeof(buf) - len, " not yet OP");
+    }
+    printf("%s: master %s (ms):%s\n", modname, masterName(m), buf);
+  }
+  for (j = 0; j < LCEC_CONF_TRACE_SLOWEST && slowest[j] != NULL; j++) {
+    rec = slowest[j];
+    printf("%s: slowest %d: %s.%s %s %.1f ms\n", modname, j + 1, masterName(rec->master), slaveName(rec->master, rec->slave),
+        stage_names[rec->stage], toMs(rec->duration));
+  }
+  printf("%s: full startup timeline in %s\n", modname, trace_file);
+  fflush(stdout);
+
+  free(totals);
+}
+
+/// @brief Check whether startup has finished, and report it if so.
+///
+/// Called from `lcec_conf`'s poll loop.  Does nothing once the final
+/// report has been written.
+void pollStartupTrace(int master_count) {
+  lcec_trace_record_t *rec;
+  long long t0 = 0;
+  int count, i, masters_op, done;
+
+  if (trace == NULL || reported_done) {
+    return;
+  }
+
+  count = countRecords();
+  if (count == 0) {
+    return;
+  }
+  if (first_seen == 0) {
+    first_seen = time(NULL);
+  }
+
+  masters_op = 0;
+  for (i = 0; i < count; i++) {
+    rec = &trace->records[i];
+    if (!isValid(rec)) {
+      continue;
+    }
+    if (t0 == 0 || rec->start < t0) {
+      t0 = rec->start;
+    }
+    if (rec->stage == LCEC_TRACE_MASTER_OP) {
+      masters_op++;
+    }
+  }
+
+  done = masters_op >= master_count;
+  if (!done && (reported_partial || time(NULL) - first_seen < LCEC_CONF_TRACE_TIMEOUT_S)) {
+    return;
+  }
+
+  writeTimeline(count, t0, done);
+  printSummary(count, master_count, t0);
+  if (done) {
+    reported_done = 1;
+  } else {
+    fprintf(stderr, "%s: WARNING: not all slaves reached OP within %d s, startup trace is incomplete\n", modname,
+        LCEC_CONF_TRACE_TIMEOUT_S);
+    reported_partial = 1;
+  }
+}
@@ -21,6 +21,7 @@
 #include <ctype.h>
 #include <expat.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 
@@ -29,6 +30,8 @@
 
 const char *modname = "lcec_conf";
 
+static LCEC_CONF_TEMPLATE_T *slave_templates;
+
 static void xml_start_handler(void *data, const char *el, const char **attr);
 static void xml_end_handler(void *data, const char *el);
 
@@ -131,6 +134,83 @@ static void xml_end_handler(void *data, const char *el) {
   XML_StopParser(inst->parser, 0);
 }
 
+/// @brief Register a `<slaveTemplate>`.
+///
+/// @param conf The template's slave token.
+/// @param offset The offset of the template body in the config data.
+/// @return The new template, or NULL if it has no name, the name is
+///   already taken, or memory runs out.
+LCEC_CONF_TEMPLATE_T *addSlaveTemplate(LCEC_CONF_SLAVE_T *conf, long offset) {
+  LCEC_CONF_TEMPLATE_T *tmpl;
+
+  if (conf->name[0] == 0) {
+    fprintf(stderr, "%s: ERROR: slaveTemplate has no name attribute\n", modname);
+    return NULL;
+  }
+  if (findSlaveTemplate(conf->name) != NULL) {
+    fprintf(stderr, "%s: ERROR: Duplicate slaveTemplate %s\n", modname, conf->name);
+    return NULL;
+  }
+
+  tmpl = calloc(1, sizeof(LCEC_CONF_TEMPLATE_T));
+  if (tmpl == NULL) {
+    fprintf(stderr, "%s: ERROR: Couldn't allocate memory for slave template\n", modname);
+    return NULL;
+  }
+  tmpl->conf = conf;
+  tmpl->offset = offset;
+  tmpl->next = slave_templates;
+  slave_templates = tmpl;
+  return tmpl;
+}
+
+LCEC_CONF_TEMPLATE_T *findSlaveTemplate(const char *name) {
+  LCEC_CONF_TEMPLATE_T *p;
+
+  for (p = slave_templates; p != NULL; p = p->next) {
+    if (strcmp(p->conf->name, name) == 0) {
+      return p;
+    }
+  }
+
+  return NULL;
+}
+
+void freeSlaveTemplates(void) {
+  LCEC_CONF_TEMPLATE_T *p;
+
+  while (slave_templates != NULL) {
+    p = slave_templates;
+    slave_templates = p->next;
+    free(p);
+  }
+}
+
+/// @brief Name slave `i` of `count` slaves expanded from one `<slave>`.
+///
+/// Unnamed slaves are named after their index, and repeated named
+/// slaves get a `-<i>` suffix.
+void setRepeatedSlaveName(LCEC_CONF_SLAVE_T *slave, const char *base_name, int count, int i) {
+  if (base_name[0] == 0) {
+    snprintf(slave->name, LCEC_CONF_STR_MAXLEN, "%d", slave->index);
+  } else if (count > 1) {
+    snprintf(slave->name, LCEC_CONF_STR_MAXLEN, "%.*s-%d", LCEC_CONF_STR_MAXLEN - 12, base_name, i);
+  }
+}
+
+/// @brief Parse a `true` or `false` attribute value, ignoring case.
+///
+/// @return 1 for true, 0 for false, or -1 for anything else.
+int parseBool(const char *s) {
+  if (strcasecmp(s, "true") == 0) {
+    return 1;
+  }
+  if (strcasecmp(s, "false") == 0) {
+    return 0;
+  }
+  return -1;
+}
+
 int parseHex(const char *s, int slen, uint8_t *buf) {
   char c;
   int len;
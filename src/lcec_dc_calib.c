@@ -0,0 +1,297 @@
+//
+//    Copyright (C) 2024 LinuxCNC-Ethercat contributors
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program; if not, write to the Free Software
+//    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+//
+
+/// @file
+/// @brief DC SYNC0 shift calibration
+///
+/// When a master has `dcCalibrate` set, every DC slave measures how
+/// long before its SYNC0 event the cyclic frame arrives.  Reading the
+/// slave's system time register (0x0910) latches the DC time at which
+/// the frame passed the slave, so comparing it with the slave's SYNC0
+/// start time (0x0990) gives the lead of the frame over the next
+/// SYNC0, including the propagation delay to that slave and the
+/// master's send jitter.  The register reads are queued in the same
+/// `ecrt_master_send()` as the process data, so they travel with it.
+///
+/// Once enough samples have been taken, the smallest lead seen, minus
+/// the configured margin, is how much earlier SYNC0 could fire without
+/// the frame ever arriving late.  The suggested `sync0Shift` is
+/// published on HAL pins and logged.
+///
+/// In `apply` mode, sampling starts in SAFEOP, where SYNC0 already
+/// runs, and the slave's cyclic unit is briefly stopped and restarted
+/// with the new shift.  That gap in SYNC0 is only acceptable while the
+/// slave's outputs aren't live, so the new shift is only written if
+/// the slave hasn't reached OP yet; otherwise it is just reported.
+/// The master's slave config keeps the startup shift, since it can't
+/// be changed from the realtime thread, and the master writes that
+/// shift again whenever it re-initializes the slave.  So after a
+/// re-init the calibrated shift is written again, once more before
+/// the slave reaches OP.
+
+#include "lcec.h"
+
+#define LCEC_DC_CALIB_SAMPLES      1000        ///< Default number of samples per slave.
+#define LCEC_DC_CALIB_START_OFFSET 100000000   ///< Delay before restarting SYNC0 in apply mode (ns).
+#define LCEC_DC_CALIB_MIN_CHANGE   1000        ///< Smallest shift change that apply mode will write (ns).
+
+#define LCEC_DC_REG_SYS_TIME   0x0910  ///< System time, latched when read.
+#define LCEC_DC_REG_ACTIVATION 0x0980  ///< Cyclic unit control and activation.
+#define LCEC_DC_REG_START_TIME 0x0990  ///< SYNC0 start time, reads back the next SYNC0 event.
+
+typedef enum {
+  LCEC_DC_CALIB_WAIT_OP,
+  LCEC_DC_CALIB_READ_START,
+  LCEC_DC_CALIB_SAMPLE,
+  LCEC_DC_CALIB_DEACTIVATE,
+  LCEC_DC_CALIB_WRITE_START,
+  LCEC_DC_CALIB_ACTIVATE,
+  LCEC_DC_CALIB_DONE,
+} lcec_dc_calib_state_t;
+
+struct lcec_dc_calib {
+  hal_s32_t *lead_min;         ///< Shortest time from frame arrival to SYNC0 (ns).
+  hal_s32_t *lead_max;         ///< Longest time from frame arrival to SYNC0 (ns).
+  hal_s32_t *shift_suggested;  ///< Suggested `sync0Shift`.
+  hal_u32_t *samples;          ///< Samples taken so far.
+  hal_bit_t *done;             ///< Calibration finished.
+  hal_bit_t *error;            ///< Calibration failed.
+
+  ec_reg_request_t *req;
+  lcec_dc_calib_state_t state;
+  uint16_t address;  ///< Register of the request in flight, for error messages.
+  uint32_t cycle;    ///< SYNC0 cycle (ns).
+  int32_t margin;    ///< Wanted minimum lead (ns).
+  uint64_t sync0;    ///< A SYNC0 event within a cycle of the last sample.
+  int32_t delta;     ///< How much earlier SYNC0 should fire (ns).
+  int applied;       ///< `delta` was written, and is written again after a re-init.
+};
+
+static const lcec_pindesc_t dc_calib_pins[] = {
+    {HAL_S32, HAL_OUT, offsetof(lcec_dc_calib_t, lead_min), "%s.%s.%s.dc-calib-lead-min"},
+    {HAL_S32, HAL_OUT, offsetof(lcec_dc_calib_t, lead_max), "%s.%s.%s.dc-calib-lead-max"},
+    {HAL_S32, HAL_OUT, offsetof(lcec_dc_calib_t, shift_suggested), "%s.%s.%s.dc-calib-shift-suggested"},
+    {HAL_U32, HAL_OUT, offsetof(lcec_dc_calib_t, samples), "%s.%s.%s.dc-calib-samples"},
+    {HAL_BIT, HAL_OUT, offsetof(lcec_dc_calib_t, done), "%s.%s.%s.dc-calib-done"},
+    {HAL_BIT, HAL_OUT, offsetof(lcec_dc_calib_t, error), "%s.%s.%s.dc-calib-error"},
+    {HAL_TYPE_UNSPECIFIED, HAL_DIR_UNSPECIFIED, -1, NULL},
+};
+
+/// @brief Set up SYNC0 shift calibration for a slave.
+///
+/// Called from `rtapi_app_main()` for each slave with SYNC0 enabled
+/// when the master has `dcCalibrate` set.  Must be called before the
+/// master is activated, since it creates a register request.
+int lcec_dc_calib_init(lcec_slave_t *slave) {
+  lcec_master_t *master = slave->master;
+  lcec_dc_calib_t *calib;
+  int err;
+
+  calib = LCEC_HAL_ALLOCATE(lcec_dc_calib_t);
+
+  if (lcec_create_reg_request(slave, sizeof(uint64_t), &calib->req) != 0) {
+    return -EIO;
+  }
+
+  if ((err = lcec_pin_newf_list(calib, dc_calib_pins, LCEC_MODULE_NAME, master->name, slave->name)) != 0) {
+    return err;
+  }
+
+  calib->cycle = slave->dc_conf->sync0Cycle;
+  calib->margin = master->dc_calib_margin > 0 ? master->dc_calib_margin : calib->cycle / 10;
+  calib->state = LCEC_DC_CALIB_WAIT_OP;
+  *(calib->lead_min) = calib->cycle;
+  *(calib->shift_suggested) = slave->dc_conf->sync0Shift;
+
+  slave->dc_calib = calib;
+  return 0;
+}
+
+static void lcec_dc_calib_read(lcec_dc_calib_t *calib, uint16_t address) {
+  calib->address = address;
+  ecrt_reg_request_read(calib->req, address, sizeof(uint64_t));
+}
+
+static void lcec_dc_calib_write(lcec_dc_calib_t *calib, uint16_t address, size_t size) {
+  calib->address = address;
+  ecrt_reg_request_write(calib->req, address, size);
+}
+
+/// @brief Time from `sys_time` to the next SYNC0 event (ns).
+///
+/// `sync0` is any SYNC0 event within about 2 s of `sys_time`, before
+/// or after it.  Only the difference matters, so this is also right
+/// for slaves with 32 bit DC, and across the wrap of the DC time.
+///
+/// @return The lead, from 0 to `cycle` - 1.
+int32_t lcec_dc_calib_lead(uint64_t sync0, uint64_t sys_time, uint32_t cycle) {
+  int32_t lead;
+
+  lead = (int32_t)(uint32_t)(sync0 - sys_time) % (int32_t)cycle;
+  if (lead < 0) {
+    lead += cycle;
+  }
+  return lead;
+}
+
+static void lcec_dc_calib_sample(lcec_slave_t *slave, uint64_t sys_time) {
+  lcec_dc_calib_t *calib = slave->dc_calib;
+  int32_t lead;
+
+  lead = lcec_dc_calib_lead(calib->sync0, sys_time, calib->cycle);
+  calib->sync0 = sys_time + lead;
+
+  if (lead < *(calib->lead_min)) {
+    *(calib->lead_min) = lead;
+  }
+  if (lead > *(calib->lead_max)) {
+    *(calib->lead_max) = lead;
+  }
+  (*(calib->samples))++;
+}
+
+// Write `delta` to the slave, unless it's already in OP.
+static void lcec_dc_calib_apply(lcec_slave_t *slave) {
+  lcec_dc_calib_t *calib = slave->dc_calib;
+  uint8_t *data = ecrt_reg_request_data(calib->req);
+
+  if (slave->state.operational) {
+    lcec_log_slave(slave, LCEC_LOG_DC_CALIB_TOO_LATE, *(calib->shift_suggested), 0, 0, 0);
+    *(calib->done) = 1;
+    calib->state = LCEC_DC_CALIB_DONE;
+    return;
+  }
+
+  // stop cyclic operation, so the new start time is picked up
+  EC_WRITE_U16(data, 0);
+  lcec_dc_calib_write(calib, LCEC_DC_REG_ACTIVATION, sizeof(uint16_t));
+  calib->state = LCEC_DC_CALIB_DEACTIVATE;
+}
+
+static void lcec_dc_calib_finish(lcec_slave_t *slave) {
+  lcec_master_t *master = slave->master;
+  lcec_dc_calib_t *calib = slave->dc_calib;
+
+  calib->delta = *(calib->lead_min) - calib->margin;
+  *(calib->shift_suggested) = slave->dc_conf->sync0Shift - calib->delta;
+  lcec_log_slave(slave, LCEC_LOG_DC_CALIB_RESULT, *(calib->lead_min), *(calib->lead_max), slave->dc_conf->sync0Shift,
+      *(calib->shift_suggested));
+
+  if (master->dc_calib_mode != lcecDcCalibrateApply || abs(calib->delta) < LCEC_DC_CALIB_MIN_CHANGE) {
+    *(calib->done) = 1;
+    calib->state = LCEC_DC_CALIB_DONE;
+    return;
+  }
+
+  lcec_dc_calib_apply(slave);
+}
+
+/// @brief Advance a slave's SYNC0 shift calibration.
+///
+/// Called every cycle from `lcec_read_master()`, after the process
+/// data and the slave's state have been read.  Each step waits for the
+/// previous register request to finish, so a sample takes at least
+/// one cycle.
+void lcec_dc_calib_run(lcec_slave_t *slave) {
+  lcec_master_t *master = slave->master;
+  lcec_dc_calib_t *calib = slave->dc_calib;
+  uint8_t *data = ecrt_reg_request_data(calib->req);
+  unsigned int al_state = slave->state.al_state & 0x0f;
+  uint64_t start;
+
+  switch (calib->state) {
+    case LCEC_DC_CALIB_DONE:
+      // the master re-initialized the slave with the startup shift
+      if (calib->applied && !slave->state.operational && al_state < EC_AL_STATE_SAFEOP) {
+        *(calib->done) = 0;
+        calib->state = LCEC_DC_CALIB_WAIT_OP;
+      }
+      return;
+
+    case LCEC_DC_CALIB_WAIT_OP:
+      // SYNC0 only runs from SAFEOP on.  Reports are taken in OP,
+      // under normal load, while applying has to start before OP.
+      if (slave->state.operational ||
+          (master->dc_calib_mode == lcecDcCalibrateApply && slave->state.online && al_state == EC_AL_STATE_SAFEOP)) {
+        lcec_dc_calib_read(calib, LCEC_DC_REG_START_TIME);
+        calib->state = LCEC_DC_CALIB_READ_START;
+      }
+      return;
+
+    default:
+      break;
+  }
+
+  switch (ecrt_reg_request_state(calib->req)) {
+    case EC_REQUEST_SUCCESS:
+      break;
+    case EC_REQUEST_ERROR:
+      lcec_log_slave(slave, LCEC_LOG_DC_CALIB_ERROR, calib->address, 0, 0, 0);
+      *(calib->error) = 1;
+      calib->state = LCEC_DC_CALIB_DONE;
+      return;
+    default:
+      return;
+  }
+
+  switch (calib->state) {
+    case LCEC_DC_CALIB_READ_START:
+      calib->sync0 = EC_READ_U64(data);
+      if (calib->applied) {
+        lcec_dc_calib_apply(slave);
+        break;
+      }
+      lcec_dc_calib_read(calib, LCEC_DC_REG_SYS_TIME);
+      calib->state = LCEC_DC_CALIB_SAMPLE;
+      break;
+
+    case LCEC_DC_CALIB_SAMPLE:
+      lcec_dc_calib_sample(slave, EC_READ_U64(data));
+      if (*(calib->samples) < (master->dc_calib_samples > 0 ? master->dc_calib_samples : LCEC_DC_CALIB_SAMPLES)) {
+        lcec_dc_calib_read(calib, LCEC_DC_REG_SYS_TIME);
+      } else {
+        lcec_dc_calib_finish(slave);
+      }
+      break;
+
+    case LCEC_DC_CALIB_DEACTIVATE:
+      // restart on the shifted grid, far enough out for the next two
+      // requests to complete first
+      start = calib->sync0 - calib->delta + (LCEC_DC_CALIB_START_OFFSET / calib->cycle + 1) * calib->cycle;
+      EC_WRITE_U64(data, start);
+      lcec_dc_calib_write(calib, LCEC_DC_REG_START_TIME, sizeof(uint64_t));
+      calib->state = LCEC_DC_CALIB_WRITE_START;
+      break;
+
+    case LCEC_DC_CALIB_WRITE_START:
+      EC_WRITE_U16(data, slave->dc_conf->assignActivate);
+      lcec_dc_calib_write(calib, LCEC_DC_REG_ACTIVATION, sizeof(uint16_t));
+      calib->state = LCEC_DC_CALIB_ACTIVATE;
+      break;
+
+    case LCEC_DC_CALIB_ACTIVATE:
+      lcec_log_slave(slave, LCEC_LOG_DC_CALIB_APPLIED, slave->dc_conf->sync0Shift, *(calib->shift_suggested), 0, 0);
+      calib->applied = 1;
+      *(calib->done) = 1;
+      calib->state = LCEC_DC_CALIB_DONE;
+      break;
+
+    default:
+      break;
+  }
+}
@@ -25,11 +25,70 @@
 static int lcec_param_newfv(hal_type_t type, hal_param_dir_t dir, void *data_addr, const char *fmt, va_list ap);
 static int lcec_param_newfv_list(void *base, const lcec_paramdesc_t *list, va_list ap);
 int lcec_comp_id = -1;
+const lcec_dry_run_t *lcec_dry_run = NULL;
+
+static void lcec_fsoe_diag_update(lcec_slave_t *slave, const uint8_t *slave_frame, const uint8_t *master_frame);
+
+static void lcec_limit_exceeded(lcec_slave_t *slave, const char *what) {
+  if (lcec_dry_run != NULL) {
+    lcec_dry_run->limit_exceeded(slave, what);
+  }
+}
+
+/// @brief Build the lookup tables used by `lcec_slave_by_index()` and `lcec_slave_by_name()`.
+///
+/// Called once all of a master's slaves have been added, by
+/// `lcec_parse_conf_tokens()`.  If two slaves share an index or a
+/// name, lookups return the first one in config order, same as a walk
+/// of the slave list would.
+void lcec_index_slaves(lcec_master_t *master) {
+  lcec_slave_t *slave, **names;
+  int max_index = -1, count = 0, i;
+
+  // ring positions are 16 bits, anything else can't be on the bus
+  for (slave = master->first_slave; slave != NULL; slave = slave->next) {
+    if (slave->index > max_index && slave->index <= 0xffff) {
+      max_index = slave->index;
+    }
+    count++;
+  }
+  if (count == 0 || max_index < 0) {
+    return;
+  }
+
+  master->slaves_by_index = LCEC_ALLOCATE_ARRAY(lcec_slave_t *, max_index + 1);
+  master->slaves_by_index_len = max_index + 1;
+  names = LCEC_ALLOCATE_ARRAY(lcec_slave_t *, count);
+
+  // Insertion sort, stable so that duplicate names keep config order.
+  // It's quadratic in the number of slaves, but runs once at startup
+  // on at most a few hundred of them.
+  count = 0;
+  for (slave = master->first_slave; slave != NULL; slave = slave->next) {
+    if (slave->index >= 0 && slave->index <= max_index && master->slaves_by_index[slave->index] == NULL) {
+      master->slaves_by_index[slave->index] = slave;
+    }
+
+    for (i = count; i > 0 && strcmp(names[i - 1]->name, slave->name) > 0; i--) {
+      names[i] = names[i - 1];
+    }
+    names[i] = slave;
+    count++;
+  }
+
+  master->slaves_by_name = names;
+  master->slave_count = count;
+}
 
 /// @brief Find the slave with a specified index underneath a specific master.
 lcec_slave_t *lcec_slave_by_index(lcec_master_t *master, int index) {
   lcec_slave_t *slave;
 
+  if (master->slaves_by_index != NULL) {
+    return (index >= 0 && index < master->slaves_by_index_len) ? master->slaves_by_index[index] : NULL;
+  }
+
+  // not indexed yet
   for (slave = master->first_slave; slave != NULL; slave = slave->next) {
     if (slave->index == index) {
       return slave;
@@ -39,6 +98,39 @@ lcec_slave_t *lcec_slave_by_index(lcec_master_t *master, int index) {
   return NULL;
 }
 
+/// @brief Find the slave with a specified name underneath a specific master.
+lcec_slave_t *lcec_slave_by_name(lcec_master_t *master, const char *name) {
+  lcec_slave_t *slave;
+  int lo, hi, mid, cmp;
+
+  if (master->slaves_by_name == NULL) {
+    // not indexed yet
+    for (slave = master->first_slave; slave != NULL; slave = slave->next) {
+      if (strcmp(slave->name, name) == 0) {
+        return slave;
+      }
+    }
+    return NULL;
+  }
+
+  // find the first match, in case of duplicates
+  lo = 0;
+  hi = master->slave_count;
+  while (lo < hi) {
+    mid = lo + (hi - lo) / 2;
+    cmp = strcmp(master->slaves_by_name[mid]->name, name);
+    if (cmp < 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  if (lo < master->slave_count && strcmp(master->slaves_by_name[lo]->name, name) == 0) {
+    return master->slaves_by_name[lo];
+  }
+  return NULL;
+}
+
 /// @brief Copy FSoE (Safety over EtherCAT / FailSafe over EtherCAT) data between slaves and masters.
 void copy_fsoe_data(lcec_slave_t *slave, unsigned int slave_offset, unsigned int master_offset) {
   lcec_master_t *master = slave->master;
@@ -56,6 +148,167 @@ void copy_fsoe_data(lcec_slave_t *slave, unsigned int slave_offset, unsigned int
   if (slave->fsoe_master_offset != NULL) {
     memcpy(&pd[master_offset], &pd[*(slave->fsoe_master_offset)], LCEC_FSOE_SIZE(fsoeConf->data_channels, fsoeConf->master_data_len));
   }
+
+  if (slave->fsoe_diag != NULL && slave->fsoe_slave_offset != NULL && slave->fsoe_master_offset != NULL) {
+    lcec_fsoe_diag_update(slave, &pd[slave_offset], &pd[master_offset]);
+  }
+}
+
+static const lcec_pindesc_t fsoe_diag_pins[] = {
+    {HAL_U32, HAL_OUT, offsetof(lcec_fsoe_diag_t, exchange_cycles), "%s.%s.%s.fsoe-diag-exchange-cycles"},
+    {HAL_U32, HAL_OUT, offsetof(lcec_fsoe_diag_t, exchange_cycles_max), "%s.%s.%s.fsoe-diag-exchange-cycles-max"},
+    {HAL_U32, HAL_OUT, offsetof(lcec_fsoe_diag_t, slave_cycles), "%s.%s.%s.fsoe-diag-slave-cycles"},
+    {HAL_U32, HAL_OUT, offsetof(lcec_fsoe_diag_t, stalls), "%s.%s.%s.fsoe-diag-stalls"},
+    {HAL_U32, HAL_IN, offsetof(lcec_fsoe_diag_t, watchdog_ms), "%s.%s.%s.fsoe-diag-watchdog-ms"},
+    {HAL_FLOAT, HAL_OUT, offsetof(lcec_fsoe_diag_t, watchdog_margin_ms), "%s.%s.%s.fsoe-diag-watchdog-margin-ms"},
+    {HAL_BIT, HAL_IN, offsetof(lcec_fsoe_diag_t, reset), "%s.%s.%s.fsoe-diag-reset"},
+    {HAL_U32, HAL_OUT, offsetof(lcec_fsoe_diag_t, hist[0]), "%s.%s.%s.fsoe-diag-hist-1"},
+    {HAL_U32, HAL_OUT, offsetof(lcec_fsoe_diag_t, hist[1]), "%s.%s.%s.fsoe-diag-hist-2"},
+    {HAL_U32, HAL_OUT, offsetof(lcec_fsoe_diag_t, hist[2]), "%s.%s.%s.fsoe-diag-hist-4"},
+    {HAL_U32, HAL_OUT, offsetof(lcec_fsoe_diag_t, hist[3]), "%s.%s.%s.fsoe-diag-hist-8"},
+    {HAL_U32, HAL_OUT, offsetof(lcec_fsoe_diag_t, hist[4]), "%s.%s.%s.fsoe-diag-hist-16"},
+    {HAL_U32, HAL_OUT, offsetof(lcec_fsoe_diag_t, hist[5]), "%s.%s.%s.fsoe-diag-hist-32"},
+    {HAL_U32, HAL_OUT, offsetof(lcec_fsoe_diag_t, hist[6]), "%s.%s.%s.fsoe-diag-hist-64"},
+    {HAL_U32, HAL_OUT, offsetof(lcec_fsoe_diag_t, hist[7]), "%s.%s.%s.fsoe-diag-hist-more"},
+    {HAL_TYPE_UNSPECIFIED, HAL_DIR_UNSPECIFIED, -1, NULL},
+};
+
+/// @brief Export FSoE connection diagnostic pins for an FSoE slave.
+///
+/// Drivers that call `copy_fsoe_data()` call this from their init
+/// function.  The diagnostics are updated by `copy_fsoe_data()` once
+/// the slave has been attached to a logic terminal.
+///
+/// A new frame from either side always carries a new CRC, so the
+/// command byte plus the first channel's CRC is enough to spot a new
+/// frame without comparing whole frames.  The time between two master
+/// frames is one complete exchange: master to slave, the slave's
+/// answer, and the logic terminal's next frame.
+int lcec_fsoe_diag_init(lcec_slave_t *slave) {
+  lcec_master_t *master = slave->master;
+  lcec_fsoe_diag_t *diag;
+  int err;
+
+  diag = LCEC_HAL_ALLOCATE(lcec_fsoe_diag_t);
+
+  if ((err = lcec_pin_newf_list(diag, fsoe_diag_pins, LCEC_MODULE_NAME, master->name, slave->name)) != 0) {
+    return err;
+  }
+
+  *(diag->watchdog_ms) = 100;
+  slave->fsoe_diag = diag;
+
+  return 0;
+}
+
+static void lcec_fsoe_diag_clear(lcec_fsoe_diag_t *diag) {
+  int i;
+
+  *(diag->exchange_cycles_max) = 0;
+  *(diag->stalls) = 0;
+  for (i = 0; i < LCEC_FSOE_DIAG_BUCKETS; i++) {
+    *(diag->hist[i]) = 0;
+  }
+}
+
+static void lcec_fsoe_diag_update(lcec_slave_t *slave, const uint8_t *slave_frame, const uint8_t *master_frame) {
+  lcec_fsoe_diag_t *diag = slave->fsoe_diag;
+  const LCEC_CONF_FSOE_T *fsoeConf = slave->fsoeConf;
+  double cycle_ms = slave->master->app_time_period * 1e-6;
+  uint32_t master_sig, slave_sig;
+  int bucket;
+
+  if (*(diag->reset) && !diag->reset_old) {
+    lcec_fsoe_diag_clear(diag);
+  }
+  diag->reset_old = *(diag->reset);
+
+  master_sig = EC_READ_U8(master_frame) | (EC_READ_U16(&master_frame[LCEC_FSOE_CMD_LEN + fsoeConf->master_data_len]) << 8);
+  slave_sig = EC_READ_U8(slave_frame) | (EC_READ_U16(&slave_frame[LCEC_FSOE_CMD_LEN + fsoeConf->slave_data_len]) << 8);
+
+  diag->since_master++;
+
+  // an exchange that is still in progress counts too, so a stalled
+  // connection shows up before the watchdog trips.
+  if (diag->started) {
+    if (diag->since_master > *(diag->exchange_cycles_max)) {
+      *(diag->exchange_cycles_max) = diag->since_master;
+    }
+    if (!diag->stalled && diag->since_master * cycle_ms * 2 > *(diag->watchdog_ms)) {
+      (*(diag->stalls))++;
+      diag->stalled = 1;
+    }
+  }
+
+  if (slave_sig != diag->slave_sig) {
+    diag->slave_sig = slave_sig;
+    if (diag->waiting) {
+      *(diag->slave_cycles) = diag->since_master;
+      diag->waiting = 0;
+    }
+  }
+
+  if (master_sig != diag->master_sig) {
+    diag->master_sig = master_sig;
+    if (diag->started) {
+      *(diag->exchange_cycles) = diag->since_master;
+      for (bucket = 0; bucket < LCEC_FSOE_DIAG_BUCKETS - 1 && (1u << bucket) < diag->since_master; bucket++)
+        ;
+      (*(diag->hist[bucket]))++;
+    }
+    diag->started = 1;
+    diag->waiting = 1;
+    diag->stalled = 0;
+    diag->since_master = 0;
+  }
+
+  *(diag->watchdog_margin_ms) = *(diag->watchdog_ms) - *(diag->exchange_cycles_max) * cycle_ms;
+}
+
+/// @brief Read consecutive process data bits into HAL bit pins.
+///
+/// Bit `i` is at bit position `bp + i` counting from byte `os`.  Each
+/// process data byte is read once, instead of once per bit as with
+/// `EC_READ_BIT()`.
+void lcec_read_bits(const uint8_t *pd, unsigned int os, unsigned int bp, hal_bit_t *const *pins, int count) {
+  const uint8_t *p = &pd[os + (bp >> 3)];
+  unsigned int shift = bp & 7;
+  uint8_t v;
+  int n;
+
+  while (count > 0) {
+    v = *p++ >> shift;
+    for (n = 8 - shift; n > 0 && count > 0; n--, count--) {
+      **pins++ = v & 1;
+      v >>= 1;
+    }
+    shift = 0;
+  }
+}
+
+/// @brief Write HAL bit pins to consecutive process data bits.
+///
+/// The counterpart of `lcec_read_bits()`.  Each process data byte is
+/// written once; bits outside of the range are left alone.
+void lcec_write_bits(uint8_t *pd, unsigned int os, unsigned int bp, hal_bit_t *const *pins, int count) {
+  uint8_t *p = &pd[os + (bp >> 3)];
+  unsigned int shift = bp & 7;
+  uint8_t v, mask;
+  int n;
+
+  while (count > 0) {
+    v = 0;
+    mask = 0;
+    for (n = shift; n < 8 && count > 0; n++, count--) {
+      if (**pins++) {
+        v |= 1 << n;
+      }
+      mask |= 1 << n;
+    }
+    *p = (*p & ~mask) | v;
+    p++;
+    shift = 0;
+  }
 }
 
 /// @brief Initialize syncs to 0.
@@ -89,6 +342,7 @@ void lcec_syncs_add_sync(lcec_syncs_t *syncs, ec_direction_t dir, ec_watchdog_mo
     rtapi_print_msg(RTAPI_MSG_ERR,
         LCEC_MSG_PFX "lcec_syncs_add_sync: WARNING: sync full for slave %s.%s, not adding more.  Expect failure.\n",
         syncs->slave->master->name, syncs->slave->name);
+    lcec_limit_exceeded(syncs->slave, "LCEC_MAX_SYNC_COUNT");
   } else {
     (syncs->sync_count)++;
   }
@@ -110,12 +364,14 @@ void lcec_syncs_add_pdo_info(lcec_syncs_t *syncs, uint16_t index) {
     rtapi_print_msg(RTAPI_MSG_ERR,
         LCEC_MSG_PFX "lcec_syncs_add_pdo_info: WARNING: pdo_info full for slave %s.%s, not adding more.  Expect failure.\n",
         syncs->slave->master->name, syncs->slave->name);
+    lcec_limit_exceeded(syncs->slave, "LCEC_MAX_PDO_INFO_COUNT");
   } else if (syncs->autoflow && (syncs->pdo_info_count > syncs->pdo_limit)) {
     rtapi_print_msg(RTAPI_MSG_ERR,
         LCEC_MSG_PFX
         "lcec_syncs_add_pdo_info: WARNING: pdo_info full for slave %s.%s has reached the configured limit of %d, not adding more.  Expect "
         "failure.\n",
         syncs->slave->master->name, syncs->slave->name, syncs->pdo_limit);
+    lcec_limit_exceeded(syncs->slave, "pdo_limit");
   } else {
     (syncs->pdo_info_count)++;
   }
@@ -147,11 +403,115 @@ void lcec_syncs_add_pdo_entry(lcec_syncs_t *syncs, uint16_t index, uint8_t subin
     rtapi_print_msg(RTAPI_MSG_ERR,
         LCEC_MSG_PFX "lcec_syncs_add_pdo_entry: WARNING: pdo_entries full for slave %s.%s, not adding more.  Expect failure.\n",
         syncs->slave->master->name, syncs->slave->name);
+    lcec_limit_exceeded(syncs->slave, "LCEC_MAX_PDO_ENTRY_COUNT");
   } else {
     (syncs->pdo_entry_count)++;
   }
 }
 
+/// @brief Step the background polling of one SDO request.
+///
+/// Call once per cycle for each request.  The request is serviced
+/// once per `poll_period` through the EtherCAT master's request
+/// queue, so the realtime thread never waits for a mailbox transfer.
+/// `started` is shared by all requests of a slave; set it to 0 at the
+/// start of each cycle.  At most one request per slave is due in a
+/// cycle, which spreads the mailbox traffic out when several come due
+/// at once.
+lcec_sdo_poll_result_t lcec_sdo_poll(lcec_slave_t *slave, lcec_sdo_poll_t *poll, long long poll_period, long period, int *started) {
+  lcec_sdo_poll_result_t result;
+
+  if (poll->req == NULL) {
+    return LCEC_SDO_POLL_IDLE;
+  }
+
+  // check for completion
+  if (poll->busy) {
+    switch (ecrt_sdo_request_state(poll->req)) {
+      case EC_REQUEST_SUCCESS:
+        result = LCEC_SDO_POLL_DONE;
+        break;
+      case EC_REQUEST_ERROR:
+        result = LCEC_SDO_POLL_ERROR;
+        break;
+      default:
+        return LCEC_SDO_POLL_IDLE;
+    }
+    poll->busy = 0;
+    poll->wait = poll_period - period;
+    return result;
+  }
+
+  // wait for the next poll
+  if (poll->wait > 0) {
+    poll->wait -= period;
+    return LCEC_SDO_POLL_IDLE;
+  }
+  if (*started || !slave->state.online) {
+    return LCEC_SDO_POLL_IDLE;
+  }
+
+  return LCEC_SDO_POLL_DUE;
+}
+
+/// @brief Create an SDO request for background transfers.
+///
+/// There's no slave config to attach the request to in a dry run, so
+/// `*req` is set to NULL there.
+///
+/// @param size The object size, in bytes.
+/// @return 0 on success, -1 if the request couldn't be created.
+int lcec_create_sdo_request(lcec_slave_t *slave, uint16_t index, uint8_t subindex, size_t size, ec_sdo_request_t **req) {
+  *req = NULL;
+  if (lcec_dry_run != NULL) {
+    return 0;
+  }
+
+  *req = ecrt_slave_config_create_sdo_request(slave->config, index, subindex, size);
+  if (*req == NULL) {
+    rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "slave %s.%s: Failed to create SDO request (0x%04x:0x%02x)\n", slave->master->name,
+        slave->name, index, subindex);
+    return -1;
+  }
+
+  return 0;
+}
+
+/// @brief Create a register request for background transfers.
+///
+/// There's no slave config to attach the request to in a dry run, so
+/// `*req` is set to NULL there.
+///
+/// @param size The largest transfer, in bytes.
+/// @return 0 on success, -1 if the request couldn't be created.
+int lcec_create_reg_request(lcec_slave_t *slave, size_t size, ec_reg_request_t **req) {
+  *req = NULL;
+  if (lcec_dry_run != NULL) {
+    return 0;
+  }
+
+  *req = ecrt_slave_config_create_reg_request(slave->config, size);
+  if (*req == NULL) {
+    rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "slave %s.%s: Failed to create register request\n", slave->master->name, slave->name);
+    return -1;
+  }
+
+  return 0;
+}
+
+/// @brief Start a transfer that `lcec_sdo_poll()` reported as due.
+///
+/// @param write Non-zero to write the request's data, 0 to read.
+void lcec_sdo_poll_start(lcec_sdo_poll_t *poll, int write, int *started) {
+  if (write) {
+    ecrt_sdo_request_write(poll->req);
+  } else {
+    ecrt_sdo_request_read(poll->req);
+  }
+  poll->busy = 1;
+  *started = 1;
+}
+
 /// @brief Read an SDO configuration from a slave device.
 int lcec_read_sdo(lcec_slave_t *slave, uint16_t index, uint8_t subindex, uint8_t *target, size_t size) {
   lcec_master_t *master = slave->master;
@@ -159,6 +519,11 @@ int lcec_read_sdo(lcec_slave_t *slave, uint16_t index, uint8_t subindex, uint8_t
   size_t result_size;
   uint32_t abort_code;
 
+  if (lcec_dry_run != NULL) {
+    memset(target, 0, size);
+    return 0;
+  }
+
   if ((err = ecrt_master_sdo_upload(master->master, slave->index, index, subindex, target, size, &result_size, &abort_code))) {
     rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "slave %s.%s: Failed to execute SDO upload (0x%04x:0x%02x, error %d, abort_code %08x)\n",
         master->name, slave->name, index, subindex, err, abort_code);
@@ -354,6 +719,10 @@ int lcec_write_sdo(lcec_slave_t *slave, uint16_t index, uint8_t subindex, uint8_
   int err;
   uint32_t abort_code;
 
+  if (lcec_dry_run != NULL) {
+    return (lcec_dry_run->sdo_write != NULL) ? lcec_dry_run->sdo_write(slave, index, subindex, value, size, NULL) : 0;
+  }
+
   if ((err = ecrt_master_sdo_download(master->master, slave->index, index, subindex, value, size, &abort_code))) {
     rtapi_print_msg(RTAPI_MSG_ERR,
         LCEC_MSG_PFX "slave %s.%s: Failed to execute SDO download (0x%04x:0x%02x, size %d, byte0=%d, error %d, abort_code %08x)\n",
@@ -418,6 +787,27 @@ int lcec_write_sdo32(lcec_slave_t *slave, uint16_t index, uint8_t subindex, uint
   return lcec_write_sdo(slave, index, subindex, data, 4);
 }
 
+// Common code for `lcec_write_sdo*_modparam`.  In a dry run, this
+// tells the `sdo_write` hook which modParam caused the write.
+static int lcec_write_sdo_modparam(
+    lcec_slave_t *slave, uint16_t index, uint8_t subindex, uint8_t *data, size_t size, uint32_t value, const char *mpname) {
+  int err;
+
+  if (lcec_dry_run != NULL) {
+    err = (lcec_dry_run->sdo_write != NULL) ? lcec_dry_run->sdo_write(slave, index, subindex, data, size, mpname) : 0;
+  } else {
+    err = lcec_write_sdo(slave, index, subindex, data, size);
+  }
+
+  if (err < 0) {
+    rtapi_print_msg(RTAPI_MSG_ERR,
+        LCEC_MSG_PFX "slave %s.%s: Failed to set SDO for <modParam name=\"%s\": sdo write of %04x:%02x = %d rejected by slave\n",
+        slave->master->name, slave->name, mpname, index, subindex, (int)value);
+    return -1;
+  }
+  return 0;
+}
+
 /// @brief Write an 8-bit SDO configuration to a slave device as part of a modParam config
 ///
 /// This tries to write the SDO provided, and prints an error message suitable for a modparam if it fails.
@@ -429,13 +819,10 @@ int lcec_write_sdo32(lcec_slave_t *slave, uint16_t index, uint8_t subindex, uint
 /// @param mpname The XML name of the modparam that triggered this.  Used for error messages.
 /// @return 0 for success or -1 for failure.
 int lcec_write_sdo8_modparam(lcec_slave_t *slave, uint16_t index, uint8_t subindex, uint8_t value, const char *mpname) {
-  if (lcec_write_sdo8(slave, index, subindex, value) < 0) {
-    rtapi_print_msg(RTAPI_MSG_ERR,
-        LCEC_MSG_PFX "slave %s.%s: Failed to set SDO for <modParam name=\"%s\": sdo write of %04x:%02x = %d rejected by slave\n",
-        slave->master->name, slave->name, mpname, index, subindex, value);
-    return -1;
-  }
-  return 0;
+  uint8_t data[1];
+
+  EC_WRITE_U8(data, value);
+  return lcec_write_sdo_modparam(slave, index, subindex, data, 1, value, mpname);
 }
 
 /// @brief Write a 16-bit SDO configuration to a slave device as part of a modParam config
@@ -449,13 +836,10 @@ int lcec_write_sdo8_modparam(lcec_slave_t *slave, uint16_t index, uint8_t subind
 /// @param mpname The XML name of the modparam that triggered this.  Used for error messages.
 /// @return 0 for success or -1 for failure.
 int lcec_write_sdo16_modparam(lcec_slave_t *slave, uint16_t index, uint8_t subindex, uint16_t value, const char *mpname) {
-  if (lcec_write_sdo16(slave, index, subindex, value) < 0) {
-    rtapi_print_msg(RTAPI_MSG_ERR,
-        LCEC_MSG_PFX "slave %s.%s: Failed to set SDO for <modParam name=\"%s\": sdo write of %04x:%02x = %d rejected by slave\n",
-        slave->master->name, slave->name, mpname, index, subindex, value);
-    return -1;
-  }
-  return 0;
+  uint8_t data[2];
+
+  EC_WRITE_U16(data, value);
+  return lcec_write_sdo_modparam(slave, index, subindex, data, 2, value, mpname);
 }
 
 /// @brief Write a 32-bit SDO configuration to a slave device as part of a modParam config
@@ -469,13 +853,10 @@ int lcec_write_sdo16_modparam(lcec_slave_t *slave, uint16_t index, uint8_t subin
 /// @param mpname The XML name of the modparam that triggered this.  Used for error messages.
 /// @return 0 for success or -1 for failure.
 int lcec_write_sdo32_modparam(lcec_slave_t *slave, uint16_t index, uint8_t subindex, uint32_t value, const char *mpname) {
-  if (lcec_write_sdo32(slave, index, subindex, value) < 0) {
-    rtapi_print_msg(RTAPI_MSG_ERR,
-        LCEC_MSG_PFX "slave %s.%s: Failed to set SDO for <modParam name=\"%s\": sdo write of %04x:%02x = %d rejected by slave\n",
-        slave->master->name, slave->name, mpname, index, subindex, value);
-    return -1;
-  }
-  return 0;
+  uint8_t data[4];
+
+  EC_WRITE_U32(data, value);
+  return lcec_write_sdo_modparam(slave, index, subindex, data, 4, value, mpname);
 }
 
 /// @brief Read IDN data from a slave device.
@@ -488,6 +869,11 @@ int lcec_read_idn(lcec_slave_t *slave, uint8_t drive_no, uint16_t idn, uint8_t *
   size_t result_size;
   uint16_t error_code;
 
+  if (lcec_dry_run != NULL) {
+    memset(target, 0, size);
+    return 0;
+  }
+
   if ((err = ecrt_master_read_idn(master->master, slave->index, drive_no, idn, target, size, &result_size, &error_code))) {
     rtapi_print_msg(RTAPI_MSG_ERR,
         LCEC_MSG_PFX "slave %s.%s: Failed to execute IDN read (drive %u idn %c-%u-%u, error %d, error_code %08x)\n", master->name,
@@ -516,11 +902,16 @@ static int lcec_param_newfv(hal_type_t type, hal_param_dir_t dir, void *data_add
     return -ENOMEM;
   }
 
-  err = hal_param_new(name, type, dir, data_addr, lcec_comp_id);
+  if (lcec_dry_run != NULL) {
+    err = lcec_dry_run->param_new(name, type, dir, data_addr);
+  } else {
+    err = hal_param_new(name, type, dir, data_addr, lcec_comp_id);
+  }
   if (err) {
     rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "exporting param %s failed\n", name);
     return err;
   }
+  lcec_mem_charge(0, 0, 0, 1);
 
   switch (type) {
     case HAL_BIT:
@@ -636,6 +1027,7 @@ int lcec_pdo_init(lcec_slave_t *slave, uint16_t idx, uint16_t sidx, unsigned int
     rtapi_print_msg(RTAPI_MSG_ERR,
         LCEC_MSG_PFX "lcec_pdo_init() failed for slave %s:%s; lcec_pdo_entry_reg_t is full, with %d of %d entries used\n",
         slave->master->name, slave->name, slave->regs->current, slave->regs->max);
+    lcec_limit_exceeded(slave, "LCEC_MAX_PDO_REG_COUNT");
     return -1;
   }
 
@@ -672,3 +1064,69 @@ int lcec_append_pdo_entry_reg(lcec_pdo_entry_reg_t *dest, lcec_pdo_entry_reg_t *
   }
   return 0;
 }
+
+// Validate a changed scale and recompute its reciprocal.
+static void lcec_scale_set(lcec_scale_t *s) {
+  if ((*(s->scale) < 1e-20) && (*(s->scale) > -1e-20)) {
+    // value too small, divide by zero is a bad thing
+    *(s->scale) = 1.0;
+  }
+  s->old = *(s->scale);
+  s->recip = 1.0 / *(s->scale);
+}
+
+/// @brief Watch a HAL scale pin or param for changes.
+///
+/// Many drivers divide by a user-settable scale.  Instead of comparing
+/// each scale against a cached copy in their `_read` or `_write`
+/// functions, drivers can register it here and use `recip` from the
+/// returned `lcec_scale_t`.  All watched scales on a slave are checked
+/// once per cycle, before the slave's `proc_read` is called.
+///
+/// When any of them changes, `slave->scale_epoch` is incremented, so
+/// drivers that cache other values derived from their scales only
+/// need to compare a single integer to know when to recompute them.
+///
+/// Scales too close to 0 are reset to 1.0.  Set the scale's default
+/// value before calling this.
+///
+/// @param slave The slave that owns the scale.
+/// @param scale The scale pin or param.
+/// @return The watched scale.
+lcec_scale_t *lcec_scale_watch(lcec_slave_t *slave, hal_float_t *scale) {
+  lcec_scale_t *s, **p;
+
+  s = LCEC_HAL_ALLOCATE(lcec_scale_t);
+  s->scale = scale;
+  lcec_scale_set(s);
+
+  // keep registration order, so drivers' scales are checked in order
+  for (p = &slave->scales; *p != NULL; p = &(*p)->next)
+    ;
+  *p = s;
+
+  return s;
+}
+
+/// @brief Check all of a slave's watched scales for changes.
+///
+/// This is called every cycle by `lcec_read_master()`, and by
+/// `lcec_write_master()` if `read` hasn't run since the last `write`,
+/// so scales are checked once per cycle whatever the function order.
+/// Drivers only need to call it if they change a watched scale
+/// themselves and need the new reciprocal in the same cycle.
+void lcec_scale_update(lcec_slave_t *slave) {
+  lcec_scale_t *s;
+  int changed = 0;
+
+  for (s = slave->scales; s != NULL; s = s->next) {
+    if (*(s->scale) != s->old) {
+      lcec_scale_set(s);
+      changed = 1;
+    }
+  }
+
+  if (changed) {
+    slave->scale_epoch++;
+  }
+}
@@ -0,0 +1,280 @@
+//
+//    Copyright (C) 2024 LinuxCNC-Ethercat contributors
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program; if not, write to the Free Software
+//    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+//
+
+/// @file
+/// @brief Deferred, realtime-safe logging for LinuxCNC-Ethercat
+///
+/// Calling `rtapi_print_msg()` from the servo thread formats text and
+/// writes it to the console, which can take long enough to show up as
+/// a latency spike.  Instead, realtime code calls `lcec_log_slave()`
+/// or `lcec_log_master()`, which only copy a message ID and a few
+/// integers into a per-master ring in RTAPI shared memory.  The ring
+/// is created and drained by `lcec_conf`, which formats the records
+/// outside of realtime.
+///
+/// Records are rate-limited per message ID and slave, so a flapping
+/// slave can't flood the ring, and can't hide records from other
+/// slaves either.  If the ring isn't available (`lcec_conf` didn't
+/// create it), records are formatted and printed directly, still
+/// subject to rate limiting.
+
+#include "lcec.h"
+
+extern int lcec_comp_id;
+
+typedef struct {
+  int level;        ///< RTAPI message level.
+  const char *fmt;  ///< printf-style format, using only 32-bit integer conversions.
+} lcec_log_fmt_t;
+
+static const lcec_log_fmt_t lcec_log_formats[LCEC_LOG_ID_COUNT] = {
+    [LCEC_LOG_APP_TIME_PERIOD] = {RTAPI_MSG_ERR, "invalid appTimePeriod of %u (should be %d)"},
+    [LCEC_LOG_MASTER_LINK] = {RTAPI_MSG_WARN, "link-up changed to %d, %u slaves responding"},
+    [LCEC_LOG_MASTER_AL_STATES] = {RTAPI_MSG_INFO, "AL states changed from 0x%02x to 0x%02x"},
+    [LCEC_LOG_SLAVE_ONLINE] = {RTAPI_MSG_INFO, "slave online, AL state 0x%02x"},
+    [LCEC_LOG_SLAVE_OFFLINE] = {RTAPI_MSG_WARN, "slave offline"},
+    [LCEC_LOG_SLAVE_AL_STATE] = {RTAPI_MSG_INFO, "AL state changed from 0x%02x to 0x%02x, operational %d"},
+    [LCEC_LOG_DEMS300_OPMODE] = {RTAPI_MSG_ERR, "MS300 not sending velo mode (mode %d)"},
+    [LCEC_LOG_DC_CALIB_RESULT] = {RTAPI_MSG_INFO, "SYNC0 lead min %d max %d ns, sync0Shift %d, suggested sync0Shift %d"},
+    [LCEC_LOG_DC_CALIB_APPLIED] = {RTAPI_MSG_INFO, "sync0Shift changed from %d to %d"},
+    [LCEC_LOG_DC_CALIB_TOO_LATE] = {RTAPI_MSG_WARN, "already in OP, suggested sync0Shift %d not applied"},
+    [LCEC_LOG_DC_CALIB_ERROR] = {RTAPI_MSG_ERR, "SYNC0 calibration failed accessing register 0x%04x"},
+    [LCEC_LOG_SDO_PIN_ERROR] = {RTAPI_MSG_WARN, "SDO pin request for 0x%04x:%02x failed"},
+    [LCEC_LOG_TELEMETRY_ERROR] = {RTAPI_MSG_WARN, "telemetry read of 0x%04x:%02x failed"},
+    [LCEC_LOG_LINK_STATE] = {RTAPI_MSG_WARN, "link %d link-up changed to %d, %u slaves responding"},
+    [LCEC_LOG_REDUNDANCY] = {RTAPI_MSG_WARN, "redundancy-active changed to %d"},
+};
+
+static int log_shmem_id = -1;
+
+static void lcec_log_push(lcec_master_t *master, int slave_index, const char *slave_name, lcec_log_limit_t *limit, lcec_log_id_t id,
+    int32_t a0, int32_t a1, int32_t a2, int32_t a3) {
+  lcec_log_ring_t *ring = master->log;
+  lcec_log_record_t *rec;
+  long long now = rtapi_get_time();
+  uint32_t head, tail;
+
+  // rate limit per message ID and slave
+  if (now - limit->window_start >= LCEC_LOG_RATE_PERIOD) {
+    limit->window_start = now;
+    limit->count = 0;
+  }
+  if (limit->count >= LCEC_LOG_RATE_BURST) {
+    limit->suppressed++;
+    return;
+  }
+  limit->count++;
+
+  // no reader, print directly
+  if (ring == NULL) {
+    lcec_log_record_t tmp = {id, slave_index, limit->suppressed, now, {a0, a1, a2, a3}};
+    char buf[256];
+    int level = lcec_log_format(&tmp, master->name, slave_name, buf, sizeof(buf));
+    rtapi_print_msg(level, "%s\n", buf);
+    limit->suppressed = 0;
+    return;
+  }
+
+  head = ring->head;
+  tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+  if (head - tail >= LCEC_LOG_RING_SIZE) {
+    __atomic_store_n(&ring->dropped, ring->dropped + 1, __ATOMIC_RELAXED);
+    return;
+  }
+
+  rec = &ring->records[head & (LCEC_LOG_RING_SIZE - 1)];
+  rec->id = id;
+  rec->slave = slave_index;
+  rec->suppressed = limit->suppressed;
+  rec->timestamp = now;
+  rec->args[0] = a0;
+  rec->args[1] = a1;
+  rec->args[2] = a2;
+  rec->args[3] = a3;
+  limit->suppressed = 0;
+
+  // publish the record
+  __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+}
+
+/// @brief Log a master-level message from realtime code.
+///
+/// Unused arguments should be passed as 0.
+void lcec_log_master(lcec_master_t *master, lcec_log_id_t id, int32_t a0, int32_t a1, int32_t a2, int32_t a3) {
+  lcec_log_push(master, -1, NULL, &master->log_limits[id], id, a0, a1, a2, a3);
+}
+
+/// @brief Log a slave-level message from realtime code.
+///
+/// Unused arguments should be passed as 0.
+void lcec_log_slave(lcec_slave_t *slave, lcec_log_id_t id, int32_t a0, int32_t a1, int32_t a2, int32_t a3) {
+  lcec_log_push(slave->master, slave->index, slave->name, &slave->log_limits[id], id, a0, a1, a2, a3);
+}
+
+/// @brief Count a slave's return to OP, so `lcec_conf` can re-apply a reloaded config.
+///
+/// Called whenever the slave's state has been read.  The AL state's
+/// error flag is masked, so OP with an error pending still counts as
+/// OP.
+///
+/// @param slave The slave, with its current state.
+/// @param last The slave's state from the previous read.
+void lcec_log_slave_reinit(lcec_slave_t *slave, const ec_slave_config_state_t *last) {
+  int op, last_op;
+
+  if (slave->reinit_count == NULL) {
+    return;
+  }
+
+  op = slave->state.online && (slave->state.al_state & 0x0f) == 0x08;
+  last_op = last->online && (last->al_state & 0x0f) == 0x08;
+  if (op && !last_op) {
+    __atomic_store_n(slave->reinit_count, *(slave->reinit_count) + 1, __ATOMIC_RELEASE);
+  }
+}
+
+/// @brief Return the size of the log shared memory segment for `ring_count` masters and `slave_count` slaves.
+size_t lcec_log_shmem_size(int ring_count, int slave_count) {
+  return sizeof(lcec_log_header_t) + ring_count * sizeof(lcec_log_ring_t) + slave_count * sizeof(lcec_slave_reinit_t);
+}
+
+/// @brief Attach each master to its log ring created by `lcec_conf`.
+///
+/// Masters are matched to rings in configuration order, and slaves
+/// to their re-init counters by index.  If the segment is missing,
+/// masters keep printing directly.
+///
+/// @return 0 if the rings are attached, <0 if logging falls back to direct printing.
+int lcec_log_attach(lcec_master_t *first_master) {
+  void *shmem_ptr;
+  lcec_log_header_t *header;
+  lcec_log_ring_t *rings;
+  lcec_slave_reinit_t *reinits;
+  lcec_master_t *master;
+  lcec_slave_t *slave;
+  int ring_count, slave_count, i, j;
+
+  // map the header to find the number of rings
+  log_shmem_id = rtapi_shmem_new(LCEC_LOG_SHMEM_KEY, lcec_comp_id, sizeof(lcec_log_header_t));
+  if (log_shmem_id < 0) {
+    goto fail0;
+  }
+  if (lcec_rtapi_shmem_getptr(log_shmem_id, &shmem_ptr) < 0) {
+    goto fail1;
+  }
+  header = (lcec_log_header_t *)shmem_ptr;
+  if (header->magic != LCEC_LOG_SHMEM_MAGIC) {
+    goto fail1;
+  }
+  ring_count = header->ring_count;
+  slave_count = header->slave_count;
+  rtapi_shmem_delete(log_shmem_id, lcec_comp_id);
+
+  // reopen with proper size
+  log_shmem_id = rtapi_shmem_new(LCEC_LOG_SHMEM_KEY, lcec_comp_id, lcec_log_shmem_size(ring_count, slave_count));
+  if (log_shmem_id < 0) {
+    goto fail0;
+  }
+  if (lcec_rtapi_shmem_getptr(log_shmem_id, &shmem_ptr) < 0) {
+    goto fail1;
+  }
+
+  rings = (lcec_log_ring_t *)((char *)shmem_ptr + sizeof(lcec_log_header_t));
+  reinits = (lcec_slave_reinit_t *)&rings[ring_count];
+  for (master = first_master, i = 0; master != NULL && i < ring_count; master = master->next, i++) {
+    master->log = &rings[i];
+    for (slave = master->first_slave; slave != NULL; slave = slave->next) {
+      for (j = 0; j < slave_count; j++) {
+        if (reinits[j].master == i && reinits[j].slave == slave->index) {
+          slave->reinit_count = &reinits[j].count;
+          break;
+        }
+      }
+    }
+  }
+
+  return 0;
+
+fail1:
+  rtapi_shmem_delete(log_shmem_id, lcec_comp_id);
+fail0:
+  log_shmem_id = -1;
+  rtapi_print_msg(RTAPI_MSG_WARN, LCEC_MSG_PFX "deferred log ring not available, printing realtime messages directly\n");
+  return -1;
+}
+
+/// @brief Release the log shared memory segment.
+void lcec_log_detach(void) {
+  if (log_shmem_id >= 0) {
+    rtapi_shmem_delete(log_shmem_id, lcec_comp_id);
+    log_shmem_id = -1;
+  }
+}
+
+/// @brief Remove the oldest record from a ring.  Called by the reader.
+///
+/// @return 1 if a record was copied into `rec`, 0 if the ring is empty.
+int lcec_log_pop(lcec_log_ring_t *ring, lcec_log_record_t *rec) {
+  uint32_t tail = ring->tail;
+  uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+
+  if (tail == head) {
+    return 0;
+  }
+
+  *rec = ring->records[tail & (LCEC_LOG_RING_SIZE - 1)];
+  __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+  return 1;
+}
+
+/// @brief Format a log record as text.
+///
+/// @param rec The record.
+/// @param master_name The master's name.
+/// @param slave_name The slave's name, or NULL to use its index.
+/// @param buf Output buffer.
+/// @param len Size of `buf`.
+/// @return The RTAPI message level for this record.
+int lcec_log_format(const lcec_log_record_t *rec, const char *master_name, const char *slave_name, char *buf, size_t len) {
+  const lcec_log_fmt_t *fmt;
+  int n;
+
+  if (rec->id >= LCEC_LOG_ID_COUNT) {
+    rtapi_snprintf(buf, len, LCEC_MSG_PFX "master %s: unknown log record %u", master_name, rec->id);
+    return RTAPI_MSG_ERR;
+  }
+  fmt = &lcec_log_formats[rec->id];
+
+  if (rec->slave < 0) {
+    n = rtapi_snprintf(buf, len, LCEC_MSG_PFX "master %s: ", master_name);
+  } else if (slave_name != NULL) {
+    n = rtapi_snprintf(buf, len, LCEC_MSG_PFX "slave %s.%s: ", master_name, slave_name);
+  } else {
+    n = rtapi_snprintf(buf, len, LCEC_MSG_PFX "slave %s.%d: ", master_name, rec->slave);
+  }
+  if (n < 0 || (size_t)n >= len) {
+    return fmt->level;
+  }
+
+  n += rtapi_snprintf(buf + n, len - n, fmt->fmt, rec->args[0], rec->args[1], rec->args[2], rec->args[3]);
+  if (n >= 0 && (size_t)n < len && rec->suppressed > 0) {
+    rtapi_snprintf(buf + n, len - n, " (%u similar messages suppressed)", rec->suppressed);
+  }
+
+  return fmt->level;
+}
@@ -48,6 +48,8 @@ static const lcec_pindesc_t master_global_pins[] = {
 
 /// @brief Master HAL pins
 static const lcec_pindesc_t master_pins[] = {
+    {HAL_U32, HAL_OUT, offsetof(lcec_master_data_t, rx_deadline_misses), "%s.rx-deadline-misses"},
+    {HAL_S32, HAL_OUT, offsetof(lcec_master_data_t, rx_wait_avg), "%s.rx-wait-avg"},
 #ifdef RTAPI_TASK_PLL_SUPPORT
     {HAL_S32, HAL_OUT, offsetof(lcec_master_data_t, pll_err), "%s.pll-err"},
     {HAL_S32, HAL_OUT, offsetof(lcec_master_data_t, pll_out), "%s.pll-out"},
@@ -56,6 +58,23 @@ static const lcec_pindesc_t master_pins[] = {
     {HAL_TYPE_UNSPECIFIED, HAL_DIR_UNSPECIFIED, -1, NULL},
 };
 
+#ifdef EC_HAVE_REDUNDANCY
+/// @brief Master HAL pins, with a backup device
+static const lcec_pindesc_t master_redundancy_pins[] = {
+    {HAL_BIT, HAL_OUT, offsetof(lcec_master_data_t, redundancy_active), "%s.redundancy-active"},
+    {HAL_U32, HAL_OUT, offsetof(lcec_master_data_t, failovers), "%s.failovers"},
+    {HAL_U32, HAL_OUT, offsetof(lcec_master_data_t, failover_lost_cycles), "%s.failover-lost-cycles"},
+    {HAL_TYPE_UNSPECIFIED, HAL_DIR_UNSPECIFIED, -1, NULL},
+};
+
+/// @brief Per-link HAL pins, with a backup device
+static const lcec_pindesc_t master_link_pins[] = {
+    {HAL_BIT, HAL_OUT, offsetof(lcec_master_link_data_t, link_up), "%s.link-%d-up"},
+    {HAL_U32, HAL_OUT, offsetof(lcec_master_link_data_t, slaves_responding), "%s.link-%d-slaves-responding"},
+    {HAL_TYPE_UNSPECIFIED, HAL_DIR_UNSPECIFIED, -1, NULL},
+};
+#endif
+
 /// @brief Master params
 static const lcec_paramdesc_t master_params[] = {
 #ifdef RTAPI_TASK_PLL_SUPPORT
@@ -95,11 +114,37 @@ lcec_master_data_t *lcec_init_master_hal(const char *pfx, int global);
 lcec_slave_state_t *lcec_init_slave_state_hal(char *master_name, char *slave_name);
 void lcec_update_master_hal(lcec_master_data_t *hal_data, ec_master_state_t *ms);
 void lcec_update_slave_state_hal(lcec_slave_state_t *hal_data, ec_slave_config_state_t *ss);
+static void lcec_log_master_state(lcec_master_t *master, ec_master_state_t *last);
+static void lcec_log_slave_state(lcec_slave_t *slave, ec_slave_config_state_t *last);
 
 void lcec_read_all(void *arg, long period);
 void lcec_write_all(void *arg, long period);
 void lcec_read_master(void *arg, long period);
 void lcec_write_master(void *arg, long period);
+void lcec_receive(lcec_master_t *master);
+#ifdef EC_HAVE_REDUNDANCY
+int lcec_init_master_redundancy(lcec_master_t *master, const char *pfx);
+void lcec_update_redundancy(lcec_master_t *master, int check_states);
+#endif
+
+static int lcec_init_disabled_slave(lcec_slave_t *slave);
+static void *lcec_disabled_hal_malloc(size_t size);
+static int lcec_disabled_pin_new(const char *name, hal_type_t type, hal_pin_dir_t dir, void **data_ptr_addr);
+static int lcec_disabled_param_new(const char *name, hal_type_t type, hal_param_dir_t dir, void *data_addr);
+static void lcec_disabled_limit_exceeded(lcec_slave_t *slave, const char *what);
+
+/// @brief Hooks for setting up slaves with `enabled="false"`.
+///
+/// Their drivers export real pins and params, but SDO reads return
+/// zeros and SDO writes and requests are skipped, as there is no
+/// slave config for them.
+static const lcec_dry_run_t disabled_hooks = {
+    lcec_disabled_hal_malloc,
+    lcec_disabled_pin_new,
+    lcec_disabled_param_new,
+    lcec_disabled_limit_exceeded,
+    NULL,
+};
 
 static void sigsegv_handler(int sig);
 
@@ -113,6 +158,7 @@ int rtapi_app_main(void) {
   lcec_slave_idnconf_t *idn_config;
   struct timeval tv;
   int pdo_entry_count = 0;
+  long long trace_start;
 
 #ifndef __KERNEL
   struct sigaction handler;
@@ -132,10 +178,18 @@ int rtapi_app_main(void) {
     goto fail0;
   }
 
+  // attach startup trace, created by lcec_conf
+  lcec_trace_attach();
+
   // parse configuration
+  trace_start = lcec_trace_start();
   if ((slave_count = lcec_parse_config()) < 0) {
     goto fail1;
   }
+  lcec_trace_add(NULL, NULL, LCEC_TRACE_PARSE_CONFIG, trace_start);
+
+  // attach deferred log rings, created by lcec_conf
+  lcec_log_attach(first_master);
 
   // init global hal data
   if ((global_hal_data = lcec_init_master_hal(LCEC_MODULE_NAME, 1)) == NULL) {
@@ -144,7 +198,10 @@ int rtapi_app_main(void) {
 
   // initialize masters
   for (master = first_master; master != NULL; master = master->next) {
+    lcec_mem_track(master, NULL);
+
     // request ethercat master
+    trace_start = lcec_trace_start();
     if (!(master->master = ecrt_request_master(master->index))) {
       rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "requesting master %s (index %d) failed\n", master->name, master->index);
       goto fail2;
@@ -160,18 +217,32 @@ int rtapi_app_main(void) {
       rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "master %s domain creation failed\n", master->name);
       goto fail2;
     }
+    lcec_trace_add(master, NULL, LCEC_TRACE_REQUEST_MASTER, trace_start);
 
     // initialize slaves
     for (slave = master->first_slave; slave != NULL; slave = slave->next) {
+      lcec_mem_track(master, slave);
+
+      // disabled slaves only get their pins
+      if (slave->disabled) {
+        if (lcec_init_disabled_slave(slave) != 0) {
+          goto fail2;
+        }
+        continue;
+      }
+
       // read slave config
 
       rtapi_print_msg(RTAPI_MSG_DBG, LCEC_MSG_PFX "calling ecrt_master_slave_config for slave %s.%s\n", master->name, slave->name);
+      trace_start = lcec_trace_start();
       if (!(slave->config = ecrt_master_slave_config(master->master, 0, slave->index, slave->vid, slave->pid))) {
         rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "fail to read slave %s.%s configuration\n", master->name, slave->name);
         goto fail2;
       }
+      lcec_trace_add(master, slave, LCEC_TRACE_SLAVE_CONFIG, trace_start);
 
       // initialize sdos
+      trace_start = lcec_trace_start();
       if (slave->sdo_config != NULL) {
         for (sdo_config = slave->sdo_config; sdo_config->index != 0xffff;
              sdo_config = (lcec_slave_sdoconf_t *)&sdo_config->data[sdo_config->length]) {
@@ -202,6 +273,8 @@ int rtapi_app_main(void) {
         }
       }
 
+      lcec_trace_add(master, slave, LCEC_TRACE_SDO_IDN, trace_start);
+
       slave->regs = lcec_allocate_pdo_entry_reg(LCEC_MAX_PDO_REG_COUNT);
       if (slave->regs == NULL) {
         rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "failure allocating PDO entries for slave %s.%s\n", master->name, slave->name);
@@ -211,10 +284,12 @@ int rtapi_app_main(void) {
       // setup pdos
       if (slave->proc_init != NULL) {
         rtapi_print_msg(RTAPI_MSG_DBG, LCEC_MSG_PFX "proc_init for slave %s.%s\n", master->name, slave->name);
+        trace_start = lcec_trace_start();
         if ((slave->proc_init(lcec_comp_id, slave)) != 0) {
           rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "failure in proc_init for slave %s.%s\n", master->name, slave->name);
           goto fail2;
         }
+        lcec_trace_add(master, slave, LCEC_TRACE_PROC_INIT, trace_start);
       }
 
       // configure dc for this slave
@@ -225,6 +300,13 @@ int rtapi_app_main(void) {
             LCEC_MSG_PFX "configuring DC for slave %s.%s: assignActivate=x%x sync0Cycle=%d sync0Shift=%d sync1Cycle=%d sync1Shift=%d\n",
             master->name, slave->name, slave->dc_conf->assignActivate, slave->dc_conf->sync0Cycle, slave->dc_conf->sync0Shift,
             slave->dc_conf->sync1Cycle, slave->dc_conf->sync1Shift);
+
+        // set up SYNC0 shift calibration
+        if (master->dc_calib_mode != lcecDcCalibrateOff && slave->dc_conf->sync0Cycle > 0) {
+          if (lcec_dc_calib_init(slave) != 0) {
+            goto fail2;
+          }
+        }
       }
 
       // Configure the slave's watchdog times.
@@ -233,6 +315,7 @@ int rtapi_app_main(void) {
       }
 
       // configure slave
+      trace_start = lcec_trace_start();
       if (slave->sync_info != NULL) {
         rtapi_print_msg(RTAPI_MSG_DBG, LCEC_MSG_PFX "sync_info setup for slave %s.%s\n", master->name, slave->name);
         if (ecrt_slave_config_pdos(slave->config, EC_END, slave->sync_info)) {
@@ -247,12 +330,18 @@ int rtapi_app_main(void) {
         rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "failure to export slave pins for slave %s.%s\n", master->name, slave->name);
         goto fail2;
       }
+      lcec_trace_add(master, slave, LCEC_TRACE_PDO_CONFIG, trace_start);
 
       pdo_entry_count += lcec_pdo_entry_reg_len(slave->regs);
     }
+    lcec_mem_track(master, NULL);
 
+    trace_start = lcec_trace_start();
     lcec_pdo_entry_reg_t *master_regs = lcec_allocate_pdo_entry_reg(pdo_entry_count + 1);
     for (slave = master->first_slave; slave != NULL; slave = slave->next) {
+      if (slave->disabled) {
+        continue;
+      }
       if (lcec_append_pdo_entry_reg(master_regs, slave->regs) < 0) {
         rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "failure to append PDO entries for slave %s.%s\n", master->name, slave->name);
         goto fail2;
@@ -265,6 +354,15 @@ int rtapi_app_main(void) {
       rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "master %s PDO entry registration failed\n", master->name);
       goto fail2;
     }
+    lcec_trace_add(master, NULL, LCEC_TRACE_DOMAIN_REG, trace_start);
+
+    // let drivers check the offsets they got
+    for (slave = master->first_slave; slave != NULL; slave = slave->next) {
+      if (!slave->disabled && slave->proc_pdo_check != NULL && slave->proc_pdo_check(slave) != 0) {
+        rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "PDO check failed for slave %s.%s\n", master->name, slave->name);
+        goto fail2;
+      }
+    }
 
     // initialize application time
     rtapi_print_msg(RTAPI_MSG_DBG, LCEC_MSG_PFX "Setting time\n");
@@ -286,10 +384,28 @@ int rtapi_app_main(void) {
 
     // activating master
     rtapi_print_msg(RTAPI_MSG_DBG, LCEC_MSG_PFX "Activating master\n");
+    trace_start = lcec_trace_start();
     if (ecrt_master_activate(master->master)) {
       rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "failed to activate master %s\n", master->name);
       goto fail2;
     }
+    lcec_trace_add(master, NULL, LCEC_TRACE_ACTIVATE, trace_start);
+
+    // time the way to OP from here, see lcec_read_master()
+    master->trace_op_start = lcec_trace_start();
+    if (master->trace_op_start != 0) {
+      for (slave = master->first_slave; slave != NULL; slave = slave->next) {
+        if (slave->disabled) {
+          continue;
+        }
+        slave->trace_op_start = master->trace_op_start;
+        master->trace_op_pending++;
+      }
+      if (master->trace_op_pending == 0) {
+        lcec_trace_add(master, NULL, LCEC_TRACE_MASTER_OP, master->trace_op_start);
+        master->trace_op_start = 0;
+      }
+    }
 
     // Get internal process data for domain
     master->process_data = ecrt_domain_data(master->domain);
@@ -302,6 +418,20 @@ int rtapi_app_main(void) {
       goto fail2;
     }
 
+#ifdef EC_HAVE_REDUNDANCY
+    if (lcec_init_master_redundancy(master, name) != 0) {
+      goto fail2;
+    }
+#endif
+
+#ifdef __KERNEL__
+    if (master->rx_deadline > 0) {
+      rtapi_print_msg(RTAPI_MSG_WARN, LCEC_MSG_PFX "master %s: receiveDeadline is only supported in userspace builds, ignoring it\n",
+          master->name);
+      master->rx_deadline = 0;
+    }
+#endif
+
 #ifdef RTAPI_TASK_PLL_SUPPORT
     // set default PLL_STEP: use +/-0.1% of period
     master->hal_data->pll_step = master->app_time_period / 1000;
@@ -336,6 +466,9 @@ int rtapi_app_main(void) {
     goto fail2;
   }
 
+  lcec_mem_track(NULL, NULL);
+  lcec_mem_report(first_master);
+
   rtapi_print_msg(RTAPI_MSG_INFO, LCEC_MSG_PFX "installed driver for %d slaves\n", slave_count);
   hal_ready(lcec_comp_id);
   return 0;
@@ -370,33 +503,7 @@ int lcec_parse_config(void) {
   void *shmem_ptr;
   LCEC_CONF_HEADER_T *header;
   size_t length;
-  char *conf;
   int slave_count;
-  const lcec_typelist_t *type;
-  lcec_master_t *master;
-  lcec_slave_t *slave;
-  lcec_slave_dc_t *dc;
-  lcec_slave_watchdog_t *wd;
-  LCEC_CONF_TYPE_T conf_type;
-  LCEC_CONF_MASTER_T *master_conf;
-  LCEC_CONF_SLAVE_T *slave_conf;
-  LCEC_CONF_DC_T *dc_conf;
-  LCEC_CONF_WATCHDOG_T *wd_conf;
-  LCEC_CONF_SYNCMANAGER_T *sm_conf;
-  LCEC_CONF_PDO_T *pdo_conf;
-  LCEC_CONF_PDOENTRY_T *pe_conf;
-  LCEC_CONF_COMPLEXENTRY_T *ce_conf;
-  LCEC_CONF_SDOCONF_T *sdo_conf;
-  LCEC_CONF_IDNCONF_T *idn_conf;
-  LCEC_CONF_MODPARAM_T *modparam_conf;
-  ec_pdo_entry_info_t *generic_pdo_entries;
-  ec_pdo_info_t *generic_pdos;
-  ec_sync_info_t *generic_sync_managers;
-  lcec_generic_pin_t *generic_hal_data;
-  hal_pin_dir_t generic_hal_dir;
-  lcec_slave_sdoconf_t *sdo_config;
-  lcec_slave_idnconf_t *idn_config;
-  lcec_slave_modparam_t *modparams;
 
   // initialize list
   first_master = NULL;
@@ -433,477 +540,17 @@ int lcec_parse_config(void) {
     goto fail1;
   }
 
-  // get pointer to config
-  conf = ((char *)shmem_ptr + sizeof(LCEC_CONF_HEADER_T));
-
   // process config items
-  slave_count = 0;
-  master = NULL;
-  slave = NULL;
-  generic_pdo_entries = NULL;
-  generic_pdos = NULL;
-  generic_sync_managers = NULL;
-  generic_hal_data = NULL;
-  generic_hal_dir = HAL_DIR_UNSPECIFIED;
-  sdo_config = NULL;
-  idn_config = NULL;
-  pe_conf = NULL;
-  modparams = NULL;
-  while ((conf_type = ((LCEC_CONF_NULL_T *)conf)->confType) != lcecConfTypeNone) {
-    // get type
-    switch (conf_type) {
-      case lcecConfTypeMaster:
-        // get config token
-        master_conf = (LCEC_CONF_MASTER_T *)conf;
-        conf += sizeof(LCEC_CONF_MASTER_T);
-
-        // alloc master memory
-        master = LCEC_ALLOCATE(lcec_master_t);
-
-        // initialize master
-        master->index = master_conf->index;
-        strncpy(master->name, master_conf->name, LCEC_CONF_STR_MAXLEN);
-        master->name[LCEC_CONF_STR_MAXLEN - 1] = 0;
-        master->app_time_period = master_conf->appTimePeriod;
-        master->sync_ref_cycles = master_conf->refClockSyncCycles;
-
-        // add master to list
-        LCEC_LIST_APPEND(first_master, last_master, master);
-        break;
-
-      case lcecConfTypeSlave:
-        // get config token
-        slave_conf = (LCEC_CONF_SLAVE_T *)conf;
-        conf += sizeof(LCEC_CONF_SLAVE_T);
-
-        // check for master
-        if (master == NULL) {
-          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Master node for slave missing\n");
-          goto fail2;
-        }
-
-        // check for valid slave type
-        if (!strcmp(slave_conf->type_name, "generic")) {
-          type = NULL;
-        } else {
-          type = lcec_findslavetype(slave_conf->type_name);
-
-          if (type == NULL) {
-            rtapi_print_msg(RTAPI_MSG_WARN, LCEC_MSG_PFX "Invalid slave name \"%s\"\n", slave_conf->type_name);
-            continue;
-          }
-        }
-
-        // create new slave
-        slave = LCEC_ALLOCATE(lcec_slave_t);
-
-        // initialize slave
-        generic_pdo_entries = NULL;
-        generic_pdos = NULL;
-        generic_sync_managers = NULL;
-        generic_hal_data = NULL;
-        generic_hal_dir = HAL_DIR_UNSPECIFIED;
-        sdo_config = NULL;
-        idn_config = NULL;
-        modparams = NULL;
-
-        slave->index = slave_conf->index;
-        strncpy(slave->name, slave_conf->name, LCEC_CONF_STR_MAXLEN);
-        slave->name[LCEC_CONF_STR_MAXLEN - 1] = 0;
-        slave->master = master;
-
-        // add slave to list
-        LCEC_LIST_APPEND(master->first_slave, master->last_slave, slave);
-
-        if (type != NULL) {
-          // normal slave
-          if (slave_conf->vid)
-            slave->vid = slave_conf->vid;
-          else
-            slave->vid = type->vid;
-
-          if (slave_conf->pid)
-            slave->pid = slave_conf->pid;
-          else
-            slave->pid = type->pid;
-
-          slave->is_fsoe_logic = type->is_fsoe_logic;
-          slave->proc_preinit = type->proc_preinit;
-          slave->proc_init = type->proc_init;
-          slave->flags = type->flags;
-        } else {
-          // generic slave
-          slave->vid = slave_conf->vid;
-          slave->pid = slave_conf->pid;
-          slave->generic_pdo_entry_count = slave_conf->pdoMappingCount;
-          slave->proc_init = lcec_generic_init;
-
-          // alloc hal memory
-          if ((generic_hal_data = LCEC_HAL_ALLOCATE_ARRAY(lcec_generic_pin_t, slave_conf->pdoMappingCount)) == NULL) {
-            rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "hal_malloc() for slave %s.%s failed\n", master->name, slave_conf->name);
-            goto fail2;
-          }
-          memset(generic_hal_data, 0, sizeof(lcec_generic_pin_t) * slave_conf->pdoMappingCount);
-
-          // alloc pdo entry memory
-          generic_pdo_entries = LCEC_ALLOCATE_ARRAY(ec_pdo_entry_info_t, slave_conf->pdoEntryCount);
-
-          // alloc pdo memory
-          generic_pdos = LCEC_ALLOCATE_ARRAY(ec_pdo_info_t, slave_conf->pdoCount);
-
-          // alloc sync manager memory
-          generic_sync_managers = LCEC_ALLOCATE_ARRAY(ec_sync_info_t, (slave_conf->syncManagerCount + 1));
-
-          generic_sync_managers->index = 0xff;
-        }
-
-        // alloc sdo config memory
-        if (slave_conf->sdoConfigLength > 0) {
-          sdo_config = (lcec_slave_sdoconf_t *)lcec_zalloc(slave_conf->sdoConfigLength + sizeof(lcec_slave_sdoconf_t));
-          if (sdo_config == NULL) {
-            rtapi_print_msg(
-                RTAPI_MSG_ERR, LCEC_MSG_PFX "Unable to allocate slave %s.%s sdo entry memory\n", master->name, slave_conf->name);
-            goto fail2;
-          }
-        }
-
-        // alloc idn config memory
-        if (slave_conf->idnConfigLength > 0) {
-          idn_config = (lcec_slave_idnconf_t *)lcec_zalloc(slave_conf->idnConfigLength + sizeof(lcec_slave_idnconf_t));
-          if (idn_config == NULL) {
-            rtapi_print_msg(
-                RTAPI_MSG_ERR, LCEC_MSG_PFX "Unable to allocate slave %s.%s idn entry memory\n", master->name, slave_conf->name);
-            goto fail2;
-          }
-        }
-
-        // alloc modparam memory
-        if (slave_conf->modParamCount > 0) {
-          modparams = LCEC_ALLOCATE_ARRAY(lcec_slave_modparam_t, (slave_conf->modParamCount + 1));
-          modparams[slave_conf->modParamCount].id = -1;
-        }
-
-        slave->hal_data = generic_hal_data;
-        slave->generic_pdo_entries = generic_pdo_entries;
-        slave->generic_pdos = generic_pdos;
-        slave->generic_sync_managers = generic_sync_managers;
-        if (slave_conf->configPdos) {
-          slave->sync_info = generic_sync_managers;
-        }
-        slave->sdo_config = sdo_config;
-        slave->idn_config = idn_config;
-        slave->modparams = modparams;
-        slave->dc_conf = NULL;
-        slave->wd_conf = NULL;
-
-        // update slave count
-        slave_count++;
-        break;
-
-      case lcecConfTypeDcConf:
-        // get config token
-        dc_conf = (LCEC_CONF_DC_T *)conf;
-        conf += sizeof(LCEC_CONF_DC_T);
-
-        // check for slave
-        if (slave == NULL) {
-          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Slave node for dc config missing\n");
-          goto fail2;
-        }
-
-        // check for double dc config
-        if (slave->dc_conf != NULL) {
-          rtapi_print_msg(RTAPI_MSG_WARN, LCEC_MSG_PFX "Double dc config for slave %s.%s\n", master->name, slave->name);
-          continue;
-        }
-
-        // create new dc config
-        dc = LCEC_ALLOCATE(lcec_slave_dc_t);
-
-        // initialize dc conf
-        dc->assignActivate = dc_conf->assignActivate;
-        dc->sync0Cycle = dc_conf->sync0Cycle;
-        dc->sync0Shift = dc_conf->sync0Shift;
-        dc->sync1Cycle = dc_conf->sync1Cycle;
-        dc->sync1Shift = dc_conf->sync1Shift;
-
-        // add to slave
-        slave->dc_conf = dc;
-        break;
-
-      case lcecConfTypeWatchdog:
-        // get config token
-        wd_conf = (LCEC_CONF_WATCHDOG_T *)conf;
-        conf += sizeof(LCEC_CONF_WATCHDOG_T);
-
-        // check for slave
-        if (slave == NULL) {
-          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Slave node for watchdog config missing\n");
-          goto fail2;
-        }
-
-        // check for double wd config
-        if (slave->wd_conf != NULL) {
-          rtapi_print_msg(RTAPI_MSG_WARN, LCEC_MSG_PFX "Double watchdog config for slave %s.%s\n", master->name, slave->name);
-          continue;
-        }
-
-        // create new wd config
-        wd = LCEC_ALLOCATE(lcec_slave_watchdog_t);
-
-        // initialize wd conf
-        wd->divider = wd_conf->divider;
-        wd->intervals = wd_conf->intervals;
-
-        // add to slave
-        slave->wd_conf = wd;
-        break;
-
-      case lcecConfTypeSyncManager:
-        // get config token
-        sm_conf = (LCEC_CONF_SYNCMANAGER_T *)conf;
-        conf += sizeof(LCEC_CONF_SYNCMANAGER_T);
-
-        // check for syncmanager
-        if (generic_sync_managers == NULL) {
-          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Sync manager for generic device missing\n");
-          goto fail2;
-        }
-
-        // check for pdos
-        if (generic_pdos == NULL) {
-          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "PDOs for generic device missing\n");
-          goto fail2;
-        }
-
-        // initialize sync manager
-        generic_sync_managers->index = sm_conf->index;
-        generic_sync_managers->dir = sm_conf->dir;
-        generic_sync_managers->n_pdos = sm_conf->pdoCount;
-        generic_sync_managers->pdos = sm_conf->pdoCount == 0 ? NULL : generic_pdos;
-
-        // get hal direction
-        switch (sm_conf->dir) {
-          case EC_DIR_INPUT:
-            generic_hal_dir = HAL_OUT;
-            break;
-          case EC_DIR_OUTPUT:
-            generic_hal_dir = HAL_IN;
-            break;
-          default:
-            generic_hal_dir = HAL_DIR_UNSPECIFIED;
-        }
-
-        // next syncmanager
-        generic_sync_managers++;
-        generic_sync_managers->index = 0xff;
-        break;
-
-      case lcecConfTypePdo:
-        // get config token
-        pdo_conf = (LCEC_CONF_PDO_T *)conf;
-        conf += sizeof(LCEC_CONF_PDO_T);
-
-        // check for pdos
-        if (generic_pdos == NULL) {
-          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "PDOs for generic device missing\n");
-          goto fail2;
-        }
-
-        // check for pdos entries
-        if (generic_pdo_entries == NULL) {
-          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "PDO entries for generic device missing\n");
-          goto fail2;
-        }
-
-        // initialize pdo
-        generic_pdos->index = pdo_conf->index;
-        generic_pdos->n_entries = pdo_conf->pdoEntryCount;
-        generic_pdos->entries = pdo_conf->pdoEntryCount == 0 ? NULL : generic_pdo_entries;
-
-        // next pdo
-        generic_pdos++;
-        break;
-
-      case lcecConfTypePdoEntry:
-        // get config token
-        pe_conf = (LCEC_CONF_PDOENTRY_T *)conf;
-        conf += sizeof(LCEC_CONF_PDOENTRY_T);
-
-        // check for pdos entries
-        if (generic_pdo_entries == NULL) {
-          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "PDO entries for generic device missing\n");
-          goto fail2;
-        }
-
-        // check for hal data
-        if (generic_hal_data == NULL) {
-          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "HAL data for generic device missing\n");
-          goto fail2;
-        }
-
-        // check for hal dir
-        if (generic_hal_dir == HAL_DIR_UNSPECIFIED) {
-          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "HAL direction for generic device missing\n");
-          goto fail2;
-        }
-
-        // initialize pdo entry
-        generic_pdo_entries->index = pe_conf->index;
-        generic_pdo_entries->subindex = pe_conf->subindex;
-        generic_pdo_entries->bit_length = pe_conf->bitLength;
-
-        // initialize hal data
-        if (pe_conf->halPin[0] != 0) {
-          strncpy(generic_hal_data->name, pe_conf->halPin, LCEC_CONF_STR_MAXLEN);
-          generic_hal_data->name[LCEC_CONF_STR_MAXLEN - 1] = 0;
-          generic_hal_data->type = pe_conf->halType;
-          generic_hal_data->subType = pe_conf->subType;
-          generic_hal_data->floatScale = pe_conf->floatScale;
-          generic_hal_data->floatOffset = pe_conf->floatOffset;
-          generic_hal_data->bitOffset = 0;
-          generic_hal_data->bitLength = pe_conf->bitLength;
-          generic_hal_data->dir = generic_hal_dir;
-          generic_hal_data->pdo_idx = pe_conf->index;
-          generic_hal_data->pdo_sidx = pe_conf->subindex;
-          generic_hal_data++;
-        }
-
-        // next pdo entry
-        generic_pdo_entries++;
-        break;
-
-      case lcecConfTypeComplexEntry:
-        // get config token
-        ce_conf = (LCEC_CONF_COMPLEXENTRY_T *)conf;
-        conf += sizeof(LCEC_CONF_COMPLEXENTRY_T);
-
-        // check for pdoEntry
-        if (pe_conf == NULL) {
-          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "pdoEntry for generic device missing\n");
-          goto fail2;
-        }
-
-        // check for hal data
-        if (generic_hal_data == NULL) {
-          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "HAL data for generic device missing\n");
-          goto fail2;
-        }
-
-        // initialize hal data
-        if (ce_conf->halPin[0] != 0) {
-          strncpy(generic_hal_data->name, ce_conf->halPin, LCEC_CONF_STR_MAXLEN);
-          generic_hal_data->name[LCEC_CONF_STR_MAXLEN - 1] = 0;
-          generic_hal_data->type = ce_conf->halType;
-          generic_hal_data->subType = ce_conf->subType;
-          generic_hal_data->floatScale = ce_conf->floatScale;
-          generic_hal_data->floatOffset = ce_conf->floatOffset;
-          generic_hal_data->bitOffset = ce_conf->bitOffset;
-          generic_hal_data->bitLength = ce_conf->bitLength;
-          generic_hal_data->dir = generic_hal_dir;
-          generic_hal_data->pdo_idx = pe_conf->index;
-          generic_hal_data->pdo_sidx = pe_conf->subindex;
-          generic_hal_data++;
-        }
-        break;
-
-      case lcecConfTypeSdoConfig:
-        // get config token
-        sdo_conf = (LCEC_CONF_SDOCONF_T *)conf;
-        conf += sizeof(LCEC_CONF_SDOCONF_T) + sdo_conf->length;
-
-        if (sdo_config == NULL) {
-          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "sdo_config is NULL\n");
-          goto fail2;
-        }
-
-        // copy attributes
-        sdo_config->index = sdo_conf->index;
-        sdo_config->subindex = sdo_conf->subindex;
-        sdo_config->length = sdo_conf->length;
-
-        // copy data
-        memcpy(sdo_config->data, sdo_conf->data, sdo_config->length);
-
-        sdo_config = (lcec_slave_sdoconf_t *)&sdo_config->data[sdo_config->length];
-        sdo_config->index = 0xffff;
-        break;
-
-      case lcecConfTypeIdnConfig:
-        // get config token
-        idn_conf = (LCEC_CONF_IDNCONF_T *)conf;
-        conf += sizeof(LCEC_CONF_IDNCONF_T) + idn_conf->length;
-
-        if (idn_config == NULL) {
-          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "idn_config is NULL\n");
-          goto fail2;
-        }
-
-        // copy attributes
-        idn_config->drive = idn_conf->drive;
-        idn_config->idn = idn_conf->idn;
-        idn_config->state = idn_conf->state;
-        idn_config->length = idn_conf->length;
-
-        // copy data
-        memcpy(idn_config->data, idn_conf->data, idn_config->length);
-
-        idn_config = (lcec_slave_idnconf_t *)&idn_config->data[idn_config->length];
-        break;
-
-      case lcecConfTypeModParam:
-        // get config token
-        modparam_conf = (LCEC_CONF_MODPARAM_T *)conf;
-        conf += sizeof(LCEC_CONF_MODPARAM_T);
-
-        // check for slave
-        if (slave == NULL) {
-          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Slave node for modparam config missing\n");
-          goto fail2;
-        }
-
-        if (modparams == NULL) {
-          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "modparams is nullg\n");
-          goto fail2;
-        }
-
-        // copy attributes
-        modparams->id = modparam_conf->id;
-        modparams->value = modparam_conf->value;
-        modparams->name = modparam_conf->name;
-
-        // next entry
-        modparams++;
-        break;
-
-      default:
-        rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Unknown config item type\n");
-        goto fail2;
-    }
+  if ((slave_count = lcec_parse_conf_tokens((char *)shmem_ptr + sizeof(LCEC_CONF_HEADER_T), &first_master, &last_master)) < 0) {
+    goto fail2;
   }
 
   // close shmem
   rtapi_shmem_delete(shmem_id, lcec_comp_id);
 
-  // allocate PDO entity memory
-  for (master = first_master; master != NULL; master = master->next) {
-    // stage 1 preinit: process all but FSOE logic devices
-    for (slave = master->first_slave; slave != NULL; slave = slave->next) {
-      if (!slave->is_fsoe_logic && slave->proc_preinit != NULL) {
-        if (slave->proc_preinit(slave) < 0) {
-          goto fail2;
-        }
-      }
-    }
-
-    // stage 2 preinit: process only FSOE logic devices (this depends on initialized fsoeConf data)
-    for (slave = master->first_slave; slave != NULL; slave = slave->next) {
-      if (slave->is_fsoe_logic && slave->proc_preinit != NULL) {
-        if (slave->proc_preinit(slave) < 0) {
-          goto fail2;
-        }
-      }
-    }
+  // run driver preinit
+  if (lcec_preinit_slaves(first_master) < 0) {
+    goto fail2;
   }
 
   return slave_count;
@@ -946,6 +593,9 @@ void lcec_clear_config(void) {
 
     master = prev_master;
   }
+
+  lcec_log_detach();
+  lcec_trace_detach();
 }
 
 #ifdef __KERNEL__
@@ -1008,6 +658,54 @@ lcec_slave_state_t *lcec_init_slave_state_hal(char *master_name, char *slave_nam
   return hal_data;
 }
 
+/// @brief Set up a slave with `enabled="false"`.
+///
+/// The driver exports its pins, which keep their defaults, but the
+/// slave gets no slave config, so none of its PDOs, SDOs, IDNs, or DC
+/// settings reach the bus and its PDOs aren't part of the domain.
+/// The cyclic functions skip it.
+static int lcec_init_disabled_slave(lcec_slave_t *slave) {
+  lcec_master_t *master = slave->master;
+  int err = 0;
+
+  rtapi_print_msg(RTAPI_MSG_INFO, LCEC_MSG_PFX "slave %s.%s is disabled\n", master->name, slave->name);
+
+  slave->regs = lcec_allocate_pdo_entry_reg(LCEC_MAX_PDO_REG_COUNT);
+  if (slave->regs == NULL) {
+    rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "failure allocating PDO entries for slave %s.%s\n", master->name, slave->name);
+    return -1;
+  }
+
+  if (slave->proc_init != NULL) {
+    lcec_dry_run = &disabled_hooks;
+    err = slave->proc_init(lcec_comp_id, slave);
+    lcec_dry_run = NULL;
+    if (err != 0) {
+      rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "failure in proc_init for slave %s.%s\n", master->name, slave->name);
+      return -1;
+    }
+  }
+
+  if ((slave->hal_state_data = lcec_init_slave_state_hal(master->name, slave->name)) == NULL) {
+    rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "failure to export slave pins for slave %s.%s\n", master->name, slave->name);
+    return -1;
+  }
+
+  return 0;
+}
+
+static void *lcec_disabled_hal_malloc(size_t size) { return hal_malloc(size); }
+
+static int lcec_disabled_pin_new(const char *name, hal_type_t type, hal_pin_dir_t dir, void **data_ptr_addr) {
+  return hal_pin_new(name, type, dir, data_ptr_addr, lcec_comp_id);
+}
+
+static int lcec_disabled_param_new(const char *name, hal_type_t type, hal_param_dir_t dir, void *data_addr) {
+  return hal_param_new(name, type, dir, data_addr, lcec_comp_id);
+}
+
+static void lcec_disabled_limit_exceeded(lcec_slave_t *slave, const char *what) {}
+
 /// @brief Update HAL pins for the master.
 void lcec_update_master_hal(lcec_master_data_t *hal_data, ec_master_state_t *ms) {
   *(hal_data->slaves_responding) = ms->slaves_responding;
@@ -1029,6 +727,33 @@ void lcec_update_slave_state_hal(lcec_slave_state_t *hal_data, ec_slave_config_s
   *(hal_data->state_op) = (ss->al_state & 0x08) != 0;
 }
 
+/// @brief Log master state changes.
+static void lcec_log_master_state(lcec_master_t *master, ec_master_state_t *last) {
+  ec_master_state_t *ms = &master->ms;
+
+  if (ms->link_up != last->link_up) {
+    lcec_log_master(master, LCEC_LOG_MASTER_LINK, ms->link_up, ms->slaves_responding, 0, 0);
+  }
+  if (ms->al_states != last->al_states) {
+    lcec_log_master(master, LCEC_LOG_MASTER_AL_STATES, last->al_states, ms->al_states, 0, 0);
+  }
+}
+
+/// @brief Log slave state changes.
+static void lcec_log_slave_state(lcec_slave_t *slave, ec_slave_config_state_t *last) {
+  ec_slave_config_state_t *ss = &slave->state;
+
+  if (ss->online != last->online) {
+    if (ss->online) {
+      lcec_log_slave(slave, LCEC_LOG_SLAVE_ONLINE, ss->al_state, 0, 0, 0);
+    } else {
+      lcec_log_slave(slave, LCEC_LOG_SLAVE_OFFLINE, 0, 0, 0, 0);
+    }
+  } else if (ss->al_state != last->al_state || ss->operational != last->operational) {
+    lcec_log_slave(slave, LCEC_LOG_SLAVE_AL_STATE, last->al_state, ss->al_state, ss->operational, 0);
+  }
+}
+
 /// @brief Update all input pins across all masters and slaves.
 void lcec_read_all(void *arg, long period) {
   lcec_master_t *master;
@@ -1062,13 +787,14 @@ void lcec_read_master(void *arg, long period) {
   lcec_master_t *master = (lcec_master_t *)arg;
   lcec_slave_t *slave;
   int check_states;
+  ec_master_state_t ms_last;
+  ec_slave_config_state_t ss_last;
 
   // check period
   if (period != master->period_last) {
     master->period_last = period;
     if (master->app_time_period != period) {
-      rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Invalid appTimePeriod of %u for master %s (should be %ld).\n", master->app_time_period,
-          master->name, period);
+      lcec_log_master(master, LCEC_LOG_APP_TIME_PERIOD, master->app_time_period, period, 0, 0);
     }
   }
 
@@ -1082,16 +808,24 @@ void lcec_read_master(void *arg, long period) {
   }
 
   // receive process data & master state
+  lcec_receive(master);
   rtapi_mutex_get(&master->mutex);
-  ecrt_master_receive(master->master);
-  ecrt_domain_process(master->domain);
   if (check_states) {
+    ms_last = master->ms;
     ecrt_master_state(master->master, &master->ms);
   }
+#ifdef EC_HAVE_REDUNDANCY
+  if (master->link_count > 1) {
+    lcec_update_redundancy(master, check_states);
+  }
+#endif
   rtapi_mutex_give(&master->mutex);
 
   // update state pins
   lcec_update_master_hal(master->hal_data, &master->ms);
+  if (check_states) {
+    lcec_log_master_state(master, &ms_last);
+  }
 
   // update global state
   global_ms.slaves_responding += master->ms.slaves_responding;
@@ -1100,14 +834,44 @@ void lcec_read_master(void *arg, long period) {
 
   // process slaves
   for (slave = master->first_slave; slave != NULL; slave = slave->next) {
-    // get slaves state
-    rtapi_mutex_get(&master->mutex);
-    if (check_states) {
-      ecrt_slave_config_state(slave->config, &slave->state);
+    if (slave->disabled) {
+      continue;
     }
-    rtapi_mutex_give(&master->mutex);
-    if (check_states) {
+
+    // get slaves state, every cycle while lcec_conf counts re-inits,
+    // SYNC0 calibration waits for a state, or the startup trace waits
+    // for OP, so no change is missed and OP is timed to the cycle
+    if (check_states || slave->reinit_count != NULL || slave->dc_calib != NULL || slave->trace_op_start != 0) {
+      rtapi_mutex_get(&master->mutex);
+      ss_last = slave->state;
+      ecrt_slave_config_state(slave->config, &slave->state);
+      rtapi_mutex_give(&master->mutex);
+
       lcec_update_slave_state_hal(slave->hal_state_data, &slave->state);
+      lcec_log_slave_state(slave, &ss_last);
+      lcec_log_slave_reinit(slave, &ss_last);
+
+      // startup trace: first time in OP
+      if (slave->trace_op_start != 0 && slave->state.operational) {
+        lcec_trace_add(master, slave, LCEC_TRACE_WAIT_OP, slave->trace_op_start);
+        slave->trace_op_start = 0;
+        if (--master->trace_op_pending == 0) {
+          lcec_trace_add(master, NULL, LCEC_TRACE_MASTER_OP, master->trace_op_start);
+          master->trace_op_start = 0;
+        }
+      }
+    }
+
+    // advance SYNC0 shift calibration
+    if (slave->dc_calib != NULL) {
+      rtapi_mutex_get(&master->mutex);
+      lcec_dc_calib_run(slave);
+      rtapi_mutex_give(&master->mutex);
+    }
+
+    // pick up scale changes before the driver uses them
+    if (slave->scales != NULL) {
+      lcec_scale_update(slave);
     }
 
     // process read function
@@ -1115,8 +879,138 @@ void lcec_read_master(void *arg, long period) {
       slave->proc_read(slave, period);
     }
   }
+  master->scales_checked = 1;
 }
 
+/// @brief Receive process data.
+///
+/// Without a `receiveDeadline`, this receives once, and a frame that
+/// is still on the wire is picked up a cycle later.  With one, it
+/// keeps receiving until the domain's working counter is complete or
+/// the deadline has passed, so `read` can run early in the thread
+/// without losing a cycle on late frames.  After
+/// `LCEC_RX_DEADLINE_MISS_LIMIT` misses in a row, e.g. with a slave
+/// that's gone, it only receives once per cycle until the domain is
+/// complete again.  Takes the master's mutex for each receive, and
+/// not while waiting `LCEC_RX_POLL_NS` before the next one.
+void lcec_receive(lcec_master_t *master) {
+  ec_domain_state_t ds;
+  long long start, wait;
+
+  start = rtapi_get_time();
+  for (;;) {
+    rtapi_mutex_get(&master->mutex);
+    ecrt_master_receive(master->master);
+    ecrt_domain_process(master->domain);
+    ecrt_domain_state(master->domain, &ds);
+    rtapi_mutex_give(&master->mutex);
+
+    if (master->rx_deadline <= 0) {
+      return;
+    }
+    wait = rtapi_get_time() - start;
+    if (ds.wc_state == EC_WC_COMPLETE) {
+      master->rx_miss_run = 0;
+      break;
+    }
+    if (wait >= master->rx_deadline || master->rx_miss_run >= LCEC_RX_DEADLINE_MISS_LIMIT) {
+      (*(master->hal_data->rx_deadline_misses))++;
+      if (master->rx_miss_run < LCEC_RX_DEADLINE_MISS_LIMIT) {
+        master->rx_miss_run++;
+      }
+      break;
+    }
+
+    // give the frame time to arrive, but don't sleep past the deadline
+    rtapi_delay((master->rx_deadline - wait < LCEC_RX_POLL_NS) ? master->rx_deadline - wait : LCEC_RX_POLL_NS);
+  }
+
+  master->rx_wait_avg += ((double)wait - master->rx_wait_avg) / LCEC_RX_WAIT_AVG_CYCLES;
+  *(master->hal_data->rx_wait_avg) = master->rx_wait_avg;
+}
+
+#ifdef EC_HAVE_REDUNDANCY
+/// @brief Export redundancy pins if the master has a backup device.
+///
+/// The backup device is set up in the EtherCAT master's own
+/// configuration; this only checks whether there is one.
+int lcec_init_master_redundancy(lcec_master_t *master, const char *pfx) {
+  lcec_master_data_t *hal_data = master->hal_data;
+  int i;
+
+  for (master->link_count = 0; master->link_count < LCEC_MAX_LINKS; master->link_count++) {
+    if (ecrt_master_link_state(master->master, master->link_count, &master->link_states[master->link_count]) != 0) {
+      break;
+    }
+  }
+  if (master->link_count < 2) {
+    return 0;
+  }
+
+  rtapi_print_msg(RTAPI_MSG_INFO, LCEC_MSG_PFX "master %s has a backup device\n", master->name);
+  if (lcec_pin_newf_list(hal_data, master_redundancy_pins, pfx) != 0) {
+    return -1;
+  }
+  for (i = 0; i < master->link_count; i++) {
+    if (lcec_pin_newf_list(&hal_data->links[i], master_link_pins, pfx, i) != 0) {
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+/// @brief Update link and redundancy pins.  Call with the master's mutex held.
+///
+/// A switch to or from the backup path shows up in the domain's
+/// `redundancy_active` flag.  `failover-lost-cycles` counts the
+/// cycles without complete process data around the last switch,
+/// from the first incomplete cycle before it to the first complete
+/// cycle after it, up to `LCEC_RX_LOST_RUN_LIMIT`.
+void lcec_update_redundancy(lcec_master_t *master, int check_states) {
+  lcec_master_data_t *hal_data = master->hal_data;
+  ec_master_link_state_t ls;
+  ec_domain_state_t ds;
+  int i;
+
+  if (check_states) {
+    for (i = 0; i < master->link_count; i++) {
+      if (ecrt_master_link_state(master->master, i, &ls) != 0) {
+        continue;
+      }
+      if (ls.link_up != master->link_states[i].link_up) {
+        lcec_log_master(master, LCEC_LOG_LINK_STATE, i, ls.link_up, ls.slaves_responding, 0);
+      }
+      master->link_states[i] = ls;
+      *(hal_data->links[i].link_up) = ls.link_up;
+      *(hal_data->links[i].slaves_responding) = ls.slaves_responding;
+    }
+  }
+
+  ecrt_domain_state(master->domain, &ds);
+  if (ds.wc_state != EC_WC_COMPLETE && master->rx_lost_run < LCEC_RX_LOST_RUN_LIMIT) {
+    master->rx_lost_run++;
+  }
+
+  if (ds.redundancy_active != *(hal_data->redundancy_active)) {
+    *(hal_data->redundancy_active) = ds.redundancy_active;
+    if (ds.redundancy_active) {
+      (*(hal_data->failovers))++;
+    }
+    lcec_log_master(master, LCEC_LOG_REDUNDANCY, ds.redundancy_active, 0, 0, 0);
+    master->failover_pending = 1;
+  }
+
+  if (ds.wc_state == EC_WC_COMPLETE) {
+    if (master->failover_pending) {
+      *(hal_data->failover_lost_cycles) = master->rx_lost_run;
+      master->failover_pending = 0;
+    }
+    master->rx_lost_run = 0;
+  }
+}
+#endif
+
 /// @brief Write all output pins on a master and its slaves.
 void lcec_write_master(void *arg, long period) {
   lcec_master_t *master = (lcec_master_t *)arg;
@@ -1132,10 +1026,18 @@ void lcec_write_master(void *arg, long period) {
 
   // process slaves
   for (slave = master->first_slave; slave != NULL; slave = slave->next) {
+    if (slave->disabled) {
+      continue;
+    }
+    // once per cycle is enough, but write may run without read, e.g. in another thread
+    if (!master->scales_checked && slave->scales != NULL) {
+      lcec_scale_update(slave);
+    }
     if (slave->proc_write != NULL) {
       slave->proc_write(slave, period);
     }
   }
+  master->scales_checked = 0;
 
 #ifdef RTAPI_TASK_PLL_SUPPORT
   // get reference time
@@ -18,27 +18,166 @@
 
 /// @file
 /// @brief Memory allocation helpers for LinuxCNC-Ethercat
+///
+/// Allocations, pins, and params are also counted, for the master
+/// and slave set with `lcec_mem_track()` and in total, so the startup
+/// summary from `lcec_mem_report()` shows which slaves use up HAL
+/// shared memory.
 
 #include <stdio.h>
 
 #include "lcec.h"
 
+// hot structs of some drivers cover many cache lines, so the hot pool
+// takes more at a time than the class pools
+lcec_pool_t lcec_hot_pool = {.chunk_size = LCEC_HOT_CHUNK_SIZE};
+
+static lcec_master_t *mem_master = NULL;
+static lcec_slave_t *mem_slave = NULL;
+static lcec_mem_usage_t mem_total;
+
+static void mem_add(lcec_mem_usage_t *mem, size_t hal_bytes, size_t heap_bytes, unsigned int pins, unsigned int params);
+
 void *lcec_hal_malloc(size_t size, const char *file, const char *func, int line) {
-  void *result = hal_malloc(size);
+  void *result = (lcec_dry_run != NULL) ? lcec_dry_run->hal_malloc(size) : hal_malloc(size);
   if (result == NULL) {
     rtapi_print_msg(
         RTAPI_MSG_ERR, LCEC_MSG_PFX "MEMORY ALLOCATION FAILURE, hal_malloc() returned NULL in function %s at %s:%d\n", func, file, line);
+    rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "about %lu bytes of HAL memory were in use, raise HAL_SIZE\n",
+        (unsigned long)lcec_mem_hal_estimate(&mem_total));
     exit(1);
   }
   memset(result, 0, size);
+  lcec_mem_charge(size, 0, 0, 0);
   return result;
 }
 
 void *lcec_malloc(size_t size, const char *file, const char *func, int line) {
-  void *result = malloc(size);
+  // calloc() may return NULL for 0 bytes, so ask for at least one
+  void *result = calloc(1, (size > 0) ? size : 1);
   if (result == NULL) {
-    fprintf(stderr, LCEC_MSG_PFX "MEMORY ALLOCATION FAILURE, hal_malloc() returned NULL in function %s at %s:%d\n", func, file, line);
+    fprintf(stderr, LCEC_MSG_PFX "MEMORY ALLOCATION FAILURE, calloc() returned NULL in function %s at %s:%d\n", func, file, line);
     exit(1);
   }
+  lcec_mem_charge(0, size, 0, 0);
+  return result;
+}
+
+/// @brief Allocate a zeroed block, aligned to `align`, from `pool`.
+///
+/// Use `LCEC_POOL_ALLOCATE()` and `LCEC_POOL_ALLOCATE_ARRAY()` instead
+/// of calling this directly, they pass the type's alignment.  New
+/// chunks are charged to whichever slave is being set up at the time,
+/// see `lcec_mem_track()`, and whatever part of them isn't handed out
+/// (alignment gaps, the end of a chunk that a block didn't fit in)
+/// shows up in the total's `pool_unused`.
+void *lcec_pool_alloc(lcec_pool_t *pool, size_t size, size_t align, const char *file, const char *func, int line) {
+  size_t pool_chunk_size = pool->chunk_size != 0 ? pool->chunk_size : LCEC_POOL_CHUNK_SIZE;
+  uint8_t *chunk, *result;
+  size_t chunk_size, pad;
+
+  if (size == 0) {
+    size = 1;
+  }
+  pad = -(uintptr_t)pool->next & (align - 1);
+
+  if (pool->next == NULL || pad + size > pool->left) {
+    // hal_malloc() only aligns to 8 bytes
+    chunk_size = size + align - 1;
+    if (chunk_size < pool_chunk_size) {
+      chunk_size = pool_chunk_size;
+    }
+    chunk = lcec_hal_malloc(chunk_size, file, func, line);
+    mem_total.pool_unused += chunk_size;
+    pad = -(uintptr_t)chunk & (align - 1);
+
+    // oversized blocks get a chunk of their own, and the current
+    // chunk stays in use
+    if (chunk_size > pool_chunk_size) {
+      mem_total.pool_unused -= size;
+      return chunk + pad;
+    }
+    pool->next = chunk;
+    pool->left = chunk_size;
+  }
+
+  result = pool->next + pad;
+  pool->next += pad + size;
+  pool->left -= pad + size;
+  mem_total.pool_unused -= size;
   return result;
 }
+
+/// @brief Charge memory used from now on to a master and slave.
+///
+/// @param master The master, or NULL to only count totals.
+/// @param slave The slave, or NULL for the master itself.
+void lcec_mem_track(lcec_master_t *master, lcec_slave_t *slave) {
+  mem_master = master;
+  mem_slave = slave;
+}
+
+/// @brief Count memory used by the current master and slave.
+///
+/// Called by the allocation helpers, and for each pin and param.  If
+/// this takes the master past its `halMemBudget`, a warning names the
+/// slave that did it.
+void lcec_mem_charge(size_t hal_bytes, size_t heap_bytes, unsigned int pins, unsigned int params) {
+  size_t used;
+
+  mem_add(&mem_total, hal_bytes, heap_bytes, pins, params);
+  if (mem_slave != NULL) {
+    mem_add(&mem_slave->mem, hal_bytes, heap_bytes, pins, params);
+  }
+  if (mem_master == NULL) {
+    return;
+  }
+
+  mem_add(&mem_master->mem, hal_bytes, heap_bytes, pins, params);
+  if (mem_master->hal_mem_budget == 0 || mem_master->hal_mem_budget_warned) {
+    return;
+  }
+  used = lcec_mem_hal_estimate(&mem_master->mem);
+  if (used > mem_master->hal_mem_budget) {
+    rtapi_print_msg(RTAPI_MSG_WARN, LCEC_MSG_PFX "master %s: about %lu bytes of HAL memory used at slave %s, over halMemBudget %u\n",
+        mem_master->name, (unsigned long)used, (mem_slave != NULL) ? mem_slave->name : "-", (unsigned int)mem_master->hal_mem_budget);
+    mem_master->hal_mem_budget_warned = 1;
+  }
+}
+
+/// @brief Estimate the HAL shared memory behind `mem`.
+///
+/// This adds the approximate size of HAL's own record for each pin
+/// and param to the bytes allocated directly.
+size_t lcec_mem_hal_estimate(const lcec_mem_usage_t *mem) {
+  return mem->hal_bytes + (size_t)mem->pins * LCEC_MEM_PIN_HAL_BYTES + (size_t)mem->params * LCEC_MEM_PARAM_HAL_BYTES;
+}
+
+/// @brief Get memory used by everything so far.
+const lcec_mem_usage_t *lcec_mem_total(void) { return &mem_total; }
+
+/// @brief Print memory used by each slave and master, and in total.
+void lcec_mem_report(lcec_master_t *first_master) {
+  lcec_master_t *master;
+  lcec_slave_t *slave;
+
+  for (master = first_master; master != NULL; master = master->next) {
+    for (slave = master->first_slave; slave != NULL; slave = slave->next) {
+      rtapi_print_msg(RTAPI_MSG_INFO, LCEC_MSG_PFX "memory %s.%s: %lu HAL bytes, %u pins, %u params, %lu heap bytes\n", master->name,
+          slave->name, (unsigned long)lcec_mem_hal_estimate(&slave->mem), slave->mem.pins, slave->mem.params,
+          (unsigned long)slave->mem.heap_bytes);
+    }
+    rtapi_print_msg(RTAPI_MSG_INFO, LCEC_MSG_PFX "memory %s: %lu HAL bytes, %u pins, %u params, %lu heap bytes\n", master->name,
+        (unsigned long)lcec_mem_hal_estimate(&master->mem), master->mem.pins, master->mem.params, (unsigned long)master->mem.heap_bytes);
+  }
+  rtapi_print_msg(RTAPI_MSG_INFO, LCEC_MSG_PFX "memory total: %lu HAL bytes (%lu unused in pools), %u pins, %u params, %lu heap bytes\n",
+      (unsigned long)lcec_mem_hal_estimate(&mem_total), (unsigned long)mem_total.pool_unused, mem_total.pins, mem_total.params,
+      (unsigned long)mem_total.heap_bytes);
+}
+
+static void mem_add(lcec_mem_usage_t *mem, size_t hal_bytes, size_t heap_bytes, unsigned int pins, unsigned int params) {
+  mem->hal_bytes += hal_bytes;
+  mem->heap_bytes += heap_bytes;
+  mem->pins += pins;
+  mem->params += params;
+}
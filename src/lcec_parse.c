@@ -0,0 +1,635 @@
+//
+//    Copyright (C) 2012 Sascha Ittner <sascha.ittner@modusoft.de>
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program; if not, write to the Free Software
+//    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+//
+
+/// @file
+/// @brief Config token parsing for LinuxCNC-Ethercat
+///
+/// This turns the token stream written by `lcec_conf` into lists of
+/// `lcec_master_t` and `lcec_slave_t`, and runs each driver's
+/// `proc_preinit`.  It is shared by the realtime module and by
+/// `lcec_conf --check`.
+
+#include "devices/lcec_generic.h"
+#include "lcec.h"
+
+/// @brief Build masters and slaves from `lcec_conf`'s config tokens.
+///
+/// Masters are appended to the list given by `first_master` and
+/// `last_master`.  On failure, everything that was already appended
+/// stays on the list so the caller can clean it up.
+///
+/// @param conf The first config token.
+/// @param first_master The first master in the list.
+/// @param last_master The last master in the list.
+/// @return The number of slaves, or <0 on error.
+int lcec_parse_conf_tokens(char *conf, lcec_master_t **first_master, lcec_master_t **last_master) {
+  char *conf_start;
+  char *template_return;
+  int slave_count;
+  const lcec_typelist_t *type;
+  lcec_master_t *master;
+  lcec_slave_t *slave;
+  lcec_slave_dc_t *dc;
+  lcec_slave_watchdog_t *wd;
+  LCEC_CONF_TYPE_T conf_type;
+  LCEC_CONF_MASTER_T *master_conf;
+  LCEC_CONF_SLAVE_T *slave_conf;
+  LCEC_CONF_DC_T *dc_conf;
+  LCEC_CONF_WATCHDOG_T *wd_conf;
+  LCEC_CONF_SYNCMANAGER_T *sm_conf;
+  LCEC_CONF_PDO_T *pdo_conf;
+  LCEC_CONF_PDOENTRY_T *pe_conf;
+  LCEC_CONF_COMPLEXENTRY_T *ce_conf;
+  LCEC_CONF_SDOCONF_T *sdo_conf;
+  LCEC_CONF_IDNCONF_T *idn_conf;
+  LCEC_CONF_MODPARAM_T *modparam_conf;
+  LCEC_CONF_SDOPIN_T *sdo_pin_conf;
+  ec_pdo_entry_info_t *generic_pdo_entries;
+  ec_pdo_info_t *generic_pdos;
+  ec_sync_info_t *generic_sync_managers;
+  lcec_generic_pin_t *generic_hal_data;
+  lcec_generic_sdo_pin_t *generic_sdo_pins;
+  hal_pin_dir_t generic_hal_dir;
+  lcec_slave_sdoconf_t *sdo_config;
+  lcec_slave_idnconf_t *idn_config;
+  lcec_slave_modparam_t *modparams;
+
+  conf_start = conf;
+  template_return = NULL;
+
+  slave_count = 0;
+  master = NULL;
+  slave = NULL;
+  generic_pdo_entries = NULL;
+  generic_pdos = NULL;
+  generic_sync_managers = NULL;
+  generic_hal_data = NULL;
+  generic_sdo_pins = NULL;
+  generic_hal_dir = HAL_DIR_UNSPECIFIED;
+  sdo_config = NULL;
+  idn_config = NULL;
+  pe_conf = NULL;
+  modparams = NULL;
+  while ((conf_type = ((LCEC_CONF_NULL_T *)conf)->confType) != lcecConfTypeNone) {
+    // get type
+    switch (conf_type) {
+      case lcecConfTypeMaster:
+        // get config token
+        master_conf = (LCEC_CONF_MASTER_T *)conf;
+        conf += sizeof(LCEC_CONF_MASTER_T);
+
+        // alloc master memory
+        master = LCEC_ALLOCATE(lcec_master_t);
+
+        // initialize master
+        master->index = master_conf->index;
+        strncpy(master->name, master_conf->name, LCEC_CONF_STR_MAXLEN);
+        master->name[LCEC_CONF_STR_MAXLEN - 1] = 0;
+        master->app_time_period = master_conf->appTimePeriod;
+        master->sync_ref_cycles = master_conf->refClockSyncCycles;
+        master->dc_calib_mode = master_conf->dcCalibrate;
+        master->dc_calib_samples = master_conf->dcCalibrateSamples;
+        master->dc_calib_margin = master_conf->dcCalibrateMargin;
+        master->rx_deadline = master_conf->receiveDeadline;
+        master->hal_mem_budget = master_conf->halMemBudget;
+        lcec_mem_track(master, NULL);
+
+        // add master to list
+        LCEC_LIST_APPEND(*first_master, *last_master, master);
+        break;
+
+      case lcecConfTypeSlave:
+        // get config token
+        slave_conf = (LCEC_CONF_SLAVE_T *)conf;
+        conf += sizeof(LCEC_CONF_SLAVE_T);
+
+        // check for master
+        if (master == NULL) {
+          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Master node for slave missing\n");
+          return -1;
+        }
+
+        // check for valid slave type
+        if (!strcmp(slave_conf->type_name, "generic")) {
+          type = NULL;
+        } else {
+          type = lcec_findslavetype(slave_conf->type_name);
+
+          if (type == NULL) {
+            rtapi_print_msg(RTAPI_MSG_WARN, LCEC_MSG_PFX "Invalid slave name \"%s\"\n", slave_conf->type_name);
+            continue;
+          }
+        }
+
+        // create new slave
+        slave = LCEC_ALLOCATE(lcec_slave_t);
+
+        // initialize slave
+        generic_pdo_entries = NULL;
+        generic_pdos = NULL;
+        generic_sync_managers = NULL;
+        generic_hal_data = NULL;
+        generic_sdo_pins = NULL;
+        generic_hal_dir = HAL_DIR_UNSPECIFIED;
+        sdo_config = NULL;
+        idn_config = NULL;
+        modparams = NULL;
+
+        slave->index = slave_conf->index;
+        strncpy(slave->name, slave_conf->name, LCEC_CONF_STR_MAXLEN);
+        slave->name[LCEC_CONF_STR_MAXLEN - 1] = 0;
+        slave->master = master;
+        slave->disabled = slave_conf->disabled;
+        lcec_mem_track(master, slave);
+
+        // add slave to list
+        LCEC_LIST_APPEND(master->first_slave, master->last_slave, slave);
+
+        if (type != NULL) {
+          // normal slave
+          if (slave_conf->vid)
+            slave->vid = slave_conf->vid;
+          else
+            slave->vid = type->vid;
+
+          if (slave_conf->pid)
+            slave->pid = slave_conf->pid;
+          else
+            slave->pid = type->pid;
+
+          slave->is_fsoe_logic = type->is_fsoe_logic;
+          slave->proc_preinit = type->proc_preinit;
+          slave->proc_init = type->proc_init;
+          slave->flags = type->flags;
+        } else {
+          // generic slave
+          slave->vid = slave_conf->vid;
+          slave->pid = slave_conf->pid;
+          slave->generic_pdo_entry_count = slave_conf->pdoMappingCount;
+          slave->proc_init = lcec_generic_init;
+
+          // alloc hal memory
+          if ((generic_hal_data = LCEC_HAL_ALLOCATE_ARRAY(lcec_generic_pin_t, slave_conf->pdoMappingCount)) == NULL) {
+            rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "hal_malloc() for slave %s.%s failed\n", master->name, slave_conf->name);
+            return -1;
+          }
+          memset(generic_hal_data, 0, sizeof(lcec_generic_pin_t) * slave_conf->pdoMappingCount);
+
+          // alloc pdo entry memory
+          generic_pdo_entries = LCEC_ALLOCATE_ARRAY(ec_pdo_entry_info_t, slave_conf->pdoEntryCount);
+
+          // alloc pdo memory
+          generic_pdos = LCEC_ALLOCATE_ARRAY(ec_pdo_info_t, slave_conf->pdoCount);
+
+          // alloc sync manager memory
+          generic_sync_managers = LCEC_ALLOCATE_ARRAY(ec_sync_info_t, (slave_conf->syncManagerCount + 1));
+
+          generic_sync_managers->index = 0xff;
+
+          // alloc sdo pin memory
+          if (slave_conf->sdoPinCount > 0) {
+            generic_sdo_pins = LCEC_HAL_ALLOCATE_ARRAY(lcec_generic_sdo_pin_t, slave_conf->sdoPinCount);
+            slave->generic_sdo_pins = generic_sdo_pins;
+            slave->generic_sdo_pin_count = slave_conf->sdoPinCount;
+          }
+        }
+
+        // alloc sdo config memory
+        if (slave_conf->sdoConfigLength > 0) {
+          sdo_config = (lcec_slave_sdoconf_t *)lcec_zalloc(slave_conf->sdoConfigLength + sizeof(lcec_slave_sdoconf_t));
+          if (sdo_config == NULL) {
+            rtapi_print_msg(
+                RTAPI_MSG_ERR, LCEC_MSG_PFX "Unable to allocate slave %s.%s sdo entry memory\n", master->name, slave_conf->name);
+            return -1;
+          }
+        }
+
+        // alloc idn config memory
+        if (slave_conf->idnConfigLength > 0) {
+          idn_config = (lcec_slave_idnconf_t *)lcec_zalloc(slave_conf->idnConfigLength + sizeof(lcec_slave_idnconf_t));
+          if (idn_config == NULL) {
+            rtapi_print_msg(
+                RTAPI_MSG_ERR, LCEC_MSG_PFX "Unable to allocate slave %s.%s idn entry memory\n", master->name, slave_conf->name);
+            return -1;
+          }
+        }
+
+        // alloc modparam memory
+        if (slave_conf->modParamCount > 0) {
+          modparams = LCEC_ALLOCATE_ARRAY(lcec_slave_modparam_t, (slave_conf->modParamCount + 1));
+          modparams[slave_conf->modParamCount].id = -1;
+        }
+
+        slave->hal_data = generic_hal_data;
+        slave->generic_pdo_entries = generic_pdo_entries;
+        slave->generic_pdos = generic_pdos;
+        slave->generic_sync_managers = generic_sync_managers;
+        if (slave_conf->configPdos) {
+          slave->sync_info = generic_sync_managers;
+        }
+        slave->sdo_config = sdo_config;
+        slave->idn_config = idn_config;
+        slave->modparams = modparams;
+        slave->dc_conf = NULL;
+        slave->wd_conf = NULL;
+
+        // update slave count
+        slave_count++;
+
+        // process the shared template body, then continue with this slave's own children
+        if (slave_conf->templateOffset >= 0) {
+          template_return = conf;
+          conf = conf_start + slave_conf->templateOffset;
+        }
+        break;
+
+      case lcecConfTypeSlaveTemplate:
+        // templates are only processed when a slave refers to them
+        slave_conf = (LCEC_CONF_SLAVE_T *)conf;
+        conf += sizeof(LCEC_CONF_SLAVE_T) + slave_conf->templateLength;
+        break;
+
+      case lcecConfTypeSlaveTemplateEnd:
+        conf += sizeof(LCEC_CONF_NULL_T);
+
+        // return from template body
+        if (template_return == NULL) {
+          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Unexpected end of slave template\n");
+          return -1;
+        }
+        conf = template_return;
+        template_return = NULL;
+        break;
+
+      case lcecConfTypeDcConf:
+        // get config token
+        dc_conf = (LCEC_CONF_DC_T *)conf;
+        conf += sizeof(LCEC_CONF_DC_T);
+
+        // check for slave
+        if (slave == NULL) {
+          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Slave node for dc config missing\n");
+          return -1;
+        }
+
+        // check for double dc config
+        if (slave->dc_conf != NULL) {
+          rtapi_print_msg(RTAPI_MSG_WARN, LCEC_MSG_PFX "Double dc config for slave %s.%s\n", master->name, slave->name);
+          continue;
+        }
+
+        // create new dc config
+        dc = LCEC_ALLOCATE(lcec_slave_dc_t);
+
+        // initialize dc conf
+        dc->assignActivate = dc_conf->assignActivate;
+        dc->sync0Cycle = dc_conf->sync0Cycle;
+        dc->sync0Shift = dc_conf->sync0Shift;
+        dc->sync1Cycle = dc_conf->sync1Cycle;
+        dc->sync1Shift = dc_conf->sync1Shift;
+
+        // add to slave
+        slave->dc_conf = dc;
+        break;
+
+      case lcecConfTypeWatchdog:
+        // get config token
+        wd_conf = (LCEC_CONF_WATCHDOG_T *)conf;
+        conf += sizeof(LCEC_CONF_WATCHDOG_T);
+
+        // check for slave
+        if (slave == NULL) {
+          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Slave node for watchdog config missing\n");
+          return -1;
+        }
+
+        // check for double wd config
+        if (slave->wd_conf != NULL) {
+          rtapi_print_msg(RTAPI_MSG_WARN, LCEC_MSG_PFX "Double watchdog config for slave %s.%s\n", master->name, slave->name);
+          continue;
+        }
+
+        // create new wd config
+        wd = LCEC_ALLOCATE(lcec_slave_watchdog_t);
+
+        // initialize wd conf
+        wd->divider = wd_conf->divider;
+        wd->intervals = wd_conf->intervals;
+
+        // add to slave
+        slave->wd_conf = wd;
+        break;
+
+      case lcecConfTypeSyncManager:
+        // get config token
+        sm_conf = (LCEC_CONF_SYNCMANAGER_T *)conf;
+        conf += sizeof(LCEC_CONF_SYNCMANAGER_T);
+
+        // check for syncmanager
+        if (generic_sync_managers == NULL) {
+          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Sync manager for generic device missing\n");
+          return -1;
+        }
+
+        // check for pdos
+        if (generic_pdos == NULL) {
+          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "PDOs for generic device missing\n");
+          return -1;
+        }
+
+        // initialize sync manager
+        generic_sync_managers->index = sm_conf->index;
+        generic_sync_managers->dir = sm_conf->dir;
+        generic_sync_managers->n_pdos = sm_conf->pdoCount;
+        generic_sync_managers->pdos = sm_conf->pdoCount == 0 ? NULL : generic_pdos;
+
+        // get hal direction
+        switch (sm_conf->dir) {
+          case EC_DIR_INPUT:
+            generic_hal_dir = HAL_OUT;
+            break;
+          case EC_DIR_OUTPUT:
+            generic_hal_dir = HAL_IN;
+            break;
+          default:
+            generic_hal_dir = HAL_DIR_UNSPECIFIED;
+        }
+
+        // next syncmanager
+        generic_sync_managers++;
+        generic_sync_managers->index = 0xff;
+        break;
+
+      case lcecConfTypePdo:
+        // get config token
+        pdo_conf = (LCEC_CONF_PDO_T *)conf;
+        conf += sizeof(LCEC_CONF_PDO_T);
+
+        // check for pdos
+        if (generic_pdos == NULL) {
+          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "PDOs for generic device missing\n");
+          return -1;
+        }
+
+        // check for pdos entries
+        if (generic_pdo_entries == NULL) {
+          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "PDO entries for generic device missing\n");
+          return -1;
+        }
+
+        // initialize pdo
+        generic_pdos->index = pdo_conf->index;
+        generic_pdos->n_entries = pdo_conf->pdoEntryCount;
+        generic_pdos->entries = pdo_conf->pdoEntryCount == 0 ? NULL : generic_pdo_entries;
+
+        // next pdo
+        generic_pdos++;
+        break;
+
+      case lcecConfTypePdoEntry:
+        // get config token
+        pe_conf = (LCEC_CONF_PDOENTRY_T *)conf;
+        conf += sizeof(LCEC_CONF_PDOENTRY_T);
+
+        // check for pdos entries
+        if (generic_pdo_entries == NULL) {
+          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "PDO entries for generic device missing\n");
+          return -1;
+        }
+
+        // check for hal data
+        if (generic_hal_data == NULL) {
+          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "HAL data for generic device missing\n");
+          return -1;
+        }
+
+        // check for hal dir
+        if (generic_hal_dir == HAL_DIR_UNSPECIFIED) {
+          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "HAL direction for generic device missing\n");
+          return -1;
+        }
+
+        // initialize pdo entry
+        generic_pdo_entries->index = pe_conf->index;
+        generic_pdo_entries->subindex = pe_conf->subindex;
+        generic_pdo_entries->bit_length = pe_conf->bitLength;
+
+        // initialize hal data
+        if (pe_conf->halPin[0] != 0) {
+          strncpy(generic_hal_data->name, pe_conf->halPin, LCEC_CONF_STR_MAXLEN);
+          generic_hal_data->name[LCEC_CONF_STR_MAXLEN - 1] = 0;
+          generic_hal_data->type = pe_conf->halType;
+          generic_hal_data->subType = pe_conf->subType;
+          generic_hal_data->floatScale = pe_conf->floatScale;
+          generic_hal_data->floatOffset = pe_conf->floatOffset;
+          generic_hal_data->bitOffset = 0;
+          generic_hal_data->bitLength = pe_conf->bitLength;
+          generic_hal_data->dir = generic_hal_dir;
+          generic_hal_data->pdo_idx = pe_conf->index;
+          generic_hal_data->pdo_sidx = pe_conf->subindex;
+          generic_hal_data++;
+        }
+
+        // next pdo entry
+        generic_pdo_entries++;
+        break;
+
+      case lcecConfTypeComplexEntry:
+        // get config token
+        ce_conf = (LCEC_CONF_COMPLEXENTRY_T *)conf;
+        conf += sizeof(LCEC_CONF_COMPLEXENTRY_T);
+
+        // check for pdoEntry
+        if (pe_conf == NULL) {
+          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "pdoEntry for generic device missing\n");
+          return -1;
+        }
+
+        // check for hal data
+        if (generic_hal_data == NULL) {
+          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "HAL data for generic device missing\n");
+          return -1;
+        }
+
+        // initialize hal data
+        if (ce_conf->halPin[0] != 0) {
+          strncpy(generic_hal_data->name, ce_conf->halPin, LCEC_CONF_STR_MAXLEN);
+          generic_hal_data->name[LCEC_CONF_STR_MAXLEN - 1] = 0;
+          generic_hal_data->type = ce_conf->halType;
+          generic_hal_data->subType = ce_conf->subType;
+          generic_hal_data->floatScale = ce_conf->floatScale;
+          generic_hal_data->floatOffset = ce_conf->floatOffset;
+          generic_hal_data->bitOffset = ce_conf->bitOffset;
+          generic_hal_data->bitLength = ce_conf->bitLength;
+          generic_hal_data->dir = generic_hal_dir;
+          generic_hal_data->pdo_idx = pe_conf->index;
+          generic_hal_data->pdo_sidx = pe_conf->subindex;
+          generic_hal_data++;
+        }
+        break;
+
+      case lcecConfTypeSdoConfig:
+        // get config token
+        sdo_conf = (LCEC_CONF_SDOCONF_T *)conf;
+        conf += sizeof(LCEC_CONF_SDOCONF_T) + sdo_conf->length;
+
+        if (sdo_config == NULL) {
+          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "sdo_config is NULL\n");
+          return -1;
+        }
+
+        // copy attributes
+        sdo_config->index = sdo_conf->index;
+        sdo_config->subindex = sdo_conf->subindex;
+        sdo_config->length = sdo_conf->length;
+
+        // copy data
+        memcpy(sdo_config->data, sdo_conf->data, sdo_config->length);
+
+        sdo_config = (lcec_slave_sdoconf_t *)&sdo_config->data[sdo_config->length];
+        sdo_config->index = 0xffff;
+        break;
+
+      case lcecConfTypeIdnConfig:
+        // get config token
+        idn_conf = (LCEC_CONF_IDNCONF_T *)conf;
+        conf += sizeof(LCEC_CONF_IDNCONF_T) + idn_conf->length;
+
+        if (idn_config == NULL) {
+          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "idn_config is NULL\n");
+          return -1;
+        }
+
+        // copy attributes
+        idn_config->drive = idn_conf->drive;
+        idn_config->idn = idn_conf->idn;
+        idn_config->state = idn_conf->state;
+        idn_config->length = idn_conf->length;
+
+        // copy data
+        memcpy(idn_config->data, idn_conf->data, idn_config->length);
+
+        idn_config = (lcec_slave_idnconf_t *)&idn_config->data[idn_config->length];
+        break;
+
+      case lcecConfTypeModParam:
+        // get config token
+        modparam_conf = (LCEC_CONF_MODPARAM_T *)conf;
+        conf += sizeof(LCEC_CONF_MODPARAM_T);
+
+        // check for slave
+        if (slave == NULL) {
+          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Slave node for modparam config missing\n");
+          return -1;
+        }
+
+        if (modparams == NULL) {
+          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "modparams is nullg\n");
+          return -1;
+        }
+
+        // copy attributes
+        modparams->id = modparam_conf->id;
+        modparams->value = modparam_conf->value;
+        modparams->name = modparam_conf->name;
+
+        // next entry
+        modparams++;
+        break;
+
+      case lcecConfTypeSdoPin:
+        // get config token
+        sdo_pin_conf = (LCEC_CONF_SDOPIN_T *)conf;
+        conf += sizeof(LCEC_CONF_SDOPIN_T);
+
+        // check for sdo pins
+        if (generic_sdo_pins == NULL) {
+          rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "SDO pins for generic device missing\n");
+          return -1;
+        }
+
+        // initialize sdo pin
+        strncpy(generic_sdo_pins->name, sdo_pin_conf->halPin, LCEC_CONF_STR_MAXLEN);
+        generic_sdo_pins->name[LCEC_CONF_STR_MAXLEN - 1] = 0;
+        generic_sdo_pins->type = sdo_pin_conf->halType;
+        generic_sdo_pins->subType = sdo_pin_conf->subType;
+        generic_sdo_pins->floatScale = sdo_pin_conf->floatScale;
+        generic_sdo_pins->floatOffset = sdo_pin_conf->floatOffset;
+        generic_sdo_pins->bitLength = sdo_pin_conf->bitLength;
+        generic_sdo_pins->dir = sdo_pin_conf->dir;
+        generic_sdo_pins->sdo_idx = sdo_pin_conf->index;
+        generic_sdo_pins->sdo_sidx = sdo_pin_conf->subindex;
+        generic_sdo_pins->poll_period = sdo_pin_conf->pollPeriod * 1000000LL;
+
+        // next sdo pin
+        generic_sdo_pins++;
+        break;
+
+      default:
+        rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "Unknown config item type\n");
+        return -1;
+    }
+  }
+
+  // build slave lookup tables, for preinit and later
+  for (master = *first_master; master != NULL; master = master->next) {
+    lcec_mem_track(master, NULL);
+    lcec_index_slaves(master);
+  }
+  lcec_mem_track(NULL, NULL);
+
+  return slave_count;
+}
+
+/// @brief Run `proc_preinit` for all slaves.
+///
+/// FSoE logic devices run last, as they depend on the `fsoeConf`
+/// data set up by the other slaves.
+///
+/// @return 0 on success, <0 on error.
+int lcec_preinit_slaves(lcec_master_t *first_master) {
+  lcec_master_t *master;
+  lcec_slave_t *slave;
+  long long trace_start;
+
+  for (master = first_master; master != NULL; master = master->next) {
+    // stage 1 preinit: process all but FSOE logic devices
+    for (slave = master->first_slave; slave != NULL; slave = slave->next) {
+      if (!slave->is_fsoe_logic && slave->proc_preinit != NULL) {
+        trace_start = lcec_trace_start();
+        if (slave->proc_preinit(slave) < 0) {
+          return -1;
+        }
+        lcec_trace_add(master, slave, LCEC_TRACE_PREINIT, trace_start);
+      }
+    }
+
+    // stage 2 preinit: process only FSOE logic devices (this depends on initialized fsoeConf data)
+    for (slave = master->first_slave; slave != NULL; slave = slave->next) {
+      if (slave->is_fsoe_logic && slave->proc_preinit != NULL) {
+        trace_start = lcec_trace_start();
+        if (slave->proc_preinit(slave) < 0) {
+          return -1;
+        }
+        lcec_trace_add(master, slave, LCEC_TRACE_PREINIT, trace_start);
+      }
+    }
+  }
+
+  return 0;
+}
@@ -36,11 +36,16 @@ static int lcec_pin_newfv(hal_type_t type, hal_pin_dir_t dir, void **data_ptr_ad
     return -ENOMEM;
   }
 
-  err = hal_pin_new(name, type, dir, data_ptr_addr, lcec_comp_id);
+  if (lcec_dry_run != NULL) {
+    err = lcec_dry_run->pin_new(name, type, dir, data_ptr_addr);
+  } else {
+    err = hal_pin_new(name, type, dir, data_ptr_addr, lcec_comp_id);
+  }
   if (err) {
     rtapi_print_msg(RTAPI_MSG_ERR, LCEC_MSG_PFX "exporting pin %s failed\n", name);
     return err;
   }
+  lcec_mem_charge(0, 0, 1, 0);
 
   switch (type) {
     case HAL_BIT:
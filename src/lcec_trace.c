@@ -0,0 +1,118 @@
+//
+//    Copyright (C) 2024 LinuxCNC-Ethercat contributors
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program; if not, write to the Free Software
+//    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+//
+
+/// @file
+/// @brief Startup timeline trace for LinuxCNC-Ethercat
+///
+/// `rtapi_app_main()` records how long each startup stage takes, per
+/// master and per slave, and the realtime thread records when each
+/// slave first reaches OP.  Records go into a table in RTAPI shared
+/// memory created by `lcec_conf`, which prints a summary and writes
+/// the full timeline to a file once every master is operational.  If
+/// `lcec_conf` didn't create the table, nothing is recorded.
+
+#include "lcec.h"
+
+extern int lcec_comp_id;
+
+static int trace_shmem_id = -1;
+static lcec_trace_t *trace = NULL;
+
+/// @brief Attach to the startup trace table created by `lcec_conf`.
+///
+/// @return 0 if attached, <0 if startup tracing is disabled.
+int lcec_trace_attach(void) {
+  void *shmem_ptr;
+
+  trace_shmem_id = rtapi_shmem_new(LCEC_TRACE_SHMEM_KEY, lcec_comp_id, sizeof(lcec_trace_t));
+  if (trace_shmem_id < 0) {
+    goto fail0;
+  }
+  if (lcec_rtapi_shmem_getptr(trace_shmem_id, &shmem_ptr) < 0) {
+    goto fail1;
+  }
+  if (((lcec_trace_t *)shmem_ptr)->magic != LCEC_TRACE_SHMEM_MAGIC) {
+    goto fail1;
+  }
+
+  trace = (lcec_trace_t *)shmem_ptr;
+  return 0;
+
+fail1:
+  rtapi_shmem_delete(trace_shmem_id, lcec_comp_id);
+fail0:
+  trace_shmem_id = -1;
+  return -1;
+}
+
+/// @brief Release the startup trace table.
+void lcec_trace_detach(void) {
+  trace = NULL;
+  if (trace_shmem_id >= 0) {
+    rtapi_shmem_delete(trace_shmem_id, lcec_comp_id);
+    trace_shmem_id = -1;
+  }
+}
+
+/// @brief Get the start time of a stage for `lcec_trace_add()`.
+///
+/// Returns 0 without reading the clock when tracing is disabled.
+long long lcec_trace_start(void) {
+  if (trace == NULL) {
+    return 0;
+  }
+  return rtapi_get_time();
+}
+
+/// @brief Record a finished startup stage.
+///
+/// Masters may run in different threads, so records are claimed with
+/// an atomic increment and marked valid once they are filled in.
+///
+/// @param master The master, or NULL for global stages.
+/// @param slave The slave, or NULL for master or global stages.
+/// @param stage The stage that just finished.
+/// @param start The value of `lcec_trace_start()` when the stage started.
+void lcec_trace_add(lcec_master_t *master, lcec_slave_t *slave, lcec_trace_stage_t stage, long long start) {
+  lcec_trace_record_t *rec;
+  lcec_master_t *m;
+  uint32_t n;
+  int pos;
+
+  if (trace == NULL) {
+    return;
+  }
+
+  n = __atomic_fetch_add(&trace->count, 1, __ATOMIC_RELAXED);
+  if (n >= LCEC_TRACE_MAX_RECORDS) {
+    return;
+  }
+
+  // lcec_conf knows masters by their position in the config
+  for (pos = -1, m = master; m != NULL; m = m->prev) {
+    pos++;
+  }
+
+  rec = &trace->records[n];
+  rec->stage = stage;
+  rec->master = pos;
+  rec->slave = slave != NULL ? slave->index : -1;
+  rec->start = start;
+  rec->duration = rtapi_get_time() - start;
+  __atomic_store_n(&rec->valid, 1, __ATOMIC_RELEASE);
+}
@@ -0,0 +1,110 @@
+//
+//    Copyright (C) 2024 LinuxCNC-Ethercat contributors
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program; if not, write to the Free Software
+//    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+//
+
+/// @file
+/// @brief Dry run hooks shared by the tests
+
+#include "dry_run.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_PIN_COUNT 1024  // The most recent pins are remembered for `test_pin()`.
+
+static struct {
+  char *name;
+  void *data;
+} pins[TEST_PIN_COUNT];
+static unsigned int pin_count;
+
+static void *test_hal_malloc(size_t size) { return calloc(1, size); }
+
+// big enough for any HAL type
+static int test_pin_new(const char *name, hal_type_t type, hal_pin_dir_t dir, void **data_ptr_addr) {
+  unsigned int i = pin_count++ % TEST_PIN_COUNT;
+
+  *data_ptr_addr = calloc(1, sizeof(double));
+  if (*data_ptr_addr == NULL) {
+    return -1;
+  }
+  free(pins[i].name);
+  pins[i].name = strdup(name);
+  pins[i].data = *data_ptr_addr;
+  return 0;
+}
+
+/// @brief Find the storage of a pin created during a dry run.
+///
+/// If several pins had the name, the newest one is returned.
+///
+/// @return The pin's value, or NULL if there is no such pin.
+void *test_pin(const char *name) {
+  unsigned int i, n;
+
+  for (n = 0; n < pin_count && n < TEST_PIN_COUNT; n++) {
+    i = (pin_count - 1 - n) % TEST_PIN_COUNT;
+    if (pins[i].name != NULL && strcmp(pins[i].name, name) == 0) {
+      return pins[i].data;
+    }
+  }
+  return NULL;
+}
+
+static int test_param_new(const char *name, hal_type_t type, hal_param_dir_t dir, void *data_addr) { return 0; }
+
+static void test_limit_exceeded(lcec_slave_t *slave, const char *what) {}
+
+const lcec_dry_run_t test_dry_run = {
+    .hal_malloc = test_hal_malloc,
+    .pin_new = test_pin_new,
+    .param_new = test_param_new,
+    .limit_exceeded = test_limit_exceeded,
+};
+
+/// @brief Assign process data offsets to a slave's registered PDO entries.
+///
+/// Entries are laid out back to back in the order of `slave->sync_info`,
+/// as in a domain with only this slave.
+///
+/// @return The slave's process data size, in bytes.
+int test_map_pdos(lcec_slave_t *slave) {
+  const ec_sync_info_t *sync;
+  const ec_pdo_entry_info_t *entry;
+  ec_pdo_entry_reg_t *reg;
+  unsigned int p, e, bits = 0;
+  int r;
+
+  for (sync = slave->sync_info; sync->index != 0xff; sync++) {
+    for (p = 0; p < sync->n_pdos; p++) {
+      for (e = 0; e < sync->pdos[p].n_entries; e++) {
+        entry = &sync->pdos[p].entries[e];
+        for (r = 0; r < slave->regs->current; r++) {
+          reg = &slave->regs->pdo_entry_regs[r];
+          if (reg->index == entry->index && reg->subindex == entry->subindex) {
+            *reg->offset = bits / 8;
+            if (reg->bit_position != NULL) {
+              *reg->bit_position = bits % 8;
+            }
+          }
+        }
+        bits += entry->bit_length;
+      }
+    }
+  }
+  return (bits + 7) / 8;
+}
@@ -0,0 +1,38 @@
+//
+//    Copyright (C) 2024 LinuxCNC-Ethercat contributors
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program; if not, write to the Free Software
+//    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+//
+
+/// @file
+/// @brief Dry run hooks shared by the tests
+///
+/// Set `lcec_dry_run = &test_dry_run;` around calls that allocate HAL
+/// memory or create pins, and set it back to NULL afterwards.  HAL
+/// memory comes from the heap, and every pin gets its own zeroed
+/// storage, which `test_pin()` finds by name.  `test_map_pdos()`
+/// places a slave's PDO entries in the process data afterwards.
+
+#ifndef _LCEC_TESTS_DRY_RUN_H_
+#define _LCEC_TESTS_DRY_RUN_H_
+
+#include "../lcec.h"
+
+extern const lcec_dry_run_t test_dry_run;
+
+void *test_pin(const char *name);
+int test_map_pdos(lcec_slave_t *slave);
+
+#endif
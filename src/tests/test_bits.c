@@ -0,0 +1,84 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../src/lcec.h"
+#include "../devices/lcec_el6900.h"
+#include "tests.h"
+
+TESTGLOBALSETUP;
+
+static hal_bit_t bits[LCEC_EL6900_DIO_MAX_COUNT];
+static hal_bit_t *pins[LCEC_EL6900_DIO_MAX_COUNT];
+
+static void setup_pins(void) {
+  int i;
+
+  for (i = 0; i < LCEC_EL6900_DIO_MAX_COUNT; i++) {
+    pins[i] = &bits[i];
+  }
+}
+
+TESTFUNC(test_read_bits) {
+  TESTSETUP;
+  uint8_t pd[40] = {0};
+  int i, bad;
+
+  setup_pins();
+
+  // 0xa5 at byte 2 bit 3 onwards: 1 0 1 0 0 1 0 1 ...
+  for (i = 0; i < 32; i++) {
+    pd[2 + i] = 0xa5;
+  }
+  lcec_read_bits(pd, 1, 11, pins, 20);
+  for (i = 0, bad = 0; i < 20; i++) {
+    bad += bits[i] != (((0xa5a5a5a5 >> 3) >> i) & 1);
+  }
+  TESTINT(bad, 0);
+
+  // the full std io range, byte aligned
+  for (i = 0; i < 32; i++) {
+    pd[i] = i * 37;
+  }
+  lcec_read_bits(pd, 0, 0, pins, LCEC_EL6900_DIO_MAX_COUNT);
+  for (i = 0, bad = 0; i < LCEC_EL6900_DIO_MAX_COUNT; i++) {
+    bad += bits[i] != EC_READ_BIT(&pd[i >> 3], i & 7);
+  }
+  TESTINT(bad, 0);
+
+  // no pins, no reads
+  lcec_read_bits(NULL, 0, 0, NULL, 0);
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_write_bits) {
+  TESTSETUP;
+  uint8_t pd[40], want[40];
+  int i;
+
+  setup_pins();
+
+  for (i = 0; i < LCEC_EL6900_DIO_MAX_COUNT; i++) {
+    bits[i] = (i % 3) == 0;
+  }
+
+  // bits outside of the range must not change
+  memset(pd, 0x5a, sizeof(pd));
+  memset(want, 0x5a, sizeof(want));
+  lcec_write_bits(pd, 3, 5, pins, LCEC_EL6900_DIO_MAX_COUNT);
+  for (i = 0; i < LCEC_EL6900_DIO_MAX_COUNT; i++) {
+    EC_WRITE_BIT(&want[3 + ((5 + i) >> 3)], (5 + i) & 7, bits[i]);
+  }
+  TESTINT(memcmp(pd, want, sizeof(pd)), 0);
+
+  // a single bit in the middle of a byte
+  pd[0] = 0xff;
+  bits[0] = 0;
+  lcec_write_bits(pd, 0, 4, pins, 1);
+  TESTINT(pd[0], 0xef);
+
+  TESTRESULTS;
+}
+
+TESTMAIN
@@ -0,0 +1,585 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../../src/devices/lcec_class_cia402.h"
+#include "../../src/devices/lcec_class_cia402_opt.h"
+#include "../../src/lcec.h"
+#include "dry_run.h"
+#include "tests.h"
+
+TESTGLOBALSETUP;
+
+// A simulated CiA 402 drive, running cycle by cycle against
+// `lcec_cia402_write()` and `lcec_cia402_read()` on an in-memory
+// process image.  The drive only sees the process image, and reads
+// and writes each object with the size and sign that the CiA 402
+// class maps it with.
+
+#define SIM_SLOT_SIZE   8  // Bytes of process image per PDO entry.
+#define SIM_PD_SIZE     (LCEC_MAX_PDO_REG_COUNT * SIM_SLOT_SIZE)
+#define BENCH_CYCLES    1000000
+#define BENCH_AXES      32
+#define BENCH_OLD_LINES 19  // Cache lines per axis before the SDO pins moved to the cold struct.
+
+#define MODE_CSP 8
+#define MODE_CSV 9
+#define MODE_CST 10
+
+// Statusword state bits, masked with SW_STATE_MASK.
+#define SW_STATE_MASK             0x6f
+#define SW_SWITCH_ON_DISABLED     0x40
+#define SW_READY_TO_SWITCH_ON     0x21
+#define SW_SWITCHED_ON            0x23
+#define SW_OPERATION_ENABLED      0x27
+#define SW_QUICK_STOP_ACTIVE      0x07
+#define SW_FAULT_REACTION_ACTIVE  0x0f
+#define SW_FAULT                  0x08
+#define SW_REMOTE                 0x0200
+#define SW_TARGET_REACHED         0x0400
+#define SW_FOLLOWS_COMMAND        0x1000
+#define SW_FOLLOWING_ERROR        0x2000
+
+// Controlword commands.
+#define CW_SHUTDOWN          0x06
+#define CW_SWITCH_ON         0x07
+#define CW_ENABLE_OPERATION  0x0f
+#define CW_DISABLE_VOLTAGE   0x00
+#define CW_QUICK_STOP        0x02
+#define CW_FAULT_RESET       0x80
+
+/// @brief Drive dynamics.  Positions are in counts, time in cycles.
+typedef struct {
+  double max_velocity;              ///< Velocity limit, counts/cycle.
+  double max_accel;                 ///< Acceleration limit, counts/cycle^2.
+  double position_gain;             ///< CSP position loop gain, 1/cycle.
+  double torque_response;           ///< CST torque first-order response per cycle, 0..1.
+  double torque_accel;              ///< Acceleration per unit of torque, counts/cycle^2.
+  double friction;                  ///< Viscous friction in CST, fraction of velocity lost per cycle.
+  uint32_t following_error_window;  ///< CSP following error that faults the drive, 0 to disable.
+  int mode_switch_cycles;           ///< Cycles before 0x6061 follows 0x6060.
+} sim_params_t;
+
+/// @brief Drive state.
+typedef struct {
+  sim_params_t p;
+  int state;  ///< One of the SW_* state values.
+  uint16_t last_controlword;
+  int8_t opmode_requested;
+  int8_t opmode_display;
+  int mode_switch_left;
+  double position;
+  double velocity;
+  double torque;
+  double following_error;
+  int fault;  ///< Set to make the drive fault on the next cycle.
+} sim_drive_t;
+
+typedef struct {
+  lcec_master_t master;
+  lcec_slave_t slave;
+  lcec_class_cia402_channel_t *data;
+  sim_drive_t drive;
+  uint8_t pd[SIM_PD_SIZE];
+} sim_t;
+
+static const sim_params_t default_params = {
+    .max_velocity = 2000.0,
+    .max_accel = 50.0,
+    .position_gain = 0.5,
+    .torque_response = 0.2,
+    .torque_accel = 0.01,
+    .friction = 0.01,
+    .following_error_window = 5000,
+    .mode_switch_cycles = 3,
+};
+
+// SDO writes from `lcec_cia402_write()`.
+static uint8_t sdo_data[4];
+static int sdo_writes;
+
+uint8_t *ecrt_sdo_request_data(ec_sdo_request_t *req) { return sdo_data; }
+void ecrt_sdo_request_write(ec_sdo_request_t *req) { sdo_writes++; }
+
+static double clamp(double v, double limit) {
+  if (v > limit) return limit;
+  if (v < -limit) return -limit;
+  return v;
+}
+
+/// @brief Move the velocity towards `want`, within the acceleration limit.
+static void sim_accelerate(sim_drive_t *d, double want) {
+  want = clamp(want, d->p.max_velocity);
+  d->velocity += clamp(want - d->velocity, d->p.max_accel);
+}
+
+static void sim_controlword(sim_drive_t *d, uint16_t cw) {
+  uint16_t last = d->last_controlword;
+
+  d->last_controlword = cw;
+  if (d->state == SW_FAULT) {
+    if ((cw & CW_FAULT_RESET) && !(last & CW_FAULT_RESET)) {
+      d->state = SW_SWITCH_ON_DISABLED;
+    }
+    return;
+  }
+  if (d->state == SW_FAULT_REACTION_ACTIVE) {
+    return;
+  }
+
+  if ((cw & 0x02) == 0) {
+    // Disable voltage
+    d->state = SW_SWITCH_ON_DISABLED;
+  } else if ((cw & 0x06) == CW_QUICK_STOP) {
+    if (d->state == SW_OPERATION_ENABLED) {
+      d->state = SW_QUICK_STOP_ACTIVE;
+    } else if (d->state != SW_QUICK_STOP_ACTIVE) {
+      d->state = SW_SWITCH_ON_DISABLED;
+    }
+  } else if ((cw & 0x07) == CW_SHUTDOWN) {
+    if (d->state != SW_QUICK_STOP_ACTIVE) d->state = SW_READY_TO_SWITCH_ON;
+  } else if ((cw & 0x0f) == CW_SWITCH_ON) {
+    if (d->state == SW_READY_TO_SWITCH_ON || d->state == SW_OPERATION_ENABLED) d->state = SW_SWITCHED_ON;
+  } else if ((cw & 0x0f) == CW_ENABLE_OPERATION) {
+    if (d->state == SW_SWITCHED_ON || d->state == SW_QUICK_STOP_ACTIVE) d->state = SW_OPERATION_ENABLED;
+  }
+}
+
+static void sim_opmode(sim_drive_t *d, int8_t opmode) {
+  if (opmode != d->opmode_requested) {
+    d->opmode_requested = opmode;
+    d->mode_switch_left = d->p.mode_switch_cycles;
+  }
+  if (d->opmode_display != d->opmode_requested && d->mode_switch_left-- <= 0) {
+    d->opmode_display = d->opmode_requested;
+  }
+}
+
+/// @brief Run one drive cycle on the process image.
+static void sim_drive_step(sim_drive_t *d, uint8_t *pd, lcec_class_cia402_channel_t *data) {
+#define SIM_READ(name)         SUBSTJOIN3(EC_READ_, PDO_SIGN_##name, PDO_BITS_##name)(&pd[data->name##_os])
+#define SIM_WRITE(name, value) SUBSTJOIN3(EC_WRITE_, PDO_SIGN_##name, PDO_BITS_##name)(&pd[data->name##_os], value)
+  uint16_t sw;
+  int32_t target_position;
+  int reached = 0;
+
+  sim_controlword(d, EC_READ_U16(&pd[data->controlword_os]));
+  sim_opmode(d, SIM_READ(opmode));
+
+  if (d->fault) {
+    d->fault = 0;
+    d->state = SW_FAULT_REACTION_ACTIVE;
+  }
+
+  d->following_error = 0;
+  switch (d->state) {
+    case SW_OPERATION_ENABLED:
+      switch (d->opmode_display) {
+        case MODE_CSP:
+          target_position = SIM_READ(target_position);
+          sim_accelerate(d, (target_position - d->position) * d->p.position_gain);
+          d->position += d->velocity;
+          d->following_error = target_position - d->position;
+          reached = fabs(d->following_error) < 1.0;
+          if (d->p.following_error_window != 0 && fabs(d->following_error) > d->p.following_error_window) {
+            d->state = SW_FAULT_REACTION_ACTIVE;
+          }
+          break;
+        case MODE_CSV:
+          sim_accelerate(d, SIM_READ(target_velocity));
+          d->position += d->velocity;
+          reached = d->velocity == SIM_READ(target_velocity);
+          break;
+        case MODE_CST:
+          d->torque += (SIM_READ(target_torque) - d->torque) * d->p.torque_response;
+          d->velocity = clamp(d->velocity * (1.0 - d->p.friction) + d->torque * d->p.torque_accel, d->p.max_velocity);
+          d->position += d->velocity;
+          reached = fabs(d->torque - SIM_READ(target_torque)) < 1.0;
+          break;
+        default:
+          // Not a cyclic mode; hold still.
+          sim_accelerate(d, 0);
+          d->position += d->velocity;
+          break;
+      }
+      break;
+    case SW_QUICK_STOP_ACTIVE:
+    case SW_FAULT_REACTION_ACTIVE:
+      d->torque = 0;
+      sim_accelerate(d, 0);
+      d->position += d->velocity;
+      if (d->state == SW_FAULT_REACTION_ACTIVE && d->velocity == 0) {
+        d->state = SW_FAULT;
+      }
+      reached = d->velocity == 0;
+      break;
+    default:
+      // Power stage off, the brake holds the axis.
+      d->velocity = 0;
+      d->torque = 0;
+      break;
+  }
+
+  sw = d->state | SW_REMOTE;
+  if (reached) sw |= SW_TARGET_REACHED;
+  if (d->state == SW_OPERATION_ENABLED && d->opmode_display >= MODE_CSP && d->opmode_display <= MODE_CST) sw |= SW_FOLLOWS_COMMAND;
+  if (d->p.following_error_window != 0 && fabs(d->following_error) > d->p.following_error_window) sw |= SW_FOLLOWING_ERROR;
+
+  EC_WRITE_U16(&pd[data->statusword_os], sw);
+  SIM_WRITE(opmode_display, d->opmode_display);
+  SIM_WRITE(actual_position, lround(d->position));
+  SIM_WRITE(actual_velocity, lround(d->velocity));
+  SIM_WRITE(actual_torque, lround(d->torque));
+  SIM_WRITE(actual_following_error, (int32_t)lround(d->following_error));
+#undef SIM_READ
+#undef SIM_WRITE
+}
+
+/// @brief Set up a CiA 402 channel with CSP, CSV, and CST objects on an in-memory process image.
+static sim_t *sim_new(const sim_params_t *params) {
+  lcec_class_cia402_channel_options_t *opt;
+  lcec_pdo_entry_reg_t *regs;
+  sim_t *sim;
+  int i;
+
+  sim = calloc(1, sizeof(sim_t));
+  if (sim == NULL) return NULL;
+  strcpy(sim->master.name, "sim");
+  sim->master.process_data = sim->pd;
+  sim->slave.master = &sim->master;
+  strcpy(sim->slave.name, "drive");
+
+  lcec_dry_run = &test_dry_run;
+  sim->slave.regs = lcec_allocate_pdo_entry_reg(LCEC_MAX_PDO_REG_COUNT);
+  opt = lcec_cia402_channel_options();
+  opt->enable_csp = 1;
+  opt->enable_csv = 1;
+  opt->enable_cst = 1;
+  opt->enable_target_torque = 1;
+  opt->enable_actual_torque = 1;
+  opt->enable_actual_following_error = 1;
+  sim->data = lcec_cia402_register_channel(&sim->slave, 0x6000, opt);
+  lcec_dry_run = NULL;
+  if (sim->data == NULL) return NULL;
+
+  // Stand in for the domain registration: each entry gets its own slot.
+  regs = sim->slave.regs;
+  for (i = 0; i < lcec_pdo_entry_reg_len(regs); i++) {
+    *regs->pdo_entry_regs[i].offset = i * SIM_SLOT_SIZE;
+  }
+
+  sim->drive.p = *params;
+  sim->drive.state = SW_SWITCH_ON_DISABLED;
+  return sim;
+}
+
+static void sim_cycle(sim_t *sim) {
+  lcec_cia402_write(&sim->slave, sim->data);
+  sim_drive_step(&sim->drive, sim->pd, sim->data);
+  lcec_cia402_read(&sim->slave, sim->data);
+}
+
+static int sim_state(sim_t *sim) { return *(sim->data->statusword) & SW_STATE_MASK; }
+
+/// @brief Send a controlword for a few cycles and return the resulting state.
+static int sim_command(sim_t *sim, uint16_t cw) {
+  *(sim->data->controlword) = cw;
+  sim_cycle(sim);
+  sim_cycle(sim);
+  return sim_state(sim);
+}
+
+/// @brief Walk the drive up to operation enabled in `mode`, holding its current position.
+static int sim_enable(sim_t *sim, int mode) {
+  int i;
+
+  *(sim->data->opmode) = mode;
+  *(sim->data->target_position) = *(sim->data->actual_position);
+  *(sim->data->target_velocity) = 0;
+  *(sim->data->target_torque) = 0;
+  sim_command(sim, CW_SHUTDOWN);
+  sim_command(sim, CW_SWITCH_ON);
+  sim_command(sim, CW_ENABLE_OPERATION);
+  for (i = 0; i < 100 && *(sim->data->opmode_display) != mode; i++) {
+    sim_cycle(sim);
+  }
+  return sim_state(sim);
+}
+
+static double elapsed_ns(struct timespec *start) {
+  struct timespec end;
+
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  return (end.tv_sec - start->tv_sec) * 1e9 + (end.tv_nsec - start->tv_nsec);
+}
+
+TESTFUNC(test_cia402_sim_state_machine) {
+  TESTSETUP;
+  sim_t *sim = sim_new(&default_params);
+
+  TESTNOTNULL(sim);
+  sim_cycle(sim);
+  TESTINT(sim_state(sim), SW_SWITCH_ON_DISABLED);
+  TESTINT(*(sim->data->statusword) & SW_REMOTE, SW_REMOTE);
+
+  // Enable operation is only accepted from switched on.
+  TESTINT(sim_command(sim, CW_ENABLE_OPERATION), SW_SWITCH_ON_DISABLED);
+  TESTINT(sim_command(sim, CW_SHUTDOWN), SW_READY_TO_SWITCH_ON);
+  TESTINT(sim_command(sim, CW_SWITCH_ON), SW_SWITCHED_ON);
+  TESTINT(sim_command(sim, CW_ENABLE_OPERATION), SW_OPERATION_ENABLED);
+  TESTINT(sim_command(sim, CW_SWITCH_ON), SW_SWITCHED_ON);
+  TESTINT(sim_command(sim, CW_ENABLE_OPERATION), SW_OPERATION_ENABLED);
+
+  // Quick stop, then back to operation.
+  TESTINT(sim_command(sim, CW_QUICK_STOP), SW_QUICK_STOP_ACTIVE);
+  TESTINT(sim_command(sim, CW_ENABLE_OPERATION), SW_OPERATION_ENABLED);
+  TESTINT(sim_command(sim, CW_DISABLE_VOLTAGE), SW_SWITCH_ON_DISABLED);
+
+  // The mode display follows the requested mode after a delay.
+  *(sim->data->opmode) = MODE_CSV;
+  sim_cycle(sim);
+  TESTINT(*(sim->data->opmode_display), 0);
+  sim_command(sim, CW_DISABLE_VOLTAGE);
+  sim_command(sim, CW_DISABLE_VOLTAGE);
+  TESTINT(*(sim->data->opmode_display), MODE_CSV);
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_cia402_sim_csp) {
+  TESTSETUP;
+  sim_t *sim = sim_new(&default_params);
+  uint32_t max_error = 0;
+  int i;
+
+  TESTNOTNULL(sim);
+  TESTINT(sim_enable(sim, MODE_CSP), SW_OPERATION_ENABLED);
+  TESTINT(*(sim->data->opmode_display), MODE_CSP);
+
+  // A 100 counts/cycle ramp is tracked with a bounded following error.
+  for (i = 0; i < 1000; i++) {
+    *(sim->data->target_position) += 100;
+    sim_cycle(sim);
+    if (i > 100 && *(sim->data->actual_following_error) > max_error) max_error = *(sim->data->actual_following_error);
+  }
+  TESTINT(sim_state(sim), SW_OPERATION_ENABLED);
+  TESTINT(*(sim->data->actual_velocity), 100);
+  TESTINT(max_error <= 200, 1);
+
+  // Then it settles on the final position.
+  for (i = 0; i < 100; i++) {
+    sim_cycle(sim);
+  }
+  TESTINT(*(sim->data->actual_position), 100000);
+  TESTINT(*(sim->data->statusword) & SW_TARGET_REACHED, SW_TARGET_REACHED);
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_cia402_sim_csv_cst) {
+  TESTSETUP;
+  sim_t *sim = sim_new(&default_params);
+  int i, pos;
+
+  TESTNOTNULL(sim);
+  TESTINT(sim_enable(sim, MODE_CSV), SW_OPERATION_ENABLED);
+
+  // 1000 counts/cycle at 50 counts/cycle^2 takes 20 cycles.
+  *(sim->data->target_velocity) = 1000;
+  for (i = 0; i < 19; i++) {
+    sim_cycle(sim);
+  }
+  TESTINT(*(sim->data->statusword) & SW_TARGET_REACHED, 0);
+  sim_cycle(sim);
+  TESTINT(*(sim->data->actual_velocity), 1000);
+  TESTINT(*(sim->data->statusword) & SW_TARGET_REACHED, SW_TARGET_REACHED);
+
+  // Switch to CST without leaving operation enabled, coasting down against friction.
+  *(sim->data->opmode) = MODE_CST;
+  for (i = 0; i < 1000; i++) {
+    sim_cycle(sim);
+  }
+  TESTINT(*(sim->data->opmode_display), MODE_CST);
+  TESTINT(*(sim->data->actual_velocity), 0);
+
+  // A constant torque accelerates to where friction balances it: 500 * 0.01 / 0.01.
+  *(sim->data->target_torque) = 500;
+  pos = *(sim->data->actual_position);
+  for (i = 0; i < 2000; i++) {
+    sim_cycle(sim);
+  }
+  TESTINT(*(sim->data->actual_torque), 500);
+  TESTINT(*(sim->data->actual_velocity), 500);
+  TESTINT(*(sim->data->actual_position) > pos, 1);
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_cia402_sim_following_error) {
+  TESTSETUP;
+  sim_t *sim = sim_new(&default_params);
+  int i;
+
+  TESTNOTNULL(sim);
+  TESTINT(sim_enable(sim, MODE_CSP), SW_OPERATION_ENABLED);
+
+  // A step bigger than the window faults the drive, which then stops.
+  *(sim->data->target_position) += 10000;
+  sim_cycle(sim);
+  TESTINT(*(sim->data->statusword) & SW_FOLLOWING_ERROR, SW_FOLLOWING_ERROR);
+  for (i = 0; i < 100; i++) {
+    sim_cycle(sim);
+  }
+  TESTINT(sim_state(sim), SW_FAULT);
+  TESTINT(*(sim->data->actual_velocity), 0);
+
+  // Fault reset is edge triggered.
+  TESTINT(sim_command(sim, CW_ENABLE_OPERATION), SW_FAULT);
+  TESTINT(sim_command(sim, CW_FAULT_RESET), SW_SWITCH_ON_DISABLED);
+  TESTINT(sim_enable(sim, MODE_CSP), SW_OPERATION_ENABLED);
+
+  // Injected faults go through fault reaction as well.
+  sim->drive.fault = 1;
+  sim_cycle(sim);
+  TESTINT(sim_state(sim), SW_FAULT);
+
+  TESTRESULTS;
+}
+
+TESTFUNC(bench_cia402_sim) {
+  TESTSETUP;
+  sim_t *sim = sim_new(&default_params);
+  struct timespec start;
+  double per_cycle;
+  int i;
+
+  TESTNOTNULL(sim);
+  TESTINT(sim_enable(sim, MODE_CSP), SW_OPERATION_ENABLED);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (i = 0; i < BENCH_CYCLES; i++) {
+    *(sim->data->target_position) += (i & 1024) ? -10 : 10;
+    sim_cycle(sim);
+  }
+  per_cycle = elapsed_ns(&start) / BENCH_CYCLES;
+
+  fprintf(stderr, "%s: %d CSP cycles: %.0f ns/cycle, %.1f M cycles/s\n", __func__, BENCH_CYCLES, per_cycle, 1000.0 / per_cycle);
+  TESTINT(sim_state(sim), SW_OPERATION_ENABLED);
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_cia402_sim_hot_layout) {
+  TESTSETUP;
+  sim_t *sim = sim_new(&default_params);
+  lcec_pool_t pool = {.chunk_size = LCEC_HOT_CHUNK_SIZE};
+  uint8_t *a, *b;
+
+  TESTNOTNULL(sim);
+  TESTINT((int)((uintptr_t)sim->data % LCEC_POOL_ALIGN), 0);
+
+  // Axes registered one after another sit on consecutive cache lines
+  // of the hot pool.
+  TESTINT((int)lcec_hot_pool.chunk_size, LCEC_HOT_CHUNK_SIZE);
+  lcec_dry_run = &test_dry_run;
+  a = (uint8_t *)LCEC_POOL_ALLOCATE(&pool, lcec_class_cia402_channel_t);
+  b = (uint8_t *)LCEC_POOL_ALLOCATE(&pool, lcec_class_cia402_channel_t);
+  lcec_dry_run = NULL;
+  TESTINT((int)((uintptr_t)a % LCEC_POOL_ALIGN), 0);
+  TESTINT((int)(b - a), (int)(LCEC_HOT_LINES(lcec_class_cia402_channel_t) * LCEC_POOL_ALIGN));
+
+  // The mode pins live with the cold data, and still work.
+  TESTNOTNULL(sim->data->cold);
+  TESTINT(sim->data->cold->supported_modes != NULL, 1);
+  TESTINT(sim->data->cold->supports_mode_csp != NULL, 1);
+  TESTINT(sim->data->cold->base_idx, 0x6000);
+
+  // Without SDO pins, the cycle never looks at them.
+  TESTINT(sim->data->write_sdos, 0);
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_cia402_sim_sdo_pins) {
+  TESTSETUP;
+  lcec_class_cia402_channel_options_t *opt;
+  lcec_class_cia402_channel_t *data;
+  sim_t *sim = sim_new(&default_params);
+
+  TESTNOTNULL(sim);
+  lcec_dry_run = &test_dry_run;
+  opt = lcec_cia402_channel_options();
+  opt->enable_csp = 1;
+  opt->enable_profile_accel = 1;
+  data = lcec_cia402_register_channel(&sim->slave, 0x6800, opt);
+  lcec_dry_run = NULL;
+  TESTNOTNULL(data);
+
+  // SDO pins live with the cold data
+  TESTINT(data->write_sdos, 1);
+  TESTINT(data->cold->profile_accel == test_pin("lcec.sim.drive.srv-profile-accel"), 1);
+  TESTINT(data->cold->profile_decel == NULL, 1);
+
+  // and are written when they change
+  sdo_writes = 0;
+  lcec_cia402_write(&sim->slave, data);
+  TESTINT(sdo_writes, 0);
+  *(data->cold->profile_accel) = 5000;
+  lcec_cia402_write(&sim->slave, data);
+  TESTINT(sdo_writes, 1);
+  TESTINT((int)EC_READ_U32(sdo_data), 5000);
+  lcec_cia402_write(&sim->slave, data);
+  TESTINT(sdo_writes, 1);
+
+  TESTRESULTS;
+}
+
+// Run BENCH_AXES axes with their hot structs `lines` cache lines
+// apart, and return the time per axis and cycle.
+static double bench_axes(int lines) {
+  sim_t *sims[BENCH_AXES];
+  struct timespec start;
+  int i, j;
+
+  for (j = 0; j < BENCH_AXES; j++) {
+    sims[j] = sim_new(&default_params);
+    if (sims[j] == NULL || sim_enable(sims[j], MODE_CSP) != SW_OPERATION_ENABLED) {
+      return -1;
+    }
+    if (lines > (int)LCEC_HOT_LINES(lcec_class_cia402_channel_t)) {
+      lcec_dry_run = &test_dry_run;
+      LCEC_POOL_ALLOCATE_ARRAY(&lcec_hot_pool, uint8_t, (lines - LCEC_HOT_LINES(lcec_class_cia402_channel_t)) * LCEC_POOL_ALIGN);
+      lcec_dry_run = NULL;
+    }
+  }
+
+  // Like a servo thread: every cycle visits every axis once.
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (i = 0; i < BENCH_CYCLES / BENCH_AXES; i++) {
+    for (j = 0; j < BENCH_AXES; j++) {
+      *(sims[j]->data->target_position) += (i & 1024) ? -10 : 10;
+      sim_cycle(sims[j]);
+    }
+  }
+  return elapsed_ns(&start) / (BENCH_CYCLES / BENCH_AXES * BENCH_AXES);
+}
+
+TESTFUNC(bench_cia402_sim_axes) {
+  TESTSETUP;
+  double before, after;
+
+  // The same cycle, with the axes spread out as far as they were
+  // when the SDO pins sat between the PDO pins, and packed now.
+  before = bench_axes(BENCH_OLD_LINES);
+  after = bench_axes(LCEC_HOT_LINES(lcec_class_cia402_channel_t));
+  TESTINT(before > 0 && after > 0, 1);
+
+  fprintf(stderr, "%s: %d axes, %d cache lines each: %.0f ns/axis/cycle, %d lines before: %.0f ns/axis/cycle\n", __func__, BENCH_AXES,
+      (int)LCEC_HOT_LINES(lcec_class_cia402_channel_t), after, BENCH_OLD_LINES, before);
+
+  TESTRESULTS;
+}
+
+TESTMAIN
@@ -0,0 +1,124 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../src/devices/lcec_class_ain.h"
+#include "../../src/lcec.h"
+#include "dry_run.h"
+#include "tests.h"
+
+TESTGLOBALSETUP;
+
+static lcec_master_t master;
+static lcec_slave_t slave;
+static lcec_slave_modparam_t modparams[4];
+static uint8_t process_data[16];
+
+TESTFUNC(test_ain_curve_parse) {
+  TESTSETUP;
+  double x[4], y[4];
+
+  TESTINT(lcec_ain_curve_parse("0:1", x, y, 4), 1);
+  TESTINT(lcec_ain_curve_parse("18.5:-50, 100:0,175.8 : 200", x, y, 4), 3);
+  TEST_MESSAGE(double, x[0], 18.5, "x[0]: got %f, want %f\n");
+  TEST_MESSAGE(double, y[0], -50.0, "y[0]: got %f, want %f\n");
+  TEST_MESSAGE(double, x[2], 175.8, "x[2]: got %f, want %f\n");
+  TEST_MESSAGE(double, y[2], 200.0, "y[2]: got %f, want %f\n");
+  TESTINT(lcec_ain_curve_parse("1:2, 3:4", NULL, NULL, 4), 2);
+
+  // malformed, or too long
+  TESTINT(lcec_ain_curve_parse("", x, y, 4), -1);
+  TESTINT(lcec_ain_curve_parse("1", x, y, 4), -1);
+  TESTINT(lcec_ain_curve_parse("1:", x, y, 4), -1);
+  TESTINT(lcec_ain_curve_parse("1:2,", x, y, 4), -1);
+  TESTINT(lcec_ain_curve_parse("1:2;3:4", x, y, 4), -1);
+  TESTINT(lcec_ain_curve_parse("1:2,3:4,5:6", x, y, 2), -1);
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_ain_curve) {
+  TESTSETUP;
+  lcec_class_ain_options_t options = {.name_prefix = "temp", .is_temperature = 1, .max_value = 0x7fff};
+  lcec_class_ain_channel_t chan = {.options = &options};
+  hal_s32_t raw;
+  hal_float_t val, scale;
+  hal_bit_t error, underrange, overrange;
+
+  strcpy(master.name, "m");
+  strcpy(slave.name, "t");
+  slave.master = &master;
+  slave.modparams = modparams;
+  master.process_data = process_data;
+
+  // split over two modParams, as long tables would be
+  modparams[0].id = 24;
+  strcpy(modparams[0].value.str, "0:0, 100:10");
+  modparams[1].id = 25;
+  strcpy(modparams[1].value.str, "0:5, 1:6");
+  modparams[2].id = 24;
+  strcpy(modparams[2].value.str, "200:40");
+  modparams[3].id = -1;
+
+  chan.raw_val = &raw;
+  chan.val = &val;
+  chan.scale = &scale;
+  chan.error = &error;
+  chan.underrange = &underrange;
+  chan.overrange = &overrange;
+  chan.error_pdo_os = chan.udr_pdo_os = chan.ovr_pdo_os = 4;
+  chan.udr_pdo_bp = 1;
+  chan.ovr_pdo_bp = 2;
+  scale = 1.0;
+
+  lcec_dry_run = &test_dry_run;
+  TESTINT(lcec_ain_set_curve(&slave, &chan, 0, 24), 0);
+  lcec_dry_run = NULL;
+  TESTINT(chan.curve->count, 3);
+
+  // interpolation, walking up and down the segments
+  EC_WRITE_S16(process_data, 50);
+  lcec_ain_read(&slave, &chan);
+  TEST_MESSAGE(double, val, 5.0, "val: got %f, want %f\n");
+  TESTINT(*(chan.open), 0);
+  EC_WRITE_S16(process_data, 150);
+  lcec_ain_read(&slave, &chan);
+  TEST_MESSAGE(double, val, 25.0, "val: got %f, want %f\n");
+  TESTINT(chan.curve->segment, 1);
+  EC_WRITE_S16(process_data, 0);
+  lcec_ain_read(&slave, &chan);
+  TEST_MESSAGE(double, val, 0.0, "val: got %f, want %f\n");
+  TESTINT(chan.curve->segment, 0);
+
+  // unchanged input, unchanged output
+  val = -1;
+  lcec_ain_read(&slave, &chan);
+  TEST_MESSAGE(double, val, -1.0, "val: got %f, want %f\n");
+
+  // off the end of the curve holds the last value
+  val = 0;
+  EC_WRITE_S16(process_data, 201);
+  lcec_ain_read(&slave, &chan);
+  TESTINT(*(chan.open), 1);
+  TEST_MESSAGE(double, val, 0.0, "val while open: got %f, want %f\n");
+
+  // so does a device error
+  EC_WRITE_S16(process_data, 100);
+  EC_WRITE_BIT(&process_data[4], 0, 1);
+  lcec_ain_read(&slave, &chan);
+  TESTINT(*(chan.open), 1);
+  EC_WRITE_BIT(&process_data[4], 0, 0);
+  lcec_ain_read(&slave, &chan);
+  TESTINT(*(chan.open), 0);
+  TEST_MESSAGE(double, val, 10.0, "val: got %f, want %f\n");
+
+  // a curve has to increase
+  strcpy(modparams[2].value.str, "50:40");
+  lcec_dry_run = &test_dry_run;
+  TESTINT(lcec_ain_set_curve(&slave, &chan, 0, 24), -1);
+  lcec_dry_run = NULL;
+
+  TESTRESULTS;
+}
+
+TESTMAIN
@@ -0,0 +1,174 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../src/devices/lcec_class_aout.h"
+#include "../../src/lcec.h"
+#include "dry_run.h"
+#include "tests.h"
+
+TESTGLOBALSETUP;
+
+#define PERIOD 1000000  // 1 ms
+
+TESTFUNC(test_aout_ramp_off) {
+  TESTSETUP;
+  lcec_class_aout_ramp_t ramp = {0};
+
+  // without limits, the output is the target
+  TESTINT(lcec_aout_ramp(&ramp, 0x7fff, 0, 0, 0, 0x7fff, PERIOD), 0x7fff);
+  TESTINT(lcec_aout_ramp(&ramp, 0x7fff, 0, 0, 0, -0x7fff, PERIOD), -0x7fff);
+  TESTINT(lcec_aout_ramp(&ramp, 0x7fff, 0, 0, 0, 1234, PERIOD), 1234);
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_aout_ramp_rate) {
+  TESTSETUP;
+  lcec_class_aout_ramp_t ramp = {0};
+  int i, out = 0;
+
+  // full scale in 100 ms
+  for (i = 0; i < 50; i++) {
+    out = lcec_aout_ramp(&ramp, 0x7fff, 10.0, 0, 0, 0x7fff, PERIOD);
+  }
+  TESTINT(out > 0x7fff / 2 - 2 && out < 0x7fff / 2 + 2, 1);
+  for (i = 0; i < 50; i++) {
+    out = lcec_aout_ramp(&ramp, 0x7fff, 10.0, 0, 0, 0x7fff, PERIOD);
+  }
+  TESTINT(out, 0x7fff);
+
+  // and down
+  out = lcec_aout_ramp(&ramp, 0x7fff, 10.0, 0, 0, 0, PERIOD);
+  TESTINT(out > 0x7fff * 98 / 100 && out < 0x7fff, 1);
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_aout_ramp_accel) {
+  TESTSETUP;
+  lcec_class_aout_ramp_t ramp = {0};
+  int i, out, last = 0, max = 0, settled = -1;
+
+  // S-curve to 10000 counts: no overshoot, and it settles
+  for (i = 0; i < 2000; i++) {
+    out = lcec_aout_ramp(&ramp, 0x7fff, 1.0, 10.0, 0, 10000, PERIOD);
+    TESTINT(out >= last, 1);
+    if (out > max) max = out;
+    if (out == 10000 && settled < 0) settled = i;
+    last = out;
+  }
+  TESTINT(max, 10000);
+  TESTINT(settled > 0, 1);
+  TESTINT(ramp.vel, 0);
+
+  // reversing halfway brakes first, then settles at the new target
+  memset(&ramp, 0, sizeof(ramp));
+  for (i = 0; i < 300; i++) {
+    lcec_aout_ramp(&ramp, 0x7fff, 1.0, 10.0, 0, 10000, PERIOD);
+  }
+  TESTINT(ramp.vel > 0, 1);
+  for (i = 0; i < 3000; i++) {
+    out = lcec_aout_ramp(&ramp, 0x7fff, 1.0, 10.0, 0, -10000, PERIOD);
+    if (out < -10000) max = out;
+  }
+  TESTINT(out, -10000);
+  TESTINT(max, 10000);
+
+  // the first cycles move slowly
+  memset(&ramp, 0, sizeof(ramp));
+  TESTINT(lcec_aout_ramp(&ramp, 0x7fff, 1.0, 10.0, 0, 10000, PERIOD) < 2, 1);
+
+  // full-scale swings at an extreme acceleration still settle
+  memset(&ramp, 0, sizeof(ramp));
+  for (i = 0; i < 100; i++) {
+    out = lcec_aout_ramp(&ramp, 0x7fff, 0, 5e5, 0, i < 50 ? 0x7fff : -0x7fff, PERIOD);
+  }
+  TESTINT(out, -0x7fff);
+  TESTINT(ramp.vel, 0);
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_aout_ramp_tau) {
+  TESTSETUP;
+  lcec_class_aout_ramp_t ramp = {0};
+  int i, out = 0;
+
+  // one time constant gets ~63% of the way
+  for (i = 0; i < 100; i++) {
+    out = lcec_aout_ramp(&ramp, 0x7fff, 0, 0, 0.1, 10000, PERIOD);
+  }
+  TESTINT(out > 6250 && out < 6350, 1);
+  for (i = 0; i < 2000; i++) {
+    out = lcec_aout_ramp(&ramp, 0x7fff, 0, 0, 0.1, 10000, PERIOD);
+  }
+  TESTINT(out, 10000);
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_aout_write_ramp) {
+  TESTSETUP;
+  static uint8_t process_data[4];
+  lcec_master_t master = {0};
+  lcec_slave_t slave = {0};
+  lcec_class_aout_options_t *opt;
+  lcec_class_aout_channel_t *chan;
+  int i;
+
+  strcpy(master.name, "m");
+  strcpy(slave.name, "el4132");
+  master.process_data = process_data;
+  slave.master = &master;
+  slave.regs = lcec_allocate_pdo_entry_reg(4);
+
+  // too big for the ramp's fixed point
+  lcec_dry_run = &test_dry_run;
+  opt = lcec_aout_options();
+  opt->max_value = 0x8000;
+  TESTINT(lcec_aout_register_channel(&slave, 0, 0x3001, opt) == NULL, 1);
+  chan = lcec_aout_register_channel(&slave, 0, 0x3001, NULL);
+  lcec_dry_run = NULL;
+  TESTINT(chan != NULL, 1);
+  lcec_scale_update(&slave);
+
+  *(chan->enable) = 1;
+  *(chan->absmode) = 1;
+  *(chan->ramp_rate) = 1.0;
+  *(chan->value) = 0.5;
+  for (i = 0; i < 1000; i++) {
+    lcec_aout_write(&slave, chan, PERIOD);
+  }
+  TESTINT(*(chan->raw_val), 0x7fff / 2);
+  TESTINT(*(chan->pos), 1);
+
+  // reversing in absmode ramps down through 0 before neg is set
+  *(chan->value) = -0.5;
+  for (i = 0; i < 100; i++) {
+    lcec_aout_write(&slave, chan, PERIOD);
+  }
+  TESTINT(*(chan->raw_val) > 0, 1);
+  TESTINT(*(chan->pos), 1);
+  TESTINT(*(chan->neg), 0);
+  for (i = 0; i < 1000; i++) {
+    lcec_aout_write(&slave, chan, PERIOD);
+  }
+  TESTINT(*(chan->raw_val), 0x7fff / 2);
+  TESTINT(*(chan->pos), 0);
+  TESTINT(*(chan->neg), 1);
+
+  // without a ramp, pos and neg follow value, not the offset output
+  *(chan->ramp_rate) = 0.0;
+  *(chan->absmode) = 0;
+  *(chan->offset) = 0.25;
+  *(chan->value) = 0.0;
+  lcec_aout_write(&slave, chan, PERIOD);
+  TESTINT(*(chan->raw_val) > 0, 1);
+  TESTINT(*(chan->pos), 0);
+  TESTINT(*(chan->neg), 0);
+
+  TESTRESULTS;
+}
+
+TESTMAIN
@@ -0,0 +1,102 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../src/devices/lcec_class_enc.h"
+#include "../../src/lcec.h"
+#include "dry_run.h"
+#include "tests.h"
+
+TESTGLOBALSETUP;
+
+static lcec_master_t master;
+static lcec_slave_t slave;
+
+static void setup_slave(void) {
+  strcpy(master.name, "m");
+  strcpy(slave.name, "enc");
+  slave.master = &master;
+}
+
+TESTFUNC(test_class_enc_gray_decode) {
+  TESTSETUP;
+  uint32_t i;
+
+  TESTINT((int)class_enc_gray_decode(0, 32), 0);
+  TESTINT((int)class_enc_gray_decode(1, 32), 1);
+  TESTINT((int)class_enc_gray_decode(3, 32), 2);
+  TESTINT((int)class_enc_gray_decode(2, 32), 3);
+  TESTINT((int)class_enc_gray_decode(0x80000000, 32) == 0xffffffff, 1);
+
+  // round trip through binary-to-Gray
+  for (i = 0; i < 100000; i += 7) {
+    TESTINT((int)class_enc_gray_decode(i ^ (i >> 1), 32), (int)i);
+  }
+
+  // bits above the data length are ignored
+  TESTINT((int)class_enc_gray_decode(0xff000000 | (25 ^ (25 >> 1)), 13), 25);
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_class_enc_rollover) {
+  TESTSETUP;
+  lcec_class_enc_data_t enc;
+  uint32_t raw = (1 << 25) - 100;
+  int i;
+
+  setup_slave();
+  lcec_dry_run = &test_dry_run;
+  TESTINT(class_enc_init(&slave, &enc, 25, "enc-0-mt"), 0);
+  lcec_dry_run = NULL;
+
+  // the first reading is 100 counts below 0, the rest follow it
+  // forwards through the 25-bit rollover twice
+  for (i = 0; i <= 2 * (1 << 25); i += 1000) {
+    class_enc_update(&enc, 0, 1.0, (raw + i) & ((1 << 25) - 1), 0, 0);
+  }
+  TEST_MESSAGE(double, *(enc.pos), (double)(i - 1000), "pos: got %f, want %f\n");
+  TESTINT((int)*(enc.ext_hi), 0);
+  TESTINT((int)*(enc.ext_lo), i - 1000 - 100);
+
+  // and back past the start
+  for (i -= 1000; i >= -5000; i -= 1000) {
+    class_enc_update(&enc, 0, 1.0, (raw + i) & ((1 << 25) - 1), 0, 0);
+  }
+  TEST_MESSAGE(double, *(enc.pos), -5000.0, "pos: got %f, want %f\n");
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_class_enc_stats) {
+  TESTSETUP;
+  lcec_class_enc_stats_t stats;
+  int i;
+
+  setup_slave();
+  lcec_dry_run = &test_dry_run;
+  TESTINT(class_enc_stats_init(&slave, &stats, "enc-0"), 0);
+  lcec_dry_run = NULL;
+
+  // 1 ms cycle, every 10th frame bad
+  for (i = 0; i < 999; i++) {
+    class_enc_stats_update(&stats, i % 10 == 0, 1000000);
+  }
+  TESTINT((int)*(stats.frames), 999);
+  TESTINT((int)*(stats.errors), 100);
+  TEST_MESSAGE(double, *(stats.error_rate), 0.0, "rate before the first window: got %f, want %f\n");
+
+  class_enc_stats_update(&stats, 0, 1000000);
+  TEST_MESSAGE(double, *(stats.error_rate), 0.1, "rate: got %f, want %f\n");
+
+  *(stats.reset) = 1;
+  class_enc_stats_update(&stats, 1, 1000000);
+  *(stats.reset) = 0;
+  TESTINT((int)*(stats.frames), 1);
+  TESTINT((int)*(stats.errors), 1);
+  TEST_MESSAGE(double, *(stats.error_rate), 0.0, "rate after reset: got %f, want %f\n");
+
+  TESTRESULTS;
+}
+
+TESTMAIN
@@ -0,0 +1,243 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../src/lcec.h"
+#include "dry_run.h"
+#include "tests.h"
+
+TESTGLOBALSETUP;
+
+#define CYCLE 1000000
+
+// Register requests are answered by the test.
+static uint8_t reg_data[8];
+static uint16_t reg_address;
+static int reg_write;
+static int reg_writes;
+
+uint8_t *ecrt_reg_request_data(ec_reg_request_t *req) { return reg_data; }
+ec_request_state_t ecrt_reg_request_state(ec_reg_request_t *req) { return EC_REQUEST_SUCCESS; }
+
+void ecrt_reg_request_read(ec_reg_request_t *req, uint16_t address, size_t size) {
+  reg_address = address;
+  reg_write = 0;
+}
+
+void ecrt_reg_request_write(ec_reg_request_t *req, uint16_t address, size_t size) {
+  reg_address = address;
+  reg_write = 1;
+  reg_writes++;
+}
+
+static lcec_master_t master;
+static lcec_slave_t slave;
+static lcec_slave_dc_t dc;
+
+static void set_state(unsigned int al_state) {
+  slave.state.online = al_state != 0;
+  slave.state.al_state = al_state;
+  slave.state.operational = al_state == EC_AL_STATE_OP;
+}
+
+static lcec_dc_calib_t *setup(LCEC_CONF_DC_CALIBRATE_T mode, unsigned int al_state) {
+  memset(&master, 0, sizeof(master));
+  memset(&slave, 0, sizeof(slave));
+  memset(&dc, 0, sizeof(dc));
+  strcpy(master.name, "m");
+  strcpy(slave.name, "drive");
+  master.dc_calib_mode = mode;
+  master.dc_calib_samples = 3;
+  master.dc_calib_margin = 100000;
+  dc.assignActivate = 0x300;
+  dc.sync0Cycle = CYCLE;
+  slave.master = &master;
+  slave.dc_conf = &dc;
+  set_state(al_state);
+  reg_address = 0;
+  reg_writes = 0;
+
+  lcec_dry_run = &test_dry_run;
+  if (lcec_dc_calib_init(&slave) != 0) {
+    slave.dc_calib = NULL;
+  }
+  lcec_dry_run = NULL;
+  return slave.dc_calib;
+}
+
+// Run a cycle, answering the request in flight.
+static void run(uint64_t value) {
+  EC_WRITE_U64(reg_data, value);
+  lcec_dc_calib_run(&slave);
+}
+
+TESTFUNC(test_dc_calib_lead) {
+  TESTSETUP;
+  uint64_t t = 1000000000ULL;
+
+  // the next SYNC0 is ahead of the frame
+  TESTINT(lcec_dc_calib_lead(t + 500000, t, CYCLE), 500000);
+  TESTINT(lcec_dc_calib_lead(t + 2300000, t, CYCLE), 300000);
+  TESTINT(lcec_dc_calib_lead(t, t, CYCLE), 0);
+
+  // or a past SYNC0 is known, which makes the difference negative
+  TESTINT(lcec_dc_calib_lead(t - 300000, t, CYCLE), 700000);
+  TESTINT(lcec_dc_calib_lead(t - 2000000, t, CYCLE), 0);
+  TESTINT(lcec_dc_calib_lead(t - 1, t, CYCLE), CYCLE - 1);
+
+  // up to about 2 s either way, in 32 bits
+  TESTINT(lcec_dc_calib_lead(t + 2100000123ULL, t, CYCLE), 123);
+  TESTINT(lcec_dc_calib_lead(t, t + 2100000123ULL, CYCLE), CYCLE - 123);
+
+  // the 64 bit DC time wraps
+  TESTINT(lcec_dc_calib_lead(400000, 0xffffffffffff0000ULL, CYCLE), 400000 + 0x10000);
+  TESTINT(lcec_dc_calib_lead(0xffffffffffff0000ULL, 400000, CYCLE), CYCLE - (400000 + 0x10000) % CYCLE);
+
+  // 32 bit DC slaves return garbage in the upper half of 0x0910
+  TESTINT(lcec_dc_calib_lead(0x0000000000100000ULL, 0xdeadbeef000f0000ULL, CYCLE), 0x10000);
+  TESTINT(lcec_dc_calib_lead(0x0000000000001000ULL, 0x12345678ffffff00ULL, CYCLE), 0x1100);
+
+  // cycles that don't divide 2^32
+  TESTINT(lcec_dc_calib_lead(t + 1000, t, 333333), 1000);
+  TESTINT(lcec_dc_calib_lead(t - 1000, t, 333333), 332333);
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_dc_calib_apply) {
+  TESTSETUP;
+  lcec_dc_calib_t *calib = setup(lcecDcCalibrateApply, EC_AL_STATE_SAFEOP);
+  uint64_t sync0 = 10000000;
+
+  TESTINT(calib != NULL, 1);
+
+  // applying starts in SAFEOP
+  run(0);
+  TESTINT(reg_address, 0x0990);
+  run(sync0);
+  TESTINT(reg_address, 0x0910);
+
+  // leads of 600, 500, and 700 us
+  run(sync0 - 600000);
+  run(sync0 + 500000);
+  TESTINT(reg_write, 0);
+  run(sync0 + 2000000 - 700000);
+
+  // 400 us earlier leaves the 100 us margin, so stop SYNC0 ...
+  TESTINT(reg_address, 0x0980);
+  TESTINT(reg_write, 1);
+  TESTINT(EC_READ_U16(reg_data), 0);
+
+  // ... restart it on the shifted grid ...
+  run(0);
+  TESTINT(reg_address, 0x0990);
+  TESTINT(EC_READ_U64(reg_data) == sync0 + 2 * CYCLE - 400000 + 101 * CYCLE, 1);
+  run(0);
+  TESTINT(reg_address, 0x0980);
+  TESTINT(EC_READ_U16(reg_data), 0x300);
+  run(0);
+  TESTINT(reg_writes, 3);
+
+  // ... leaving the startup shift alone
+  TESTINT(dc.sync0Shift, 0);
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_dc_calib_reinit) {
+  TESTSETUP;
+  lcec_dc_calib_t *calib = setup(lcecDcCalibrateApply, EC_AL_STATE_SAFEOP);
+  uint64_t sync0 = 10000000;
+  int i;
+
+  TESTINT(calib != NULL, 1);
+  run(0);
+  run(sync0);
+  for (i = 0; i < 3; i++) {
+    run(sync0 - 500000);
+  }
+  for (i = 0; i < 3; i++) {
+    run(0);
+  }
+  TESTINT(reg_writes, 3);
+
+  // in OP, nothing happens
+  set_state(EC_AL_STATE_OP);
+  run(0);
+  TESTINT(reg_writes, 3);
+
+  // the master re-initializes the slave with the startup shift
+  set_state(EC_AL_STATE_PREOP);
+  run(0);
+  TESTINT(reg_writes, 3);
+
+  // so it's written again in SAFEOP, without new samples
+  set_state(EC_AL_STATE_SAFEOP);
+  run(0);
+  TESTINT(reg_address, 0x0990);
+  TESTINT(reg_write, 0);
+  run(sync0 + 7 * CYCLE);
+  TESTINT(reg_address, 0x0980);
+  TESTINT(reg_write, 1);
+  run(0);
+  TESTINT(EC_READ_U64(reg_data) == sync0 + 7 * CYCLE - 400000 + 101 * CYCLE, 1);
+  run(0);
+  run(0);
+  TESTINT(reg_writes, 6);
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_dc_calib_too_late) {
+  TESTSETUP;
+  lcec_dc_calib_t *calib = setup(lcecDcCalibrateApply, EC_AL_STATE_OP);
+  uint64_t sync0 = 10000000;
+  int i;
+
+  TESTINT(calib != NULL, 1);
+
+  // samples are still taken in OP, but the shift isn't written
+  run(0);
+  run(sync0);
+  for (i = 0; i < 3; i++) {
+    run(sync0 - 500000);
+  }
+  run(0);
+  TESTINT(reg_writes, 0);
+
+  // and isn't written after a re-init either
+  set_state(EC_AL_STATE_INIT);
+  run(0);
+  set_state(EC_AL_STATE_SAFEOP);
+  run(0);
+  run(0);
+  TESTINT(reg_writes, 0);
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_dc_calib_report) {
+  TESTSETUP;
+  lcec_dc_calib_t *calib = setup(lcecDcCalibrateReport, EC_AL_STATE_SAFEOP);
+  uint64_t sync0 = 10000000;
+  int i;
+
+  TESTINT(calib != NULL, 1);
+
+  // reports wait for OP
+  run(0);
+  TESTINT(reg_address, 0);
+  set_state(EC_AL_STATE_OP);
+  run(0);
+  TESTINT(reg_address, 0x0990);
+  run(sync0);
+  for (i = 0; i < 3; i++) {
+    run(sync0 - 500000);
+  }
+  run(0);
+  TESTINT(reg_writes, 0);
+
+  TESTRESULTS;
+}
+
+TESTMAIN
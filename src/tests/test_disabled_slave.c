@@ -0,0 +1,155 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "../../src/lcec.h"
+#include "../../src/lcec_conf.h"
+#include "../../src/lcec_conf_priv.h"
+#include "../devices/lcec_class_din.h"
+#include "dry_run.h"
+#include "tests.h"
+
+TESTGLOBALSETUP;
+
+static int test_din_init(int comp_id, lcec_slave_t *slave);
+
+// tests run from constructors, possibly before the drivers register
+// their types, so use a type of our own
+static lcec_typelist_t types[] = {
+    {"TESTDIN", 0, 0, 0, NULL, test_din_init, NULL, 2},
+    {NULL},
+};
+
+static char conf[4096];
+static size_t conf_len;
+static int pin_count;
+
+static int test_din_init(int comp_id, lcec_slave_t *slave) {
+  lcec_class_din_channels_t *hal_data;
+  unsigned int i;
+
+  hal_data = lcec_din_allocate_channels(slave->flags);
+  if (hal_data == NULL) {
+    return -1;
+  }
+  slave->hal_data = hal_data;
+
+  for (i = 0; i < slave->flags; i++) {
+    hal_data->channels[i] = lcec_din_register_channel(slave, i, 0x6000 + (i << 4), 0x01);
+    if (hal_data->channels[i] == NULL) {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+static void add_token(const void *token, size_t len) {
+  memcpy(&conf[conf_len], token, len);
+  conf_len += len;
+}
+
+// a master with two 2-channel inputs, the second one maybe disabled
+static void build_conf(int disabled) {
+  static int registered;
+  LCEC_CONF_MASTER_T master = {.confType = lcecConfTypeMaster};
+  LCEC_CONF_SLAVE_T slave = {.confType = lcecConfTypeSlave, .templateOffset = -1};
+  LCEC_CONF_NULL_T end = {.confType = lcecConfTypeNone};
+
+  if (!registered) {
+    lcec_addtypes(types, __FILE__);
+    registered = 1;
+  }
+
+  conf_len = 0;
+  strcpy(master.name, "0");
+  add_token(&master, sizeof(master));
+
+  strcpy(slave.type_name, "TESTDIN");
+  strcpy(slave.name, "din0");
+  add_token(&slave, sizeof(slave));
+
+  slave.index = 1;
+  slave.disabled = disabled;
+  strcpy(slave.name, "din1");
+  add_token(&slave, sizeof(slave));
+
+  add_token(&end, sizeof(end));
+}
+
+static int count_pin_new(const char *name, hal_type_t type, hal_pin_dir_t dir, void **data_ptr_addr) {
+  pin_count++;
+  return test_dry_run.pin_new(name, type, dir, data_ptr_addr);
+}
+
+// Run --check's setup for the config, returning its PDO entry count.
+static int check_conf(int disabled, lcec_master_t **master) {
+  lcec_master_t *first = NULL, *last = NULL;
+  lcec_dry_run_t hooks = test_dry_run;
+  unsigned int bits;
+  int entries, unknown;
+
+  hooks.pin_new = count_pin_new;
+  lcec_dry_run = &hooks;
+  pin_count = 0;
+
+  build_conf(disabled);
+  entries = -1;
+  if (lcec_parse_conf_tokens(conf, &first, &last) == 2 && lcec_preinit_slaves(first) == 0) {
+    entries = checkMaster(first, &bits, &unknown);
+  }
+  lcec_dry_run = NULL;
+
+  *master = first;
+  return entries;
+}
+
+TESTFUNC(test_disabled_parse) {
+  TESTSETUP;
+
+  TESTINT(parseBool("true"), 1);
+  TESTINT(parseBool("TRUE"), 1);
+  TESTINT(parseBool("false"), 0);
+  TESTINT(parseBool("False"), 0);
+  TESTINT(parseBool("yes"), -1);
+  TESTINT(parseBool("0"), -1);
+  TESTINT(parseBool(""), -1);
+  TESTINT(parseBool("falsey"), -1);
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_disabled_tokens) {
+  TESTSETUP;
+  lcec_master_t *first = NULL, *last = NULL;
+
+  lcec_dry_run = &test_dry_run;
+  build_conf(1);
+  TESTINT(lcec_parse_conf_tokens(conf, &first, &last), 2);
+  lcec_dry_run = NULL;
+
+  TESTINT(first != NULL && first->first_slave != NULL && first->first_slave->next != NULL, 1);
+  TESTINT(first->first_slave->disabled, 0);
+  TESTINT(first->first_slave->next->disabled, 1);
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_disabled_check) {
+  TESTSETUP;
+  lcec_master_t *master;
+  int entries, disabled_entries, pins;
+
+  entries = check_conf(0, &master);
+  pins = pin_count;
+  TESTINT(entries, 4);
+  TESTINT(pins > 0, 1);
+
+  // the disabled slave's PDOs are left out, but its pins are still there
+  disabled_entries = check_conf(1, &master);
+  TESTINT(disabled_entries, 2);
+  TESTINT(pin_count, pins);
+  TESTINT(master->first_slave->next->hal_data != NULL, 1);
+
+  TESTRESULTS;
+}
+
+TESTMAIN
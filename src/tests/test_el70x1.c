@@ -0,0 +1,196 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../src/devices/lcec_el70x1.h"
+#include "../../src/lcec.h"
+#include "dry_run.h"
+#include "tests.h"
+
+TESTGLOBALSETUP;
+
+#define PERIOD 1000000
+
+// Where an EL7031 with the positioning interface has its process
+// data: ENC, STM, and POS control, then ENC, STM, and POS status.
+#define STM_CTL_OS  6
+#define POS_CTL_OS  8
+#define POS_TARGET  10
+#define POS_VELO    14
+#define POS_START   16
+#define POS_ACCEL   18
+#define POS_DECEL   20
+#define STM_STAT_OS 32
+#define POS_STAT_OS 34
+#define POS_ACTUAL  36
+#define POS_ACT_VEL 40
+#define POS_TIME    42
+#define PD_SIZE     46
+
+static lcec_master_t master;
+static lcec_slave_t slave;
+static lcec_slave_modparam_t modparams[2];
+static uint8_t pd[64];
+static int position_mode;
+
+static int record_sdo_write(lcec_slave_t *slave, uint16_t index, uint8_t subindex, const uint8_t *value, size_t size, const char *mpname) {
+  if (index == 0x8012 && subindex == 0x01) {
+    position_mode = value[0];
+  }
+  return 0;
+}
+
+// Set up an EL7031 and place its process data, returning its size.
+static int setup(const char *name, int positioning) {
+  lcec_dry_run_t hooks = test_dry_run;
+  int err;
+
+  memset(&master, 0, sizeof(master));
+  memset(&slave, 0, sizeof(slave));
+  memset(pd, 0, sizeof(pd));
+  strcpy(master.name, "m");
+  strcpy(slave.name, name);
+  master.process_data = pd;
+  slave.master = &master;
+  slave.regs = lcec_allocate_pdo_entry_reg(LCEC_MAX_PDO_REG_COUNT);
+  slave.modparams = modparams;
+  modparams[0].id = LCEC_EL70x1_PARAM_POSITIONING;
+  modparams[0].name = "positioningInterface";
+  modparams[0].value.bit = positioning;
+  modparams[1].id = -1;
+  position_mode = -1;
+
+  hooks.sdo_write = record_sdo_write;
+  lcec_dry_run = &hooks;
+  err = lcec_el7031_init(0, &slave);
+  lcec_dry_run = NULL;
+  return err != 0 ? -1 : test_map_pdos(&slave);
+}
+
+static void *pin(const char *name) {
+  char full[128];
+
+  snprintf(full, sizeof(full), "%s.m.%s.%s", LCEC_MODULE_NAME, slave.name, name);
+  return test_pin(full);
+}
+
+static int has_pdo(uint16_t index) {
+  const ec_sync_info_t *s;
+  unsigned int i;
+
+  for (s = slave.sync_info; s->index != 0xff; s++) {
+    for (i = 0; i < s->n_pdos; i++) {
+      if (s->pdos[i].index == index) {
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+TESTFUNC(test_el70x1_position) {
+  TESTSETUP;
+
+  // the STM position output, without any pos-* pins
+  TESTINT(setup("stm", 0), 24);
+  TESTINT(position_mode, 3);
+  TESTINT(has_pdo(0x1603), 1);
+  TESTINT(has_pdo(0x1607), 0);
+  TESTINT(has_pdo(0x1a07), 0);
+  TESTINT(pin("srv-pos-cmd") != NULL, 1);
+  TESTINT(pin("pos-target") == NULL, 1);
+
+  *(hal_float_t *)pin("srv-pos-cmd") = -1234.6;
+  slave.proc_write(&slave, PERIOD);
+  TESTINT(EC_READ_S32(&pd[8]), -1234);
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_el70x1_positioning_write) {
+  TESTSETUP;
+
+  TESTINT(setup("pos", 1), PD_SIZE);
+  TESTINT(position_mode, 0);
+  TESTINT(has_pdo(0x1603), 0);
+  TESTINT(has_pdo(0x1607), 1);
+  TESTINT(has_pdo(0x1a07), 1);
+  TESTINT(pin("srv-pos-cmd") == NULL, 1);
+
+  // absolute moves by default
+  slave.proc_write(&slave, PERIOD);
+  TESTINT(EC_READ_U16(&pd[POS_START]), 1);
+  TESTINT(EC_READ_U8(&pd[POS_CTL_OS]), 0);
+
+  *(hal_float_t *)pin("pos-target") = 100000.9;
+  *(hal_s32_t *)pin("pos-velocity") = -2000;
+  *(hal_u32_t *)pin("pos-accel") = 1000;
+  *(hal_u32_t *)pin("pos-decel") = 1500;
+  *(hal_u32_t *)pin("pos-start-type") = 2;
+  *(hal_bit_t *)pin("pos-execute") = 1;
+  *(hal_bit_t *)pin("srv-enable") = 1;
+  slave.proc_write(&slave, PERIOD);
+  TESTINT(*(hal_s32_t *)pin("pos-target-raw"), 100000);
+  TESTINT(EC_READ_S32(&pd[POS_TARGET]), 100000);
+  TESTINT(EC_READ_S16(&pd[POS_VELO]), -2000);
+  TESTINT(EC_READ_U16(&pd[POS_ACCEL]), 1000);
+  TESTINT(EC_READ_U16(&pd[POS_DECEL]), 1500);
+  TESTINT(EC_READ_U16(&pd[POS_START]), 2);
+  TESTINT(EC_READ_U8(&pd[POS_CTL_OS]), 0x01);
+  TESTINT(EC_READ_U8(&pd[STM_CTL_OS]), 0x01);
+
+  // out of range values are clamped to the PDO's size
+  *(hal_s32_t *)pin("pos-velocity") = 40000;
+  *(hal_u32_t *)pin("pos-accel") = 70000;
+  *(hal_bit_t *)pin("pos-execute") = 0;
+  *(hal_bit_t *)pin("pos-emergency-stop") = 1;
+  slave.proc_write(&slave, PERIOD);
+  TESTINT(EC_READ_S16(&pd[POS_VELO]), 0x7fff);
+  TESTINT(EC_READ_U16(&pd[POS_ACCEL]), 0xffff);
+  TESTINT(EC_READ_U8(&pd[POS_CTL_OS]), 0x02);
+  *(hal_s32_t *)pin("pos-velocity") = -40000;
+  slave.proc_write(&slave, PERIOD);
+  TESTINT(EC_READ_S16(&pd[POS_VELO]), -0x7fff);
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_el70x1_positioning_read) {
+  TESTSETUP;
+
+  TESTINT(setup("pos", 1), PD_SIZE);
+
+  // busy, calibrated, and accelerating
+  EC_WRITE_U8(&pd[POS_STAT_OS], 0x31);
+  EC_WRITE_S32(&pd[POS_ACTUAL], -123456);
+  EC_WRITE_S16(&pd[POS_ACT_VEL], -300);
+  EC_WRITE_U32(&pd[POS_TIME], 987654);
+  EC_WRITE_U8(&pd[STM_STAT_OS], 0x03);
+  slave.proc_read(&slave, PERIOD);
+  TESTINT(*(hal_bit_t *)pin("pos-busy"), 1);
+  TESTINT(*(hal_bit_t *)pin("pos-in-target"), 0);
+  TESTINT(*(hal_bit_t *)pin("pos-warning"), 0);
+  TESTINT(*(hal_bit_t *)pin("pos-error"), 0);
+  TESTINT(*(hal_bit_t *)pin("pos-calibrated"), 1);
+  TESTINT(*(hal_bit_t *)pin("pos-accelerating"), 1);
+  TESTINT(*(hal_bit_t *)pin("pos-decelerating"), 0);
+  TESTINT(*(hal_s32_t *)pin("pos-actual-raw"), -123456);
+  TESTINT((int)*(hal_float_t *)pin("pos-actual"), -123456);
+  TESTINT(*(hal_s32_t *)pin("pos-actual-velocity"), -300);
+  TESTINT(*(hal_u32_t *)pin("pos-drive-time"), 987654);
+  TESTINT(*(hal_bit_t *)pin("srv-ready-to-enable"), 1);
+  TESTINT(*(hal_bit_t *)pin("srv-ready"), 1);
+
+  // in target, with a warning and an error
+  EC_WRITE_U8(&pd[POS_STAT_OS], 0x0e);
+  slave.proc_read(&slave, PERIOD);
+  TESTINT(*(hal_bit_t *)pin("pos-busy"), 0);
+  TESTINT(*(hal_bit_t *)pin("pos-in-target"), 1);
+  TESTINT(*(hal_bit_t *)pin("pos-warning"), 1);
+  TESTINT(*(hal_bit_t *)pin("pos-error"), 1);
+  TESTINT(*(hal_bit_t *)pin("pos-calibrated"), 0);
+
+  TESTRESULTS;
+}
+
+TESTMAIN
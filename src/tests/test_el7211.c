@@ -0,0 +1,277 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../src/devices/lcec_el7211.h"
+#include "../../src/lcec.h"
+#include "dry_run.h"
+#include "tests.h"
+
+TESTGLOBALSETUP;
+
+#define PERIOD 1000000
+
+static lcec_master_t master;
+static lcec_slave_t slave;
+static lcec_slave_modparam_t modparams[4];
+static uint8_t pd[64];
+static uint64_t sdo_buf[8];  // an <sdoConfig>, aligned for lcec_slave_sdoconf_t
+
+// SDOs written by the driver
+static struct {
+  uint16_t index;
+  uint8_t subindex;
+  uint8_t value;
+} sdos[8];
+static int sdo_count;
+
+static int record_sdo_write(lcec_slave_t *slave, uint16_t index, uint8_t subindex, const uint8_t *value, size_t size, const char *mpname) {
+  if (sdo_count < 8) {
+    sdos[sdo_count].index = index;
+    sdos[sdo_count].subindex = subindex;
+    sdos[sdo_count].value = value[0];
+    sdo_count++;
+  }
+  return 0;
+}
+
+static void setup(void) {
+  memset(&master, 0, sizeof(master));
+  memset(&slave, 0, sizeof(slave));
+  memset(modparams, 0, sizeof(modparams));
+  memset(pd, 0, sizeof(pd));
+  memset(sdo_buf, 0, sizeof(sdo_buf));
+  strcpy(master.name, "m");
+  strcpy(slave.name, "x");
+  master.process_data = pd;
+  slave.master = &master;
+  slave.modparams = modparams;
+  modparams[0].id = -1;
+  sdo_count = 0;
+}
+
+static void add_modparam(int id, const char *name, const char *str, int bit) {
+  lcec_slave_modparam_t *p = modparams;
+
+  while (p->id >= 0) {
+    p++;
+  }
+  p->id = id;
+  p->name = name;
+  if (str != NULL) {
+    snprintf(p->value.str, sizeof(p->value.str), "%s", str);
+  } else {
+    p->value.bit = bit;
+  }
+  p[1].id = -1;
+}
+
+// <sdoConfig idx="7010" subIdx="03"><sdoDataRaw data="mode"/></sdoConfig>
+static void set_mode(uint8_t mode) {
+  lcec_slave_sdoconf_t *sdo = (lcec_slave_sdoconf_t *)sdo_buf;
+
+  sdo->index = 0x7010;
+  sdo->subindex = 0x03;
+  sdo->length = 1;
+  sdo->data[0] = mode;
+  sdo = (lcec_slave_sdoconf_t *)&sdo->data[sdo->length];
+  sdo->index = 0xffff;
+  slave.sdo_config = (lcec_slave_sdoconf_t *)sdo_buf;
+}
+
+// Offsets the domain would assign.
+static unsigned int pdo_offset(uint16_t index, uint8_t subindex) {
+  switch (index << 8 | subindex) {
+    case 0x601001:
+      return 4;  // status word
+    case 0x601007:
+      return 8;  // actual velocity
+    case 0x601012:
+      return 12;  // info data 1
+    case 0x601013:
+      return 14;  // info data 2
+    case 0x701001:
+      return 16;  // control word
+    case 0x701006:
+      return 20;  // velocity command
+    case 0x70100c:
+      return 24;  // torque offset
+  }
+  return 0;  // actual position
+}
+
+static int init(void) {
+  lcec_dry_run_t hooks = test_dry_run;
+  int err, i;
+
+  slave.regs = lcec_allocate_pdo_entry_reg(LCEC_MAX_PDO_REG_COUNT);
+  hooks.sdo_write = record_sdo_write;
+  lcec_dry_run = &hooks;
+  err = lcec_el7211_init(0, &slave);
+  lcec_dry_run = NULL;
+
+  for (i = 0; err == 0 && i < slave.regs->current; i++) {
+    *slave.regs->pdo_entry_regs[i].offset = pdo_offset(slave.regs->pdo_entry_regs[i].index, slave.regs->pdo_entry_regs[i].subindex);
+  }
+  return err;
+}
+
+static const ec_pdo_info_t *find_pdo(uint16_t index, int *sync) {
+  const ec_sync_info_t *s;
+  unsigned int i;
+
+  for (s = slave.sync_info; s->index != 0xff; s++) {
+    for (i = 0; i < s->n_pdos; i++) {
+      if (s->pdos[i].index == index) {
+        *sync = s->index;
+        return &s->pdos[i];
+      }
+    }
+  }
+  return NULL;
+}
+
+static void *pin(const char *name) {
+  char full[128];
+
+  snprintf(full, sizeof(full), "%s.m.x.%s", LCEC_MODULE_NAME, name);
+  return test_pin(full);
+}
+
+TESTFUNC(test_el7211_default) {
+  TESTSETUP;
+  int sync;
+
+  setup();
+  TESTINT(init(), 0);
+
+  // velocity mode only
+  TESTINT(slave.regs->current, 5);
+  TESTINT(find_pdo(0x1601, &sync) != NULL && sync == 2, 1);
+  TESTINT(find_pdo(0x1605, &sync) == NULL, 1);
+  TESTINT(find_pdo(0x1A04, &sync) == NULL, 1);
+  TESTINT(find_pdo(0x1A05, &sync) == NULL, 1);
+  TESTINT(sdo_count, 0);
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_el7211_info_data) {
+  TESTSETUP;
+  const ec_pdo_info_t *pdo;
+  int sync;
+
+  setup();
+  add_modparam(LCEC_EL7211_PARAM_INFO_DATA_1, "infoData1", "dcLinkVoltage", 0);
+  add_modparam(LCEC_EL7211_PARAM_INFO_DATA_2, "infoData2", "7", 0);
+  TESTINT(init(), 0);
+
+  // selected with 0x8010:39 and 0x8010:3a
+  TESTINT(sdo_count, 2);
+  TESTINT(sdos[0].index, 0x8010);
+  TESTINT(sdos[0].subindex, 0x39);
+  TESTINT(sdos[0].value, 1);
+  TESTINT(sdos[1].subindex, 0x3a);
+  TESTINT(sdos[1].value, 7);
+
+  // and mapped to 0x6010:12 and 0x6010:13
+  TESTINT(slave.regs->current, 7);
+  pdo = find_pdo(0x1A04, &sync);
+  TESTINT(pdo != NULL && sync == 3 && pdo->n_entries == 1, 1);
+  TESTINT(pdo->entries[0].index, 0x6010);
+  TESTINT(pdo->entries[0].subindex, 0x12);
+  pdo = find_pdo(0x1A05, &sync);
+  TESTINT(pdo != NULL && sync == 3 && pdo->entries[0].subindex == 0x13, 1);
+
+  // values are scaled by their selector, raw ones aren't
+  slave.state.operational = 1;
+  EC_WRITE_U16(&pd[12], 48000);
+  EC_WRITE_U16(&pd[14], 0xfffe);
+  slave.proc_read(&slave, PERIOD);
+  TESTINT(*(hal_s32_t *)pin("info-data-1-raw"), 48000);
+  TESTINT((int)(*(hal_float_t *)pin("info-data-1") * 1000 + 0.5), 48000);
+  TESTINT(*(hal_s32_t *)pin("info-data-2-raw"), 0xfffe);
+  TESTINT((int)*(hal_float_t *)pin("info-data-2"), 0xfffe);
+
+  // unknown names are errors
+  setup();
+  add_modparam(LCEC_EL7211_PARAM_INFO_DATA_1, "infoData1", "speed", 0);
+  TESTINT(init(), -1);
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_el7211_torque_ff) {
+  TESTSETUP;
+  const ec_pdo_info_t *pdo;
+  hal_float_t *torque_ff;
+  hal_s32_t *torque_ff_raw;
+  int sync;
+
+  setup();
+  add_modparam(LCEC_EL7211_PARAM_TORQUE_FF, "torqueFeedForward", NULL, 1);
+  TESTINT(init(), 0);
+
+  // 0x7010:0c, 16 bits, in PDO 0x1605 with the other outputs
+  TESTINT(slave.regs->current, 6);
+  pdo = find_pdo(0x1605, &sync);
+  TESTINT(pdo != NULL && sync == 2 && pdo->n_entries == 1, 1);
+  TESTINT(pdo->entries[0].index, 0x7010);
+  TESTINT(pdo->entries[0].subindex, 0x0c);
+  TESTINT(pdo->entries[0].bit_length, 16);
+
+  torque_ff = pin("torque-ff");
+  torque_ff_raw = pin("torque-ff-raw");
+  TESTINT(torque_ff != NULL && torque_ff_raw != NULL, 1);
+
+  // nothing is sent while disabled
+  *torque_ff = 0.25;
+  slave.proc_write(&slave, PERIOD);
+  TESTINT(*torque_ff_raw, 0);
+  TESTINT(EC_READ_S16(&pd[24]), 0);
+
+  // fractions of rated current go out in 1000ths
+  *(hal_bit_t *)pin("enable") = 1;
+  slave.proc_write(&slave, PERIOD);
+  TESTINT(*torque_ff_raw, 250);
+  TESTINT(EC_READ_S16(&pd[24]), 250);
+  *torque_ff = -1.5;
+  slave.proc_write(&slave, PERIOD);
+  TESTINT(EC_READ_S16(&pd[24]), -1500);
+
+  // and are clamped to 16 bits
+  *torque_ff = 40.0;
+  slave.proc_write(&slave, PERIOD);
+  TESTINT(EC_READ_S16(&pd[24]), 0x7fff);
+  *torque_ff = -40.0;
+  slave.proc_write(&slave, PERIOD);
+  TESTINT(EC_READ_S16(&pd[24]), -0x7fff);
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_el7211_torque_ff_mode) {
+  TESTSETUP;
+
+  // an explicit CSV is fine
+  setup();
+  set_mode(9);
+  add_modparam(LCEC_EL7211_PARAM_TORQUE_FF, "torqueFeedForward", NULL, 1);
+  TESTINT(init(), 0);
+
+  // any other mode isn't
+  setup();
+  set_mode(8);
+  add_modparam(LCEC_EL7211_PARAM_TORQUE_FF, "torqueFeedForward", NULL, 1);
+  TESTINT(init(), -1);
+
+  // unless the offset isn't used
+  setup();
+  set_mode(8);
+  add_modparam(LCEC_EL7211_PARAM_TORQUE_FF, "torqueFeedForward", NULL, 0);
+  TESTINT(init(), 0);
+
+  TESTRESULTS;
+}
+
+TESTMAIN
@@ -0,0 +1,82 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../src/devices/lcec_class_esc_health.h"
+#include "../../src/lcec.h"
+#include "dry_run.h"
+#include "tests.h"
+
+TESTGLOBALSETUP;
+
+static lcec_master_t master;
+static lcec_slave_t slave;
+
+TESTFUNC(test_esc_health_update) {
+  TESTSETUP;
+  lcec_class_esc_health_t *health;
+  uint8_t data[LCEC_ESC_REG_COUNTERS_LEN] = {0};
+  int i;
+
+  strcpy(master.name, "m");
+  strcpy(slave.name, "ek1122");
+  slave.master = &master;
+  slave.index = 3;
+
+  lcec_dry_run = &test_dry_run;
+  health = lcec_esc_health_init(&slave, 1000000000LL);
+  lcec_dry_run = NULL;
+  TESTINT(health != NULL, 1);
+
+  // readouts start at different times on different slaves
+  TESTINT((int)(health->wait / 1000000), 3 * 1000 / 32);
+
+  // ports 0 and 3 have a link, 1 and 2 don't
+  EC_WRITE_U16(data, 0x0090 | 0x0300);
+  lcec_esc_health_update(health, LCEC_ESC_REG_DL_STATUS, data);
+  TESTINT(*(health->port[0].link), 1);
+  TESTINT(*(health->port[1].link), 0);
+  TESTINT(*(health->port[2].link), 0);
+  TESTINT(*(health->port[3].link), 1);
+
+  for (i = 0; i < LCEC_ESC_REG_COUNTERS_LEN; i++) {
+    data[i] = i + 1;
+  }
+  lcec_esc_health_update(health, LCEC_ESC_REG_RX_ERRORS, data);
+  TESTINT((int)*(health->port[0].invalid_frames), 1);
+  TESTINT((int)*(health->port[0].rx_errors), 2);
+  TESTINT((int)*(health->port[3].invalid_frames), 7);
+  TESTINT((int)*(health->port[3].rx_errors), 8);
+  TESTINT((int)*(health->port[1].forwarded_errors), 10);
+  TESTINT((int)*(health->ecat_errors), 13);
+  TESTINT((int)*(health->pdi_errors), 14);
+  TESTINT((int)*(health->port[0].lost_links), 17);
+  TESTINT((int)*(health->port[3].lost_links), 20);
+  TESTINT(*(health->valid), 1);
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_esc_health_clear) {
+  TESTSETUP;
+  int written[LCEC_ESC_REG_COUNTERS_LEN] = {0};
+  const lcec_esc_health_clear_t *clear;
+  int i, j;
+
+  for (i = 0; i < LCEC_ESC_HEALTH_CLEAR_COUNT; i++) {
+    clear = &lcec_esc_health_clear[i];
+    for (j = 0; j < (int)clear->len; j++) {
+      written[clear->address - LCEC_ESC_REG_RX_ERRORS + j] = 1;
+    }
+  }
+
+  // each group of counters needs one of its registers written
+  TESTINT(written[0], 1);
+  TESTINT(written[LCEC_ESC_REG_ECAT_ERRORS - LCEC_ESC_REG_RX_ERRORS], 1);
+  TESTINT(written[LCEC_ESC_REG_PDI_ERRORS - LCEC_ESC_REG_RX_ERRORS], 1);
+  TESTINT(written[LCEC_ESC_REG_LOST_LINKS - LCEC_ESC_REG_RX_ERRORS], 1);
+
+  TESTRESULTS;
+}
+
+TESTMAIN
@@ -0,0 +1,146 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../src/lcec.h"
+#include "dry_run.h"
+#include "tests.h"
+
+TESTGLOBALSETUP;
+
+// Process data layout: the slave's own FSoE frames, and the logic
+// terminal's copies of them.
+#define SLAVE_OS        0   // slave to logic, written by the slave
+#define MASTER_OS       16  // logic to slave, read by the slave
+#define LOGIC_SLAVE_OS  32  // slave's frame, as read by the logic terminal
+#define LOGIC_MASTER_OS 48  // master frame, as written by the logic terminal
+
+static lcec_master_t master;
+static lcec_slave_t slave;
+static uint8_t pd[64];
+static unsigned int logic_slave_os = LOGIC_SLAVE_OS;
+static unsigned int logic_master_os = LOGIC_MASTER_OS;
+static const LCEC_CONF_FSOE_T fsoe_conf = {1, 1, 1};
+
+// Write a frame's command byte and first CRC, which is all the
+// diagnostics look at.
+static void set_frame(unsigned int os, uint8_t cmd, uint16_t crc) {
+  EC_WRITE_U8(&pd[os], cmd);
+  EC_WRITE_U16(&pd[os + LCEC_FSOE_CMD_LEN + 1], crc);
+}
+
+static void cycles(int n) {
+  while (n-- > 0) {
+    copy_fsoe_data(&slave, SLAVE_OS, MASTER_OS);
+  }
+}
+
+static lcec_fsoe_diag_t *setup(void) {
+  memset(&master, 0, sizeof(master));
+  memset(&slave, 0, sizeof(slave));
+  memset(pd, 0, sizeof(pd));
+  strcpy(master.name, "m");
+  strcpy(slave.name, "el1904");
+  master.process_data = pd;
+  master.app_time_period = 1000000;
+  slave.master = &master;
+  slave.fsoeConf = &fsoe_conf;
+  slave.fsoe_slave_offset = &logic_slave_os;
+  slave.fsoe_master_offset = &logic_master_os;
+
+  lcec_dry_run = &test_dry_run;
+  if (lcec_fsoe_diag_init(&slave) != 0) {
+    slave.fsoe_diag = NULL;
+  }
+  lcec_dry_run = NULL;
+  return slave.fsoe_diag;
+}
+
+TESTFUNC(test_fsoe_diag_exchange) {
+  TESTSETUP;
+  lcec_fsoe_diag_t *diag = setup();
+
+  TESTINT(diag != NULL, 1);
+  TESTINT(*(diag->watchdog_ms), 100);
+
+  // frames are passed through between slave and logic terminal
+  set_frame(LOGIC_MASTER_OS, 0x36, 0x1111);
+  cycles(1);
+  TESTINT(EC_READ_U8(&pd[MASTER_OS]), 0x36);
+  TESTINT(*(diag->exchange_cycles), 0);
+
+  // the slave answers two cycles later
+  cycles(1);
+  set_frame(SLAVE_OS, 0x36, 0x2222);
+  cycles(1);
+  TESTINT(EC_READ_U16(&pd[LOGIC_SLAVE_OS + 2]), 0x2222);
+  TESTINT(*(diag->slave_cycles), 2);
+
+  // and the next master frame completes a 3-cycle exchange
+  set_frame(LOGIC_MASTER_OS, 0x36, 0x3333);
+  cycles(1);
+  TESTINT(*(diag->exchange_cycles), 3);
+  TESTINT(*(diag->exchange_cycles_max), 3);
+  TESTINT(*(diag->hist[2]), 1);
+  TESTINT(*(diag->stalls), 0);
+  TESTINT((int)(*(diag->watchdog_margin_ms) * 1000), 97000);
+
+  // a repeated slave frame isn't a new answer
+  cycles(1);
+  TESTINT(*(diag->slave_cycles), 2);
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_fsoe_diag_stall) {
+  TESTSETUP;
+  lcec_fsoe_diag_t *diag = setup();
+  int i;
+
+  TESTINT(diag != NULL, 1);
+  *(diag->watchdog_ms) = 10;
+
+  set_frame(LOGIC_MASTER_OS, 0x36, 0x1111);
+  cycles(1);
+
+  // half the watchdog is used up after 5 cycles, an exchange still
+  // in progress counts as a stall once
+  cycles(5);
+  TESTINT(*(diag->stalls), 0);
+  TESTINT(*(diag->exchange_cycles_max), 5);
+  cycles(3);
+  TESTINT(*(diag->stalls), 1);
+  TESTINT(*(diag->exchange_cycles_max), 8);
+
+  set_frame(LOGIC_MASTER_OS, 0x36, 0x2222);
+  cycles(1);
+  TESTINT(*(diag->exchange_cycles), 9);
+  TESTINT(*(diag->hist[4]), 1);
+  TESTINT((int)(*(diag->watchdog_margin_ms) * 1000), 1000);
+
+  // very long exchanges end up in the last bucket
+  for (i = 0; i < 100; i++) {
+    cycles(1);
+  }
+  set_frame(LOGIC_MASTER_OS, 0x36, 0x3333);
+  cycles(1);
+  TESTINT(*(diag->hist[LCEC_FSOE_DIAG_BUCKETS - 1]), 1);
+  TESTINT(*(diag->stalls), 2);
+
+  // a rising edge on reset clears the counters
+  *(diag->reset) = 1;
+  cycles(1);
+  TESTINT(*(diag->stalls), 0);
+  TESTINT(*(diag->hist[4]), 0);
+  TESTINT(*(diag->hist[LCEC_FSOE_DIAG_BUCKETS - 1]), 0);
+  TESTINT(*(diag->exchange_cycles_max), 1);
+
+  // holding it doesn't
+  set_frame(LOGIC_MASTER_OS, 0x36, 0x4444);
+  cycles(1);
+  TESTINT(*(diag->hist[1]), 1);
+
+  TESTRESULTS;
+}
+
+TESTMAIN
@@ -0,0 +1,123 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../../src/lcec.h"
+#include "../devices/lcec_generic.h"
+#include "tests.h"
+
+TESTGLOBALSETUP;
+
+static lcec_generic_sdo_pin_t make_pin(volatile void *pin, hal_type_t type, LCEC_PDOENT_TYPE_T subType, int bitLength) {
+  lcec_generic_sdo_pin_t sdo_pin = {0};
+
+  sdo_pin.pin = (void *)pin;
+  sdo_pin.type = type;
+  sdo_pin.subType = subType;
+  sdo_pin.bitLength = bitLength;
+  sdo_pin.floatScale = 1.0;
+  return sdo_pin;
+}
+
+TESTFUNC(test_generic_sdo_decode) {
+  TESTSETUP;
+  hal_s32_t s32;
+  hal_u32_t u32;
+  hal_float_t flt;
+  lcec_generic_sdo_pin_t p;
+
+  // signed values are sign-extended from the SDO's size
+  p = make_pin(&s32, HAL_S32, lcecPdoEntTypeSimple, 16);
+  lcec_generic_sdo_decode(&p, 0xfffe);
+  TESTINT(s32, -2);
+
+  p = make_pin(&u32, HAL_U32, lcecPdoEntTypeSimple, 16);
+  lcec_generic_sdo_decode(&p, 0xfffe);
+  TESTINT((int)u32, 0xfffe);
+
+  // e.g. a temperature in 0.1 degrees
+  p = make_pin(&flt, HAL_FLOAT, lcecPdoEntTypeFloatSigned, 16);
+  p.floatScale = 0.1;
+  p.floatOffset = 1.0;
+  lcec_generic_sdo_decode(&p, (uint16_t)-250);
+  TEST_MESSAGE(double, flt, -24.0, "float: got %f, want %f\n");
+
+  p = make_pin(&flt, HAL_FLOAT, lcecPdoEntTypeFloatIeee, 32);
+  lcec_generic_sdo_decode(&p, 0x3fc00000);
+  TEST_MESSAGE(double, flt, 1.5, "float-ieee: got %f, want %f\n");
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_generic_sdo_encode) {
+  TESTSETUP;
+  hal_s32_t s32;
+  hal_u32_t u32;
+  hal_float_t flt;
+  lcec_generic_sdo_pin_t p;
+
+  // values out of range are clamped
+  p = make_pin(&s32, HAL_S32, lcecPdoEntTypeSimple, 8);
+  s32 = -2;
+  TESTINT((int)lcec_generic_sdo_encode(&p), 0xfe);
+  s32 = 1000;
+  TESTINT((int)lcec_generic_sdo_encode(&p), 0x7f);
+  s32 = -1000;
+  TESTINT((int)lcec_generic_sdo_encode(&p), 0x80);
+
+  p = make_pin(&u32, HAL_U32, lcecPdoEntTypeSimple, 16);
+  u32 = 0x12345;
+  TESTINT((int)lcec_generic_sdo_encode(&p), 0xffff);
+
+  // scale and offset are undone on write
+  p = make_pin(&flt, HAL_FLOAT, lcecPdoEntTypeFloatUnsigned, 16);
+  p.floatScale = 0.5;
+  p.floatOffset = 10.0;
+  flt = 20.0;
+  TESTINT((int)lcec_generic_sdo_encode(&p), 20);
+
+  // a round trip through a double
+  p = make_pin(&flt, HAL_FLOAT, lcecPdoEntTypeFloatDoubleIeee, 64);
+  flt = 2.25;
+  lcec_generic_sdo_decode(&p, lcec_generic_sdo_encode(&p));
+  TEST_MESSAGE(double, flt, 2.25, "float-double-ieee: got %f, want %f\n");
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_sdo_poll_schedule) {
+  TESTSETUP;
+  lcec_master_t master = {0};
+  lcec_slave_t slave = {0};
+  lcec_sdo_poll_t a = {0}, b = {0}, none = {0};
+  int started;
+
+  slave.master = &master;
+  slave.state.online = 1;
+  // only the scheduling is tested, so the requests are never touched
+  a.req = (ec_sdo_request_t *)&a;
+  b.req = (ec_sdo_request_t *)&b;
+
+  // without a request, nothing is ever due
+  started = 0;
+  TESTINT(lcec_sdo_poll(&slave, &none, 0, 1000, &started), LCEC_SDO_POLL_IDLE);
+
+  // only one request per slave is due in a cycle
+  TESTINT(lcec_sdo_poll(&slave, &a, 3000, 1000, &started), LCEC_SDO_POLL_DUE);
+  started = 1;
+  TESTINT(lcec_sdo_poll(&slave, &b, 3000, 1000, &started), LCEC_SDO_POLL_IDLE);
+
+  // a request waits out its poll period
+  b.wait = 2000;
+  started = 0;
+  TESTINT(lcec_sdo_poll(&slave, &b, 3000, 1000, &started), LCEC_SDO_POLL_IDLE);
+  TESTINT(lcec_sdo_poll(&slave, &b, 3000, 1000, &started), LCEC_SDO_POLL_IDLE);
+  TESTINT(lcec_sdo_poll(&slave, &b, 3000, 1000, &started), LCEC_SDO_POLL_DUE);
+
+  // and never starts while the slave is offline
+  slave.state.online = 0;
+  TESTINT(lcec_sdo_poll(&slave, &b, 3000, 1000, &started), LCEC_SDO_POLL_IDLE);
+
+  TESTRESULTS;
+}
+
+TESTMAIN
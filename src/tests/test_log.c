@@ -0,0 +1,215 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../src/lcec.h"
+#include "tests.h"
+
+TESTGLOBALSETUP;
+
+// The ring is tested without RTAPI, so take over the clock and the
+// console.
+static long long now;
+static char printed[256];
+static int print_count;
+
+long long rtapi_get_time(void) { return now; }
+
+void rtapi_print_msg(msg_level_t level, const char *fmt, ...) {
+  va_list ap;
+
+  va_start(ap, fmt);
+  vsnprintf(printed, sizeof(printed), fmt, ap);
+  va_end(ap);
+  print_count++;
+}
+
+static void setup(lcec_master_t *master, lcec_slave_t *slave, lcec_log_ring_t *ring) {
+  memset(master, 0, sizeof(*master));
+  memset(slave, 0, sizeof(*slave));
+  strcpy(master->name, "m");
+  strcpy(slave->name, "el1008");
+  slave->index = 3;
+  slave->master = master;
+  master->log = ring;
+  if (ring != NULL) {
+    memset(ring, 0, sizeof(*ring));
+  }
+  now = 1000000000LL;
+}
+
+TESTFUNC(test_log_wraparound) {
+  TESTSETUP;
+  static lcec_log_ring_t ring;
+  lcec_master_t master;
+  lcec_slave_t slave;
+  lcec_log_record_t rec;
+  int i, n;
+
+  setup(&master, &slave, &ring);
+
+  // start just below the 32-bit wrap of head and tail
+  ring.head = ring.tail = 0xffffffff - 2;
+  for (i = 0; i < 3; i++) {
+    lcec_log_slave(&slave, LCEC_LOG_SLAVE_ONLINE, i, 0, 0, 0);
+    lcec_log_slave(&slave, LCEC_LOG_SLAVE_OFFLINE, 0, 0, 0, 0);
+    now += LCEC_LOG_RATE_PERIOD;
+  }
+  TESTINT(ring.head, 3);
+
+  for (i = 0, n = 0; lcec_log_pop(&ring, &rec); i++) {
+    if (rec.id == LCEC_LOG_SLAVE_ONLINE) {
+      TESTINT(rec.args[0], n);
+      n++;
+    }
+    TESTINT(rec.slave, 3);
+  }
+  TESTINT(i, 6);
+  TESTINT(n, 3);
+  TESTINT(ring.tail, ring.head);
+
+  // a full ring drops new records and counts them
+  now += LCEC_LOG_RATE_PERIOD;
+  for (i = 0; i < LCEC_LOG_RING_SIZE + 2; i++) {
+    lcec_log_master(&master, i % LCEC_LOG_ID_COUNT, 0, 0, 0, 0);
+    if (i % LCEC_LOG_ID_COUNT == LCEC_LOG_ID_COUNT - 1) {
+      now += LCEC_LOG_RATE_PERIOD;
+    }
+  }
+  TESTINT(ring.head - ring.tail, LCEC_LOG_RING_SIZE);
+  TESTINT(ring.dropped, 2);
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_log_rate_limit) {
+  TESTSETUP;
+  static lcec_log_ring_t ring;
+  lcec_master_t master;
+  lcec_slave_t slave, other;
+  lcec_log_record_t rec;
+  int i;
+
+  setup(&master, &slave, &ring);
+  other = slave;
+  other.index = 4;
+
+  // a flapping slave only gets a burst per window
+  for (i = 0; i < 10; i++) {
+    lcec_log_slave(&slave, LCEC_LOG_SLAVE_AL_STATE, 1, 8, 1, 0);
+  }
+  TESTINT(ring.head, LCEC_LOG_RATE_BURST);
+
+  // other IDs and slaves aren't affected
+  lcec_log_slave(&slave, LCEC_LOG_SLAVE_OFFLINE, 0, 0, 0, 0);
+  lcec_log_slave(&other, LCEC_LOG_SLAVE_AL_STATE, 1, 8, 1, 0);
+  TESTINT(ring.head, LCEC_LOG_RATE_BURST + 2);
+
+  // the next window's first record reports what was suppressed
+  now += LCEC_LOG_RATE_PERIOD;
+  lcec_log_slave(&slave, LCEC_LOG_SLAVE_AL_STATE, 1, 8, 1, 0);
+  while (lcec_log_pop(&ring, &rec)) {
+  }
+  TESTINT(rec.id, LCEC_LOG_SLAVE_AL_STATE);
+  TESTINT(rec.suppressed, 10 - LCEC_LOG_RATE_BURST);
+  TESTINT(slave.log_limits[LCEC_LOG_SLAVE_AL_STATE].suppressed, 0);
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_log_direct) {
+  TESTSETUP;
+  lcec_master_t master;
+  lcec_slave_t slave;
+  int i;
+
+  // without a reader, records are printed at once
+  setup(&master, &slave, NULL);
+  print_count = 0;
+  lcec_log_slave(&slave, LCEC_LOG_SLAVE_OFFLINE, 0, 0, 0, 0);
+  TESTINT(print_count, 1);
+  TESTSTRING(printed, LCEC_MSG_PFX "slave m.el1008: slave offline\n");
+
+  // still rate limited
+  for (i = 0; i < 10; i++) {
+    lcec_log_master(&master, LCEC_LOG_MASTER_LINK, 0, 2, 0, 0);
+  }
+  TESTINT(print_count, 1 + LCEC_LOG_RATE_BURST);
+  TESTSTRING(printed, LCEC_MSG_PFX "master m: link-up changed to 0, 2 slaves responding\n");
+  now += LCEC_LOG_RATE_PERIOD;
+  lcec_log_master(&master, LCEC_LOG_MASTER_LINK, 1, 3, 0, 0);
+  TESTSTRING(printed, LCEC_MSG_PFX "master m: link-up changed to 1, 3 slaves responding (6 similar messages suppressed)\n");
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_log_reinit) {
+  TESTSETUP;
+  lcec_master_t master;
+  lcec_slave_t slave;
+  ec_slave_config_state_t last;
+  uint32_t count = 0;
+  static const struct {
+    unsigned int online, al_state, count;
+  } steps[] = {
+      {1, 0x08, 1},  // startup
+      {1, 0x08, 1},  //
+      {1, 0x18, 1},  // OP with the error flag set is still OP
+      {1, 0x08, 1},  //
+      {0, 0x08, 1},  // gone, with a stale AL state
+      {1, 0x01, 1},  // re-initialized by the master
+      {1, 0x04, 1},  //
+      {1, 0x08, 2},  // back in OP
+      {1, 0x12, 2},  // error in PREOP
+      {1, 0x18, 3},  // back in OP, error flag still set
+  };
+  unsigned int i;
+
+  setup(&master, &slave, NULL);
+  slave.reinit_count = &count;
+  for (i = 0; i < sizeof(steps) / sizeof(steps[0]); i++) {
+    last = slave.state;
+    slave.state.online = steps[i].online;
+    slave.state.al_state = steps[i].al_state;
+    lcec_log_slave_reinit(&slave, &last);
+    TESTINT(count, steps[i].count);
+  }
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_log_format) {
+  TESTSETUP;
+  lcec_log_record_t rec = {LCEC_LOG_SDO_PIN_ERROR, 7, 0, 0, {0x8010, 0x11, 0, 0}};
+  char buf[256], want[256], small[24];
+
+  TESTINT(lcec_log_format(&rec, "m", "drive", buf, sizeof(buf)), RTAPI_MSG_WARN);
+  TESTSTRING(buf, LCEC_MSG_PFX "slave m.drive: SDO pin request for 0x8010:11 failed");
+
+  // falls back to the index without a name
+  lcec_log_format(&rec, "m", NULL, buf, sizeof(buf));
+  TESTSTRING(buf, LCEC_MSG_PFX "slave m.7: SDO pin request for 0x8010:11 failed");
+
+  rec.suppressed = 3;
+  lcec_log_format(&rec, "m", "drive", buf, sizeof(buf));
+  TESTSTRING(buf, LCEC_MSG_PFX "slave m.drive: SDO pin request for 0x8010:11 failed (3 similar messages suppressed)");
+
+  // master records, unknown IDs, and short buffers
+  rec.slave = -1;
+  rec.suppressed = 0;
+  rec.id = LCEC_LOG_REDUNDANCY;
+  rec.args[0] = 1;
+  TESTINT(lcec_log_format(&rec, "m", NULL, buf, sizeof(buf)), RTAPI_MSG_WARN);
+  TESTSTRING(buf, LCEC_MSG_PFX "master m: redundancy-active changed to 1");
+  rec.id = LCEC_LOG_ID_COUNT;
+  TESTINT(lcec_log_format(&rec, "m", NULL, buf, sizeof(buf)), RTAPI_MSG_ERR);
+  snprintf(want, sizeof(want), LCEC_MSG_PFX "master m: unknown log record %d", LCEC_LOG_ID_COUNT);
+  TESTSTRING(buf, want);
+  rec.id = LCEC_LOG_REDUNDANCY;
+  lcec_log_format(&rec, "m", NULL, small, sizeof(small));
+  TESTINT((int)strlen(small), (int)sizeof(small) - 1);
+
+  TESTRESULTS;
+}
+
+TESTMAIN
@@ -0,0 +1,140 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../src/lcec.h"
+#include "dry_run.h"
+#include "tests.h"
+
+TESTGLOBALSETUP;
+
+TESTFUNC(test_mem_charge) {
+  TESTSETUP;
+  lcec_master_t master;
+  lcec_slave_t a, b;
+  hal_u32_t *pin;
+  uint32_t param;
+  size_t total_hal;
+
+  memset(&master, 0, sizeof(master));
+  memset(&a, 0, sizeof(a));
+  memset(&b, 0, sizeof(b));
+  strcpy(master.name, "m");
+  strcpy(a.name, "a");
+  strcpy(b.name, "b");
+  total_hal = lcec_mem_total()->hal_bytes;
+
+  lcec_dry_run = &test_dry_run;
+  lcec_mem_track(&master, &a);
+  LCEC_HAL_ALLOCATE_ARRAY(uint32_t, 10);
+  TESTINT(lcec_pin_newf(HAL_U32, HAL_OUT, (void **)&pin, "m.a.pin"), 0);
+  TESTINT(lcec_param_newf(HAL_U32, HAL_RW, &param, "m.a.param"), 0);
+  free(LCEC_ALLOCATE_ARRAY(char, 100));
+
+  lcec_mem_track(&master, &b);
+  LCEC_HAL_ALLOCATE(uint64_t);
+
+  // not charged to either slave or the master
+  lcec_mem_track(NULL, NULL);
+  LCEC_HAL_ALLOCATE(uint64_t);
+  lcec_dry_run = NULL;
+
+  TESTINT((int)a.mem.hal_bytes, 40);
+  TESTINT((int)a.mem.heap_bytes, 100);
+  TESTINT((int)a.mem.pins, 1);
+  TESTINT((int)a.mem.params, 1);
+  TESTINT((int)lcec_mem_hal_estimate(&a.mem), 40 + LCEC_MEM_PIN_HAL_BYTES + LCEC_MEM_PARAM_HAL_BYTES);
+  TESTINT((int)b.mem.hal_bytes, 8);
+  TESTINT((int)b.mem.pins, 0);
+  TESTINT((int)master.mem.hal_bytes, 48);
+  TESTINT((int)master.mem.pins, 1);
+  TESTINT((int)(lcec_mem_total()->hal_bytes - total_hal), 56);
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_mem_budget) {
+  TESTSETUP;
+  lcec_master_t master;
+  lcec_slave_t slave;
+
+  memset(&master, 0, sizeof(master));
+  memset(&slave, 0, sizeof(slave));
+  strcpy(master.name, "m");
+  strcpy(slave.name, "s");
+  master.hal_mem_budget = 100;
+
+  lcec_dry_run = &test_dry_run;
+  lcec_mem_track(&master, &slave);
+  LCEC_HAL_ALLOCATE_ARRAY(uint8_t, 100);
+  TESTINT(master.hal_mem_budget_warned, 0);
+  LCEC_HAL_ALLOCATE(uint8_t);
+  TESTINT(master.hal_mem_budget_warned, 1);
+  lcec_mem_track(NULL, NULL);
+  lcec_dry_run = NULL;
+
+  TESTRESULTS;
+}
+
+typedef struct LCEC_HOT {
+  uint32_t x;
+} hot_t;
+
+TESTFUNC(test_mem_pool) {
+  TESTSETUP;
+  lcec_pool_t pool;
+  uint8_t *a, *b, *c, *d;
+  uint32_t *e;
+  hot_t *h1, *h2;
+  size_t unused;
+  int i, zero;
+
+  memset(&pool, 0, sizeof(pool));
+  unused = lcec_mem_total()->pool_unused;
+  lcec_dry_run = &test_dry_run;
+  a = LCEC_POOL_ALLOCATE_ARRAY(&pool, uint8_t, 10);
+  b = LCEC_POOL_ALLOCATE_ARRAY(&pool, uint8_t, 100);
+  c = LCEC_POOL_ALLOCATE_ARRAY(&pool, uint8_t, 2 * LCEC_POOL_CHUNK_SIZE);
+  d = LCEC_POOL_ALLOCATE(&pool, uint8_t);
+  e = LCEC_POOL_ALLOCATE(&pool, uint32_t);
+  lcec_dry_run = NULL;
+
+  // blocks follow each other, aligned for their type
+  TESTINT((int)(b - a), 10);
+  TESTINT((int)((uintptr_t)e % __alignof__(uint32_t)), 0);
+  TESTINT((int)((uint8_t *)e - d), 2);
+
+  // an oversized block doesn't end the current chunk
+  TESTINT((int)(d - b), 100);
+
+  for (i = 0, zero = 1; i < 2 * LCEC_POOL_CHUNK_SIZE; i++) {
+    zero = zero && c[i] == 0;
+  }
+  TESTINT(zero, 1);
+
+  // what isn't handed out of a chunk is reported
+  TESTINT((int)(lcec_mem_total()->pool_unused - unused), LCEC_POOL_CHUNK_SIZE - (10 + 100 + 1 + 4));
+
+  // hot structs start on a cache line, and the gap before them is unused
+  unused = lcec_mem_total()->pool_unused;
+  lcec_dry_run = &test_dry_run;
+  h1 = LCEC_POOL_ALLOCATE(&pool, hot_t);
+  h2 = LCEC_POOL_ALLOCATE(&pool, hot_t);
+  lcec_dry_run = NULL;
+  TESTINT((int)((uintptr_t)h1 % LCEC_POOL_ALIGN), 0);
+  TESTINT((int)((uint8_t *)h2 - (uint8_t *)h1), LCEC_POOL_ALIGN);
+  TESTINT((int)(unused - lcec_mem_total()->pool_unused), 2 * LCEC_POOL_ALIGN);
+
+  // a pool can take bigger chunks, so that big blocks still follow each other
+  memset(&pool, 0, sizeof(pool));
+  pool.chunk_size = 4 * LCEC_POOL_CHUNK_SIZE;
+  lcec_dry_run = &test_dry_run;
+  a = LCEC_POOL_ALLOCATE_ARRAY(&pool, uint8_t, LCEC_POOL_CHUNK_SIZE);
+  b = LCEC_POOL_ALLOCATE_ARRAY(&pool, uint8_t, LCEC_POOL_CHUNK_SIZE);
+  lcec_dry_run = NULL;
+  TESTINT((int)(b - a), LCEC_POOL_CHUNK_SIZE);
+
+  TESTRESULTS;
+}
+
+TESTMAIN
@@ -0,0 +1,146 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../src/lcec.h"
+#include "tests.h"
+
+TESTGLOBALSETUP;
+
+void lcec_receive(lcec_master_t *master);
+
+// The frame arrives after `arrival` ns of the test's clock, which only
+// moves while lcec_receive() waits.
+static long long now;
+static long long arrival;
+static int receives;
+static int delays;
+static int complete;
+
+long long rtapi_get_time(void) { return now; }
+
+void rtapi_delay(long int nsec) {
+  now += nsec;
+  delays++;
+}
+
+void ecrt_master_receive(ec_master_t *master) { receives++; }
+
+void ecrt_domain_process(ec_domain_t *domain) { complete = now >= arrival; }
+
+void ecrt_domain_state(const ec_domain_t *domain, ec_domain_state_t *state) {
+  memset(state, 0, sizeof(*state));
+  state->wc_state = complete ? EC_WC_COMPLETE : EC_WC_INCOMPLETE;
+}
+
+static lcec_master_t master;
+static lcec_master_data_t hal_data;
+static hal_u32_t misses;
+static hal_s32_t wait_avg;
+
+static void setup(int32_t deadline) {
+  memset(&master, 0, sizeof(master));
+  memset(&hal_data, 0, sizeof(hal_data));
+  misses = 0;
+  wait_avg = 0;
+  hal_data.rx_deadline_misses = &misses;
+  hal_data.rx_wait_avg = &wait_avg;
+  master.hal_data = &hal_data;
+  master.rx_deadline = deadline;
+}
+
+// Run a cycle with the frame `late` ns late.
+static void cycle(long long late) {
+  now = 1000000000LL;
+  arrival = now + late;
+  receives = 0;
+  delays = 0;
+  lcec_receive(&master);
+}
+
+TESTFUNC(test_receive_no_deadline) {
+  TESTSETUP;
+
+  // one receive, late or not
+  setup(0);
+  cycle(50000);
+  TESTINT(receives, 1);
+  TESTINT(delays, 0);
+  TESTINT(misses, 0);
+  TESTINT(wait_avg, 0);
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_receive_deadline) {
+  TESTSETUP;
+
+  setup(100000);
+
+  // on time
+  cycle(0);
+  TESTINT(receives, 1);
+  TESTINT(delays, 0);
+
+  // a late frame is picked up on the next poll, not in a busy loop
+  cycle(30000);
+  TESTINT(receives, 3);
+  TESTINT(delays, 2);
+  TESTINT((int)(now - 1000000000LL), 2 * LCEC_RX_POLL_NS);
+  TESTINT(misses, 0);
+  TESTINT(master.rx_miss_run, 0);
+  TESTINT(master.rx_wait_avg > 0, 1);
+
+  // one that's too late waits out the deadline, and no longer
+  cycle(150000);
+  TESTINT((int)(now - 1000000000LL), 100000);
+  TESTINT(receives, 100000 / LCEC_RX_POLL_NS + 1);
+  TESTINT(misses, 1);
+  TESTINT(master.rx_miss_run, 1);
+
+  // the last wait is cut short
+  master.rx_deadline = 90000;
+  cycle(150000);
+  TESTINT((int)(now - 1000000000LL), 90000);
+  TESTINT(misses, 2);
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_receive_miss_limit) {
+  TESTSETUP;
+  int i;
+
+  setup(100000);
+
+  // misses in a row stop the waiting ...
+  for (i = 0; i < LCEC_RX_DEADLINE_MISS_LIMIT; i++) {
+    cycle(1000000);
+  }
+  TESTINT(misses, LCEC_RX_DEADLINE_MISS_LIMIT);
+  TESTINT(master.rx_miss_run, LCEC_RX_DEADLINE_MISS_LIMIT);
+
+  // ... but are still counted
+  cycle(1000000);
+  TESTINT(receives, 1);
+  TESTINT(delays, 0);
+  TESTINT(misses, LCEC_RX_DEADLINE_MISS_LIMIT + 1);
+  TESTINT(master.rx_miss_run, LCEC_RX_DEADLINE_MISS_LIMIT);
+
+  // a late frame isn't waited for ...
+  cycle(30000);
+  TESTINT(receives, 1);
+  TESTINT(misses, LCEC_RX_DEADLINE_MISS_LIMIT + 2);
+
+  // ... until one is on time again
+  cycle(0);
+  TESTINT(receives, 1);
+  TESTINT(master.rx_miss_run, 0);
+  cycle(30000);
+  TESTINT(receives, 3);
+  TESTINT(misses, LCEC_RX_DEADLINE_MISS_LIMIT + 2);
+
+  TESTRESULTS;
+}
+
+TESTMAIN
@@ -0,0 +1,161 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../src/lcec.h"
+#include "dry_run.h"
+#include "tests.h"
+
+TESTGLOBALSETUP;
+
+#ifdef EC_HAVE_REDUNDANCY
+int lcec_init_master_redundancy(lcec_master_t *master, const char *pfx);
+void lcec_update_redundancy(lcec_master_t *master, int check_states);
+
+// The master's devices and domain, as the test sets them.
+static ec_master_link_state_t links[LCEC_MAX_LINKS];
+static int link_count;
+static ec_domain_state_t domain;
+
+int ecrt_master_link_state(const ec_master_t *master, unsigned int dev_idx, ec_master_link_state_t *state) {
+  if ((int)dev_idx >= link_count) {
+    return -1;
+  }
+  *state = links[dev_idx];
+  return 0;
+}
+
+void ecrt_domain_state(const ec_domain_t *domain_, ec_domain_state_t *state) { *state = domain; }
+
+static lcec_master_t master;
+static lcec_master_data_t hal_data;
+
+static int setup(int count) {
+  int err;
+
+  memset(&master, 0, sizeof(master));
+  memset(&hal_data, 0, sizeof(hal_data));
+  memset(links, 0, sizeof(links));
+  memset(&domain, 0, sizeof(domain));
+  strcpy(master.name, "ring");
+  master.hal_data = &hal_data;
+  link_count = count;
+  links[0].link_up = 1;
+  links[0].slaves_responding = 4;
+  links[1].link_up = 1;
+  domain.wc_state = EC_WC_COMPLETE;
+
+  lcec_dry_run = &test_dry_run;
+  err = lcec_init_master_redundancy(&master, "lcec.ring");
+  lcec_dry_run = NULL;
+  return err;
+}
+
+// Run `n` cycles, updating the links on the first one.
+static void cycles(int n) {
+  int i;
+
+  for (i = 0; i < n; i++) {
+    lcec_update_redundancy(&master, i == 0);
+  }
+}
+
+TESTFUNC(test_redundancy_single) {
+  TESTSETUP;
+
+  // without a backup device, no pins
+  TESTINT(setup(1), 0);
+  TESTINT(master.link_count, 1);
+  TESTINT(hal_data.redundancy_active == NULL, 1);
+  TESTINT(hal_data.links[0].link_up == NULL, 1);
+  TESTINT(test_pin("lcec.ring.link-0-up") == NULL, 1);
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_redundancy_links) {
+  TESTSETUP;
+
+  TESTINT(setup(2), 0);
+  TESTINT(master.link_count, 2);
+  TESTINT(test_pin("lcec.ring.link-0-up") == hal_data.links[0].link_up, 1);
+  TESTINT(test_pin("lcec.ring.link-1-slaves-responding") == hal_data.links[1].slaves_responding, 1);
+  TESTINT(test_pin("lcec.ring.failovers") == hal_data.failovers, 1);
+
+  cycles(1);
+  TESTINT(*(hal_data.links[0].link_up), 1);
+  TESTINT(*(hal_data.links[0].slaves_responding), 4);
+  TESTINT(*(hal_data.links[1].link_up), 1);
+  TESTINT(*(hal_data.links[1].slaves_responding), 0);
+
+  // a cable breaks between slaves 2 and 3
+  links[0].slaves_responding = 2;
+  links[1].slaves_responding = 2;
+  cycles(1);
+  TESTINT(*(hal_data.links[0].slaves_responding), 2);
+  TESTINT(*(hal_data.links[1].slaves_responding), 2);
+
+  // link changes only show when states are checked
+  links[0].link_up = 0;
+  lcec_update_redundancy(&master, 0);
+  TESTINT(*(hal_data.links[0].link_up), 1);
+  lcec_update_redundancy(&master, 1);
+  TESTINT(*(hal_data.links[0].link_up), 0);
+  TESTINT(master.link_states[0].link_up, 0);
+  TESTINT(*(hal_data.links[1].link_up), 1);
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_redundancy_failover) {
+  TESTSETUP;
+
+  TESTINT(setup(2), 0);
+  cycles(5);
+  TESTINT(*(hal_data.failovers), 0);
+
+  // 3 cycles lost, then the backup path takes over, then 1 more
+  domain.wc_state = EC_WC_INCOMPLETE;
+  cycles(3);
+  domain.redundancy_active = 1;
+  cycles(1);
+  TESTINT(*(hal_data.redundancy_active), 1);
+  TESTINT(*(hal_data.failovers), 1);
+  TESTINT(*(hal_data.failover_lost_cycles), 0);
+  domain.wc_state = EC_WC_COMPLETE;
+  cycles(2);
+  TESTINT(*(hal_data.failover_lost_cycles), 4);
+  TESTINT(master.rx_lost_run, 0);
+
+  // switching back isn't a failover, but its lost cycles count
+  domain.wc_state = EC_WC_INCOMPLETE;
+  domain.redundancy_active = 0;
+  cycles(1);
+  domain.wc_state = EC_WC_COMPLETE;
+  cycles(1);
+  TESTINT(*(hal_data.redundancy_active), 0);
+  TESTINT(*(hal_data.failovers), 1);
+  TESTINT(*(hal_data.failover_lost_cycles), 1);
+
+  // lost cycles without a switch leave it alone
+  domain.wc_state = EC_WC_INCOMPLETE;
+  cycles(7);
+  domain.wc_state = EC_WC_COMPLETE;
+  cycles(1);
+  TESTINT(*(hal_data.failover_lost_cycles), 1);
+
+  // and a long outage stops counting
+  domain.wc_state = EC_WC_INCOMPLETE;
+  master.rx_lost_run = LCEC_RX_LOST_RUN_LIMIT - 1;
+  domain.redundancy_active = 1;
+  cycles(3);
+  domain.wc_state = EC_WC_COMPLETE;
+  cycles(1);
+  TESTINT(*(hal_data.failovers), 2);
+  TESTINT(*(hal_data.failover_lost_cycles), LCEC_RX_LOST_RUN_LIMIT);
+
+  TESTRESULTS;
+}
+#endif
+
+TESTMAIN
@@ -0,0 +1,222 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "../../src/lcec.h"
+#include "../../src/lcec_conf.h"
+#include "../../src/lcec_conf_priv.h"
+#include "../devices/lcec_class_din.h"
+#include "dry_run.h"
+#include "tests.h"
+
+TESTGLOBALSETUP;
+
+#define TEST_MP_FILTER   1  // written to SDO 0x8000:01
+#define TEST_MP_MODE     2  // only changes what the driver does
+#define TEST_MP_CHANNELS 3  // changes the number of pins
+
+static int test_reload_init(int comp_id, lcec_slave_t *slave);
+
+// tests run from constructors, possibly before the drivers register
+// their types, so use a type of our own
+static lcec_typelist_t types[] = {
+    {"TESTRELOAD", 0, 0, 0, NULL, test_reload_init, NULL, 0},
+    {NULL},
+};
+
+typedef struct {
+  const char *name;
+  uint32_t filter;
+  uint32_t mode;
+  uint32_t channels;
+  uint16_t sdo;
+  int slaves;
+} test_conf_t;
+
+static char old_conf[4096], new_conf[4096];
+static size_t conf_len;
+
+static int test_reload_init(int comp_id, lcec_slave_t *slave) {
+  lcec_class_din_channels_t *hal_data;
+  lcec_slave_modparam_t *p;
+  unsigned int channels = 1, i;
+
+  for (p = slave->modparams; p != NULL && p->id >= 0; p++) {
+    switch (p->id) {
+      case TEST_MP_FILTER:
+        if (lcec_write_sdo16_modparam(slave, 0x8000, 0x01, p->value.u32, p->name) != 0) {
+          return -1;
+        }
+        break;
+      case TEST_MP_CHANNELS:
+        channels = p->value.u32;
+        break;
+    }
+  }
+
+  hal_data = lcec_din_allocate_channels(channels);
+  if (hal_data == NULL) {
+    return -1;
+  }
+  slave->hal_data = hal_data;
+
+  for (i = 0; i < channels; i++) {
+    hal_data->channels[i] = lcec_din_register_channel(slave, i, 0x6000 + (i << 4), 0x01);
+    if (hal_data->channels[i] == NULL) {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+static void *add_token(char *conf, const void *token, size_t len) {
+  void *p = &conf[conf_len];
+
+  memcpy(p, token, len);
+  conf_len += len;
+  return p;
+}
+
+static void add_modparam(char *conf, int id, const char *name, uint32_t value) {
+  LCEC_CONF_MODPARAM_T mp = {.confType = lcecConfTypeModParam, .id = id};
+
+  strcpy(mp.name, name);
+  mp.value.u32 = value;
+  add_token(conf, &mp, sizeof(mp));
+}
+
+// A master with one TESTRELOAD slave per `slaves`, each with an
+// <sdoConfig> for 0x8001:02 and three modParams.
+static void build_conf(char *conf, const test_conf_t *tc) {
+  static int registered;
+  LCEC_CONF_MASTER_T master = {.confType = lcecConfTypeMaster};
+  LCEC_CONF_SLAVE_T slave = {.confType = lcecConfTypeSlave, .templateOffset = -1};
+  LCEC_CONF_SDOCONF_T sdo = {.confType = lcecConfTypeSdoConfig, .index = 0x8001, .subindex = 0x02, .length = 2};
+  uint8_t sdo_data[2];
+  LCEC_CONF_NULL_T end = {.confType = lcecConfTypeNone};
+  int i;
+
+  if (!registered) {
+    lcec_addtypes(types, __FILE__);
+    registered = 1;
+  }
+
+  conf_len = 0;
+  strcpy(master.name, "0");
+  add_token(conf, &master, sizeof(master));
+
+  for (i = 0; i < tc->slaves; i++) {
+    strcpy(slave.type_name, "TESTRELOAD");
+    snprintf(slave.name, sizeof(slave.name), "%s%d", tc->name, i);
+    slave.index = i;
+    slave.sdoConfigLength = sizeof(sdo) + sizeof(sdo_data);
+    slave.modParamCount = 3;
+    add_token(conf, &slave, sizeof(slave));
+
+    EC_WRITE_U16(sdo_data, tc->sdo);
+    add_token(conf, &sdo, sizeof(sdo));
+    add_token(conf, sdo_data, sizeof(sdo_data));
+    add_modparam(conf, TEST_MP_FILTER, "filter", tc->filter);
+    add_modparam(conf, TEST_MP_MODE, "mode", tc->mode);
+    add_modparam(conf, TEST_MP_CHANNELS, "channels", tc->channels);
+  }
+
+  add_token(conf, &end, sizeof(end));
+}
+
+static const test_conf_t base = {"in", 10, 0, 2, 0x1234, 2};
+
+// Build both configs and run the structure check.
+static int compare(const test_conf_t *old_tc, const test_conf_t *new_tc) {
+  build_conf(old_conf, old_tc);
+  build_conf(new_conf, new_tc);
+  return reloadCompareStructure(old_conf, new_conf);
+}
+
+// Build both configs and return the number of writes a reload needs.
+static int diff(const test_conf_t *old_tc, const test_conf_t *new_tc) {
+  lcec_master_t *first;
+
+  build_conf(old_conf, old_tc);
+  build_conf(new_conf, new_tc);
+  return reloadDiff(old_conf, new_conf, &first, -1, -1);
+}
+
+TESTFUNC(test_reload_structure) {
+  TESTSETUP;
+  test_conf_t tc;
+
+  TESTINT(compare(&base, &base), 0);
+
+  // values may change
+  tc = base;
+  tc.filter = 20;
+  tc.mode = 1;
+  tc.sdo = 0x4321;
+  TESTINT(compare(&base, &tc), 0);
+
+  // at this level, even a modParam that needs a restart
+  tc = base;
+  tc.channels = 4;
+  TESTINT(compare(&base, &tc), 0);
+
+  // but not slaves
+  tc = base;
+  tc.name = "out";
+  TESTINT(compare(&base, &tc), -1);
+  tc = base;
+  tc.slaves = 3;
+  TESTINT(compare(&base, &tc), -1);
+  TESTINT(compare(&tc, &base), -1);
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_reload_diff) {
+  TESTSETUP;
+  test_conf_t tc;
+
+  TESTINT(diff(&base, &base), 0);
+
+  // one write per slave for a changed SDO
+  tc = base;
+  tc.sdo = 0x4321;
+  TESTINT(diff(&base, &tc), 2);
+
+  // and for a modParam the driver writes to an SDO
+  tc = base;
+  tc.filter = 20;
+  TESTINT(diff(&base, &tc), 2);
+  tc.sdo = 0x4321;
+  TESTINT(diff(&base, &tc), 4);
+
+  // a modParam without an SDO can't be reloaded
+  tc = base;
+  tc.mode = 1;
+  TESTINT(diff(&base, &tc), -1);
+
+  // nor one that changes pins
+  tc = base;
+  tc.channels = 4;
+  TESTINT(diff(&base, &tc), -1);
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_reload_restore) {
+  TESTSETUP;
+  lcec_master_t *first;
+  test_conf_t tc;
+
+  // restoring a re-initialized slave only touches that slave
+  tc = base;
+  tc.filter = 20;
+  build_conf(old_conf, &base);
+  build_conf(new_conf, &tc);
+  TESTINT(reloadDiff(old_conf, new_conf, &first, 0, 1), 1);
+  TESTINT(reloadDiff(old_conf, new_conf, &first, 0, 5), 0);
+  TESTINT(reloadDiff(old_conf, new_conf, &first, 1, 1), 0);
+
+  TESTRESULTS;
+}
+
+TESTMAIN
@@ -0,0 +1,48 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../../src/lcec.h"
+#include "dry_run.h"
+#include "tests.h"
+
+TESTGLOBALSETUP;
+
+TESTFUNC(test_scale_watch) {
+  TESTSETUP;
+  lcec_slave_t slave = {0};
+  lcec_scale_t *a, *b;
+  hal_float_t scale_a = 4.0, scale_b = 0.0;
+
+  // lcec_scale_watch() allocates HAL memory, so run without HAL
+  lcec_dry_run = &test_dry_run;
+  a = lcec_scale_watch(&slave, &scale_a);
+  b = lcec_scale_watch(&slave, &scale_b);
+  lcec_dry_run = NULL;
+
+  TEST_MESSAGE(double, a->recip, 0.25, "a->recip: got %f, want %f\n");
+  TEST_MESSAGE(double, scale_b, 1.0, "zero scale reset: got %f, want %f\n");
+  TEST_MESSAGE(double, b->recip, 1.0, "b->recip: got %f, want %f\n");
+  TESTINT((int)slave.scale_epoch, 0);
+
+  // no change, no new epoch
+  lcec_scale_update(&slave);
+  TESTINT((int)slave.scale_epoch, 0);
+
+  scale_b = 2.0;
+  lcec_scale_update(&slave);
+  TESTINT((int)slave.scale_epoch, 1);
+  TEST_MESSAGE(double, b->recip, 0.5, "b->recip: got %f, want %f\n");
+  TEST_MESSAGE(double, a->recip, 0.25, "a->recip: got %f, want %f\n");
+
+  // two changes in one cycle are one epoch
+  scale_a = 8.0;
+  scale_b = 1e-30;
+  lcec_scale_update(&slave);
+  TESTINT((int)slave.scale_epoch, 2);
+  TEST_MESSAGE(double, a->recip, 0.125, "a->recip: got %f, want %f\n");
+  TEST_MESSAGE(double, scale_b, 1.0, "tiny scale reset: got %f, want %f\n");
+
+  TESTRESULTS;
+}
+
+TESTMAIN
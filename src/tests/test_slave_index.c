@@ -0,0 +1,55 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "../../src/lcec.h"
+#include "tests.h"
+
+TESTGLOBALSETUP;
+
+static lcec_master_t master;
+static lcec_slave_t slaves[5];
+
+static void add_slave(lcec_slave_t *slave, int index, const char *name) {
+  slave->index = index;
+  strcpy(slave->name, name);
+  slave->master = &master;
+  LCEC_LIST_APPEND(master.first_slave, master.last_slave, slave);
+}
+
+TESTFUNC(test_slave_index) {
+  TESTSETUP;
+
+  // out of order, with a gap at index 3 and a duplicate name
+  add_slave(&slaves[0], 0, "ek1100");
+  add_slave(&slaves[1], 4, "fsoe");
+  add_slave(&slaves[2], 1, "din");
+  add_slave(&slaves[3], 2, "aout");
+  add_slave(&slaves[4], 5, "din");
+
+  // lookups work before the tables are built, too
+  TESTINT(lcec_slave_by_index(&master, 4) == &slaves[1], 1);
+  TESTINT(lcec_slave_by_name(&master, "din") == &slaves[2], 1);
+
+  lcec_index_slaves(&master);
+  TESTINT(master.slave_count, 5);
+  TESTINT(master.slaves_by_index_len, 6);
+
+  TESTINT(lcec_slave_by_index(&master, 0) == &slaves[0], 1);
+  TESTINT(lcec_slave_by_index(&master, 2) == &slaves[3], 1);
+  TESTINT(lcec_slave_by_index(&master, 4) == &slaves[1], 1);
+  TESTINT(lcec_slave_by_index(&master, 3) == NULL, 1);
+  TESTINT(lcec_slave_by_index(&master, 6) == NULL, 1);
+  TESTINT(lcec_slave_by_index(&master, -1) == NULL, 1);
+
+  TESTINT(lcec_slave_by_name(&master, "aout") == &slaves[3], 1);
+  TESTINT(lcec_slave_by_name(&master, "ek1100") == &slaves[0], 1);
+  TESTINT(lcec_slave_by_name(&master, "fsoe") == &slaves[1], 1);
+  TESTINT(lcec_slave_by_name(&master, "din") == &slaves[2], 1);
+  TESTINT(lcec_slave_by_name(&master, "dout") == NULL, 1);
+  TESTINT(lcec_slave_by_name(&master, "zzz") == NULL, 1);
+  TESTINT(lcec_slave_by_name(&master, "") == NULL, 1);
+
+  TESTRESULTS;
+}
+
+TESTMAIN
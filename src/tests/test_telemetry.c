@@ -0,0 +1,161 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../src/devices/lcec_class_telemetry.h"
+#include "../../src/lcec.h"
+#include "dry_run.h"
+#include "tests.h"
+
+TESTGLOBALSETUP;
+
+TESTFUNC(test_telemetry_parse_mode) {
+  TESTSETUP;
+
+  TESTINT(lcec_telemetry_parse_mode("off"), LCEC_TELEMETRY_OFF);
+  TESTINT(lcec_telemetry_parse_mode("pdo"), LCEC_TELEMETRY_PDO);
+  TESTINT(lcec_telemetry_parse_mode("sdo"), LCEC_TELEMETRY_SDO);
+  TESTINT(lcec_telemetry_parse_mode("fast"), -1);
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_telemetry_sample) {
+  TESTSETUP;
+  lcec_class_telemetry_value_t value = {0};
+  hal_float_t v, peak, avg;
+  int i;
+
+  value.value = &v;
+  value.peak = &peak;
+  value.avg = &avg;
+
+  // the first reading sets everything
+  value.age = 1000000;
+  lcec_telemetry_sample(&value, 2.0);
+  TEST_MESSAGE(double, avg, 2.0, "avg: got %f, want %f\n");
+  TEST_MESSAGE(double, peak, 2.0, "peak: got %f, want %f\n");
+
+  // a short spike shows in the peak, but barely in the average
+  value.age = 1000000;
+  lcec_telemetry_sample(&value, 10.0);
+  TEST_MESSAGE(double, peak, 10.0, "peak: got %f, want %f\n");
+  TEST_MESSAGE(double, avg, 2.008, "avg: got %f, want %f\n");
+
+  // a new level takes a few time constants to settle, at any sample rate
+  for (i = 0; i < 50; i++) {
+    value.age = LCEC_TELEMETRY_AVG_TAU_NS / 10;
+    lcec_telemetry_sample(&value, 4.0);
+  }
+  TESTINT(avg > 3.98 && avg < 4.0, 1);
+  TEST_MESSAGE(double, v, 4.0, "value: got %f, want %f\n");
+  TEST_MESSAGE(double, peak, 10.0, "peak: got %f, want %f\n");
+
+  // after a reset
+  value.valid = 0;
+  lcec_telemetry_sample(&value, 3.0);
+  TEST_MESSAGE(double, peak, 3.0, "peak after reset: got %f, want %f\n");
+
+  TESTRESULTS;
+}
+
+// Offsets the domain would assign to an EP9214's currents and
+// voltages, with a signed 32 bit and an 8 bit value after them.
+static unsigned int pdo_offset(uint16_t index, uint8_t subindex) {
+  switch (index << 8 | subindex) {
+    case 0x600011:
+      return 2;
+    case 0x600012:
+      return 4;
+    case 0x601011:
+      return 6;
+    case 0x601012:
+      return 8;
+    case 0xf60011:
+      return 10;
+    case 0xf60012:
+      return 12;
+    case 0x700001:
+      return 16;
+  }
+  return 20;
+}
+
+TESTFUNC(test_telemetry_pdo) {
+  TESTSETUP;
+  lcec_master_t master = {0};
+  lcec_slave_t slave = {0};
+  lcec_class_telemetry_t *tel;
+  lcec_class_telemetry_value_t *v[7];
+  uint8_t pd[32] = {0};
+  int i;
+
+  strcpy(master.name, "m");
+  strcpy(slave.name, "ep9214");
+  master.process_data = pd;
+  slave.master = &master;
+  slave.regs = lcec_allocate_pdo_entry_reg(LCEC_MAX_PDO_REG_COUNT);
+
+  lcec_dry_run = &test_dry_run;
+  tel = lcec_telemetry_allocate(&slave, 7, LCEC_TELEMETRY_PDO, LCEC_TELEMETRY_POLL_NS);
+  TESTINT(tel != NULL, 1);
+  v[0] = lcec_telemetry_register_value(&slave, tel, 0x6000, 0x11, 16, 0, 0.001, "chan-1-current-us");
+  v[1] = lcec_telemetry_register_value(&slave, tel, 0x6000, 0x12, 16, 0, 0.001, "chan-1-current-up");
+  v[2] = lcec_telemetry_register_value(&slave, tel, 0x6010, 0x11, 16, 0, 0.001, "chan-2-current-us");
+  v[3] = lcec_telemetry_register_value(&slave, tel, 0x6010, 0x12, 16, 0, 0.001, "chan-2-current-up");
+  v[4] = lcec_telemetry_register_value(&slave, tel, 0xf600, 0x11, 16, 0, 0.001, "voltage-us");
+  v[5] = lcec_telemetry_register_value(&slave, tel, 0xf600, 0x12, 16, 0, 0.001, "voltage-up");
+  v[6] = lcec_telemetry_register_value(&slave, tel, 0x7000, 0x01, 32, 1, 1.0, "power");
+  TESTINT(lcec_telemetry_register_value(&slave, tel, 0x7000, 0x02, 8, 0, 1.0, "extra") == NULL, 1);
+  lcec_dry_run = NULL;
+
+  // every value is registered for the domain, and no SDO requests are made
+  TESTINT(tel->count, 7);
+  TESTINT(slave.regs->current, 7);
+  for (i = 0; i < 7; i++) {
+    TESTINT(v[i] != NULL, 1);
+    TESTINT(slave.regs->pdo_entry_regs[i].index, v[i]->idx);
+    TESTINT(slave.regs->pdo_entry_regs[i].subindex, v[i]->sidx);
+    TESTINT(slave.regs->pdo_entry_regs[i].offset == &v[i]->pdo_os, 1);
+    TESTINT(v[i]->poll.req == NULL, 1);
+    *slave.regs->pdo_entry_regs[i].offset = pdo_offset(v[i]->idx, v[i]->sidx);
+  }
+
+  EC_WRITE_U16(&pd[2], 1500);
+  EC_WRITE_U16(&pd[4], 250);
+  EC_WRITE_U16(&pd[6], 3000);
+  EC_WRITE_U16(&pd[8], 40000);
+  EC_WRITE_U16(&pd[10], 24100);
+  EC_WRITE_U16(&pd[12], 23900);
+  EC_WRITE_S32(&pd[16], -70000);
+
+  // nothing is read before the slave is operational
+  lcec_telemetry_read(&slave, tel, 1000000);
+  for (i = 0; i < 7; i++) {
+    TESTINT(v[i]->valid, 0);
+  }
+
+  // then each value comes from its own offset
+  slave.state.operational = 1;
+  lcec_telemetry_read(&slave, tel, 1000000);
+  TESTINT((int)(*(v[0]->value) * 1000 + 0.5), 1500);
+  TESTINT((int)(*(v[1]->value) * 1000 + 0.5), 250);
+  TESTINT((int)(*(v[2]->value) * 1000 + 0.5), 3000);
+  TESTINT((int)(*(v[3]->value) * 1000 + 0.5), 40000);
+  TESTINT((int)(*(v[4]->value) * 1000 + 0.5), 24100);
+  TESTINT((int)(*(v[5]->value) * 1000 + 0.5), 23900);
+  TESTINT((int)*(v[6]->value), -70000);
+  TESTINT((int)(*(v[3]->peak) * 1000 + 0.5), 40000);
+  TESTINT((int)(*(v[3]->avg) * 1000 + 0.5), 40000);
+
+  // and follows it
+  EC_WRITE_U16(&pd[8], 100);
+  lcec_telemetry_read(&slave, tel, 1000000);
+  TESTINT((int)(*(v[3]->value) * 1000 + 0.5), 100);
+  TESTINT((int)(*(v[3]->peak) * 1000 + 0.5), 40000);
+  TESTINT((int)(*(v[2]->value) * 1000 + 0.5), 3000);
+
+  TESTRESULTS;
+}
+
+TESTMAIN
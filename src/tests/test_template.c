@@ -0,0 +1,228 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "../../src/lcec.h"
+#include "../../src/lcec_conf.h"
+#include "../../src/lcec_conf_priv.h"
+#include "../devices/lcec_class_din.h"
+#include "dry_run.h"
+#include "tests.h"
+
+TESTGLOBALSETUP;
+
+static int test_din_init(int comp_id, lcec_slave_t *slave);
+
+// tests run from constructors, possibly before the drivers register
+// their types, so use a type of our own
+static lcec_typelist_t types[] = {
+    {"TESTDIN", 0, 0, 0, NULL, test_din_init, NULL, 2},
+    {NULL},
+};
+
+static char conf[4096];
+static size_t conf_len;
+
+static int test_din_init(int comp_id, lcec_slave_t *slave) {
+  lcec_class_din_channels_t *hal_data;
+  unsigned int i;
+
+  hal_data = lcec_din_allocate_channels(slave->flags);
+  if (hal_data == NULL) {
+    return -1;
+  }
+  slave->hal_data = hal_data;
+
+  for (i = 0; i < slave->flags; i++) {
+    hal_data->channels[i] = lcec_din_register_channel(slave, i, 0x6000 + (i << 4), 0x01);
+    if (hal_data->channels[i] == NULL) {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+static void *add_token(const void *token, size_t len) {
+  void *p = &conf[conf_len];
+
+  memcpy(p, token, len);
+  conf_len += len;
+  return p;
+}
+
+static void register_types(void) {
+  static int registered;
+
+  if (!registered) {
+    lcec_addtypes(types, __FILE__);
+    registered = 1;
+  }
+}
+
+// Write the tokens lcec_conf emits for
+//
+//   <slaveTemplate type="TESTDIN" name="din"><dcConf .../></slaveTemplate>
+//   <slave idx="1" template="din" name="in" count="3"/>
+//   <slave idx="4" template="din"><watchdog .../></slave>
+static void build_conf(void) {
+  LCEC_CONF_MASTER_T master = {.confType = lcecConfTypeMaster};
+  LCEC_CONF_SLAVE_T tmpl = {.confType = lcecConfTypeSlaveTemplate, .templateOffset = -1};
+  LCEC_CONF_SLAVE_T slave;
+  LCEC_CONF_DC_T dc = {.confType = lcecConfTypeDcConf, .assignActivate = 0x300, .sync0Cycle = 1000000};
+  LCEC_CONF_WATCHDOG_T wd = {.confType = lcecConfTypeWatchdog, .divider = 2498, .intervals = 100};
+  LCEC_CONF_NULL_T tmpl_end = {.confType = lcecConfTypeSlaveTemplateEnd};
+  LCEC_CONF_NULL_T end = {.confType = lcecConfTypeNone};
+  LCEC_CONF_SLAVE_T *t;
+  long offset;
+  int i;
+
+  register_types();
+
+  conf_len = 0;
+  strcpy(master.name, "0");
+  add_token(&master, sizeof(master));
+
+  strcpy(tmpl.type_name, "TESTDIN");
+  strcpy(tmpl.name, "din");
+  t = add_token(&tmpl, sizeof(tmpl));
+  offset = conf_len;
+  add_token(&dc, sizeof(dc));
+  add_token(&tmpl_end, sizeof(tmpl_end));
+  t->templateLength = conf_len - offset;
+
+  slave = *t;
+  slave.confType = lcecConfTypeSlave;
+  slave.templateOffset = offset;
+  slave.templateLength = 0;
+  for (i = 0; i < 3; i++) {
+    slave.index = 1 + i;
+    setRepeatedSlaveName(&slave, "in", 3, i);
+    add_token(&slave, sizeof(slave));
+  }
+
+  slave.index = 4;
+  setRepeatedSlaveName(&slave, "", 1, 0);
+  add_token(&slave, sizeof(slave));
+  add_token(&wd, sizeof(wd));
+
+  add_token(&end, sizeof(end));
+}
+
+TESTFUNC(test_template_names) {
+  TESTSETUP;
+  LCEC_CONF_SLAVE_T slave = {.index = 7};
+  char long_name[LCEC_CONF_STR_MAXLEN];
+
+  // unnamed slaves are named after their index
+  setRepeatedSlaveName(&slave, "", 1, 0);
+  TESTSTRING(slave.name, "7");
+  slave.index = 9;
+  setRepeatedSlaveName(&slave, "", 3, 2);
+  TESTSTRING(slave.name, "9");
+
+  // a single named slave keeps its name
+  strcpy(slave.name, "axis");
+  setRepeatedSlaveName(&slave, "axis", 1, 0);
+  TESTSTRING(slave.name, "axis");
+
+  // repeated ones are numbered from 0
+  setRepeatedSlaveName(&slave, "axis", 3, 0);
+  TESTSTRING(slave.name, "axis-0");
+  setRepeatedSlaveName(&slave, "axis", 3, 2);
+  TESTSTRING(slave.name, "axis-2");
+
+  // and a long base name is cut to leave room for the suffix
+  memset(long_name, 'x', sizeof(long_name) - 1);
+  long_name[sizeof(long_name) - 1] = 0;
+  setRepeatedSlaveName(&slave, long_name, 20, 19);
+  TESTINT((int)strlen(slave.name), LCEC_CONF_STR_MAXLEN - 12 + 3);
+  TESTSTRING(&slave.name[LCEC_CONF_STR_MAXLEN - 12], "-19");
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_template_registry) {
+  TESTSETUP;
+  LCEC_CONF_SLAVE_T a = {.confType = lcecConfTypeSlaveTemplate};
+  LCEC_CONF_SLAVE_T b = a, dup = a, unnamed = a;
+
+  strcpy(a.name, "a");
+  strcpy(b.name, "b");
+  strcpy(dup.name, "a");
+
+  TESTINT(findSlaveTemplate("a") == NULL, 1);
+  TESTINT(addSlaveTemplate(&a, 100) != NULL, 1);
+  TESTINT(addSlaveTemplate(&b, 200) != NULL, 1);
+  TESTINT(findSlaveTemplate("a")->offset, 100);
+  TESTINT(findSlaveTemplate("b")->offset, 200);
+  TESTINT(findSlaveTemplate("b")->conf == &b, 1);
+
+  // missing, duplicate and unnamed templates are errors
+  TESTINT(findSlaveTemplate("c") == NULL, 1);
+  TESTINT(addSlaveTemplate(&dup, 300) == NULL, 1);
+  TESTINT(findSlaveTemplate("a")->conf == &a, 1);
+  TESTINT(addSlaveTemplate(&unnamed, 300) == NULL, 1);
+
+  freeSlaveTemplates();
+  TESTINT(findSlaveTemplate("a") == NULL, 1);
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_template_tokens) {
+  TESTSETUP;
+  lcec_master_t *first = NULL, *last = NULL;
+  lcec_slave_t *slave;
+  unsigned int bits;
+  int unknown, i;
+
+  build_conf();
+  lcec_dry_run = &test_dry_run;
+  TESTINT(lcec_parse_conf_tokens(conf, &first, &last), 4);
+  TESTINT(lcec_preinit_slaves(first), 0);
+  TESTINT(checkMaster(first, &bits, &unknown), 8);
+  lcec_dry_run = NULL;
+
+  // each instance gets the template's type and body, the template
+  // itself is no slave
+  for (slave = first->first_slave, i = 0; slave != NULL; slave = slave->next, i++) {
+    TESTINT(slave->index, i + 1);
+    TESTINT(slave->proc_init == test_din_init, 1);
+    TESTINT(slave->dc_conf != NULL && slave->dc_conf->assignActivate == 0x300, 1);
+  }
+  TESTINT(i, 4);
+
+  slave = first->first_slave;
+  TESTSTRING(slave->name, "in-0");
+  TESTSTRING(slave->next->next->name, "in-2");
+  TESTINT(slave->wd_conf == NULL, 1);
+
+  // the slave's own children follow the template body
+  slave = last->last_slave;
+  TESTSTRING(slave->name, "4");
+  TESTINT(slave->wd_conf != NULL && slave->wd_conf->divider == 2498, 1);
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_template_stray_end) {
+  TESTSETUP;
+  lcec_master_t *first = NULL, *last = NULL;
+  LCEC_CONF_MASTER_T master = {.confType = lcecConfTypeMaster};
+  LCEC_CONF_NULL_T tmpl_end = {.confType = lcecConfTypeSlaveTemplateEnd};
+  LCEC_CONF_NULL_T end = {.confType = lcecConfTypeNone};
+
+  // a template end without a slave using the template
+  conf_len = 0;
+  strcpy(master.name, "0");
+  add_token(&master, sizeof(master));
+  add_token(&tmpl_end, sizeof(tmpl_end));
+  add_token(&end, sizeof(end));
+
+  lcec_dry_run = &test_dry_run;
+  TESTINT(lcec_parse_conf_tokens(conf, &first, &last), -1);
+  lcec_dry_run = NULL;
+
+  TESTRESULTS;
+}
+
+TESTMAIN
@@ -0,0 +1,169 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../../src/lcec.h"
+#include "../../src/lcec_conf.h"
+#include "../../src/lcec_conf_priv.h"
+#include "tests.h"
+
+TESTGLOBALSETUP;
+
+// The realtime side and lcec_conf share one table, which the test
+// hands out in place of RTAPI shared memory.  The clock and the names
+// lcec_conf would have read from the config are the test's, too.
+static lcec_trace_t table;
+static long long now;
+
+int rtapi_shmem_new(int key, int module_id, unsigned long int size) { return key == LCEC_TRACE_SHMEM_KEY ? 1 : -1; }
+int rtapi_shmem_delete(int shmem_id, int module_id) { return 0; }
+
+#if defined RTAPI_SERIAL && RTAPI_SERIAL >= 2
+int rtapi_shmem_getptr(int shmem_id, void **ptr, unsigned long int *size) {
+#else
+int rtapi_shmem_getptr(int shmem_id, void **ptr) {
+#endif
+  *ptr = &table;
+  return 0;
+}
+
+long long rtapi_get_time(void) { return now; }
+
+const char *findLogName(int master, int slave) {
+  static const char *names[2][3] = {{"m0", "D0", "D1"}, {"m1", "D0", NULL}};
+
+  if (master < 0 || master > 1 || slave < -1 || slave > 1) {
+    return NULL;
+  }
+  return names[master][slave + 1];
+}
+
+static lcec_master_t masters[2];
+static lcec_slave_t slaves[2];
+
+static void setup(const char *file) {
+  memset(masters, 0, sizeof(masters));
+  memset(slaves, 0, sizeof(slaves));
+  masters[1].prev = &masters[0];
+  slaves[0].index = 0;
+  slaves[1].index = 1;
+  now = 1000000000LL;
+
+  initStartupTrace(0, file);
+  lcec_trace_attach();
+}
+
+// Record a stage that took `ms`.
+static void add(lcec_master_t *master, lcec_slave_t *slave, lcec_trace_stage_t stage, int ms) {
+  long long start = lcec_trace_start();
+
+  now += ms * 1000000LL;
+  lcec_trace_add(master, slave, stage, start);
+}
+
+TESTFUNC(test_trace_record) {
+  TESTSETUP;
+  lcec_trace_record_t *rec;
+
+  // nothing is recorded before attaching
+  lcec_trace_detach();
+  TESTINT(lcec_trace_start() == 0, 1);
+  lcec_trace_add(NULL, NULL, LCEC_TRACE_PARSE_CONFIG, 0);
+  TESTINT(table.count, 0);
+
+  setup(NULL);
+  TESTINT(table.magic, LCEC_TRACE_SHMEM_MAGIC);
+
+  add(NULL, NULL, LCEC_TRACE_PARSE_CONFIG, 3);
+  add(&masters[1], &slaves[1], LCEC_TRACE_PROC_INIT, 2);
+  TESTINT(table.count, 2);
+
+  // global stages have no master or slave
+  rec = &table.records[0];
+  TESTINT(rec->valid, 1);
+  TESTINT(rec->stage, LCEC_TRACE_PARSE_CONFIG);
+  TESTINT(rec->master, -1);
+  TESTINT(rec->slave, -1);
+  TESTINT(rec->start == 1000000000LL, 1);
+  TESTINT((int)rec->duration, 3000000);
+
+  // masters are known by their position, slaves by their index
+  rec = &table.records[1];
+  TESTINT(rec->stage, LCEC_TRACE_PROC_INIT);
+  TESTINT(rec->master, 1);
+  TESTINT(rec->slave, 1);
+  TESTINT(rec->start == 1003000000LL, 1);
+  TESTINT((int)rec->duration, 2000000);
+
+  // a full table still counts what it drops
+  table.count = LCEC_TRACE_MAX_RECORDS;
+  add(&masters[0], NULL, LCEC_TRACE_ACTIVATE, 1);
+  TESTINT(table.count, LCEC_TRACE_MAX_RECORDS + 1);
+
+  lcec_trace_detach();
+  freeStartupTrace(0);
+
+  TESTRESULTS;
+}
+
+TESTFUNC(test_trace_format) {
+  TESTSETUP;
+  char file[] = "/tmp/test_trace.XXXXXX";
+  char line[256];
+  FILE *f;
+  int fd;
+
+  fd = mkstemp(file);
+  TESTINT(fd >= 0, 1);
+  close(fd);
+  setup(file);
+
+  add(NULL, NULL, LCEC_TRACE_PARSE_CONFIG, 3);
+  add(&masters[0], &slaves[0], LCEC_TRACE_PROC_INIT, 2);
+  add(&masters[0], &slaves[1], LCEC_TRACE_PROC_INIT, 5);
+  add(&masters[1], &slaves[1], LCEC_TRACE_PROC_INIT, 1);  // a slave without a name
+  add(&masters[0], NULL, LCEC_TRACE_ACTIVATE, 10);
+  add(&masters[0], &slaves[0], LCEC_TRACE_WAIT_OP, 40);
+
+  // a record still being filled in is skipped
+  table.records[table.count++].stage = LCEC_TRACE_PROC_INIT;
+
+  // nothing is written until every master is in OP
+  pollStartupTrace(2);
+  f = fopen(file, "r");
+  TESTINT(f != NULL && fgetc(f) == EOF, 1);
+  if (f != NULL) {
+    fclose(f);
+  }
+
+  add(&masters[0], NULL, LCEC_TRACE_MASTER_OP, 50);
+  add(&masters[1], NULL, LCEC_TRACE_MASTER_OP, 20);
+  pollStartupTrace(2);
+
+  f = fopen(file, "r");
+  TESTINT(f != NULL, 1);
+  if (f != NULL) {
+    TESTSTRING(fgets(line, sizeof(line), f), "# lcec startup trace\n");
+    fgets(line, sizeof(line), f);
+    fgets(line, sizeof(line), f);
+    TESTSTRING(fgets(line, sizeof(line), f), "       0.000        3.000  parse-config   -\n");
+    TESTSTRING(fgets(line, sizeof(line), f), "       3.000        2.000  proc-init      m0.D0\n");
+    TESTSTRING(fgets(line, sizeof(line), f), "       5.000        5.000  proc-init      m0.D1\n");
+    TESTSTRING(fgets(line, sizeof(line), f), "      10.000        1.000  proc-init      m1.?\n");
+    TESTSTRING(fgets(line, sizeof(line), f), "      11.000       10.000  activate       m0\n");
+    TESTSTRING(fgets(line, sizeof(line), f), "      21.000       40.000  wait-op        m0.D0\n");
+    TESTSTRING(fgets(line, sizeof(line), f), "      61.000       50.000  master-op      m0\n");
+    TESTSTRING(fgets(line, sizeof(line), f), "     111.000       20.000  master-op      m1\n");
+    TESTINT(fgets(line, sizeof(line), f) == NULL, 1);
+    fclose(f);
+  }
+
+  lcec_trace_detach();
+  freeStartupTrace(0);
+  unlink(file);
+
+  TESTRESULTS;
+}
+
+TESTMAIN